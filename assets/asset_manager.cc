@@ -5,6 +5,7 @@
 #include "flutter/assets/asset_manager.h"
 
 #include "flutter/assets/directory_asset_bundle.h"
+#include "flutter/fml/mapping.h"
 #include "flutter/fml/trace_event.h"
 
 namespace flutter {
@@ -13,19 +14,23 @@ AssetManager::AssetManager() = default;
 
 AssetManager::~AssetManager() = default;
 
-void AssetManager::PushFront(std::unique_ptr<AssetResolver> resolver) {
+void AssetManager::PushFront(std::shared_ptr<AssetResolver> resolver) {
   if (resolver == nullptr || !resolver->IsValid()) {
     return;
   }
 
+  std::scoped_lock lock(resolvers_mutex_);
+  DiscardPrefetchedMappings();
   resolvers_.push_front(std::move(resolver));
 }
 
-void AssetManager::PushBack(std::unique_ptr<AssetResolver> resolver) {
+void AssetManager::PushBack(std::shared_ptr<AssetResolver> resolver) {
   if (resolver == nullptr || !resolver->IsValid()) {
     return;
   }
 
+  std::scoped_lock lock(resolvers_mutex_);
+  DiscardPrefetchedMappings();
   resolvers_.push_back(std::move(resolver));
 }
 
@@ -35,8 +40,10 @@ void AssetManager::UpdateResolverByType(
   if (updated_asset_resolver == nullptr) {
     return;
   }
+  std::scoped_lock lock(resolvers_mutex_);
+  DiscardPrefetchedMappings();
   bool updated = false;
-  std::deque<std::unique_ptr<AssetResolver>> new_resolvers;
+  std::deque<std::shared_ptr<AssetResolver>> new_resolvers;
   for (auto& old_resolver : resolvers_) {
     if (!updated && old_resolver->GetType() == type) {
       // Push the replacement updated resolver in place of the old_resolver.
@@ -53,10 +60,88 @@ void AssetManager::UpdateResolverByType(
   resolvers_.swap(new_resolvers);
 }
 
-std::deque<std::unique_ptr<AssetResolver>> AssetManager::TakeResolvers() {
+std::deque<std::shared_ptr<AssetResolver>> AssetManager::TakeResolvers() {
+  std::scoped_lock lock(resolvers_mutex_);
+  DiscardPrefetchedMappings();
   return std::move(resolvers_);
 }
 
+void AssetManager::DiscardPrefetchedMappings() {
+  std::scoped_lock lock(mutex_);
+  resolvers_generation_++;
+  prefetched_mappings_.clear();
+  prefetched_bytes_ = 0;
+}
+
+void AssetManager::PrefetchAssets(std::vector<std::string> asset_names,
+                                  fml::RefPtr<fml::TaskRunner> task_runner,
+                                  size_t max_bytes) {
+  if (asset_names.empty() || !task_runner) {
+    return;
+  }
+  size_t generation;
+  {
+    std::scoped_lock lock(mutex_);
+    generation = resolvers_generation_;
+  }
+  task_runner->PostTask([weak_manager = weak_from_this(),
+                         asset_names = std::move(asset_names), generation,
+                         max_bytes]() {
+    TRACE_EVENT0("flutter", "AssetManager::PrefetchAssets");
+    for (const auto& asset_name : asset_names) {
+      auto manager = weak_manager.lock();
+      if (!manager) {
+        return;
+      }
+      // Resolved without holding the resolvers lock. If the resolvers change
+      // meanwhile, the generation check below discards the mapping.
+      std::unique_ptr<fml::Mapping> mapping =
+          ResolveAsMapping(manager->GetResolvers(), asset_name);
+      if (!mapping) {
+        continue;
+      }
+      // Whether the mapping can be held on to without going over the limit.
+      auto fits = [&]() {
+        return manager->prefetched_bytes_ + mapping->GetSize() <= max_bytes &&
+               manager->prefetched_mappings_.count(asset_name) == 0;
+      };
+      {
+        std::scoped_lock lock(manager->mutex_);
+        if (manager->resolvers_generation_ != generation) {
+          return;
+        }
+        if (!fits()) {
+          continue;
+        }
+      }
+      fml::PrefetchMapping(*mapping);
+      std::scoped_lock lock(manager->mutex_);
+      if (manager->resolvers_generation_ != generation) {
+        return;
+      }
+      if (!fits()) {
+        continue;
+      }
+      manager->prefetched_bytes_ += mapping->GetSize();
+      manager->prefetched_mappings_.emplace(asset_name, std::move(mapping));
+    }
+  });
+}
+
+void AssetManager::StartRecordingAccesses() {
+  std::scoped_lock lock(mutex_);
+  recording_accesses_ = true;
+  recorded_accesses_.clear();
+  recorded_access_set_.clear();
+}
+
+std::vector<std::string> AssetManager::StopRecordingAccesses() {
+  std::scoped_lock lock(mutex_);
+  recording_accesses_ = false;
+  recorded_access_set_.clear();
+  return std::move(recorded_accesses_);
+}
+
 // |AssetResolver|
 std::unique_ptr<fml::Mapping> AssetManager::GetAsMapping(
     const std::string& asset_name) const {
@@ -65,7 +150,32 @@ std::unique_ptr<fml::Mapping> AssetManager::GetAsMapping(
   }
   TRACE_EVENT1("flutter", "AssetManager::GetAsMapping", "name",
                asset_name.c_str());
-  for (const auto& resolver : resolvers_) {
+  {
+    std::scoped_lock lock(mutex_);
+    if (recording_accesses_ &&
+        recorded_access_set_.insert(asset_name).second) {
+      recorded_accesses_.push_back(asset_name);
+    }
+    auto prefetched = prefetched_mappings_.find(asset_name);
+    if (prefetched != prefetched_mappings_.end()) {
+      auto mapping = std::move(prefetched->second);
+      prefetched_mappings_.erase(prefetched);
+      prefetched_bytes_ -= mapping->GetSize();
+      return mapping;
+    }
+  }
+  return ResolveAsMapping(GetResolvers(), asset_name);
+}
+
+std::deque<std::shared_ptr<AssetResolver>> AssetManager::GetResolvers() const {
+  std::scoped_lock lock(resolvers_mutex_);
+  return resolvers_;
+}
+
+std::unique_ptr<fml::Mapping> AssetManager::ResolveAsMapping(
+    const std::deque<std::shared_ptr<AssetResolver>>& resolvers,
+    const std::string& asset_name) {
+  for (const auto& resolver : resolvers) {
     auto mapping = resolver->GetAsMapping(asset_name);
     if (mapping != nullptr) {
       return mapping;
@@ -85,7 +195,7 @@ std::vector<std::unique_ptr<fml::Mapping>> AssetManager::GetAsMappings(
   }
   TRACE_EVENT1("flutter", "AssetManager::GetAsMappings", "pattern",
                asset_pattern.c_str());
-  for (const auto& resolver : resolvers_) {
+  for (const auto& resolver : GetResolvers()) {
     auto resolver_mappings = resolver->GetAsMappings(asset_pattern, subdir);
     mappings.insert(mappings.end(),
                     std::make_move_iterator(resolver_mappings.begin()),
@@ -96,6 +206,7 @@ std::vector<std::unique_ptr<fml::Mapping>> AssetManager::GetAsMappings(
 
 // |AssetResolver|
 bool AssetManager::IsValid() const {
+  std::scoped_lock lock(resolvers_mutex_);
   return resolvers_.size() > 0;
 }
 
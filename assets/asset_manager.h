@@ -7,24 +7,31 @@
 
 #include <deque>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 
 #include <optional>
 #include "flutter/assets/asset_resolver.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/ref_counted.h"
+#include "flutter/fml/task_runner.h"
 
 namespace flutter {
 
-class AssetManager final : public AssetResolver {
+class AssetManager final : public AssetResolver,
+                           public std::enable_shared_from_this<AssetManager> {
  public:
+  static constexpr size_t kDefaultMaxPrefetchedBytes = 64 * 1024 * 1024;
+
   AssetManager();
 
   ~AssetManager() override;
 
-  void PushFront(std::unique_ptr<AssetResolver> resolver);
+  void PushFront(std::shared_ptr<AssetResolver> resolver);
 
-  void PushBack(std::unique_ptr<AssetResolver> resolver);
+  void PushBack(std::shared_ptr<AssetResolver> resolver);
 
   //--------------------------------------------------------------------------
   /// @brief      Replaces an asset resolver of the specified `type` with
@@ -54,7 +61,53 @@ class AssetManager final : public AssetResolver {
       std::unique_ptr<AssetResolver> updated_asset_resolver,
       AssetResolver::AssetResolverType type);
 
-  std::deque<std::unique_ptr<AssetResolver>> TakeResolvers();
+  //----------------------------------------------------------------------------
+  /// @brief      Removes all the resolvers and returns them. Reads that
+  ///             started before the call may still be using them.
+  ///
+  std::deque<std::shared_ptr<AssetResolver>> TakeResolvers();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Resolves the given assets on `task_runner` and asks the
+  ///             operating system to read their contents ahead of their first
+  ///             use, so that a frame that needs them does not block on
+  ///             storage. The resolved mappings are handed out by the next
+  ///             `GetAsMapping` call for each asset, which saves opening the
+  ///             asset again.
+  ///
+  ///             Changing the resolvers discards prefetched mappings. Nothing
+  ///             is prefetched unless the asset manager is owned by a
+  ///             `std::shared_ptr`.
+  ///
+  ///             Prefetched mappings that have not been requested yet are
+  ///             held on to, so at most `max_bytes` of them are kept. Assets
+  ///             that don't fit are skipped and resolved when requested.
+  ///
+  /// @param[in]  asset_names  The assets to prefetch, such as a list recorded
+  ///                          by `StopRecordingAccesses` on a previous launch.
+  /// @param[in]  task_runner  The background task runner to resolve and
+  ///                          prefetch the assets on.
+  /// @param[in]  max_bytes    The most bytes of prefetched mappings to hold
+  ///                          for assets that have not been requested yet.
+  ///
+  void PrefetchAssets(std::vector<std::string> asset_names,
+                      fml::RefPtr<fml::TaskRunner> task_runner,
+                      size_t max_bytes = kDefaultMaxPrefetchedBytes);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Starts recording the names of the assets requested with
+  ///             `GetAsMapping`, so that they can be prefetched the next time
+  ///             the application starts.
+  ///
+  void StartRecordingAccesses();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Stops recording asset accesses.
+  ///
+  /// @return     The names of the assets requested since
+  ///             `StartRecordingAccesses`, in the order of their first request.
+  ///
+  std::vector<std::string> StopRecordingAccesses();
 
   // |AssetResolver|
   bool IsValid() const override;
@@ -75,7 +128,37 @@ class AssetManager final : public AssetResolver {
       const std::optional<std::string>& subdir) const override;
 
  private:
-  std::deque<std::unique_ptr<AssetResolver>> resolvers_;
+  // Guards the resolvers, which the prefetch task runner reads while the
+  // thread that owns the asset manager may change them. Acquired before
+  // |mutex_| when both are held. Only held to copy the resolvers, never while
+  // they read assets.
+  mutable std::mutex resolvers_mutex_;
+  std::deque<std::shared_ptr<AssetResolver>> resolvers_;
+
+  // Guards the prefetched mappings and the recorded accesses, which are used
+  // from the threads that read assets and from the prefetch task runner.
+  mutable std::mutex mutex_;
+  mutable std::unordered_map<std::string, std::unique_ptr<fml::Mapping>>
+      prefetched_mappings_;
+  // The total size of |prefetched_mappings_|.
+  mutable size_t prefetched_bytes_ = 0;
+  // Incremented whenever the resolvers change, so that prefetches started
+  // before the change do not hand out mappings of replaced resolvers.
+  size_t resolvers_generation_ = 0;
+  bool recording_accesses_ = false;
+  mutable std::vector<std::string> recorded_accesses_;
+  mutable std::unordered_set<std::string> recorded_access_set_;
+
+  // Returns a copy of |resolvers_|, with which assets can be resolved
+  // without holding |resolvers_mutex_|.
+  std::deque<std::shared_ptr<AssetResolver>> GetResolvers() const;
+
+  static std::unique_ptr<fml::Mapping> ResolveAsMapping(
+      const std::deque<std::shared_ptr<AssetResolver>>& resolvers,
+      const std::string& asset_name);
+
+  // Must be called with |resolvers_mutex_| held.
+  void DiscardPrefetchedMappings();
 
   FML_DISALLOW_COPY_AND_ASSIGN(AssetManager);
 };
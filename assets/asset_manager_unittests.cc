@@ -0,0 +1,165 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/assets/asset_manager.h"
+
+#include <string>
+#include <vector>
+
+#include "flutter/assets/asset_pack.h"
+#include "flutter/assets/packed_asset_bundle.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/thread.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+std::unique_ptr<AssetResolver> CreateBundle(
+    const std::vector<std::string>& asset_names) {
+  AssetPackBuilder builder;
+  for (const auto& asset_name : asset_names) {
+    builder.AddAsset(asset_name,
+                     std::make_unique<fml::DataMapping>(asset_name));
+  }
+  return std::make_unique<PackedAssetBundle>(builder.Build(), false);
+}
+
+// Records the names of the assets looked up in the resolver it wraps.
+class LookupRecordingResolver : public AssetResolver {
+ public:
+  LookupRecordingResolver(std::unique_ptr<AssetResolver> resolver,
+                          std::vector<std::string>* lookups)
+      : resolver_(std::move(resolver)), lookups_(lookups) {}
+
+  // |AssetResolver|
+  bool IsValid() const override { return resolver_->IsValid(); }
+
+  // |AssetResolver|
+  bool IsValidAfterAssetManagerChange() const override { return false; }
+
+  // |AssetResolver|
+  AssetResolverType GetType() const override { return resolver_->GetType(); }
+
+  // |AssetResolver|
+  std::unique_ptr<fml::Mapping> GetAsMapping(
+      const std::string& asset_name) const override {
+    lookups_->push_back(asset_name);
+    return resolver_->GetAsMapping(asset_name);
+  }
+
+ private:
+  std::unique_ptr<AssetResolver> resolver_;
+  std::vector<std::string>* lookups_;
+};
+
+// Runs all tasks posted to |task_runner| before this call.
+void Flush(const fml::RefPtr<fml::TaskRunner>& task_runner) {
+  fml::AutoResetWaitableEvent latch;
+  task_runner->PostTask([&latch] { latch.Signal(); });
+  latch.Wait();
+}
+
+}  // namespace
+
+TEST(AssetManagerTest, RecordsFirstAccessOfEachAsset) {
+  auto asset_manager = std::make_shared<AssetManager>();
+  asset_manager->PushBack(CreateBundle({"a", "b", "c"}));
+
+  asset_manager->GetAsMapping("a");
+  asset_manager->StartRecordingAccesses();
+  asset_manager->GetAsMapping("c");
+  asset_manager->GetAsMapping("missing");
+  asset_manager->GetAsMapping("c");
+  asset_manager->GetAsMapping("b");
+  auto accesses = asset_manager->StopRecordingAccesses();
+  asset_manager->GetAsMapping("a");
+
+  EXPECT_EQ(accesses, (std::vector<std::string>{"c", "missing", "b"}));
+  EXPECT_TRUE(asset_manager->StopRecordingAccesses().empty());
+}
+
+TEST(AssetManagerTest, HandsOutPrefetchedMappings) {
+  fml::Thread thread("prefetch");
+  auto asset_manager = std::make_shared<AssetManager>();
+  asset_manager->PushBack(CreateBundle({"a", "b"}));
+
+  asset_manager->PrefetchAssets({"a", "missing"}, thread.GetTaskRunner());
+  Flush(thread.GetTaskRunner());
+
+  // Prefetching is not recorded as an access.
+  asset_manager->StartRecordingAccesses();
+  for (int i = 0; i < 2; ++i) {
+    auto mapping = asset_manager->GetAsMapping("a");
+    ASSERT_NE(mapping, nullptr);
+    EXPECT_EQ(std::string(reinterpret_cast<const char*>(mapping->GetMapping()),
+                          mapping->GetSize()),
+              "a");
+  }
+  EXPECT_EQ(asset_manager->GetAsMapping("missing"), nullptr);
+  EXPECT_EQ(asset_manager->StopRecordingAccesses(),
+            (std::vector<std::string>{"a", "missing"}));
+}
+
+TEST(AssetManagerTest, LimitsTheSizeOfUnrequestedPrefetchedMappings) {
+  fml::Thread thread("prefetch");
+  auto asset_manager = std::make_shared<AssetManager>();
+  std::vector<std::string> lookups;
+  asset_manager->PushBack(std::make_unique<LookupRecordingResolver>(
+      CreateBundle({"aaaa", "bbbb", "cc", "dddd"}), &lookups));
+
+  // Only "aaaa" and "cc" fit in the limit.
+  asset_manager->PrefetchAssets({"aaaa", "bbbb", "cc", "dddd"},
+                                thread.GetTaskRunner(), 6);
+  Flush(thread.GetTaskRunner());
+  lookups.clear();
+  EXPECT_NE(asset_manager->GetAsMapping("aaaa"), nullptr);
+  EXPECT_NE(asset_manager->GetAsMapping("bbbb"), nullptr);
+  EXPECT_NE(asset_manager->GetAsMapping("cc"), nullptr);
+  EXPECT_EQ(lookups, (std::vector<std::string>{"bbbb"}));
+
+  // Requesting the prefetched mappings made room for more.
+  asset_manager->PrefetchAssets({"dddd"}, thread.GetTaskRunner(), 6);
+  Flush(thread.GetTaskRunner());
+  lookups.clear();
+  EXPECT_NE(asset_manager->GetAsMapping("dddd"), nullptr);
+  EXPECT_TRUE(lookups.empty());
+}
+
+TEST(AssetManagerTest, ChangingResolversDiscardsPrefetchedMappings) {
+  fml::Thread thread("prefetch");
+  auto asset_manager = std::make_shared<AssetManager>();
+  asset_manager->PushBack(CreateBundle({"a"}));
+
+  asset_manager->PrefetchAssets({"a"}, thread.GetTaskRunner());
+  Flush(thread.GetTaskRunner());
+  asset_manager->UpdateResolverByType(
+      CreateBundle({"b"}),
+      AssetResolver::AssetResolverType::kPackedAssetBundle);
+
+  EXPECT_EQ(asset_manager->GetAsMapping("a"), nullptr);
+  EXPECT_NE(asset_manager->GetAsMapping("b"), nullptr);
+}
+
+TEST(AssetManagerTest, PrefetchDoesNotKeepAssetManagerAlive) {
+  fml::Thread thread("prefetch");
+  fml::AutoResetWaitableEvent latch;
+  thread.GetTaskRunner()->PostTask([&latch] { latch.Wait(); });
+
+  std::weak_ptr<AssetManager> weak_asset_manager;
+  {
+    auto asset_manager = std::make_shared<AssetManager>();
+    asset_manager->PushBack(CreateBundle({"a"}));
+    asset_manager->PrefetchAssets({"a"}, thread.GetTaskRunner());
+    weak_asset_manager = asset_manager;
+  }
+  EXPECT_TRUE(weak_asset_manager.expired());
+  latch.Signal();
+  Flush(thread.GetTaskRunner());
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -0,0 +1,244 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/assets/asset_pack.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+#include "flutter/fml/file.h"
+#include "flutter/fml/logging.h"
+
+namespace flutter {
+
+namespace {
+
+constexpr uint32_t kFNVOffsetBasis = 2166136261u;
+constexpr uint32_t kFNVPrime = 16777619u;
+
+// Displacements are tried up to this value before giving up on a bucket,
+// which in practice only happens for pathological inputs.
+constexpr int32_t kMaxDisplacement = 1 << 20;
+
+uint64_t AlignUp(uint64_t offset, uint64_t alignment) {
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+uint32_t HashName(uint32_t seed, const std::string& name) {
+  return AssetPackHash(seed, name.data(), name.size());
+}
+
+// Collects the paths of all files below |directory| relative to the directory
+// that was originally visited, which is |prefix| away from |directory|.
+bool CollectFiles(const fml::UniqueFD& directory,
+                  const std::string& prefix,
+                  std::vector<std::string>& files) {
+  bool success = true;
+  fml::FileVisitor visitor = [&](const fml::UniqueFD& directory,
+                                 const std::string& filename) {
+    if (fml::IsDirectory(directory, filename.c_str())) {
+      success &= CollectFiles(
+          fml::OpenDirectoryReadOnly(directory, filename.c_str()),
+          prefix + filename + "/", files);
+    } else {
+      files.push_back(prefix + filename);
+    }
+    return true;
+  };
+  bool visited = fml::VisitFiles(directory, visitor);
+  return visited && success;
+}
+
+}  // namespace
+
+uint32_t AssetPackHash(uint32_t seed, const char* name, size_t size) {
+  uint32_t hash = kFNVOffsetBasis ^ (seed * 0x9E3779B9u);
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= static_cast<uint8_t>(name[i]);
+    hash *= kFNVPrime;
+  }
+  // FNV-1a leaves the low bits poorly mixed for short keys, and the index
+  // reduces the hash modulo the entry count.
+  hash ^= hash >> 16;
+  hash *= 0x85EBCA6Bu;
+  hash ^= hash >> 13;
+  return hash;
+}
+
+uint32_t AssetPackFindEntry(const int32_t* displacements,
+                            uint32_t entry_count,
+                            const std::string& name) {
+  FML_DCHECK(entry_count > 0);
+  const int32_t displacement = displacements[HashName(0, name) % entry_count];
+  if (displacement < 0) {
+    // Negated after adding one, so that INT32_MIN doesn't overflow.
+    return static_cast<uint32_t>(-(displacement + 1));
+  }
+  return HashName(displacement, name) % entry_count;
+}
+
+AssetPackBuilder::AssetPackBuilder() = default;
+
+AssetPackBuilder::~AssetPackBuilder() = default;
+
+bool AssetPackBuilder::AddAsset(const std::string& name,
+                                std::unique_ptr<fml::Mapping> mapping) {
+  if (!mapping || !names_.insert(name).second) {
+    return false;
+  }
+  assets_.push_back({name, std::move(mapping)});
+  return true;
+}
+
+bool AssetPackBuilder::AddDirectory(const fml::UniqueFD& directory) {
+  if (!fml::IsDirectory(directory)) {
+    return false;
+  }
+  std::vector<std::string> files;
+  if (!CollectFiles(directory, "", files)) {
+    return false;
+  }
+  std::sort(files.begin(), files.end());
+  for (const std::string& file : files) {
+    if (!AddAsset(file, fml::FileMapping::CreateReadOnly(directory, file))) {
+      FML_LOG(ERROR) << "Could not add asset " << file;
+      return false;
+    }
+  }
+  return true;
+}
+
+std::unique_ptr<fml::Mapping> AssetPackBuilder::Build() const {
+  const uint32_t entry_count = assets_.size();
+
+  // Hash and displace: the assets are distributed into one bucket per entry
+  // by their unseeded hash. Starting with the largest, every bucket gets the
+  // first seed that maps all its assets to free slots. Buckets of a single
+  // asset take any free slot, which is stored directly as a negative value.
+  std::vector<std::vector<uint32_t>> buckets(entry_count);
+  for (uint32_t i = 0; i < entry_count; ++i) {
+    buckets[HashName(0, assets_[i].name) % entry_count].push_back(i);
+  }
+  std::vector<uint32_t> bucket_order(entry_count);
+  for (uint32_t i = 0; i < entry_count; ++i) {
+    bucket_order[i] = i;
+  }
+  std::stable_sort(bucket_order.begin(), bucket_order.end(),
+                   [&buckets](uint32_t a, uint32_t b) {
+                     return buckets[a].size() > buckets[b].size();
+                   });
+
+  std::vector<int32_t> displacements(entry_count, 0);
+  // The asset at each slot of the index, or -1 while the slot is free.
+  std::vector<int64_t> slots(entry_count, -1);
+  std::vector<uint32_t> bucket_slots;
+  uint32_t next_free_slot = 0;
+  for (uint32_t bucket_index : bucket_order) {
+    const std::vector<uint32_t>& bucket = buckets[bucket_index];
+    if (bucket.empty()) {
+      break;
+    }
+    if (bucket.size() == 1) {
+      while (slots[next_free_slot] >= 0) {
+        ++next_free_slot;
+      }
+      slots[next_free_slot] = bucket[0];
+      displacements[bucket_index] = -static_cast<int32_t>(next_free_slot) - 1;
+      continue;
+    }
+    bool placed = false;
+    for (int32_t displacement = 1; !placed && displacement < kMaxDisplacement;
+         ++displacement) {
+      bucket_slots.clear();
+      for (uint32_t asset : bucket) {
+        uint32_t slot =
+            HashName(displacement, assets_[asset].name) % entry_count;
+        if (slots[slot] >= 0 ||
+            std::find(bucket_slots.begin(), bucket_slots.end(), slot) !=
+                bucket_slots.end()) {
+          break;
+        }
+        bucket_slots.push_back(slot);
+      }
+      if (bucket_slots.size() == bucket.size()) {
+        for (size_t i = 0; i < bucket.size(); ++i) {
+          slots[bucket_slots[i]] = bucket[i];
+        }
+        displacements[bucket_index] = displacement;
+        placed = true;
+      }
+    }
+    if (!placed) {
+      FML_LOG(ERROR) << "Could not find a perfect hash for the asset names.";
+      return nullptr;
+    }
+  }
+
+  // Names are stored in slot order. The data keeps the order the assets were
+  // added in, so that callers can keep related assets close together.
+  std::vector<AssetPackEntry> entries(entry_count);
+  uint64_t names_size = 0;
+  for (uint32_t slot = 0; slot < entry_count; ++slot) {
+    const std::string& name = assets_[slots[slot]].name;
+    entries[slot].name_offset = names_size;
+    entries[slot].name_size = name.size();
+    names_size += name.size();
+  }
+  if (names_size > std::numeric_limits<uint32_t>::max()) {
+    FML_LOG(ERROR) << "The asset names are too long for an asset pack.";
+    return nullptr;
+  }
+
+  std::vector<uint32_t> asset_slots(entry_count);
+  for (uint32_t slot = 0; slot < entry_count; ++slot) {
+    asset_slots[slots[slot]] = slot;
+  }
+  uint64_t data_size = 0;
+  for (uint32_t i = 0; i < entry_count; ++i) {
+    const uint64_t size = assets_[i].mapping->GetSize();
+    data_size = AlignUp(data_size, size >= kAssetPackPageSize
+                                       ? kAssetPackPageSize
+                                       : kAssetPackDataAlignment);
+    entries[asset_slots[i]].data_offset = data_size;
+    entries[asset_slots[i]].data_size = size;
+    data_size += size;
+  }
+
+  AssetPackHeader header = {};
+  std::memcpy(header.magic, kAssetPackMagic, sizeof(header.magic));
+  header.version = kAssetPackVersion;
+  header.entry_count = entry_count;
+  header.index_size = entry_count * sizeof(AssetPackEntry) +
+                      entry_count * sizeof(int32_t) + names_size;
+  header.data_offset =
+      AlignUp(sizeof(AssetPackHeader) + header.index_size, kAssetPackPageSize);
+
+  std::vector<uint8_t> pack(header.data_offset + data_size, 0);
+  uint8_t* cursor = pack.data();
+  std::memcpy(cursor, &header, sizeof(header));
+  cursor += sizeof(header);
+  std::memcpy(cursor, entries.data(), entry_count * sizeof(AssetPackEntry));
+  cursor += entry_count * sizeof(AssetPackEntry);
+  std::memcpy(cursor, displacements.data(), entry_count * sizeof(int32_t));
+  cursor += entry_count * sizeof(int32_t);
+  for (uint32_t slot = 0; slot < entry_count; ++slot) {
+    const std::string& name = assets_[slots[slot]].name;
+    std::memcpy(cursor, name.data(), name.size());
+    cursor += name.size();
+  }
+  uint8_t* data = pack.data() + header.data_offset;
+  for (uint32_t i = 0; i < entry_count; ++i) {
+    const AssetPackEntry& entry = entries[asset_slots[i]];
+    if (entry.data_size > 0) {
+      std::memcpy(data + entry.data_offset, assets_[i].mapping->GetMapping(),
+                  entry.data_size);
+    }
+  }
+
+  return std::make_unique<fml::DataMapping>(std::move(pack));
+}
+
+}  // namespace flutter
@@ -0,0 +1,143 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_ASSETS_ASSET_PACK_H_
+#define FLUTTER_ASSETS_ASSET_PACK_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/unique_fd.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// An asset pack stores all the assets of an application in a single file, so
+/// that they can be served from one memory mapping instead of one open, stat
+/// and mapping per asset. The file is laid out as follows, with all integers
+/// stored in the byte order of the (little endian) target:
+///
+///   AssetPackHeader
+///   AssetPackEntry entries[entry_count]
+///   int32_t displacements[entry_count]
+///   char names[]
+///   <zero padding up to the next page boundary>
+///   asset data
+///
+/// The entries are indexed by a minimal perfect hash of the asset names (see
+/// `AssetPackFindEntry`), so that an asset is found with two hashes of its name
+/// and one name comparison. Assets of at least `kAssetPackPageSize` bytes start
+/// on a page boundary so that they can be paged in independently. Smaller
+/// assets are packed with `kAssetPackDataAlignment` alignment.
+///
+/// Packs are created by `AssetPackBuilder`, or from a flutter_assets directory
+/// with the `asset_pack` tool, and read by `PackedAssetBundle`.
+///
+static constexpr char kAssetPackMagic[8] = {'F', 'L', 'T', 'A',
+                                            'P', 'A', 'C', 'K'};
+static constexpr uint32_t kAssetPackVersion = 1;
+static constexpr uint64_t kAssetPackPageSize = 4096;
+static constexpr uint64_t kAssetPackDataAlignment = 16;
+
+struct AssetPackHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t entry_count;
+  // The size of the index (the entries, displacements and names), which
+  // directly follows the header.
+  uint64_t index_size;
+  // The offset of the asset data from the start of the pack.
+  uint64_t data_offset;
+};
+
+struct AssetPackEntry {
+  // The offset of the name from the start of the names.
+  uint32_t name_offset;
+  uint32_t name_size;
+  // The offset of the asset from the start of the data.
+  uint64_t data_offset;
+  uint64_t data_size;
+};
+
+static_assert(sizeof(AssetPackHeader) == 32, "Unexpected header padding.");
+static_assert(sizeof(AssetPackEntry) == 24, "Unexpected entry padding.");
+
+//------------------------------------------------------------------------------
+/// @brief      The hash function of the asset name index, a 32-bit FNV-1a
+///             hash whose offset basis is perturbed by `seed`.
+///
+uint32_t AssetPackHash(uint32_t seed, const char* name, size_t size);
+
+//------------------------------------------------------------------------------
+/// @brief      Looks up an asset name in the index of a pack.
+///
+/// @param[in]  displacements  The displacements of the pack's index.
+/// @param[in]  entry_count    The number of entries of the pack.
+/// @param[in]  name           The asset name.
+///
+/// @return     The only entry index the asset can be at if it is in the pack.
+///             The caller must still compare the name of the entry.
+///
+uint32_t AssetPackFindEntry(const int32_t* displacements,
+                            uint32_t entry_count,
+                            const std::string& name);
+
+//------------------------------------------------------------------------------
+/// Builds an asset pack from assets that are added one by one.
+///
+class AssetPackBuilder {
+ public:
+  AssetPackBuilder();
+
+  ~AssetPackBuilder();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Adds an asset to the pack.
+  ///
+  /// @param[in]  name     The name the asset is looked up with, which is its
+  ///                      path relative to the assets directory with `/` as
+  ///                      the separator.
+  /// @param[in]  mapping  The contents of the asset.
+  ///
+  /// @return     Whether the asset was added. Fails if an asset with the same
+  ///             name was already added.
+  ///
+  bool AddAsset(const std::string& name, std::unique_ptr<fml::Mapping> mapping);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Adds all files in a directory and its subdirectories, such as
+  ///             a flutter_assets directory, in the order of their names.
+  ///
+  /// @return     Whether all files could be read and added.
+  ///
+  bool AddDirectory(const fml::UniqueFD& directory);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Lays out the pack and returns its contents.
+  ///
+  /// @return     The pack, or nullptr if no perfect hash of the asset names
+  ///             could be found.
+  ///
+  std::unique_ptr<fml::Mapping> Build() const;
+
+ private:
+  struct Asset {
+    std::string name;
+    std::unique_ptr<fml::Mapping> mapping;
+  };
+
+  std::vector<Asset> assets_;
+  std::unordered_set<std::string> names_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(AssetPackBuilder);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_ASSETS_ASSET_PACK_H_
@@ -0,0 +1,121 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+#include <vector>
+
+#include "flutter/assets/asset_pack.h"
+#include "flutter/assets/directory_asset_bundle.h"
+#include "flutter/assets/packed_asset_bundle.h"
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/fml/file.h"
+#include "flutter/fml/logging.h"
+
+namespace flutter {
+
+namespace {
+
+// A flutter_assets directory with |count| assets of a few kilobytes spread
+// over a handful of directories, and an asset pack of the same assets.
+class AssetsFixture {
+ public:
+  explicit AssetsFixture(int count) {
+    for (int i = 0; i < count; ++i) {
+      std::string directory = "assets_" + std::to_string(i % 8);
+      std::string name = "asset_" + std::to_string(i) + ".png";
+      auto directory_fd = fml::CreateDirectory(
+          assets_dir_.fd(), {directory}, fml::FilePermission::kReadWrite);
+      std::string contents(1024 + (i % 8) * 512, static_cast<char>(i));
+      FML_CHECK(fml::WriteAtomically(directory_fd, name.c_str(),
+                                     fml::DataMapping(contents)));
+      asset_names_.push_back(directory + "/" + name);
+    }
+
+    AssetPackBuilder builder;
+    FML_CHECK(builder.AddDirectory(assets_dir_.fd()));
+    auto pack = builder.Build();
+    FML_CHECK(pack);
+    FML_CHECK(fml::WriteAtomically(pack_dir_.fd(), "assets.pack", *pack));
+  }
+
+  std::unique_ptr<AssetResolver> OpenDirectoryAssetBundle() {
+    return std::make_unique<DirectoryAssetBundle>(
+        fml::OpenDirectory(assets_dir_.path().c_str(), false,
+                           fml::FilePermission::kRead),
+        false);
+  }
+
+  std::unique_ptr<AssetResolver> OpenPackedAssetBundle() {
+    return std::make_unique<PackedAssetBundle>(
+        fml::OpenFile(pack_dir_.fd(), "assets.pack", false,
+                      fml::FilePermission::kRead),
+        false);
+  }
+
+  const std::vector<std::string>& asset_names() const { return asset_names_; }
+
+ private:
+  fml::ScopedTemporaryDirectory assets_dir_;
+  fml::ScopedTemporaryDirectory pack_dir_;
+  std::vector<std::string> asset_names_;
+};
+
+// Opens the bundle and resolves every asset, reading the first byte of each
+// like the first use of an asset would.
+template <class OpenBundle>
+void ResolveAllAssets(benchmark::State& state,
+                      const AssetsFixture& fixture,
+                      OpenBundle open_bundle) {
+  while (state.KeepRunning()) {
+    std::unique_ptr<AssetResolver> bundle = open_bundle();
+    for (const auto& name : fixture.asset_names()) {
+      auto mapping = bundle->GetAsMapping(name);
+      benchmark::DoNotOptimize(mapping->GetMapping()[0]);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * fixture.asset_names().size());
+}
+
+template <class OpenBundle>
+void MatchAssets(benchmark::State& state,
+                 const AssetsFixture& fixture,
+                 OpenBundle open_bundle) {
+  std::unique_ptr<AssetResolver> bundle = open_bundle();
+  while (state.KeepRunning()) {
+    auto mappings = bundle->GetAsMappings(".*_1[0-9]*\\.png", std::nullopt);
+    benchmark::DoNotOptimize(mappings.data());
+  }
+}
+
+}  // namespace
+
+static void BM_DirectoryAssetBundleStartup(benchmark::State& state) {
+  AssetsFixture fixture(state.range(0));
+  ResolveAllAssets(state, fixture,
+                   [&fixture] { return fixture.OpenDirectoryAssetBundle(); });
+}
+BENCHMARK(BM_DirectoryAssetBundleStartup)->Arg(50)->Arg(300);
+
+static void BM_PackedAssetBundleStartup(benchmark::State& state) {
+  AssetsFixture fixture(state.range(0));
+  ResolveAllAssets(state, fixture,
+                   [&fixture] { return fixture.OpenPackedAssetBundle(); });
+}
+BENCHMARK(BM_PackedAssetBundleStartup)->Arg(50)->Arg(300);
+
+static void BM_DirectoryAssetBundleGetAsMappings(benchmark::State& state) {
+  AssetsFixture fixture(300);
+  MatchAssets(state, fixture,
+              [&fixture] { return fixture.OpenDirectoryAssetBundle(); });
+}
+BENCHMARK(BM_DirectoryAssetBundleGetAsMappings);
+
+static void BM_PackedAssetBundleGetAsMappings(benchmark::State& state) {
+  AssetsFixture fixture(300);
+  MatchAssets(state, fixture,
+              [&fixture] { return fixture.OpenPackedAssetBundle(); });
+}
+BENCHMARK(BM_PackedAssetBundleGetAsMappings);
+
+}  // namespace flutter
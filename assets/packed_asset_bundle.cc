@@ -0,0 +1,173 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/assets/packed_asset_bundle.h"
+
+#include <cstring>
+#include <regex>
+#include <string_view>
+#include <utility>
+
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+PackedAssetBundle::PackedAssetBundle(const fml::UniqueFD& pack_file,
+                                     bool is_valid_after_asset_manager_change)
+    : PackedAssetBundle(std::make_shared<fml::FileMapping>(pack_file),
+                        is_valid_after_asset_manager_change) {}
+
+PackedAssetBundle::PackedAssetBundle(std::shared_ptr<const fml::Mapping> pack,
+                                     bool is_valid_after_asset_manager_change)
+    : pack_(std::move(pack)) {
+  if (!pack_ || pack_->GetMapping() == nullptr ||
+      pack_->GetSize() < sizeof(AssetPackHeader)) {
+    return;
+  }
+  const uint8_t* base = pack_->GetMapping();
+  const uint64_t size = pack_->GetSize();
+
+  AssetPackHeader header;
+  std::memcpy(&header, base, sizeof(header));
+  if (std::memcmp(header.magic, kAssetPackMagic, sizeof(header.magic)) != 0 ||
+      header.version != kAssetPackVersion) {
+    FML_LOG(ERROR) << "Not a supported asset pack.";
+    return;
+  }
+  if (header.index_size > size) {
+    FML_LOG(ERROR) << "The asset pack is truncated or corrupt.";
+    return;
+  }
+  const uint64_t names_offset =
+      sizeof(AssetPackHeader) +
+      header.entry_count * (sizeof(AssetPackEntry) + sizeof(int32_t));
+  const uint64_t index_end = sizeof(AssetPackHeader) + header.index_size;
+  if (index_end < names_offset || header.data_offset < index_end ||
+      header.data_offset > size) {
+    FML_LOG(ERROR) << "The asset pack is truncated or corrupt.";
+    return;
+  }
+
+  entries_ = reinterpret_cast<const AssetPackEntry*>(
+      base + sizeof(AssetPackHeader));
+  displacements_ = reinterpret_cast<const int32_t*>(
+      base + sizeof(AssetPackHeader) +
+      header.entry_count * sizeof(AssetPackEntry));
+  names_ = reinterpret_cast<const char*>(base + names_offset);
+  data_ = base + header.data_offset;
+  entry_count_ = header.entry_count;
+
+  // Validate every entry once so that lookups can trust the index.
+  const uint64_t names_size = index_end - names_offset;
+  const uint64_t data_size = size - header.data_offset;
+  for (uint32_t i = 0; i < entry_count_; ++i) {
+    const AssetPackEntry& entry = entries_[i];
+    if (uint64_t{entry.name_offset} + entry.name_size > names_size ||
+        entry.data_offset > data_size ||
+        entry.data_size > data_size - entry.data_offset) {
+      FML_LOG(ERROR) << "The asset pack is truncated or corrupt.";
+      return;
+    }
+    // A negative displacement is the index of the only entry in its bucket.
+    const int32_t displacement = displacements_[i];
+    if (displacement < 0 &&
+        -(int64_t{displacement} + 1) >= int64_t{entry_count_}) {
+      FML_LOG(ERROR) << "The asset pack is truncated or corrupt.";
+      return;
+    }
+  }
+
+  is_valid_after_asset_manager_change_ = is_valid_after_asset_manager_change;
+  is_valid_ = true;
+}
+
+PackedAssetBundle::~PackedAssetBundle() = default;
+
+// |AssetResolver|
+bool PackedAssetBundle::IsValid() const {
+  return is_valid_;
+}
+
+// |AssetResolver|
+bool PackedAssetBundle::IsValidAfterAssetManagerChange() const {
+  return is_valid_after_asset_manager_change_;
+}
+
+// |AssetResolver|
+AssetResolver::AssetResolverType PackedAssetBundle::GetType() const {
+  return AssetResolver::AssetResolverType::kPackedAssetBundle;
+}
+
+std::unique_ptr<fml::Mapping> PackedAssetBundle::GetEntryMapping(
+    const AssetPackEntry& entry) const {
+  // The slice holds a reference to the pack, which may outlive this bundle.
+  return std::make_unique<fml::NonOwnedMapping>(
+      data_ + entry.data_offset, entry.data_size,
+      [pack = pack_](const uint8_t* data, size_t size) {});
+}
+
+// |AssetResolver|
+std::unique_ptr<fml::Mapping> PackedAssetBundle::GetAsMapping(
+    const std::string& asset_name) const {
+  if (!is_valid_) {
+    FML_DLOG(WARNING) << "Asset bundle was not valid.";
+    return nullptr;
+  }
+  if (entry_count_ == 0) {
+    return nullptr;
+  }
+
+  const AssetPackEntry& entry =
+      entries_[AssetPackFindEntry(displacements_, entry_count_, asset_name)];
+  if (asset_name != std::string_view(names_ + entry.name_offset,
+                                     entry.name_size)) {
+    return nullptr;
+  }
+  return GetEntryMapping(entry);
+}
+
+// |AssetResolver|
+std::vector<std::unique_ptr<fml::Mapping>> PackedAssetBundle::GetAsMappings(
+    const std::string& asset_pattern,
+    const std::optional<std::string>& subdir) const {
+  TRACE_EVENT0("flutter", "PackedAssetBundle::GetAsMappings");
+  std::vector<std::unique_ptr<fml::Mapping>> mappings;
+  if (!is_valid_) {
+    FML_DLOG(WARNING) << "Asset bundle was not valid.";
+    return mappings;
+  }
+
+  // Like DirectoryAssetBundle, match the file names of the assets, either
+  // directly within |subdir| or anywhere in the pack.
+  std::string_view directory;
+  if (subdir) {
+    directory = subdir.value();
+    while (!directory.empty() && directory.back() == '/') {
+      directory.remove_suffix(1);
+    }
+  }
+  std::regex asset_regex(asset_pattern);
+  for (uint32_t i = 0; i < entry_count_; ++i) {
+    const AssetPackEntry& entry = entries_[i];
+    std::string_view name(names_ + entry.name_offset, entry.name_size);
+    const size_t separator = name.rfind('/');
+    const std::string_view filename =
+        separator == std::string_view::npos ? name : name.substr(separator + 1);
+    if (subdir) {
+      const std::string_view parent = separator == std::string_view::npos
+                                          ? std::string_view()
+                                          : name.substr(0, separator);
+      if (parent != directory) {
+        continue;
+      }
+    }
+    if (std::regex_match(filename.begin(), filename.end(), asset_regex)) {
+      mappings.push_back(GetEntryMapping(entry));
+    }
+  }
+  return mappings;
+}
+
+}  // namespace flutter
@@ -0,0 +1,70 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_ASSETS_PACKED_ASSET_BUNDLE_H_
+#define FLUTTER_ASSETS_PACKED_ASSET_BUNDLE_H_
+
+#include <memory>
+#include <optional>
+
+#include "flutter/assets/asset_pack.h"
+#include "flutter/assets/asset_resolver.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/unique_fd.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// An asset resolver that serves assets from an asset pack (see
+/// `asset_pack.h`). The pack is mapped once, and assets are returned as slices
+/// of that mapping that keep it alive, so resolving an asset neither opens a
+/// file nor copies its contents.
+///
+class PackedAssetBundle : public AssetResolver {
+ public:
+  PackedAssetBundle(const fml::UniqueFD& pack_file,
+                    bool is_valid_after_asset_manager_change);
+
+  PackedAssetBundle(std::shared_ptr<const fml::Mapping> pack,
+                    bool is_valid_after_asset_manager_change);
+
+  ~PackedAssetBundle() override;
+
+ private:
+  std::shared_ptr<const fml::Mapping> pack_;
+  const AssetPackEntry* entries_ = nullptr;
+  const int32_t* displacements_ = nullptr;
+  const char* names_ = nullptr;
+  const uint8_t* data_ = nullptr;
+  uint32_t entry_count_ = 0;
+  bool is_valid_ = false;
+  bool is_valid_after_asset_manager_change_ = false;
+
+  std::unique_ptr<fml::Mapping> GetEntryMapping(
+      const AssetPackEntry& entry) const;
+
+  // |AssetResolver|
+  bool IsValid() const override;
+
+  // |AssetResolver|
+  bool IsValidAfterAssetManagerChange() const override;
+
+  // |AssetResolver|
+  AssetResolver::AssetResolverType GetType() const override;
+
+  // |AssetResolver|
+  std::unique_ptr<fml::Mapping> GetAsMapping(
+      const std::string& asset_name) const override;
+
+  // |AssetResolver|
+  std::vector<std::unique_ptr<fml::Mapping>> GetAsMappings(
+      const std::string& asset_pattern,
+      const std::optional<std::string>& subdir) const override;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(PackedAssetBundle);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_ASSETS_PACKED_ASSET_BUNDLE_H_
@@ -0,0 +1,212 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/assets/packed_asset_bundle.h"
+
+#include <cstring>
+#include <limits>
+#include <string>
+
+#include "flutter/assets/asset_pack.h"
+#include "flutter/fml/file.h"
+#include "flutter/fml/mapping.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+std::unique_ptr<fml::Mapping> MakeMapping(const std::string& contents) {
+  return std::make_unique<fml::DataMapping>(contents);
+}
+
+std::string ToString(const fml::Mapping& mapping) {
+  return std::string(reinterpret_cast<const char*>(mapping.GetMapping()),
+                     mapping.GetSize());
+}
+
+std::shared_ptr<const fml::Mapping> BuildPack(AssetPackBuilder& builder) {
+  std::shared_ptr<const fml::Mapping> pack = builder.Build();
+  EXPECT_NE(pack, nullptr);
+  return pack;
+}
+
+bool IsValidPack(std::vector<uint8_t> bytes) {
+  std::unique_ptr<AssetResolver> bundle = std::make_unique<PackedAssetBundle>(
+      std::make_shared<fml::DataMapping>(std::move(bytes)), false);
+  return bundle->IsValid();
+}
+
+}  // namespace
+
+TEST(PackedAssetBundleTest, ResolvesEveryAsset) {
+  AssetPackBuilder builder;
+  for (int i = 0; i < 500; ++i) {
+    ASSERT_TRUE(builder.AddAsset("assets/image_" + std::to_string(i) + ".png",
+                                 MakeMapping("image " + std::to_string(i))));
+  }
+  ASSERT_TRUE(builder.AddAsset("AssetManifest.json", MakeMapping("{}")));
+  std::unique_ptr<AssetResolver> bundle =
+      std::make_unique<PackedAssetBundle>(BuildPack(builder), false);
+  ASSERT_TRUE(bundle->IsValid());
+  EXPECT_EQ(bundle->GetType(),
+            AssetResolver::AssetResolverType::kPackedAssetBundle);
+
+  for (int i = 0; i < 500; ++i) {
+    auto mapping =
+        bundle->GetAsMapping("assets/image_" + std::to_string(i) + ".png");
+    ASSERT_NE(mapping, nullptr);
+    EXPECT_EQ(ToString(*mapping), "image " + std::to_string(i));
+  }
+  auto manifest = bundle->GetAsMapping("AssetManifest.json");
+  ASSERT_NE(manifest, nullptr);
+  EXPECT_EQ(ToString(*manifest), "{}");
+
+  EXPECT_EQ(bundle->GetAsMapping("assets/image_500.png"), nullptr);
+  EXPECT_EQ(bundle->GetAsMapping("image_1.png"), nullptr);
+  EXPECT_EQ(bundle->GetAsMapping(""), nullptr);
+}
+
+TEST(PackedAssetBundleTest, RejectsDuplicateAssets) {
+  AssetPackBuilder builder;
+  ASSERT_TRUE(builder.AddAsset("a", MakeMapping("1")));
+  EXPECT_FALSE(builder.AddAsset("a", MakeMapping("2")));
+}
+
+TEST(PackedAssetBundleTest, EmptyPackIsValid) {
+  AssetPackBuilder builder;
+  std::unique_ptr<AssetResolver> bundle =
+      std::make_unique<PackedAssetBundle>(BuildPack(builder), true);
+  ASSERT_TRUE(bundle->IsValid());
+  EXPECT_TRUE(bundle->IsValidAfterAssetManagerChange());
+  EXPECT_EQ(bundle->GetAsMapping("a"), nullptr);
+  EXPECT_TRUE(bundle->GetAsMappings(".*", std::nullopt).empty());
+}
+
+TEST(PackedAssetBundleTest, RejectsCorruptPacks) {
+  AssetPackBuilder builder;
+  ASSERT_TRUE(builder.AddAsset("a", MakeMapping("1")));
+  auto pack = builder.Build();
+  ASSERT_NE(pack, nullptr);
+
+  std::vector<uint8_t> bytes(pack->GetMapping(),
+                             pack->GetMapping() + pack->GetSize());
+  EXPECT_TRUE(IsValidPack(bytes));
+
+  std::vector<uint8_t> truncated(bytes.begin(), bytes.begin() + 40);
+  EXPECT_FALSE(IsValidPack(truncated));
+
+  std::vector<uint8_t> bad_magic = bytes;
+  bad_magic[0] = 'X';
+  EXPECT_FALSE(IsValidPack(bad_magic));
+
+  EXPECT_FALSE(IsValidPack({'F', 'L', 'T'}));
+
+  // The displacement of the only entry must not refer past the entries.
+  const size_t displacement_offset =
+      sizeof(AssetPackHeader) + sizeof(AssetPackEntry);
+  for (int32_t displacement : {-2, std::numeric_limits<int32_t>::min()}) {
+    std::vector<uint8_t> bad_displacement = bytes;
+    std::memcpy(bad_displacement.data() + displacement_offset, &displacement,
+                sizeof(displacement));
+    EXPECT_FALSE(IsValidPack(bad_displacement));
+  }
+  std::vector<uint8_t> direct_displacement = bytes;
+  const int32_t first_entry = -1;
+  std::memcpy(direct_displacement.data() + displacement_offset, &first_entry,
+              sizeof(first_entry));
+  EXPECT_TRUE(IsValidPack(direct_displacement));
+
+  std::unique_ptr<AssetResolver> missing_file =
+      std::make_unique<PackedAssetBundle>(fml::UniqueFD(), false);
+  EXPECT_FALSE(missing_file->IsValid());
+}
+
+TEST(PackedAssetBundleTest, AlignsLargeAssetsToPages) {
+  AssetPackBuilder builder;
+  ASSERT_TRUE(builder.AddAsset("small", MakeMapping("s")));
+  ASSERT_TRUE(builder.AddAsset(
+      "large", MakeMapping(std::string(kAssetPackPageSize + 1, 'l'))));
+  ASSERT_TRUE(builder.AddAsset("empty", MakeMapping("")));
+  auto pack = BuildPack(builder);
+  std::unique_ptr<AssetResolver> bundle =
+      std::make_unique<PackedAssetBundle>(pack, false);
+  ASSERT_TRUE(bundle->IsValid());
+
+  auto large = bundle->GetAsMapping("large");
+  ASSERT_NE(large, nullptr);
+  EXPECT_EQ(large->GetSize(), kAssetPackPageSize + 1);
+  EXPECT_EQ((large->GetMapping() - pack->GetMapping()) % kAssetPackPageSize,
+            0u);
+  auto empty = bundle->GetAsMapping("empty");
+  ASSERT_NE(empty, nullptr);
+  EXPECT_EQ(empty->GetSize(), 0u);
+}
+
+TEST(PackedAssetBundleTest, MappingsOutliveBundle) {
+  AssetPackBuilder builder;
+  ASSERT_TRUE(builder.AddAsset("a", MakeMapping("contents")));
+  std::unique_ptr<fml::Mapping> mapping;
+  {
+    std::unique_ptr<AssetResolver> bundle =
+        std::make_unique<PackedAssetBundle>(builder.Build(), false);
+    mapping = bundle->GetAsMapping("a");
+  }
+  ASSERT_NE(mapping, nullptr);
+  EXPECT_EQ(ToString(*mapping), "contents");
+}
+
+TEST(PackedAssetBundleTest, MatchesFileNamesLikeDirectoryAssetBundle) {
+  AssetPackBuilder builder;
+  ASSERT_TRUE(builder.AddAsset("shaders/a.sksl", MakeMapping("a")));
+  ASSERT_TRUE(builder.AddAsset("shaders/b.sksl", MakeMapping("b")));
+  ASSERT_TRUE(builder.AddAsset("shaders/nested/c.sksl", MakeMapping("c")));
+  ASSERT_TRUE(builder.AddAsset("d.sksl", MakeMapping("d")));
+  ASSERT_TRUE(builder.AddAsset("shaders/e.txt", MakeMapping("e")));
+  std::unique_ptr<AssetResolver> bundle =
+      std::make_unique<PackedAssetBundle>(BuildPack(builder), false);
+  ASSERT_TRUE(bundle->IsValid());
+
+  EXPECT_EQ(bundle->GetAsMappings(".*\\.sksl", std::nullopt).size(), 4u);
+  EXPECT_EQ(bundle->GetAsMappings(".*\\.sksl", "shaders").size(), 2u);
+  EXPECT_EQ(bundle->GetAsMappings(".*\\.sksl", "shaders/").size(), 2u);
+  EXPECT_EQ(bundle->GetAsMappings(".*", "shaders/nested").size(), 1u);
+  EXPECT_TRUE(bundle->GetAsMappings(".*", "missing").empty());
+  // The pattern is matched against file names, not paths.
+  EXPECT_TRUE(bundle->GetAsMappings("shaders/.*", std::nullopt).empty());
+}
+
+TEST(PackedAssetBundleTest, CanBuildFromDirectory) {
+  fml::ScopedTemporaryDirectory assets_dir;
+  auto subdir = fml::CreateDirectory(assets_dir.fd(), {"fonts"},
+                                     fml::FilePermission::kReadWrite);
+  ASSERT_TRUE(fml::WriteAtomically(assets_dir.fd(), "AssetManifest.json",
+                                   fml::DataMapping("{}")));
+  ASSERT_TRUE(fml::WriteAtomically(subdir, "Roboto.ttf",
+                                   fml::DataMapping("font")));
+
+  AssetPackBuilder builder;
+  ASSERT_TRUE(builder.AddDirectory(assets_dir.fd()));
+  auto pack = builder.Build();
+  ASSERT_NE(pack, nullptr);
+
+  fml::ScopedTemporaryDirectory pack_dir;
+  ASSERT_TRUE(fml::WriteAtomically(pack_dir.fd(), "assets.pack", *pack));
+  std::unique_ptr<AssetResolver> bundle = std::make_unique<PackedAssetBundle>(
+      fml::OpenFile(pack_dir.fd(), "assets.pack", false,
+                    fml::FilePermission::kRead),
+      false);
+  ASSERT_TRUE(bundle->IsValid());
+
+  auto manifest = bundle->GetAsMapping("AssetManifest.json");
+  ASSERT_NE(manifest, nullptr);
+  EXPECT_EQ(ToString(*manifest), "{}");
+  auto font = bundle->GetAsMapping("fonts/Roboto.ttf");
+  ASSERT_NE(font, nullptr);
+  EXPECT_EQ(ToString(*font), "font");
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -4,6 +4,7 @@
 
 #include "flutter/common/graphics/persistent_cache.h"
 
+#include <algorithm>
 #include <future>
 #include <memory>
 #include <string>
@@ -51,6 +52,8 @@ bool PersistentCache::gIsReadOnly = false;
 
 std::atomic<bool> PersistentCache::cache_sksl_ = false;
 std::atomic<bool> PersistentCache::strategy_set_ = false;
+std::atomic<bool> PersistentCache::staged_sksl_warm_up_ = false;
+std::atomic<bool> PersistentCache::cache_raster_images_ = false;
 
 void PersistentCache::SetCacheSkSL(bool value) {
   if (strategy_set_ && value != cache_sksl_) {
@@ -133,7 +136,7 @@ static void FreeOldCacheDirectory(const fml::UniqueFD& cache_base_dir) {
 static std::shared_ptr<fml::UniqueFD> MakeCacheDirectory(
     const std::string& global_cache_base_path,
     bool read_only,
-    bool cache_sksl) {
+    const char* subdir_name) {
   fml::UniqueFD cache_base_dir;
   if (global_cache_base_path.length()) {
     cache_base_dir = fml::OpenDirectory(global_cache_base_path.c_str(), false,
@@ -146,8 +149,8 @@ static std::shared_ptr<fml::UniqueFD> MakeCacheDirectory(
     FreeOldCacheDirectory(cache_base_dir);
     std::vector<std::string> components = {
         kEngineComponent, GetFlutterEngineVersion(), "skia", GetSkiaVersion()};
-    if (cache_sksl) {
-      components.push_back(PersistentCache::kSkSLSubdirName);
+    if (subdir_name) {
+      components.push_back(subdir_name);
     }
     return std::make_shared<fml::UniqueFD>(
         CreateDirectory(cache_base_dir, components,
@@ -193,8 +196,13 @@ sk_sp<SkData> ParseBase64(const std::string& input) {
 }
 
 size_t PersistentCache::PrecompileKnownSkSLs(GrDirectContext* context) const {
-  auto known_sksls = LoadSkSLs();
   // A trace must be present even if no precompilations have been completed.
+  if (staged_sksl_warm_up_) {
+    FML_TRACE_EVENT("flutter", "PersistentCache::PrecompileKnownSkSLs",
+                    "count", size_t{0});
+    return 0;
+  }
+  auto known_sksls = LoadSkSLs();
   FML_TRACE_EVENT("flutter", "PersistentCache::PrecompileKnownSkSLs", "count",
                   known_sksls.size());
 
@@ -219,31 +227,14 @@ size_t PersistentCache::PrecompileKnownSkSLs(GrDirectContext* context) const {
 std::vector<PersistentCache::SkSLCache> PersistentCache::LoadSkSLs() const {
   TRACE_EVENT0("flutter", "PersistentCache::LoadSkSLs");
   std::vector<PersistentCache::SkSLCache> result;
-  fml::FileVisitor visitor = [&result](const fml::UniqueFD& directory,
-                                       const std::string& filename) {
-    sk_sp<SkData> key = ParseBase32(filename);
-    sk_sp<SkData> data = LoadFile(directory, filename);
-    if (key != nullptr && data != nullptr) {
-      result.push_back({key, data});
-    } else {
-      FML_LOG(ERROR) << "Failed to load: " << filename;
-    }
+  VisitSkSLs([&result](SkSLCache sksl) {
+    result.push_back(std::move(sksl));
     return true;
-  };
-
-  // Only visit sksl_cache_directory_ if this persistent cache is valid.
-  // However, we'd like to continue visit the asset dir even if this persistent
-  // cache is invalid.
-  if (IsValid()) {
-    // In case `rewinddir` doesn't work reliably, load SkSLs from a freshly
-    // opened directory (https://github.com/flutter/flutter/issues/65258).
-    fml::UniqueFD fresh_dir =
-        fml::OpenDirectoryReadOnly(*cache_directory_, kSkSLSubdirName);
-    if (fresh_dir.is_valid()) {
-      fml::VisitFiles(fresh_dir, visitor);
-    }
-  }
+  });
+  return result;
+}
 
+void PersistentCache::VisitSkSLs(const SkSLVisitor& visitor) const {
   std::unique_ptr<fml::Mapping> mapping = nullptr;
   if (asset_manager_ != nullptr) {
     mapping = asset_manager_->GetAsMapping(kAssetFileName);
@@ -263,7 +254,9 @@ std::vector<PersistentCache::SkSLCache> PersistentCache::LoadSkSLs() const {
         sk_sp<SkData> key = ParseBase32(item.name.GetString());
         sk_sp<SkData> sksl = ParseBase64(item.value.GetString());
         if (key != nullptr && sksl != nullptr) {
-          result.push_back({key, sksl});
+          if (!visitor({key, sksl})) {
+            return;
+          }
         } else {
           FML_LOG(ERROR) << "Failed to load: " << item.name.GetString();
         }
@@ -271,14 +264,43 @@ std::vector<PersistentCache::SkSLCache> PersistentCache::LoadSkSLs() const {
     }
   }
 
-  return result;
+  // Only visit sksl_cache_directory_ if this persistent cache is valid.
+  // However, we'd like to continue visit the asset dir even if this persistent
+  // cache is invalid.
+  if (!IsValid()) {
+    return;
+  }
+  // In case `rewinddir` doesn't work reliably, load SkSLs from a freshly
+  // opened directory (https://github.com/flutter/flutter/issues/65258).
+  fml::UniqueFD fresh_dir =
+      fml::OpenDirectoryReadOnly(*cache_directory_, kSkSLSubdirName);
+  if (!fresh_dir.is_valid()) {
+    return;
+  }
+  fml::VisitFiles(fresh_dir, [&visitor](const fml::UniqueFD& directory,
+                                        const std::string& filename) {
+    sk_sp<SkData> key = ParseBase32(filename);
+    sk_sp<SkData> data = LoadFile(directory, filename);
+    if (key != nullptr && data != nullptr) {
+      return visitor({key, data});
+    }
+    FML_LOG(ERROR) << "Failed to load: " << filename;
+    return true;
+  });
 }
 
 PersistentCache::PersistentCache(bool read_only)
     : is_read_only_(read_only),
-      cache_directory_(MakeCacheDirectory(cache_base_path_, read_only, false)),
+      cache_directory_(
+          MakeCacheDirectory(cache_base_path_, read_only, nullptr)),
       sksl_cache_directory_(
-          MakeCacheDirectory(cache_base_path_, read_only, true)) {
+          MakeCacheDirectory(cache_base_path_, read_only, kSkSLSubdirName)),
+      raster_cache_directory_(
+          cache_raster_images_
+              ? MakeCacheDirectory(cache_base_path_,
+                                   read_only,
+                                   kRasterCacheSubdirName)
+              : std::make_shared<fml::UniqueFD>()) {
   if (!IsValid()) {
     FML_LOG(WARNING) << "Could not acquire the persistent cache directory. "
                         "Caching of GPU resources on disk is disabled.";
@@ -379,6 +401,124 @@ void PersistentCache::store(const SkData& key, const SkData& data) {
                        std::move(file_name), std::move(mapping));
 }
 
+std::vector<PersistentCache::RasterCacheImageInfo>
+PersistentCache::ListRasterCacheImages() const {
+  TRACE_EVENT0("flutter", "PersistentCache::ListRasterCacheImages");
+  std::vector<RasterCacheImageInfo> result;
+  if (!IsValid() || !raster_cache_directory_->is_valid()) {
+    return result;
+  }
+  auto visitor = [&result](const fml::UniqueFD& directory,
+                           const std::string& filename) {
+    sk_sp<SkData> key = ParseBase32(filename);
+    size_t size = 0;
+    if (key != nullptr &&
+        fml::GetFileSize(fml::OpenFileReadOnly(directory, filename.c_str()),
+                         &size) &&
+        size != 0) {
+      result.push_back({key, size});
+    } else {
+      FML_LOG(ERROR) << "Failed to load: " << filename;
+    }
+    return true;
+  };
+  // As with the SkSLs, list the images from a freshly opened directory in
+  // case `rewinddir` doesn't work reliably.
+  fml::UniqueFD fresh_dir =
+      fml::OpenDirectoryReadOnly(*cache_directory_, kRasterCacheSubdirName);
+  if (fresh_dir.is_valid()) {
+    fml::VisitFiles(fresh_dir, visitor);
+  }
+  return result;
+}
+
+sk_sp<SkData> PersistentCache::LoadRasterCacheImage(const SkData& key) const {
+  TRACE_EVENT0("flutter", "PersistentCache::LoadRasterCacheImage");
+  if (!IsValid() || !raster_cache_directory_->is_valid()) {
+    return nullptr;
+  }
+  auto file_name = SkKeyToFilePath(key);
+  if (file_name.size() == 0) {
+    return nullptr;
+  }
+  return LoadFile(*raster_cache_directory_, file_name);
+}
+
+bool PersistentCache::StoreRasterCacheImage(const SkData& key,
+                                            const SkData& image) {
+  TRACE_EVENT0("flutter", "PersistentCache::StoreRasterCacheImage");
+  if (is_read_only_ || !IsValid() || !raster_cache_directory_->is_valid()) {
+    return false;
+  }
+
+  auto file_name = SkKeyToFilePath(key);
+  if (file_name.size() == 0 || image.size() == 0) {
+    return false;
+  }
+
+  fml::NonOwnedMapping mapping(image.bytes(), image.size());
+  if (!fml::WriteAtomically(*raster_cache_directory_, file_name.c_str(),
+                            mapping)) {
+    FML_LOG(WARNING) << "Could not write raster cache image: " << file_name;
+    return false;
+  }
+  return true;
+}
+
+void PersistentCache::RemoveRasterCacheImage(const SkData& key) {
+  if (is_read_only_ || !IsValid() || !raster_cache_directory_->is_valid()) {
+    return;
+  }
+
+  auto file_name = SkKeyToFilePath(key);
+  if (file_name.size() == 0) {
+    return;
+  }
+
+  fml::UnlinkFile(*raster_cache_directory_, file_name.c_str());
+}
+
+std::vector<std::string> PersistentCache::LoadAssetAccessTrace() const {
+  TRACE_EVENT0("flutter", "PersistentCache::LoadAssetAccessTrace");
+  std::vector<std::string> result;
+  if (!IsValid()) {
+    return result;
+  }
+  sk_sp<SkData> data = LoadFile(*cache_directory_, kAssetAccessTraceFileName);
+  if (data == nullptr) {
+    return result;
+  }
+  // One asset name per line.
+  std::string_view names(static_cast<const char*>(data->data()), data->size());
+  while (!names.empty()) {
+    size_t end = names.find('\n');
+    if (end == std::string_view::npos) {
+      end = names.size();
+    }
+    if (end > 0) {
+      result.emplace_back(names.substr(0, end));
+    }
+    names.remove_prefix(std::min(end + 1, names.size()));
+  }
+  return result;
+}
+
+void PersistentCache::StoreAssetAccessTrace(
+    const std::vector<std::string>& asset_names) {
+  if (is_read_only_ || !IsValid()) {
+    return;
+  }
+
+  std::string names;
+  for (const auto& asset_name : asset_names) {
+    names += asset_name;
+    names += '\n';
+  }
+  PersistentCacheStore(GetWorkerTaskRunner(), cache_directory_,
+                       kAssetAccessTraceFileName,
+                       std::make_unique<fml::DataMapping>(names));
+}
+
 void PersistentCache::DumpSkp(const SkData& data) {
   if (is_read_only_ || !IsValid()) {
     FML_LOG(ERROR) << "Could not dump SKP from read-only or invalid persistent "
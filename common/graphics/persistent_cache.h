@@ -5,6 +5,7 @@
 #ifndef FLUTTER_COMMON_GRAPHICS_PERSISTENT_CACHE_H_
 #define FLUTTER_COMMON_GRAPHICS_PERSISTENT_CACHE_H_
 
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <set>
@@ -74,6 +75,15 @@ class PersistentCache : public GrContextOptions::PersistentCache {
   /// Load all the SkSL shader caches in the right directory.
   std::vector<SkSLCache> LoadSkSLs() const;
 
+  /// Called with each SkSL as it is loaded. Loading stops once this returns
+  /// false.
+  using SkSLVisitor = std::function<bool(SkSLCache sksl)>;
+
+  /// Load the SkSLs one by one, in the order they should be precompiled in:
+  /// first the SkSLs bundled with the application, in the order they were
+  /// captured, then the SkSLs cached by previous runs.
+  void VisitSkSLs(const SkSLVisitor& visitor) const;
+
   //----------------------------------------------------------------------------
   /// @brief      Precompile SkSLs packaged with the application and gathered
   ///             during previous runs in the given context.
@@ -85,10 +95,42 @@ class PersistentCache : public GrContextOptions::PersistentCache {
   ///
   /// @param      context  The rendering context to precompile shaders in.
   ///
-  /// @return     The number of SkSLs precompiled.
+  /// @return     The number of SkSLs precompiled. This is 0 if staged SkSL
+  ///             warm-up is enabled, in which case the rasterizer precompiles
+  ///             the SkSLs in the background instead.
   ///
   size_t PrecompileKnownSkSLs(GrDirectContext* context) const;
 
+  /// The key of an encoded raster cache image and its size in bytes.
+  using RasterCacheImageInfo = std::pair<sk_sp<SkData>, size_t>;
+
+  /// List the encoded images stored by the raster cache in previous runs
+  /// without loading them.
+  std::vector<RasterCacheImageInfo> ListRasterCacheImages() const;
+
+  /// Load the encoded raster cache image stored with the given key, or return
+  /// nullptr if there is none.
+  sk_sp<SkData> LoadRasterCacheImage(const SkData& key) const;
+
+  /// Store an encoded raster cache image. The file is written on the calling
+  /// thread, so that the caller can order it with |RemoveRasterCacheImage|.
+  ///
+  /// @return     Whether the image was written.
+  ///
+  bool StoreRasterCacheImage(const SkData& key, const SkData& image);
+
+  /// Remove the encoded raster cache image stored with the given key. The file
+  /// is removed on the calling thread.
+  void RemoveRasterCacheImage(const SkData& key);
+
+  /// Load the names of the assets that were accessed early in a previous run,
+  /// as stored by |StoreAssetAccessTrace|.
+  std::vector<std::string> LoadAssetAccessTrace() const;
+
+  /// Store the names of the assets accessed early in this run, so that the
+  /// next run can prefetch them. The file is written on a worker task runner.
+  void StoreAssetAccessTrace(const std::vector<std::string>& asset_names);
+
   // Return mappings for all skp's accessible through the AssetManager
   std::vector<std::unique_ptr<fml::Mapping>> GetSkpsFromAssetManager() const;
 
@@ -100,10 +142,25 @@ class PersistentCache : public GrContextOptions::PersistentCache {
 
   static void SetCacheSkSL(bool value);
 
+  static bool staged_sksl_warm_up() { return staged_sksl_warm_up_; }
+
+  static void SetStagedSkSLWarmUp(bool value) { staged_sksl_warm_up_ = value; }
+
+  static bool cache_raster_images() { return cache_raster_images_; }
+
+  /// Whether the raster cache stores images on disk. Must be set before
+  /// GetCacheForProcess is called for the raster cache directory to be
+  /// created.
+  static void SetCacheRasterImages(bool value) {
+    cache_raster_images_ = value;
+  }
+
   static void MarkStrategySet() { strategy_set_ = true; }
 
   static constexpr char kSkSLSubdirName[] = "sksl";
+  static constexpr char kRasterCacheSubdirName[] = "raster_cache";
   static constexpr char kAssetFileName[] = "io.flutter.shaders.json";
+  static constexpr char kAssetAccessTraceFileName[] = "asset_access_trace";
 
  private:
   static std::string cache_base_path_;
@@ -123,9 +180,18 @@ class PersistentCache : public GrContextOptions::PersistentCache {
   // strategy_set_ becomes true.
   static std::atomic<bool> strategy_set_;
 
+  // Whether |PrecompileKnownSkSLs| leaves precompilation to the staged SkSL
+  // warm-up of the rasterizer.
+  static std::atomic<bool> staged_sksl_warm_up_;
+
+  // Whether the "raster_cache" directory is created and used for the images
+  // of the raster cache.
+  static std::atomic<bool> cache_raster_images_;
+
   const bool is_read_only_;
   const std::shared_ptr<fml::UniqueFD> cache_directory_;
   const std::shared_ptr<fml::UniqueFD> sksl_cache_directory_;
+  const std::shared_ptr<fml::UniqueFD> raster_cache_directory_;
   mutable std::mutex worker_task_runners_mutex_;
   std::multiset<fml::RefPtr<fml::TaskRunner>> worker_task_runners_;
 
@@ -62,6 +62,14 @@ std::string Settings::ToString() const {
   stream << "frame_rasterized_callback set: " << !!frame_rasterized_callback
          << std::endl;
   stream << "old_gen_heap_size: " << old_gen_heap_size << std::endl;
+  stream << "raster_cache_max_retained_bytes: "
+         << raster_cache_max_retained_bytes << std::endl;
+  stream << "raster_cache_async_rasterization: "
+         << raster_cache_async_rasterization << std::endl;
+  stream << "raster_cache_persistent_images: "
+         << raster_cache_persistent_images << std::endl;
+  stream << "decoded_image_cache_max_bytes: " << decoded_image_cache_max_bytes
+         << std::endl;
   return stream.str();
 }
 
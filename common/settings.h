@@ -40,8 +40,25 @@ class FrameTiming {
     return data_[phase] = value;
   }
 
+  // The number of pointer events handled by this frame, and the mean and the
+  // longest time from their time stamps to the end of the frame's
+  // rasterization.
+  size_t GetInputEventCount() const { return input_event_count_; }
+  fml::TimeDelta GetMeanInputLatency() const { return mean_input_latency_; }
+  fml::TimeDelta GetMaxInputLatency() const { return max_input_latency_; }
+  void SetInputLatency(size_t event_count,
+                       fml::TimeDelta mean,
+                       fml::TimeDelta max) {
+    input_event_count_ = event_count;
+    mean_input_latency_ = mean;
+    max_input_latency_ = max;
+  }
+
  private:
   fml::TimePoint data_[kCount];
+  size_t input_event_count_ = 0;
+  fml::TimeDelta mean_input_latency_;
+  fml::TimeDelta max_input_latency_;
 };
 
 using TaskObserverAdd =
@@ -110,6 +127,10 @@ struct Settings {
   bool trace_systrace = false;
   bool dump_skp_on_shader_compilation = false;
   bool cache_sksl = false;
+  // Precompile the known SkSLs in small batches between frames once the
+  // rasterizer has a surface, instead of all at once when the surface is
+  // created.
+  bool staged_sksl_warm_up = false;
   bool purge_persistent_cache = false;
   bool endless_trace_buffer = false;
   bool enable_dart_profiling = false;
@@ -159,6 +180,17 @@ struct Settings {
   // Selects the SkParagraph implementation of the text layout engine.
   bool enable_skparagraph = false;
 
+  // Records the draw operations of dart:ui Canvas objects into a command
+  // buffer that is replayed with one native call per flush, instead of making
+  // a native call for each of them.
+  bool enable_canvas_command_buffer = false;
+
+  // Merges the pointer move and hover events received within a frame before
+  // they are dispatched to the framework, instead of using the pointer data
+  // dispatcher of the platform view. See `CoalescingPointerDataDispatcher`.
+  // The input latency of `FrameTiming` is only measured with this enabled.
+  bool enable_pointer_event_coalescing = false;
+
   // All shells in the process share the same VM. The last shell to shutdown
   // should typically shut down the VM as well. However, applications depend on
   // the behavior of "warming-up" the VM by creating a shell that does not do
@@ -227,6 +259,13 @@ struct Settings {
   fml::UniqueFD::element_type assets_dir =
       fml::UniqueFD::traits_type::InvalidValue();
   std::string assets_path;
+  // An asset pack (see flutter/assets/asset_pack.h) that is searched before
+  // the assets directory.
+  std::string asset_pack_path;
+  // When non-zero, the assets requested during this many frames after launch
+  // are recorded in the persistent cache, and the assets recorded by the
+  // previous launch are prefetched on the IO task runner.
+  size_t asset_access_trace_frame_count = 0;
 
   // Callback to handle the timings of a rasterized frame. This is called as
   // soon as a frame is rasterized.
@@ -247,6 +286,35 @@ struct Settings {
   /// https://github.com/dart-lang/sdk/blob/ca64509108b3e7219c50d6c52877c85ab6a35ff2/runtime/vm/flag_list.h#L150
   int64_t old_gen_heap_size = -1;
 
+  /// The byte budget for raster cache entries that are retained across frames
+  /// even if they were not used in the previous frame. 0 disables retention,
+  /// so entries are evicted as soon as they go unused for a frame.
+  size_t raster_cache_max_retained_bytes = 0;
+
+  /// Whether raster cache pictures are rasterized on the concurrent worker
+  /// task runner instead of synchronously on the raster thread. Pictures are
+  /// played back directly until their cache entry is ready.
+  bool raster_cache_async_rasterization = false;
+
+  /// Whether pictures cached by the raster cache are also stored in the
+  /// persistent cache, so that later runs of the application can draw them
+  /// without rasterizing them first.
+  bool raster_cache_persistent_images = false;
+
+  /// Whether plain container and transform layer subtrees that the framework
+  /// retains across frames are rasterized once and then drawn from the raster
+  /// cache while only their translation changes.
+  bool raster_cache_subtrees = false;
+
+  /// Whether the children of container layers are prerolled on worker threads
+  /// as well as on the raster thread.
+  bool concurrent_preroll = false;
+
+  /// The byte budget for images that are kept decoded so that decoding the
+  /// same image bytes at the same size again skips decompression. 0 disables
+  /// the decoded image cache.
+  size_t decoded_image_cache_max_bytes = 0;
+
   /// A timestamp representing when the engine started. The value is based
   /// on the clock used by the Dart timeline APIs. This timestamp is used
   /// to log a timeline event that tracks the latency of engine startup.
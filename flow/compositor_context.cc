@@ -9,6 +9,44 @@
 
 namespace flutter {
 
+std::optional<SkRect> FrameDamage::ComputeClipRect(
+    flutter::LayerTree& layer_tree) {
+  FML_DCHECK(prev_layer_tree_ != &layer_tree);
+  if (!layer_tree.root_layer()) {
+    return std::nullopt;
+  }
+
+  PaintRegionMap empty_paint_region_map;
+  DiffContext context(layer_tree.frame_size(), layer_tree.device_pixel_ratio(),
+                      layer_tree.paint_region_map(),
+                      prev_layer_tree_ ? prev_layer_tree_->paint_region_map()
+                                       : empty_paint_region_map);
+  context.PushCullRect(SkRect::MakeIWH(layer_tree.frame_size().width(),
+                                       layer_tree.frame_size().height()));
+  // An empty paint region map means that the previous layer tree was never
+  // diffed, so there is nothing to diff against.
+  bool can_diff = prev_layer_tree_ &&
+                  !prev_layer_tree_->paint_region_map().empty() &&
+                  prev_layer_tree_->frame_size() == layer_tree.frame_size();
+  {
+    DiffContext::AutoSubtreeRestore subtree(&context);
+    if (!can_diff) {
+      context.MarkSubtreeDirty();
+    }
+    layer_tree.root_layer()->Diff(
+        &context, can_diff ? prev_layer_tree_->root_layer() : nullptr);
+  }
+
+  damage_ = context.ComputeDamage(additional_damage_);
+  if (!can_diff) {
+    // The previous frame may have painted anywhere, so it all changed.
+    damage_->frame_damage = SkIRect::MakeSize(layer_tree.frame_size());
+    damage_->buffer_damage = SkIRect::MakeSize(layer_tree.frame_size());
+  }
+  context.statistics().LogStatistics();
+  return SkRect::Make(damage_->buffer_damage);
+}
+
 CompositorContext::CompositorContext(fml::Milliseconds frame_budget)
     : raster_time_(frame_budget), ui_time_(frame_budget) {}
 
@@ -69,8 +107,13 @@ CompositorContext::ScopedFrame::~ScopedFrame() {
 
 RasterStatus CompositorContext::ScopedFrame::Raster(
     flutter::LayerTree& layer_tree,
-    bool ignore_raster_cache) {
+    bool ignore_raster_cache,
+    FrameDamage* frame_damage) {
   TRACE_EVENT0("flutter", "CompositorContext::ScopedFrame::Raster");
+
+  std::optional<SkRect> clip_rect =
+      frame_damage ? frame_damage->ComputeClipRect(layer_tree) : std::nullopt;
+
   bool root_needs_readback = layer_tree.Preroll(*this, ignore_raster_cache);
   bool needs_save_layer = root_needs_readback && !surface_supports_readback();
   PostPrerollResult post_preroll_result = PostPrerollResult::kSuccess;
@@ -85,6 +128,13 @@ RasterStatus CompositorContext::ScopedFrame::Raster(
   if (post_preroll_result == PostPrerollResult::kSkipAndRetryFrame) {
     return RasterStatus::kSkipAndRetry;
   }
+  // Restrict painting to the damaged area. Everything outside of it is already
+  // up to date in the framebuffer.
+  SkAutoCanvasRestore restore(canvas(), canvas() && clip_rect.has_value());
+  if (canvas() && clip_rect) {
+    canvas()->clipRect(*clip_rect);
+  }
+
   // Clearing canvas after preroll reduces one render target switch when preroll
   // paints some raster cache.
   if (canvas()) {
@@ -6,12 +6,16 @@
 #define FLUTTER_FLOW_COMPOSITOR_CONTEXT_H_
 
 #include <memory>
+#include <optional>
 #include <string>
+#include <utility>
 
 #include "flutter/common/graphics/texture.h"
+#include "flutter/flow/diff_context.h"
 #include "flutter/flow/embedded_views.h"
 #include "flutter/flow/instrumentation.h"
 #include "flutter/flow/raster_cache.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/raster_thread_merger.h"
 #include "third_party/skia/include/core/SkCanvas.h"
@@ -50,6 +54,47 @@ enum class RasterStatus {
   kDiscarded
 };
 
+// Computes the area of a frame that needs to be repainted by diffing its layer
+// tree against the layer tree of the previous frame.
+class FrameDamage {
+ public:
+  // Sets the layer tree of the previous frame. If not set, if it was not diffed
+  // itself or if the frame size changed, the whole frame is damaged.
+  void SetPreviousLayerTree(const LayerTree* prev_layer_tree) {
+    prev_layer_tree_ = prev_layer_tree;
+  }
+
+  // Adds damage that is repainted regardless of the diff, e.g. the area in
+  // which the target framebuffer lags behind the previous frame.
+  void AddAdditionalDamage(const SkIRect& damage) {
+    additional_damage_.join(damage);
+  }
+
+  // Diffs |layer_tree| against the previous layer tree and returns the rect
+  // that painting must be clipped to. This also records the paint regions of
+  // |layer_tree| so that it can be diffed against by the next frame.
+  //
+  // Returns nullopt if the layer tree has no root layer.
+  std::optional<SkRect> ComputeClipRect(LayerTree& layer_tree);
+
+  // The damage computed by the last call to |ComputeClipRect|; see
+  // |Damage::frame_damage|.
+  std::optional<SkIRect> GetFrameDamage() const {
+    return damage_ ? std::make_optional(damage_->frame_damage) : std::nullopt;
+  }
+
+  // The damage computed by the last call to |ComputeClipRect|; see
+  // |Damage::buffer_damage|.
+  std::optional<SkIRect> GetBufferDamage() const {
+    return damage_ ? std::make_optional(damage_->buffer_damage) : std::nullopt;
+  }
+
+ private:
+  SkIRect additional_damage_ = SkIRect::MakeEmpty();
+  std::optional<Damage> damage_;
+  const LayerTree* prev_layer_tree_ = nullptr;
+};
+
 class CompositorContext {
  public:
   class ScopedFrame {
@@ -79,8 +124,11 @@ class CompositorContext {
 
     GrDirectContext* gr_context() const { return gr_context_; }
 
+    // Prerolls and paints |layer_tree|. If |frame_damage| is not null, painting
+    // is clipped to the area that changed since the previous frame.
     virtual RasterStatus Raster(LayerTree& layer_tree,
-                                bool ignore_raster_cache);
+                                bool ignore_raster_cache,
+                                FrameDamage* frame_damage);
 
    private:
     CompositorContext& context_;
@@ -114,6 +162,21 @@ class CompositorContext {
 
   RasterCache& raster_cache() { return raster_cache_; }
 
+  // Preroll the children of ContainerLayers on the worker threads of
+  // |task_runner| as well as on the raster thread, or only on the raster
+  // thread if |task_runner| is nullptr, which is the default.
+  //
+  // Raster cache operations and platform views are still prerolled on the
+  // raster thread, in the same order as without a task runner.
+  void SetConcurrentPrerollTaskRunner(
+      std::shared_ptr<fml::ConcurrentTaskRunner> task_runner) {
+    concurrent_preroll_task_runner_ = std::move(task_runner);
+  }
+
+  fml::ConcurrentTaskRunner* concurrent_preroll_task_runner() const {
+    return concurrent_preroll_task_runner_.get();
+  }
+
   TextureRegistry& texture_registry() { return texture_registry_; }
 
   const Counter& frame_count() const { return frame_count_; }
@@ -128,6 +191,7 @@ class CompositorContext {
   Counter frame_count_;
   Stopwatch raster_time_;
   Stopwatch ui_time_;
+  std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_preroll_task_runner_;
 
   void BeginFrame(ScopedFrame& frame, bool enable_instrumentation);
 
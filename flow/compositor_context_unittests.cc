@@ -0,0 +1,133 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/compositor_context.h"
+
+#include "flutter/flow/layers/layer_tree.h"
+#include "flutter/flow/testing/diff_context_test.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace flutter {
+namespace testing {
+
+using FrameDamageTest = DiffContextTest;
+
+namespace {
+
+std::unique_ptr<LayerTree> CreateLayerTree(std::shared_ptr<Layer> root) {
+  auto layer_tree = std::make_unique<LayerTree>(SkISize::Make(200, 200), 1.0f);
+  layer_tree->set_root_layer(std::move(root));
+  return layer_tree;
+}
+
+}  // namespace
+
+TEST_F(FrameDamageTest, DamagesWholeFrameWithoutPreviousLayerTree) {
+  auto pic = CreatePicture(SkRect::MakeLTRB(10, 10, 50, 50), 1);
+  auto layer_tree =
+      CreateLayerTree(CreateContainerLayer(CreatePictureLayer(pic)));
+
+  FrameDamage damage;
+  auto clip_rect = damage.ComputeClipRect(*layer_tree);
+  ASSERT_TRUE(clip_rect.has_value());
+  EXPECT_EQ(*clip_rect, SkRect::MakeWH(200, 200));
+  ASSERT_TRUE(damage.GetFrameDamage().has_value());
+  EXPECT_EQ(*damage.GetFrameDamage(), SkIRect::MakeWH(200, 200));
+  ASSERT_TRUE(damage.GetBufferDamage().has_value());
+  EXPECT_EQ(*damage.GetBufferDamage(), SkIRect::MakeWH(200, 200));
+}
+
+TEST_F(FrameDamageTest, NoDamageWithoutRootLayer) {
+  auto layer_tree = std::make_unique<LayerTree>(SkISize::Make(200, 200), 1.0f);
+
+  FrameDamage damage;
+  EXPECT_FALSE(damage.ComputeClipRect(*layer_tree).has_value());
+  EXPECT_FALSE(damage.GetFrameDamage().has_value());
+  EXPECT_FALSE(damage.GetBufferDamage().has_value());
+}
+
+TEST_F(FrameDamageTest, DiffsAgainstPreviousLayerTree) {
+  auto pic1 = CreatePicture(SkRect::MakeLTRB(10, 10, 50, 50), 1);
+  auto pic2 = CreatePicture(SkRect::MakeLTRB(100, 100, 150, 150), 1);
+  auto layer1 = CreatePictureLayer(pic1);
+
+  auto t1 = CreateLayerTree(CreateContainerLayer(layer1));
+  FrameDamage damage1;
+  damage1.ComputeClipRect(*t1);
+
+  auto t2 =
+      CreateLayerTree(CreateContainerLayer({layer1, CreatePictureLayer(pic2)}));
+  FrameDamage damage2;
+  damage2.SetPreviousLayerTree(t1.get());
+  auto clip_rect = damage2.ComputeClipRect(*t2);
+  ASSERT_TRUE(clip_rect.has_value());
+  EXPECT_EQ(*clip_rect, SkRect::MakeLTRB(100, 100, 150, 150));
+  EXPECT_EQ(*damage2.GetFrameDamage(), SkIRect::MakeLTRB(100, 100, 150, 150));
+
+  // The existing damage of the framebuffer only extends the buffer damage.
+  FrameDamage damage3;
+  damage3.SetPreviousLayerTree(t1.get());
+  damage3.AddAdditionalDamage(SkIRect::MakeLTRB(0, 0, 20, 20));
+  clip_rect = damage3.ComputeClipRect(*t2);
+  ASSERT_TRUE(clip_rect.has_value());
+  EXPECT_EQ(*clip_rect, SkRect::MakeLTRB(0, 0, 150, 150));
+  EXPECT_EQ(*damage3.GetFrameDamage(), SkIRect::MakeLTRB(100, 100, 150, 150));
+  EXPECT_EQ(*damage3.GetBufferDamage(), SkIRect::MakeLTRB(0, 0, 150, 150));
+}
+
+TEST_F(FrameDamageTest, DamagesWholeFrameIfPreviousLayerTreeWasNotDiffed) {
+  auto pic = CreatePicture(SkRect::MakeLTRB(10, 10, 50, 50), 1);
+  auto layer = CreatePictureLayer(pic);
+
+  auto t1 = CreateLayerTree(CreateContainerLayer(layer));
+  auto t2 = CreateLayerTree(CreateContainerLayer(layer));
+  FrameDamage damage;
+  damage.SetPreviousLayerTree(t1.get());
+  damage.ComputeClipRect(*t2);
+  EXPECT_EQ(*damage.GetFrameDamage(), SkIRect::MakeWH(200, 200));
+}
+
+TEST_F(FrameDamageTest, RasterOnlyRepaintsDamage) {
+  auto pic1 = CreatePicture(SkRect::MakeLTRB(0, 0, 50, 50), 0x00FF00FF);
+  auto pic2 = CreatePicture(SkRect::MakeLTRB(100, 100, 150, 150), 0x0000FFFF);
+  auto layer1 = CreatePictureLayer(pic1);
+  auto t1 = CreateLayerTree(CreateContainerLayer(layer1));
+  auto t2 =
+      CreateLayerTree(CreateContainerLayer({layer1, CreatePictureLayer(pic2)}));
+
+  CompositorContext compositor_context;
+  auto surface = SkSurface::MakeRasterN32Premul(200, 200);
+  {
+    FrameDamage damage;
+    auto frame = compositor_context.AcquireFrame(
+        nullptr, surface->getCanvas(), nullptr, SkMatrix::I(), false, true,
+        nullptr);
+    EXPECT_EQ(frame->Raster(*t1, false, &damage), RasterStatus::kSuccess);
+  }
+
+  // Outside of the damage of the next frame, this is not painted over.
+  SkPaint paint;
+  paint.setColor(SK_ColorRED);
+  surface->getCanvas()->drawRect(SkRect::MakeLTRB(160, 160, 200, 200), paint);
+
+  {
+    FrameDamage damage;
+    damage.SetPreviousLayerTree(t1.get());
+    auto frame = compositor_context.AcquireFrame(
+        nullptr, surface->getCanvas(), nullptr, SkMatrix::I(), false, true,
+        nullptr);
+    EXPECT_EQ(frame->Raster(*t2, false, &damage), RasterStatus::kSuccess);
+  }
+
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(200, 200);
+  ASSERT_TRUE(surface->readPixels(bitmap, 0, 0));
+  EXPECT_EQ(bitmap.getColor(25, 25), SK_ColorGREEN);
+  EXPECT_EQ(bitmap.getColor(125, 125), SK_ColorBLUE);
+  EXPECT_EQ(bitmap.getColor(180, 180), SK_ColorRED);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -3,8 +3,6 @@
 
 namespace flutter {
 
-#ifdef FLUTTER_ENABLE_DIFF_CONTEXT
-
 DiffContext::DiffContext(SkISize frame_size,
                          double frame_device_pixel_ratio,
                          PaintRegionMap& this_frame_paint_region_map,
@@ -147,15 +145,14 @@ PaintRegion DiffContext::GetOldLayerPaintRegion(const Layer* layer) const {
 void DiffContext::Statistics::LogStatistics() {
 #if !FLUTTER_RELEASE
   FML_TRACE_COUNTER("flutter", "DiffContext", reinterpret_cast<int64_t>(this),
-                    "NewPictures", new_pictures_, "PicturesTooComplexToCompare",
-                    pictures_too_complex_to_compare_, "DeepComparePictures",
+                    "NewPictures", new_pictures_, "DeepComparePictures",
                     deep_compare_pictures_, "SameInstancePictures",
                     same_instance_pictures_,
                     "DifferentInstanceButEqualPictures",
-                    different_instance_but_equal_pictures_);
+                    different_instance_but_equal_pictures_,
+                    "ComputedPictureFingerprints",
+                    computed_picture_fingerprints_);
 #endif  // !FLUTTER_RELEASE
 }
 
-#endif  // FLUTTER_ENABLE_DIFF_CONTEXT
-
 }  // namespace flutter
@@ -11,8 +11,6 @@
 
 namespace flutter {
 
-#ifdef FLUTTER_ENABLE_DIFF_CONTEXT
-
 class Layer;
 
 // Represents area that needs to be updated in front buffer (frame_damage) and
@@ -136,31 +134,41 @@ class DiffContext {
     // Picture replaced by different picture
     void AddNewPicture() { ++new_pictures_; }
 
-    // Picture that would require deep comparison but was considered too complex
-    // to serialize and thus was treated as new picture
-    void AddPictureTooComplexToCompare() { ++pictures_too_complex_to_compare_; }
-
     // Picture that has identical instance between frames
     void AddSameInstancePicture() { ++same_instance_pictures_; };
 
-    // Picture that had to be serialized to compare for equality
+    // Picture that had to be compared by fingerprint for equality
     void AddDeepComparePicture() { ++deep_compare_pictures_; }
 
-    // Picture that had to be serialized to compare (different instances),
-    // but were equal
+    // Picture that had to be compared by fingerprint (different instances),
+    // and whose fingerprints matched
     void AddDifferentInstanceButEqualPicture() {
       ++different_instance_but_equal_pictures_;
     };
 
+    // Picture whose fingerprint was not cached on its layer yet and had to be
+    // computed
+    void AddComputedPictureFingerprint() { ++computed_picture_fingerprints_; }
+
+    int new_pictures() const { return new_pictures_; }
+    int same_instance_pictures() const { return same_instance_pictures_; }
+    int deep_compare_pictures() const { return deep_compare_pictures_; }
+    int different_instance_but_equal_pictures() const {
+      return different_instance_but_equal_pictures_;
+    }
+    int computed_picture_fingerprints() const {
+      return computed_picture_fingerprints_;
+    }
+
     // Logs the statistics to trace counter
     void LogStatistics();
 
    private:
     int new_pictures_ = 0;
-    int pictures_too_complex_to_compare_ = 0;
     int same_instance_pictures_ = 0;
     int deep_compare_pictures_ = 0;
     int different_instance_but_equal_pictures_ = 0;
+    int computed_picture_fingerprints_ = 0;
   };
 
   Statistics& statistics() { return statistics_; }
@@ -201,8 +209,6 @@ class DiffContext {
   Statistics statistics_;
 };
 
-#endif  // FLUTTER_ENABLE_DIFF_CONTEXT
-
 }  // namespace flutter
 
 #endif  // FLUTTER_FLOW_DIFF_CONTEXT_H_
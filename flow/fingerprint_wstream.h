@@ -0,0 +1,46 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_FINGERPRINT_WSTREAM_H_
+#define FLUTTER_FLOW_FINGERPRINT_WSTREAM_H_
+
+#include <cstdint>
+
+#include "third_party/skia/include/core/SkStream.h"
+
+namespace flutter {
+
+// A stream that digests the serialized data written to it instead of storing
+// it. This is used to fingerprint pictures. Two independent 64 bit hashes are
+// kept to make accidental collisions, which would leave stale content on
+// screen, vanishingly unlikely.
+class FingerprintWStream : public SkWStream {
+ public:
+  bool write(const void* buffer, size_t size) override {
+    const uint8_t* bytes = static_cast<const uint8_t*>(buffer);
+    for (size_t i = 0; i < size; i++) {
+      // FNV-1a.
+      hash_1_ = (hash_1_ ^ bytes[i]) * 0x100000001b3ull;
+      // Polynomial rolling hash with an odd multiplier unrelated to the FNV
+      // prime.
+      hash_2_ = hash_2_ * 0x9e3779b97f4a7c15ull + bytes[i] + 1;
+    }
+    bytes_written_ += size;
+    return true;
+  }
+
+  size_t bytesWritten() const override { return bytes_written_; }
+
+  uint64_t hash_1() const { return hash_1_; }
+  uint64_t hash_2() const { return hash_2_; }
+
+ private:
+  uint64_t hash_1_ = 0xcbf29ce484222325ull;
+  uint64_t hash_2_ = 0;
+  size_t bytes_written_ = 0;
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_FLOW_FINGERPRINT_WSTREAM_H_
@@ -0,0 +1,716 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <list>
+#include <memory>
+#include <new>
+#include <optional>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/flow/compositor_context.h"
+#include "flutter/flow/layers/clip_path_layer.h"
+#include "flutter/flow/layers/clip_rect_layer.h"
+#include "flutter/flow/layers/clip_rrect_layer.h"
+#include "flutter/flow/layers/container_layer.h"
+#include "flutter/flow/layers/layer_tree.h"
+#include "flutter/flow/layers/opacity_layer.h"
+#include "flutter/flow/layers/physical_shape_layer.h"
+#include "flutter/flow/layers/picture_layer.h"
+#include "flutter/flow/layers/transform_layer.h"
+#include "flutter/flow/raster_cache.h"
+#include "flutter/flow/rtree.h"
+#include "flutter/fml/concurrent_message_loop.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace {
+
+// The number of heap allocations made by the process so far, counted by the
+// replacement of the global operator new below.
+std::atomic<size_t> g_allocation_count = 0;
+
+}  // namespace
+
+void* operator new(size_t size) {
+  g_allocation_count.fetch_add(1, std::memory_order_relaxed);
+  if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+    return pointer;
+  }
+  // The engine is built without exceptions, so there is no bad_alloc to throw.
+  std::abort();
+}
+
+void* operator new[](size_t size) {
+  return operator new(size);
+}
+
+void operator delete(void* pointer) noexcept {
+  std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+  std::free(pointer);
+}
+
+namespace flutter {
+
+namespace {
+
+const SkISize kFrameSize = SkISize::Make(1000, 1000);
+
+// A small picture, like most widgets record, that the raster cache doesn't
+// consider worth rasterizing.
+sk_sp<SkPicture> CreateWidgetPicture(int seed) {
+  const SkRect bounds = SkRect::MakeWH(40, 40);
+  SkPictureRecorder recorder;
+  SkCanvas* canvas = recorder.beginRecording(bounds);
+  SkPaint paint(SkColor4f::FromColor(SkColorSetRGB(seed % 256, 128, 64)));
+  canvas->drawRect(SkRect::MakeWH(40, 20), paint);
+  canvas->drawOval(SkRect::MakeXYWH(0, 20, 20, 20), paint);
+  canvas->drawRRect(
+      SkRRect::MakeRectXY(SkRect::MakeXYWH(20, 20, 20, 20), 4, 4), paint);
+  return recorder.finishRecordingAsPicture();
+}
+
+// A picture with enough operations for the raster cache to rasterize it once
+// it has been drawn for a few frames, like a paragraph of text.
+sk_sp<SkPicture> CreateTextPicture(const SkSize& size, int seed) {
+  SkPictureRecorder recorder;
+  SkCanvas* canvas = recorder.beginRecording(SkRect::MakeSize(size));
+  SkPaint paint(SkColor4f::FromColor(SkColorSetRGB(32, seed % 256, 32)));
+  for (SkScalar y = 2; y + 8 <= size.height(); y += 12) {
+    for (SkScalar x = 2; x + 6 <= size.width(); x += 8) {
+      canvas->drawRect(SkRect::MakeXYWH(x, y, 6, 8), paint);
+    }
+  }
+  return recorder.finishRecordingAsPicture();
+}
+
+std::shared_ptr<PictureLayer> CreatePictureLayer(const SkPoint& offset,
+                                                 sk_sp<SkPicture> picture) {
+  return std::make_shared<PictureLayer>(
+      offset, SkiaGPUObject<SkPicture>(std::move(picture), nullptr),
+      /* is_complex= */ false, /* will_change= */ false);
+}
+
+// Builds |depth| nested transform layers that end in a clip with
+// |picture_count| pictures, like a list item in a scrolling view.
+std::shared_ptr<Layer> CreateSubtree(int depth, int picture_count, int seed) {
+  auto clip = std::make_shared<ClipRectLayer>(SkRect::MakeWH(400, 400),
+                                              Clip::hardEdge);
+  for (int i = 0; i < picture_count; i++) {
+    SkPoint offset = SkPoint::Make((i % 8) * 50, (i / 8) * 50);
+    clip->Add(CreatePictureLayer(offset, CreateWidgetPicture(seed + i)));
+  }
+  std::shared_ptr<ContainerLayer> subtree = clip;
+  for (int i = 0; i < depth; i++) {
+    auto transform = std::make_shared<TransformLayer>(
+        SkMatrix::Translate(i % 3, 1).preScale(1.01f, 1.0f));
+    transform->Add(subtree);
+    subtree = transform;
+  }
+  return subtree;
+}
+
+// Makes |layer| replace |previous| in the next frame, as the framework does
+// with the layers that it updates, and remembers it for the frame after.
+template <typename T>
+std::shared_ptr<T> Update(std::shared_ptr<T> layer,
+                          std::shared_ptr<T>& previous) {
+  if (previous) {
+    layer->AssignOldLayer(previous.get());
+  }
+  previous = layer;
+  return layer;
+}
+
+enum class SceneKind {
+  // 64 nested transforms under an animated one.
+  kDeepTransforms,
+  // A grid of 1024 small pictures, one of which changes in each frame.
+  kManyPictures,
+  // 12 nested rect, rrect and path clips with pictures, scrolled.
+  kNestedClips,
+  // 8 groups of pictures that fade. Every other group overlaps itself, so
+  // that it needs a saveLayer.
+  kOpacityFade,
+  // A list of cards below an app bar, scrolled.
+  kScrollingList,
+  // A list page sliding in over another one that slides out and fades.
+  kPageTransition,
+};
+
+// A scene whose layer tree is built for each frame like the framework builds
+// it: the layers that change are new objects that replace the layers of the
+// previous frame, and the rest of the tree is retained.
+class Scene {
+ public:
+  virtual ~Scene() = default;
+
+  virtual std::shared_ptr<Layer> BuildFrame(int frame) = 0;
+};
+
+class DeepTransformsScene : public Scene {
+ public:
+  DeepTransformsScene() {
+    auto content = std::make_shared<ContainerLayer>();
+    for (int i = 0; i < 16; i++) {
+      SkPoint offset = SkPoint::Make((i % 4) * 50, (i / 4) * 50);
+      content->Add(CreatePictureLayer(offset, CreateWidgetPicture(i)));
+    }
+    std::shared_ptr<ContainerLayer> chain = content;
+    for (int i = 0; i < 64; i++) {
+      SkMatrix matrix = SkMatrix::Translate(2, 1);
+      matrix.preRotate(0.5f, 100, 100);
+      auto transform = std::make_shared<TransformLayer>(matrix);
+      transform->Add(chain);
+      chain = transform;
+    }
+    chain_ = chain;
+  }
+
+  std::shared_ptr<Layer> BuildFrame(int frame) override {
+    SkMatrix matrix = SkMatrix::Translate(400, 400);
+    matrix.preRotate(frame % 360);
+    auto root = Update(std::make_shared<TransformLayer>(matrix), root_);
+    root->Add(chain_);
+    return root;
+  }
+
+ private:
+  std::shared_ptr<Layer> chain_;
+  std::shared_ptr<TransformLayer> root_;
+};
+
+class ManyPicturesScene : public Scene {
+ public:
+  ManyPicturesScene() {
+    for (int i = 0; i < kPictureCount; i++) {
+      pictures_.push_back(
+          CreatePictureLayer(Offset(i), CreateWidgetPicture(i)));
+    }
+  }
+
+  std::shared_ptr<Layer> BuildFrame(int frame) override {
+    const int changed = frame % kPictureCount;
+    pictures_[changed] =
+        CreatePictureLayer(Offset(changed), CreateWidgetPicture(frame));
+    auto root = Update(std::make_shared<ContainerLayer>(), root_);
+    for (const auto& picture : pictures_) {
+      root->Add(picture);
+    }
+    return root;
+  }
+
+ private:
+  static constexpr int kPictureCount = 1024;
+
+  static SkPoint Offset(int index) {
+    return SkPoint::Make((index % 32) * 30, (index / 32) * 30);
+  }
+
+  std::vector<std::shared_ptr<Layer>> pictures_;
+  std::shared_ptr<ContainerLayer> root_;
+};
+
+class NestedClipsScene : public Scene {
+ public:
+  NestedClipsScene() {
+    std::shared_ptr<ContainerLayer> inner;
+    for (int level = 11; level >= 0; level--) {
+      SkRect bounds =
+          SkRect::MakeWH(900, 900).makeInset(level * 30, level * 30);
+      std::shared_ptr<ContainerLayer> clip;
+      switch (level % 3) {
+        case 0:
+          clip = std::make_shared<ClipRectLayer>(bounds, Clip::hardEdge);
+          break;
+        case 1:
+          clip = std::make_shared<ClipRRectLayer>(
+              SkRRect::MakeRectXY(bounds, 16, 16), Clip::antiAlias);
+          break;
+        default: {
+          SkPath path;
+          path.addCircle(bounds.centerX(), bounds.centerY(),
+                         bounds.width() / 2);
+          clip = std::make_shared<ClipPathLayer>(path, Clip::antiAlias);
+          break;
+        }
+      }
+      for (int i = 0; i < 4; i++) {
+        SkPoint offset =
+            SkPoint::Make(bounds.left() + i * 50, bounds.top() + 10);
+        clip->Add(CreatePictureLayer(offset, CreateWidgetPicture(level + i)));
+      }
+      if (inner) {
+        clip->Add(inner);
+      }
+      inner = clip;
+    }
+    clips_ = inner;
+  }
+
+  std::shared_ptr<Layer> BuildFrame(int frame) override {
+    auto root = Update(std::make_shared<TransformLayer>(
+                           SkMatrix::Translate(0, -(frame % 100))),
+                       root_);
+    root->Add(clips_);
+    return root;
+  }
+
+ private:
+  std::shared_ptr<Layer> clips_;
+  std::shared_ptr<TransformLayer> root_;
+};
+
+class OpacityFadeScene : public Scene {
+ public:
+  OpacityFadeScene() {
+    for (int group = 0; group < 8; group++) {
+      const bool overlapping = group % 2 == 1;
+      auto content = std::make_shared<ContainerLayer>();
+      for (int i = 0; i < 12; i++) {
+        SkPoint offset = overlapping ? SkPoint::Make(i * 4, i * 4)
+                                     : SkPoint::Make(i * 60, 0);
+        content->Add(CreatePictureLayer(offset, CreateWidgetPicture(i)));
+      }
+      groups_.push_back(content);
+    }
+    fades_.resize(groups_.size());
+  }
+
+  std::shared_ptr<Layer> BuildFrame(int frame) override {
+    auto root = Update(std::make_shared<ContainerLayer>(), root_);
+    for (size_t group = 0; group < groups_.size(); group++) {
+      SkAlpha alpha = (frame * 8 + group * 32) % 256;
+      auto fade = Update(std::make_shared<OpacityLayer>(
+                             alpha, SkPoint::Make(0, group * 120)),
+                         fades_[group]);
+      fade->Add(groups_[group]);
+      root->Add(fade);
+    }
+    return root;
+  }
+
+ private:
+  std::vector<std::shared_ptr<Layer>> groups_;
+  std::vector<std::shared_ptr<OpacityLayer>> fades_;
+  std::shared_ptr<ContainerLayer> root_;
+};
+
+// The layers of a page with an app bar and a list of 40 cards. Only the
+// layers above the cards change when the list scrolls.
+class ListPage {
+ public:
+  explicit ListPage(int seed) {
+    SkPath app_bar_path;
+    app_bar_path.addRect(SkRect::MakeWH(kFrameSize.width(), 80));
+    app_bar_ = std::make_shared<PhysicalShapeLayer>(
+        SK_ColorBLUE, SK_ColorBLACK, 4.0f, app_bar_path, Clip::none);
+    app_bar_->Add(CreatePictureLayer(SkPoint::Make(16, 24),
+                                     CreateTextPicture({200, 32}, seed)));
+    app_bar_->Add(CreatePictureLayer(SkPoint::Make(940, 20),
+                                     CreateWidgetPicture(seed)));
+
+    items_ = std::make_shared<ContainerLayer>();
+    for (int i = 0; i < 40; i++) {
+      auto item =
+          std::make_shared<TransformLayer>(SkMatrix::Translate(16, i * 100));
+      SkPath card_path;
+      card_path.addRRect(SkRRect::MakeRectXY(
+          SkRect::MakeWH(kFrameSize.width() - 32, 88), 8, 8));
+      auto card = std::make_shared<PhysicalShapeLayer>(
+          SK_ColorWHITE, SK_ColorBLACK, 2.0f, card_path, Clip::antiAlias);
+      card->Add(CreatePictureLayer(SkPoint::Make(16, 24),
+                                   CreateWidgetPicture(seed + i)));
+      card->Add(CreatePictureLayer(SkPoint::Make(72, 12),
+                                   CreateTextPicture({400, 64}, seed + i)));
+      item->Add(card);
+      items_->Add(item);
+    }
+  }
+
+  std::shared_ptr<Layer> BuildFrame(SkScalar scroll_offset) {
+    auto page = Update(std::make_shared<ContainerLayer>(), page_);
+    auto viewport = Update(
+        std::make_shared<ClipRectLayer>(
+            SkRect::MakeLTRB(0, 80, kFrameSize.width(), kFrameSize.height()),
+            Clip::hardEdge),
+        viewport_);
+    auto scroll = Update(std::make_shared<TransformLayer>(
+                             SkMatrix::Translate(0, 80 - scroll_offset)),
+                         scroll_);
+    scroll->Add(items_);
+    viewport->Add(scroll);
+    page->Add(viewport);
+    page->Add(app_bar_);
+    return page;
+  }
+
+ private:
+  std::shared_ptr<PhysicalShapeLayer> app_bar_;
+  std::shared_ptr<ContainerLayer> items_;
+  std::shared_ptr<ContainerLayer> page_;
+  std::shared_ptr<ClipRectLayer> viewport_;
+  std::shared_ptr<TransformLayer> scroll_;
+};
+
+class ScrollingListScene : public Scene {
+ public:
+  ScrollingListScene() : page_(0) {}
+
+  std::shared_ptr<Layer> BuildFrame(int frame) override {
+    return page_.BuildFrame((frame * 7) % 3000);
+  }
+
+ private:
+  ListPage page_;
+};
+
+class PageTransitionScene : public Scene {
+ public:
+  PageTransitionScene() : outgoing_page_(0), incoming_page_(100) {}
+
+  std::shared_ptr<Layer> BuildFrame(int frame) override {
+    // The transition takes 30 frames and then starts over.
+    const float progress = (frame % 30) / 30.0f;
+    auto root = Update(std::make_shared<ContainerLayer>(), root_);
+
+    auto fade = Update(
+        std::make_shared<OpacityLayer>((1.0f - progress) * 255, SkPoint()),
+        fade_);
+    auto outgoing_slide =
+        Update(std::make_shared<TransformLayer>(SkMatrix::Translate(
+                   -progress * kFrameSize.width() / 3, 0)),
+               outgoing_slide_);
+    outgoing_slide->Add(outgoing_page_.BuildFrame(200));
+    fade->Add(outgoing_slide);
+    root->Add(fade);
+
+    auto incoming_slide =
+        Update(std::make_shared<TransformLayer>(SkMatrix::Translate(
+                   (1.0f - progress) * kFrameSize.width(), 0)),
+               incoming_slide_);
+    incoming_slide->Add(incoming_page_.BuildFrame(0));
+    root->Add(incoming_slide);
+    return root;
+  }
+
+ private:
+  ListPage outgoing_page_;
+  ListPage incoming_page_;
+  std::shared_ptr<ContainerLayer> root_;
+  std::shared_ptr<OpacityLayer> fade_;
+  std::shared_ptr<TransformLayer> outgoing_slide_;
+  std::shared_ptr<TransformLayer> incoming_slide_;
+};
+
+std::unique_ptr<Scene> CreateScene(SceneKind kind) {
+  switch (kind) {
+    case SceneKind::kDeepTransforms:
+      return std::make_unique<DeepTransformsScene>();
+    case SceneKind::kManyPictures:
+      return std::make_unique<ManyPicturesScene>();
+    case SceneKind::kNestedClips:
+      return std::make_unique<NestedClipsScene>();
+    case SceneKind::kOpacityFade:
+      return std::make_unique<OpacityFadeScene>();
+    case SceneKind::kScrollingList:
+      return std::make_unique<ScrollingListScene>();
+    case SceneKind::kPageTransition:
+      return std::make_unique<PageTransitionScene>();
+  }
+  FML_UNREACHABLE();
+}
+
+// The steps of rasterizing a frame that are measured separately.
+enum class Phase {
+  kDiff,
+  kPreroll,
+  kPaint,
+  // All of the above, as |CompositorContext::ScopedFrame::Raster| does them.
+  kFrame,
+};
+
+// Rasterizes the frames of a scene into a software surface and reports the
+// time, the heap allocations and the raster cache hit rates of |phase|. The
+// other phases run untimed, since each phase depends on the previous ones.
+void RasterizeScene(benchmark::State& state, SceneKind kind, Phase phase) {
+  auto scene = CreateScene(kind);
+  CompositorContext compositor_context(fml::kDefaultFrameBudget);
+  sk_sp<SkSurface> surface =
+      SkSurface::MakeRasterN32Premul(kFrameSize.width(), kFrameSize.height());
+  SkCanvas* canvas = surface->getCanvas();
+  FrameDamage frame_damage;
+  std::unique_ptr<LayerTree> previous_layer_tree;
+  std::unique_ptr<LayerTree> layer_tree;
+
+  int frame = 0;
+  size_t allocation_count = 0;
+  RasterCache::DrawStatistics draw_statistics;
+  while (state.KeepRunning()) {
+    std::unique_ptr<CompositorContext::ScopedFrame> scoped_frame;
+    {
+      benchmarking::ScopedPauseTiming pause(state);
+      previous_layer_tree = std::move(layer_tree);
+      layer_tree = std::make_unique<LayerTree>(kFrameSize, 1.0f);
+      layer_tree->set_root_layer(scene->BuildFrame(frame++));
+      frame_damage.SetPreviousLayerTree(previous_layer_tree.get());
+      scoped_frame = compositor_context.AcquireFrame(
+          nullptr, canvas, nullptr, SkMatrix::I(), false, true, nullptr);
+    }
+
+    // Only the allocations of the measured phase are counted.
+    auto run_phase = [&](Phase run, const std::function<void()>& step) {
+      benchmarking::ScopedPauseTiming pause(state, run != phase);
+      const size_t allocations_before = g_allocation_count;
+      step();
+      if (run == phase) {
+        allocation_count += g_allocation_count - allocations_before;
+      }
+    };
+    if (phase == Phase::kFrame) {
+      run_phase(Phase::kFrame, [&] {
+        scoped_frame->Raster(*layer_tree, false, &frame_damage);
+      });
+    } else {
+      std::optional<SkRect> clip_rect;
+      run_phase(Phase::kDiff,
+                [&] { clip_rect = frame_damage.ComputeClipRect(*layer_tree); });
+      run_phase(Phase::kPreroll, [&] { layer_tree->Preroll(*scoped_frame); });
+      run_phase(Phase::kPaint, [&] {
+        SkAutoCanvasRestore restore(canvas, clip_rect.has_value());
+        if (clip_rect) {
+          canvas->clipRect(*clip_rect);
+        }
+        layer_tree->Paint(*scoped_frame);
+      });
+    }
+
+    {
+      benchmarking::ScopedPauseTiming pause(state);
+      const auto& frame_statistics =
+          compositor_context.raster_cache().draw_statistics();
+      draw_statistics.picture_hits += frame_statistics.picture_hits;
+      draw_statistics.picture_misses += frame_statistics.picture_misses;
+      draw_statistics.layer_hits += frame_statistics.layer_hits;
+      draw_statistics.layer_misses += frame_statistics.layer_misses;
+      // Ends the frame, which sweeps the raster cache.
+      scoped_frame.reset();
+    }
+  }
+
+  auto hit_rate = [](size_t hits, size_t misses) {
+    return hits + misses > 0 ? static_cast<double>(hits) / (hits + misses)
+                             : 0.0;
+  };
+  state.counters["AllocsPerFrame"] =
+      frame > 0 ? static_cast<double>(allocation_count) / frame : 0.0;
+  state.counters["PictureCacheHitRate"] =
+      hit_rate(draw_statistics.picture_hits, draw_statistics.picture_misses);
+  state.counters["LayerCacheHitRate"] =
+      hit_rate(draw_statistics.layer_hits, draw_statistics.layer_misses);
+}
+
+// The list based merge that |RTree::searchNonOverlappingDrawnRects| used
+// before the sweep, kept to compare the cost of both.
+std::list<SkRect> LegacyNonOverlappingRects(const std::vector<SkRect>& rects) {
+  std::list<SkRect> final_results;
+  for (const SkRect& current_record_rect : rects) {
+    auto replaced_existing_rect = false;
+    auto curr_rect_itr = final_results.begin();
+    std::list<SkRect>::iterator first_intersecting_rect_itr;
+    while (!replaced_existing_rect && curr_rect_itr != final_results.end()) {
+      if (SkRect::Intersects(*curr_rect_itr, current_record_rect)) {
+        replaced_existing_rect = true;
+        first_intersecting_rect_itr = curr_rect_itr;
+        curr_rect_itr->join(current_record_rect);
+      }
+      curr_rect_itr++;
+    }
+    while (replaced_existing_rect && curr_rect_itr != final_results.end()) {
+      if (SkRect::Intersects(*curr_rect_itr, *first_intersecting_rect_itr)) {
+        first_intersecting_rect_itr->join(*curr_rect_itr);
+        curr_rect_itr = final_results.erase(curr_rect_itr);
+      } else {
+        curr_rect_itr++;
+      }
+    }
+    if (!replaced_existing_rect) {
+      final_results.push_back(current_record_rect);
+    }
+  }
+  return final_results;
+}
+
+}  // namespace
+
+// Prerolls a layer tree with |state.range(0)| independent subtrees under the
+// root, each with 16 nested transforms and 32 pictures. If |state.range(1)| is
+// not zero, the subtrees are prerolled concurrently.
+static void BM_PrerollSyntheticTree(benchmark::State& state) {
+  const int subtree_count = state.range(0);
+  const bool concurrent = state.range(1) != 0;
+
+  LayerTree layer_tree(kFrameSize, 1.0f);
+  auto root = std::make_shared<ContainerLayer>();
+  for (int i = 0; i < subtree_count; i++) {
+    root->Add(CreateSubtree(16, 32, i * 32));
+  }
+  layer_tree.set_root_layer(root);
+
+  CompositorContext compositor_context(fml::kDefaultFrameBudget);
+  std::shared_ptr<fml::ConcurrentMessageLoop> worker_loop;
+  if (concurrent) {
+    worker_loop = fml::ConcurrentMessageLoop::Create();
+    compositor_context.SetConcurrentPrerollTaskRunner(
+        worker_loop->GetTaskRunner());
+  }
+
+  while (state.KeepRunning()) {
+    auto scoped_frame = compositor_context.AcquireFrame(
+        nullptr, nullptr, nullptr, SkMatrix::I(), false, true, nullptr);
+    layer_tree.Preroll(*scoped_frame);
+  }
+}
+
+BENCHMARK(BM_PrerollSyntheticTree)
+    ->ArgNames({"subtrees", "concurrent"})
+    ->Args({2, 0})
+    ->Args({2, 1})
+    ->Args({8, 0})
+    ->Args({8, 1})
+    ->Args({32, 0})
+    ->Args({32, 1})
+    ->Unit(benchmark::kMicrosecond);
+
+static void BM_Diff(benchmark::State& state, SceneKind kind) {
+  RasterizeScene(state, kind, Phase::kDiff);
+}
+
+static void BM_Preroll(benchmark::State& state, SceneKind kind) {
+  RasterizeScene(state, kind, Phase::kPreroll);
+}
+
+static void BM_Paint(benchmark::State& state, SceneKind kind) {
+  RasterizeScene(state, kind, Phase::kPaint);
+}
+
+static void BM_Frame(benchmark::State& state, SceneKind kind) {
+  RasterizeScene(state, kind, Phase::kFrame);
+}
+
+#define FLOW_SCENE_BENCHMARKS(name, kind)              \
+  BENCHMARK_CAPTURE(BM_Diff, name, SceneKind::kind)    \
+      ->Unit(benchmark::kMicrosecond);                 \
+  BENCHMARK_CAPTURE(BM_Preroll, name, SceneKind::kind) \
+      ->Unit(benchmark::kMicrosecond);                 \
+  BENCHMARK_CAPTURE(BM_Paint, name, SceneKind::kind)   \
+      ->Unit(benchmark::kMicrosecond);                 \
+  BENCHMARK_CAPTURE(BM_Frame, name, SceneKind::kind)   \
+      ->Unit(benchmark::kMicrosecond);
+
+FLOW_SCENE_BENCHMARKS(DeepTransforms, kDeepTransforms)
+FLOW_SCENE_BENCHMARKS(ManyPictures, kManyPictures)
+FLOW_SCENE_BENCHMARKS(NestedClips, kNestedClips)
+FLOW_SCENE_BENCHMARKS(OpacityFade, kOpacityFade)
+FLOW_SCENE_BENCHMARKS(ScrollingList, kScrollingList)
+FLOW_SCENE_BENCHMARKS(PageTransition, kPageTransition)
+
+// Prepares 256 pictures in each frame. If |state.range(0)| is not zero, the
+// pictures are rasterized already. Otherwise they have not been drawn often
+// enough for the raster cache to rasterize them.
+static void BM_RasterCachePrepare(benchmark::State& state) {
+  const bool cached = state.range(0) != 0;
+  const size_t picture_count = 256;
+  RasterCache raster_cache(cached ? 1 : std::numeric_limits<size_t>::max(),
+                           picture_count);
+  std::vector<sk_sp<SkPicture>> pictures;
+  for (size_t i = 0; i < picture_count; i++) {
+    pictures.push_back(CreateTextPicture({200, 40}, i));
+  }
+  sk_sp<SkSurface> surface = SkSurface::MakeRasterN32Premul(200, 40);
+  SkCanvas* canvas = surface->getCanvas();
+
+  auto prepare = [&] {
+    for (const auto& picture : pictures) {
+      raster_cache.Prepare(nullptr, picture.get(), SkMatrix::I(), nullptr,
+                           false, false);
+    }
+  };
+  // Like PictureLayer, draws the pictures after preparing them, which keeps
+  // them in the cache.
+  auto draw_and_sweep = [&] {
+    for (const auto& picture : pictures) {
+      raster_cache.Draw(*picture, *canvas);
+    }
+    raster_cache.SweepAfterFrame();
+  };
+  for (int frame = 0; frame < 2; frame++) {
+    prepare();
+    draw_and_sweep();
+  }
+
+  while (state.KeepRunning()) {
+    prepare();
+    benchmarking::ScopedPauseTiming pause(state);
+    draw_and_sweep();
+  }
+  state.SetItemsProcessed(state.iterations() * picture_count);
+}
+
+BENCHMARK(BM_RasterCachePrepare)
+    ->ArgName("cached")
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMicrosecond);
+
+// Searches the non-overlapping drawn rects of a picture with 500 rects, as
+// drawn by a scrolling list with some overlapping decorations. If
+// |state.range(0)| is not zero, the rects are merged with the list based merge
+// that the search used before instead.
+static void BM_SearchNonOverlappingDrawnRects(benchmark::State& state) {
+  const bool legacy = state.range(0) != 0;
+  RTreeFactory rtree_factory;
+  SkPictureRecorder recorder;
+  SkCanvas* recording_canvas =
+      recorder.beginRecording(SkRect::MakeIWH(1000, 1000), &rtree_factory);
+  SkPaint rect_paint;
+  rect_paint.setColor(SK_ColorCYAN);
+
+  const SkRect query = SkRect::MakeLTRB(100, 0, 700, 1000);
+  std::vector<SkRect> intersecting_rects;
+  for (int i = 0; i < 500; i++) {
+    float top = (i / 5) * 10.0f;
+    float left = (i % 5) * 200.0f;
+    SkRect rect = SkRect::MakeXYWH(left, top, (i % 3) ? 150 : 220, 8);
+    recording_canvas->drawRect(rect, rect_paint);
+    if (SkRect::Intersects(rect, query)) {
+      intersecting_rects.push_back(rect);
+    }
+  }
+  sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+  auto rtree = rtree_factory.getInstance();
+
+  while (state.KeepRunning()) {
+    if (legacy) {
+      benchmark::DoNotOptimize(LegacyNonOverlappingRects(intersecting_rects));
+    } else {
+      benchmark::DoNotOptimize(rtree->searchNonOverlappingDrawnRects(query));
+    }
+  }
+}
+
+BENCHMARK(BM_SearchNonOverlappingDrawnRects)
+    ->ArgName("legacy")
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace flutter
@@ -4,6 +4,7 @@
 
 #include "flutter/flow/frame_timings.h"
 
+#include <algorithm>
 #include <memory>
 #include <sstream>
 
@@ -98,6 +99,14 @@ void FrameTimingsRecorder::RecordRasterStart(fml::TimePoint raster_start) {
   raster_start_ = raster_start;
 }
 
+void FrameTimingsRecorder::RecordInputEvents(
+    const std::vector<fml::TimePoint>& event_times) {
+  std::scoped_lock state_lock(state_mutex_);
+  FML_DCHECK(state_ < State::kRasterEnd);
+  input_event_times_.insert(input_event_times_.end(), event_times.begin(),
+                            event_times.end());
+}
+
 FrameTiming FrameTimingsRecorder::RecordRasterEnd(fml::TimePoint raster_end) {
   std::scoped_lock state_lock(state_mutex_);
   FML_DCHECK(state_ == State::kRasterStart);
@@ -109,6 +118,19 @@ FrameTiming FrameTimingsRecorder::RecordRasterEnd(fml::TimePoint raster_end) {
   timing.Set(FrameTiming::kBuildFinish, build_end_);
   timing.Set(FrameTiming::kRasterStart, raster_start_);
   timing.Set(FrameTiming::kRasterFinish, raster_end_);
+  if (!input_event_times_.empty()) {
+    fml::TimeDelta total_latency;
+    fml::TimeDelta max_latency;
+    for (fml::TimePoint event_time : input_event_times_) {
+      fml::TimeDelta latency = raster_end_ - event_time;
+      total_latency = total_latency + latency;
+      max_latency = std::max(max_latency, latency);
+    }
+    timing.SetInputLatency(
+        input_event_times_.size(),
+        total_latency / static_cast<int64_t>(input_event_times_.size()),
+        max_latency);
+  }
   return timing;
 }
 
@@ -126,6 +148,7 @@ std::unique_ptr<FrameTimingsRecorder> FrameTimingsRecorder::CloneUntil(
 
   if (state >= State::kBuildStart) {
     recorder->build_start_ = build_start_;
+    recorder->input_event_times_ = input_event_times_;
   }
 
   if (state >= State::kRasterEnd) {
@@ -6,6 +6,7 @@
 #define FLUTTER_FLOW_FRAME_TIMINGS_H_
 
 #include <mutex>
+#include <vector>
 
 #include "flutter/common/settings.h"
 #include "flutter/fml/macros.h"
@@ -76,6 +77,11 @@ class FrameTimingsRecorder {
   /// Records a raster start event.
   void RecordRasterStart(fml::TimePoint raster_start);
 
+  /// Records the time stamps of pointer events that are handled by this frame.
+  /// Their latency to the raster end is summarized in the `FrameTiming`, so
+  /// they must come from the clock of `fml::TimePoint::Now`.
+  void RecordInputEvents(const std::vector<fml::TimePoint>& event_times);
+
   /// Clones the recorder until (and including) the specified state.
   std::unique_ptr<FrameTimingsRecorder> CloneUntil(State state);
 
@@ -106,6 +112,7 @@ class FrameTimingsRecorder {
   fml::TimePoint build_end_;
   fml::TimePoint raster_start_;
   fml::TimePoint raster_end_;
+  std::vector<fml::TimePoint> input_event_times_;
 
   FML_DISALLOW_COPY_ASSIGN_AND_MOVE(FrameTimingsRecorder);
 };
@@ -59,6 +59,25 @@ TEST(FrameTimingsRecorderTest, RecordRasterTimes) {
   ASSERT_EQ(raster_end, recorder->GetRasterEndTime());
 }
 
+TEST(FrameTimingsRecorderTest, RecordInputLatency) {
+  auto recorder = std::make_unique<FrameTimingsRecorder>();
+
+  const auto st = fml::TimePoint::Now();
+  const auto en = st + fml::TimeDelta::FromMillisecondsF(16);
+  recorder->RecordVsync(st, en);
+  recorder->RecordBuildStart(st);
+  recorder->RecordInputEvents({st - fml::TimeDelta::FromMilliseconds(4),
+                               st - fml::TimeDelta::FromMilliseconds(2)});
+  recorder->RecordBuildEnd(st + fml::TimeDelta::FromMilliseconds(8));
+  recorder->RecordRasterStart(st + fml::TimeDelta::FromMilliseconds(8));
+  FrameTiming timing =
+      recorder->RecordRasterEnd(st + fml::TimeDelta::FromMilliseconds(16));
+
+  ASSERT_EQ(timing.GetInputEventCount(), 2u);
+  ASSERT_EQ(timing.GetMeanInputLatency(), fml::TimeDelta::FromMilliseconds(19));
+  ASSERT_EQ(timing.GetMaxInputLatency(), fml::TimeDelta::FromMilliseconds(20));
+}
+
 // Windows and Fuchsia don't allow testing with killed by signal.
 #if !defined(OS_FUCHSIA) && !defined(OS_WIN) && \
     (FLUTTER_RUNTIME_MODE == FLUTTER_RUNTIME_MODE_DEBUG)
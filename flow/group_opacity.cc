@@ -0,0 +1,363 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/group_opacity.h"
+
+#include <vector>
+
+#include "flutter/fml/trace_event.h"
+#include "third_party/skia/include/core/SkCanvasVirtualEnforcer.h"
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkRRect.h"
+#include "third_party/skia/include/core/SkRegion.h"
+#include "third_party/skia/include/utils/SkNoDrawCanvas.h"
+#include "third_party/skia/include/utils/SkPaintFilterCanvas.h"
+
+namespace flutter {
+
+namespace {
+
+// Records the device bounds of the draw operations of a picture and whether
+// each of them can take an opacity on its paint.
+class GroupOpacityAnalyzer final
+    : public SkCanvasVirtualEnforcer<SkNoDrawCanvas> {
+ public:
+  // The canvas doesn't clip, so that no operation is culled before it is
+  // analyzed.
+  GroupOpacityAnalyzer()
+      : SkCanvasVirtualEnforcer<SkNoDrawCanvas>(
+            SkIRect::MakeLTRB(-kUnclipped, -kUnclipped, kUnclipped,
+                              kUnclipped)) {}
+
+  bool can_apply_group_opacity() const { return can_apply_group_opacity_; }
+
+ private:
+  static constexpr int32_t kUnclipped = 1 << 28;
+
+  bool can_apply_group_opacity_ = true;
+  bool has_unbounded_op_ = false;
+  std::vector<SkIRect> op_bounds_;
+
+  void MarkIncompatible() { can_apply_group_opacity_ = false; }
+
+  // Adds an operation that draws within |bounds|, in local coordinates, with
+  // |paint|. An operation without bounds covers the whole canvas.
+  void AddOp(const SkRect* bounds, const SkPaint* paint) {
+    if (!can_apply_group_opacity_) {
+      return;
+    }
+    if (paint && (paint->getBlendMode() != SkBlendMode::kSrcOver ||
+                  paint->getColorFilter() || paint->getImageFilter() ||
+                  !paint->canComputeFastBounds())) {
+      MarkIncompatible();
+      return;
+    }
+    if (has_unbounded_op_ || (!bounds && !op_bounds_.empty())) {
+      MarkIncompatible();
+      return;
+    }
+    if (!bounds) {
+      has_unbounded_op_ = true;
+      return;
+    }
+    SkRect storage;
+    const SkRect& paint_bounds =
+        paint ? paint->computeFastBounds(*bounds, &storage) : *bounds;
+    // Anti-aliased edges touch the pixels that the bounds partially cover.
+    SkIRect device_bounds = getTotalMatrix().mapRect(paint_bounds).roundOut();
+    for (const SkIRect& other : op_bounds_) {
+      if (SkIRect::Intersects(other, device_bounds)) {
+        MarkIncompatible();
+        return;
+      }
+    }
+    op_bounds_.push_back(device_bounds);
+  }
+
+  void AddOp(const SkRect& bounds, const SkPaint& paint) {
+    AddOp(&bounds, &paint);
+  }
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  SaveLayerStrategy getSaveLayerStrategy(const SaveLayerRec& rec) override {
+    MarkIncompatible();
+    return kNoLayer_SaveLayerStrategy;
+  }
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  bool onDoSaveBehind(const SkRect*) override {
+    MarkIncompatible();
+    return false;
+  }
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawPaint(const SkPaint& paint) override {
+    AddOp(nullptr, &paint);
+  }
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawBehind(const SkPaint&) override { MarkIncompatible(); }
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawPoints(PointMode,
+                    size_t count,
+                    const SkPoint pts[],
+                    const SkPaint&) override {
+    // Points and line segments may overlap each other.
+    MarkIncompatible();
+  }
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawRect(const SkRect& rect, const SkPaint& paint) override {
+    AddOp(rect, paint);
+  }
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawRegion(const SkRegion& region, const SkPaint& paint) override {
+    AddOp(SkRect::Make(region.getBounds()), paint);
+  }
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawOval(const SkRect& rect, const SkPaint& paint) override {
+    AddOp(rect, paint);
+  }
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawArc(const SkRect& rect,
+                 SkScalar,
+                 SkScalar,
+                 bool,
+                 const SkPaint& paint) override {
+    AddOp(rect, paint);
+  }
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawRRect(const SkRRect& rrect, const SkPaint& paint) override {
+    AddOp(rrect.getBounds(), paint);
+  }
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawDRRect(const SkRRect& outer,
+                    const SkRRect&,
+                    const SkPaint& paint) override {
+    AddOp(outer.getBounds(), paint);
+  }
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawPath(const SkPath& path, const SkPaint& paint) override {
+    if (path.isInverseFillType()) {
+      AddOp(nullptr, &paint);
+    } else {
+      AddOp(path.getBounds(), paint);
+    }
+  }
+
+#ifdef SK_SUPPORT_LEGACY_ONDRAWIMAGERECT
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawImage(const SkImage*,
+                   SkScalar left,
+                   SkScalar top,
+                   const SkPaint*) override {
+    MarkIncompatible();
+  }
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawImageRect(const SkImage*,
+                       const SkRect* src,
+                       const SkRect& dst,
+                       const SkPaint*,
+                       SrcRectConstraint) override {
+    MarkIncompatible();
+  }
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawImageLattice(const SkImage*,
+                          const Lattice&,
+                          const SkRect&,
+                          const SkPaint*) override {
+    MarkIncompatible();
+  }
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawAtlas(const SkImage*,
+                   const SkRSXform[],
+                   const SkRect[],
+                   const SkColor[],
+                   int,
+                   SkBlendMode,
+                   const SkRect*,
+                   const SkPaint*) override {
+    MarkIncompatible();
+  }
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawEdgeAAImageSet(const ImageSetEntry[],
+                            int count,
+                            const SkPoint[],
+                            const SkMatrix[],
+                            const SkPaint*,
+                            SrcRectConstraint) override {
+    MarkIncompatible();
+  }
+#endif
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawImage2(const SkImage* image,
+                    SkScalar left,
+                    SkScalar top,
+                    const SkSamplingOptions&,
+                    const SkPaint* paint) override {
+    SkRect dst = SkRect::MakeXYWH(left, top, image->width(), image->height());
+    AddOp(&dst, paint);
+  }
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawImageRect2(const SkImage*,
+                        const SkRect& src,
+                        const SkRect& dst,
+                        const SkSamplingOptions&,
+                        const SkPaint* paint,
+                        SrcRectConstraint) override {
+    AddOp(&dst, paint);
+  }
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawImageLattice2(const SkImage*,
+                           const Lattice&,
+                           const SkRect& dst,
+                           SkFilterMode,
+                           const SkPaint* paint) override {
+    AddOp(&dst, paint);
+  }
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawTextBlob(const SkTextBlob*,
+                      SkScalar,
+                      SkScalar,
+                      const SkPaint&) override {
+    // The glyphs of a text blob may overlap each other.
+    MarkIncompatible();
+  }
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawPatch(const SkPoint[12],
+                   const SkColor[4],
+                   const SkPoint[4],
+                   SkBlendMode,
+                   const SkPaint&) override {
+    MarkIncompatible();
+  }
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawVerticesObject(const SkVertices*,
+                            SkBlendMode,
+                            const SkPaint&) override {
+    MarkIncompatible();
+  }
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawAtlas2(const SkImage*,
+                    const SkRSXform[],
+                    const SkRect[],
+                    const SkColor[],
+                    int,
+                    SkBlendMode,
+                    const SkSamplingOptions&,
+                    const SkRect*,
+                    const SkPaint*) override {
+    MarkIncompatible();
+  }
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawShadowRec(const SkPath&, const SkDrawShadowRec&) override {
+    // The ambient and the spot shadows overlap.
+    MarkIncompatible();
+  }
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawPicture(const SkPicture*,
+                     const SkMatrix*,
+                     const SkPaint*) override {
+    MarkIncompatible();
+  }
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawDrawable(SkDrawable*, const SkMatrix*) override {
+    MarkIncompatible();
+  }
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawAnnotation(const SkRect&, const char[], SkData*) override {}
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawEdgeAAQuad(const SkRect&,
+                        const SkPoint[4],
+                        SkCanvas::QuadAAFlags,
+                        const SkColor4f&,
+                        SkBlendMode) override {
+    // The color of the quad is not a paint that the opacity can be applied to.
+    MarkIncompatible();
+  }
+
+  // |SkCanvasVirtualEnforcer<SkNoDrawCanvas>|
+  void onDrawEdgeAAImageSet2(const ImageSetEntry[],
+                             int count,
+                             const SkPoint[],
+                             const SkMatrix[],
+                             const SkSamplingOptions&,
+                             const SkPaint*,
+                             SrcRectConstraint) override {
+    MarkIncompatible();
+  }
+};
+
+// Forwards draw operations to a canvas with an opacity applied to the paint
+// of each of them.
+class OpacityPaintFilterCanvas final : public SkPaintFilterCanvas {
+ public:
+  OpacityPaintFilterCanvas(SkCanvas* canvas, SkScalar opacity)
+      : SkPaintFilterCanvas(canvas), opacity_(opacity) {}
+
+ private:
+  const SkScalar opacity_;
+
+  // |SkPaintFilterCanvas|
+  bool onFilter(SkPaint& paint) const override {
+    paint.setAlphaf(paint.getAlphaf() * opacity_);
+    return true;
+  }
+};
+
+}  // namespace
+
+bool CanApplyGroupOpacity(const SkPicture& picture) {
+  if (picture.approximateOpCount() > kMaxGroupOpacityAnalysisOpCount) {
+    return false;
+  }
+  TRACE_EVENT0("flutter", "CanApplyGroupOpacity");
+  GroupOpacityAnalyzer analyzer;
+  picture.playback(&analyzer);
+  return analyzer.can_apply_group_opacity();
+}
+
+void DrawPictureWithOpacity(const SkPicture& picture,
+                            SkCanvas* canvas,
+                            SkScalar opacity) {
+  // The filter canvas starts out with an identity matrix and a clip of the
+  // size of |canvas|. Pictures recorded with a bounding box hierarchy skip
+  // the operations outside the local clip bounds of the canvas they are
+  // played back into, so the filter canvas is given the matrix and the
+  // device clip of |canvas| first. Both calls are forwarded to |canvas|,
+  // where they change nothing.
+  const SkM44 matrix = canvas->getLocalToDevice();
+  const SkIRect device_clip_bounds = canvas->getDeviceClipBounds();
+  OpacityPaintFilterCanvas opacity_canvas(canvas, opacity);
+  SkAutoCanvasRestore save(&opacity_canvas, true);
+  opacity_canvas.resetMatrix();
+  opacity_canvas.clipRect(SkRect::Make(device_clip_bounds));
+  opacity_canvas.setMatrix(matrix);
+  picture.playback(&opacity_canvas);
+}
+
+}  // namespace flutter
@@ -0,0 +1,37 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_GROUP_OPACITY_H_
+#define FLUTTER_FLOW_GROUP_OPACITY_H_
+
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkPicture.h"
+
+namespace flutter {
+
+// Pictures with more operations than this are not analyzed by
+// |CanApplyGroupOpacity|.
+static constexpr int kMaxGroupOpacityAnalysisOpCount = 64;
+
+// Whether drawing |picture| with a group opacity, i.e. into a saveLayer that
+// is blended with the opacity, looks the same as applying the opacity to the
+// paint of each of its draw operations.
+//
+// That is the case if no two operations touch the same pixel and if the
+// opacity can be applied to each operation without a layer, which excludes
+// saveLayers, non-src-over blend modes, color and image filters, and
+// operations such as text blobs, vertices and nested pictures that may
+// overlap themselves.
+bool CanApplyGroupOpacity(const SkPicture& picture);
+
+// Plays |picture| back into |canvas|, applying |opacity| to the paint of each
+// of its draw operations. Only draws the same as a saveLayer with |opacity|
+// if |CanApplyGroupOpacity| is true for the picture.
+void DrawPictureWithOpacity(const SkPicture& picture,
+                            SkCanvas* canvas,
+                            SkScalar opacity);
+
+}  // namespace flutter
+
+#endif  // FLUTTER_FLOW_GROUP_OPACITY_H_
@@ -0,0 +1,185 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/group_opacity.h"
+
+#include <functional>
+#include <variant>
+#include <vector>
+
+#include "flutter/testing/mock_canvas.h"
+#include "gtest/gtest.h"
+#include "third_party/skia/include/core/SkBBHFactory.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+sk_sp<SkPicture> RecordPicture(const std::function<void(SkCanvas*)>& draw) {
+  SkPictureRecorder recorder;
+  draw(recorder.beginRecording(SkRect::MakeWH(100, 100)));
+  return recorder.finishRecordingAsPicture();
+}
+
+}  // namespace
+
+TEST(GroupOpacityTest, NonOverlappingOpsCanApplyGroupOpacity) {
+  auto picture = RecordPicture([](SkCanvas* canvas) {
+    canvas->drawRect(SkRect::MakeLTRB(0, 0, 10, 10), SkPaint());
+    canvas->drawOval(SkRect::MakeLTRB(10, 0, 20, 10), SkPaint());
+    canvas->translate(0, 10);
+    canvas->drawRect(SkRect::MakeLTRB(0, 0, 10, 10), SkPaint());
+  });
+  EXPECT_TRUE(CanApplyGroupOpacity(*picture));
+}
+
+TEST(GroupOpacityTest, OverlappingOpsCannotApplyGroupOpacity) {
+  auto picture = RecordPicture([](SkCanvas* canvas) {
+    canvas->drawRect(SkRect::MakeLTRB(0, 0, 10, 10), SkPaint());
+    canvas->translate(5, 5);
+    canvas->drawRect(SkRect::MakeLTRB(0, 0, 10, 10), SkPaint());
+  });
+  EXPECT_FALSE(CanApplyGroupOpacity(*picture));
+}
+
+TEST(GroupOpacityTest, StrokesAreIncludedInTheBounds) {
+  SkPaint stroke;
+  stroke.setStyle(SkPaint::kStroke_Style);
+  stroke.setStrokeWidth(4);
+  auto picture = RecordPicture([&stroke](SkCanvas* canvas) {
+    canvas->drawRect(SkRect::MakeLTRB(0, 0, 10, 10), stroke);
+    canvas->drawRect(SkRect::MakeLTRB(11, 0, 20, 10), stroke);
+  });
+  EXPECT_FALSE(CanApplyGroupOpacity(*picture));
+}
+
+TEST(GroupOpacityTest, OpsThatNeedALayerCannotApplyGroupOpacity) {
+  SkPaint blend_paint;
+  blend_paint.setBlendMode(SkBlendMode::kMultiply);
+  auto blend_picture = RecordPicture([&blend_paint](SkCanvas* canvas) {
+    canvas->drawRect(SkRect::MakeLTRB(0, 0, 10, 10), blend_paint);
+  });
+  EXPECT_FALSE(CanApplyGroupOpacity(*blend_picture));
+
+  auto save_layer_picture = RecordPicture([](SkCanvas* canvas) {
+    canvas->saveLayer(nullptr, nullptr);
+    canvas->drawRect(SkRect::MakeLTRB(0, 0, 10, 10), SkPaint());
+    canvas->drawRect(SkRect::MakeLTRB(20, 20, 30, 30), SkPaint());
+    canvas->restore();
+  });
+  EXPECT_FALSE(CanApplyGroupOpacity(*save_layer_picture));
+
+  // The lines cross each other.
+  const SkPoint points[] = {{0, 0}, {10, 10}, {0, 10}, {10, 0}};
+  auto points_picture = RecordPicture([&points](SkCanvas* canvas) {
+    canvas->drawPoints(SkCanvas::kLines_PointMode, 4, points, SkPaint());
+  });
+  EXPECT_FALSE(CanApplyGroupOpacity(*points_picture));
+}
+
+TEST(GroupOpacityTest, DrawPaintOnlyCombinesWithNothing) {
+  EXPECT_TRUE(CanApplyGroupOpacity(*RecordPicture(
+      [](SkCanvas* canvas) { canvas->drawPaint(SkPaint()); })));
+  EXPECT_FALSE(CanApplyGroupOpacity(*RecordPicture([](SkCanvas* canvas) {
+    canvas->drawPaint(SkPaint());
+    canvas->drawRect(SkRect::MakeLTRB(0, 0, 10, 10), SkPaint());
+  })));
+}
+
+TEST(GroupOpacityTest, LargePicturesAreNotAnalyzed) {
+  auto picture = RecordPicture([](SkCanvas* canvas) {
+    for (int i = 0; i <= kMaxGroupOpacityAnalysisOpCount; i++) {
+      canvas->drawRect(SkRect::MakeXYWH(i * 10, 0, 5, 5), SkPaint());
+    }
+  });
+  EXPECT_FALSE(CanApplyGroupOpacity(*picture));
+}
+
+TEST(GroupOpacityTest, DrawPictureWithOpacityAppliesItToEachPaint) {
+  SkPaint paint(SkColors::kRed);
+  paint.setAlphaf(0.5f);
+  auto picture = RecordPicture([&paint](SkCanvas* canvas) {
+    canvas->drawRect(SkRect::MakeLTRB(0, 0, 10, 10), paint);
+    canvas->drawRect(SkRect::MakeLTRB(20, 0, 30, 10), SkPaint());
+  });
+
+  MockCanvas canvas;
+  DrawPictureWithOpacity(*picture, &canvas, 0.5f);
+
+  SkPaint expected_paint(SkColors::kRed);
+  expected_paint.setAlphaf(0.25f);
+  SkPaint expected_default_paint;
+  expected_default_paint.setAlphaf(0.5f);
+  std::vector<MockCanvas::DrawCall> draw_rect_calls;
+  for (const auto& draw_call : canvas.draw_calls()) {
+    if (std::holds_alternative<MockCanvas::DrawRectData>(draw_call.data)) {
+      draw_rect_calls.push_back(draw_call);
+    }
+  }
+  EXPECT_EQ(draw_rect_calls,
+            std::vector({MockCanvas::DrawCall{
+                             1, MockCanvas::DrawRectData{
+                                    SkRect::MakeLTRB(0, 0, 10, 10),
+                                    expected_paint}},
+                         MockCanvas::DrawCall{
+                             1, MockCanvas::DrawRectData{
+                                    SkRect::MakeLTRB(20, 0, 30, 10),
+                                    expected_default_paint}}}));
+}
+
+TEST(GroupOpacityTest, DrawPictureWithOpacityDrawsOutsideTheCanvasSize) {
+  // Recorded with a bounding box hierarchy, like the pictures of the
+  // framework, so that playback skips the ops outside the local clip bounds.
+  SkRTreeFactory rtree_factory;
+  SkPictureRecorder recorder;
+  SkCanvas* recording_canvas = recorder.beginRecording(
+      SkRect::MakeLTRB(-100, -100, 300, 300), &rtree_factory);
+  recording_canvas->drawRect(SkRect::MakeLTRB(-50, -50, -10, -10),
+                             SkPaint(SkColors::kRed));
+  recording_canvas->drawRect(SkRect::MakeLTRB(150, 150, 190, 190),
+                             SkPaint(SkColors::kBlue));
+  auto picture = recorder.finishRecordingAsPicture();
+
+  // Both rects are outside the 100x100 canvas in the coordinates of the
+  // picture, and inside it once transformed.
+  auto draw = [&picture](bool with_save_layer) {
+    auto surface = SkSurface::MakeRasterN32Premul(100, 100);
+    SkCanvas* canvas = surface->getCanvas();
+    canvas->translate(50, 50);
+    canvas->scale(0.25f, 0.25f);
+    if (with_save_layer) {
+      canvas->saveLayerAlphaf(nullptr, 0.5f);
+      picture->playback(canvas);
+      canvas->restore();
+    } else {
+      DrawPictureWithOpacity(*picture, canvas, 0.5f);
+    }
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(100, 100);
+    surface->readPixels(bitmap, 0, 0);
+    return bitmap;
+  };
+  SkBitmap expected = draw(true);
+  SkBitmap actual = draw(false);
+
+  EXPECT_NE(expected.getColor(42, 42), SK_ColorTRANSPARENT);
+  EXPECT_NE(expected.getColor(92, 92), SK_ColorTRANSPARENT);
+  // The alpha of a saveLayer and of a paint may round differently.
+  for (int y = 0; y < 100; y++) {
+    for (int x = 0; x < 100; x++) {
+      for (int shift : {0, 8, 16, 24}) {
+        ASSERT_NEAR(actual.getColor(x, y) >> shift & 0xFF,
+                    expected.getColor(x, y) >> shift & 0xFF, 1)
+            << "at " << x << ", " << y;
+      }
+    }
+  }
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -4,13 +4,131 @@
 
 #include "flutter/flow/layers/container_layer.h"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <optional>
+#include <thread>
 
 namespace flutter {
 
-ContainerLayer::ContainerLayer() {}
+namespace {
+
+// A ContainerLayer with fewer children prerolls them serially even if
+// |PrerollContext::concurrent_preroll_task_runner| is set.
+constexpr size_t kMinConcurrentPrerollChildren = 2;
+
+// What prerolling a child on a worker thread left in its PrerollContext.
+struct ConcurrentPrerollResult {
+  MutatorsStack mutators_stack;
+  std::vector<std::function<void(PrerollContext*)>> deferred_raster_cache_tasks;
+  bool has_platform_view = false;
+  bool has_texture_layer = false;
+  bool surface_needs_readback = false;
+  bool subtree_can_inherit_opacity = false;
+  bool needs_serial_preroll = false;
+};
+
+// Shared by the raster thread and the worker tasks that preroll the children
+// of a ContainerLayer. Each thread prerolls the next child that no other
+// thread has claimed, until none is left.
+struct ConcurrentPrerollState {
+  explicit ConcurrentPrerollState(size_t p_child_count)
+      : child_count(p_child_count) {}
+
+  const size_t child_count;
+  // Only called for claimed children. Worker tasks that start after the last
+  // child was claimed don't use it, since it refers to the stack of the
+  // raster thread.
+  std::function<void(size_t)> preroll_child;
+  std::atomic<size_t> next_child = 0;
+
+  std::mutex mutex;
+  std::condition_variable all_done;
+  size_t done_count = 0;
+};
+
+void PrerollUnclaimedChildren(ConcurrentPrerollState& state) {
+  size_t prerolled_count = 0;
+  for (size_t index = state.next_child++; index < state.child_count;
+       index = state.next_child++) {
+    state.preroll_child(index);
+    prerolled_count++;
+  }
+  if (prerolled_count == 0) {
+    return;
+  }
+  std::scoped_lock lock(state.mutex);
+  state.done_count += prerolled_count;
+  if (state.done_count == state.child_count) {
+    state.all_done.notify_all();
+  }
+}
 
-#ifdef FLUTTER_ENABLE_DIFF_CONTEXT
+// Prerolls |layers| on the raster thread and on the worker threads of
+// |context->concurrent_preroll_task_runner|. Each layer gets its own copy of
+// |context| and of its mutators stack, so the layers may be prerolled in any
+// order. The raster cache is not modified until the results are merged.
+std::vector<ConcurrentPrerollResult> PrerollConcurrently(
+    PrerollContext* context,
+    const std::vector<std::shared_ptr<Layer>>& layers,
+    const SkMatrix& matrix) {
+  TRACE_EVENT0("flutter", "ContainerLayer::PrerollConcurrently");
+  std::vector<ConcurrentPrerollResult> results(layers.size());
+  auto state = std::make_shared<ConcurrentPrerollState>(layers.size());
+  state->preroll_child = [context, &layers, &matrix, &results](size_t index) {
+    ConcurrentPrerollResult& result = results[index];
+    result.mutators_stack = context->mutators_stack;
+    PrerollContext child_context = {
+        context->raster_cache,
+        context->gr_context,
+        nullptr, /* view_embedder */
+        result.mutators_stack,
+        context->dst_color_space,
+        context->cull_rect,
+        context->surface_needs_readback,
+        context->raster_time,
+        context->ui_time,
+        context->texture_registry,
+        context->checkerboard_offscreen_layers,
+        context->frame_device_pixel_ratio};
+    child_context.has_texture_layer = context->has_texture_layer;
+    child_context.has_opacity_ancestor = context->has_opacity_ancestor;
+    child_context.deferred_raster_cache_tasks =
+        &result.deferred_raster_cache_tasks;
+
+    layers[index]->Preroll(&child_context, matrix);
+
+    result.has_platform_view = child_context.has_platform_view;
+    result.has_texture_layer = child_context.has_texture_layer;
+    result.surface_needs_readback = child_context.surface_needs_readback;
+    result.subtree_can_inherit_opacity =
+        child_context.subtree_can_inherit_opacity;
+    result.needs_serial_preroll = child_context.needs_serial_preroll;
+  };
+
+  // The raster thread prerolls children too, so one task fewer than there
+  // are children is enough.
+  const size_t task_count = std::min<size_t>(
+      layers.size() - 1, std::max(1u, std::thread::hardware_concurrency()));
+  std::vector<fml::closure> tasks;
+  tasks.reserve(task_count);
+  for (size_t i = 0; i < task_count; i++) {
+    tasks.push_back([state] { PrerollUnclaimedChildren(*state); });
+  }
+  context->concurrent_preroll_task_runner->PostTasks(std::move(tasks));
+
+  PrerollUnclaimedChildren(*state);
+  std::unique_lock lock(state->mutex);
+  state->all_done.wait(
+      lock, [&state] { return state->done_count == state->child_count; });
+  return results;
+}
+
+}  // namespace
+
+ContainerLayer::ContainerLayer() {}
 
 void ContainerLayer::Diff(DiffContext* context, const Layer* old_layer) {
   auto old_container = static_cast<const ContainerLayer*>(old_layer);
@@ -104,22 +222,32 @@ void ContainerLayer::DiffChildren(DiffContext* context,
   }
 }
 
-#endif  // FLUTTER_ENABLE_DIFF_CONTEXT
-
 void ContainerLayer::Add(std::shared_ptr<Layer> layer) {
   layers_.emplace_back(std::move(layer));
 }
 
 void ContainerLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
   TRACE_EVENT0("flutter", "ContainerLayer::Preroll");
+  if (TryToReuseSubtreeCache(context, matrix)) {
+    return;
+  }
 
+  bool needs_readback = context->surface_needs_readback;
+  context->surface_needs_readback = false;
   SkRect child_paint_bounds = SkRect::MakeEmpty();
   PrerollChildren(context, matrix, &child_paint_bounds);
   set_paint_bounds(child_paint_bounds);
+
+  TryToPrepareSubtreeCache(context, matrix, context->surface_needs_readback);
+  context->surface_needs_readback |= needs_readback;
+  context->subtree_can_inherit_opacity = children_can_inherit_opacity();
 }
 
 void ContainerLayer::Paint(PaintContext& context) const {
   FML_DCHECK(needs_painting(context));
+  if (TryToDrawSubtreeCache(context)) {
+    return;
+  }
 
   PaintChildren(context);
 }
@@ -140,17 +268,67 @@ void ContainerLayer::PrerollChildren(PrerollContext* context,
   FML_DCHECK(!context->has_platform_view);
   bool child_has_platform_view = false;
   bool child_has_texture_layer = false;
-  for (auto& layer : layers_) {
+  bool children_can_inherit_opacity = !layers_.empty();
+
+  // The children are prerolled concurrently first, and the results are then
+  // merged in order below, as if the children had been prerolled serially.
+  std::vector<ConcurrentPrerollResult> concurrent_results;
+#if defined(LEGACY_FUCHSIA_EMBEDDER)
+  // Whether a layer needs to be system composited depends on the siblings
+  // before it.
+  constexpr bool can_preroll_concurrently = false;
+#else
+  constexpr bool can_preroll_concurrently = true;
+#endif
+  // Children that are prerolled concurrently don't get the task runner, since
+  // a single level usually has enough work for the workers.
+  if (can_preroll_concurrently && context->concurrent_preroll_task_runner &&
+      layers_.size() >= kMinConcurrentPrerollChildren) {
+    concurrent_results = PrerollConcurrently(context, layers_, child_matrix);
+  }
+  const bool had_texture_layer = context->has_texture_layer;
+
+  for (size_t i = 0; i < layers_.size(); i++) {
+    Layer* layer = layers_[i].get();
     // Reset context->has_platform_view to false so that layers aren't treated
     // as if they have a platform view based on one being previously found in a
     // sibling tree.
     context->has_platform_view = false;
-
-    layer->Preroll(context, child_matrix);
+    // Layers that can apply an inherited opacity set this in their Preroll.
+    context->subtree_can_inherit_opacity = false;
+
+    // A child that was prerolled concurrently didn't know whether a sibling
+    // before it has a texture layer, so it is prerolled again if one does.
+    if (!concurrent_results.empty() &&
+        !concurrent_results[i].needs_serial_preroll &&
+        context->has_texture_layer == had_texture_layer) {
+      ConcurrentPrerollResult& result = concurrent_results[i];
+      for (auto& task : result.deferred_raster_cache_tasks) {
+        RunOrDeferRasterCacheTask(context, std::move(task));
+      }
+      context->has_platform_view = result.has_platform_view;
+      context->has_texture_layer = result.has_texture_layer;
+      context->surface_needs_readback |= result.surface_needs_readback;
+      context->subtree_can_inherit_opacity = result.subtree_can_inherit_opacity;
+    } else {
+      // The whole subtree of the child is prerolled on the raster thread.
+      fml::ConcurrentTaskRunner* concurrent_preroll_task_runner =
+          context->concurrent_preroll_task_runner;
+      if (!concurrent_results.empty()) {
+        context->concurrent_preroll_task_runner = nullptr;
+      }
+      layer->Preroll(context, child_matrix);
+      context->concurrent_preroll_task_runner = concurrent_preroll_task_runner;
+    }
 
     if (layer->needs_system_composite()) {
       set_needs_system_composite(true);
     }
+    // Overlapping children would blend with each other if the opacity were
+    // applied to each of them instead of to the group.
+    children_can_inherit_opacity =
+        children_can_inherit_opacity && context->subtree_can_inherit_opacity &&
+        !SkRect::Intersects(*child_paint_bounds, layer->paint_bounds());
     child_paint_bounds->join(layer->paint_bounds());
 
     child_has_platform_view =
@@ -162,6 +340,8 @@ void ContainerLayer::PrerollChildren(PrerollContext* context,
   context->has_platform_view = child_has_platform_view;
   context->has_texture_layer = child_has_texture_layer;
   set_subtree_has_platform_view(child_has_platform_view);
+  context->subtree_can_inherit_opacity = false;
+  children_can_inherit_opacity_ = children_can_inherit_opacity;
 
 #if defined(LEGACY_FUCHSIA_EMBEDDER)
   if (child_layer_exists_below_) {
@@ -194,10 +374,81 @@ void ContainerLayer::TryToPrepareRasterCache(PrerollContext* context,
   if (!context->has_platform_view && !context->has_texture_layer &&
       context->raster_cache &&
       SkRect::Intersects(context->cull_rect, layer->paint_bounds())) {
-    context->raster_cache->Prepare(context, layer, matrix);
+    RunOrDeferRasterCacheTask(
+        context, [layer, matrix](PrerollContext* raster_context) {
+          raster_context->raster_cache->Prepare(raster_context, layer, matrix);
+        });
   }
 }
 
+static SkMatrix GetSubtreeCacheMatrix(const SkMatrix& matrix) {
+#ifndef SUPPORT_FRACTIONAL_TRANSLATION
+  return RasterCache::GetIntegralTransCTM(matrix);
+#else
+  return matrix;
+#endif
+}
+
+bool ContainerLayer::TryToReuseSubtreeCache(PrerollContext* context,
+                                            const SkMatrix& matrix) {
+  const SkMatrix cache_matrix = GetSubtreeCacheMatrix(matrix);
+  if (!context->raster_cache || !CanCacheSubtree()) {
+    subtree_cached_ = false;
+  } else if (context->deferred_raster_cache_tasks) {
+    subtree_cached_ = context->raster_cache->HasSubtree(this, cache_matrix);
+    if (subtree_cached_) {
+      RunOrDeferRasterCacheTask(
+          context, [this, cache_matrix](PrerollContext* raster_context) {
+            raster_context->raster_cache->TouchSubtree(this, cache_matrix);
+          });
+    }
+  } else {
+    subtree_cached_ = context->raster_cache->TouchSubtree(this, cache_matrix);
+  }
+  if (subtree_cached_) {
+    context->subtree_can_inherit_opacity = true;
+  }
+  return subtree_cached_;
+}
+
+void ContainerLayer::TryToPrepareSubtreeCache(PrerollContext* context,
+                                              const SkMatrix& matrix,
+                                              bool subtree_needs_readback) {
+  if (!context->raster_cache ||
+      !context->raster_cache->subtree_caching_enabled() || !CanCacheSubtree()) {
+    return;
+  }
+  // Subtrees that are partially culled are not cached, since the cache would
+  // hold pixels that are not visible.
+  if (context->has_platform_view || context->has_texture_layer ||
+      subtree_needs_readback || needs_system_composite() ||
+      paint_bounds().isEmpty() ||
+      !context->cull_rect.contains(paint_bounds())) {
+    return;
+  }
+  subtree_cached_ = false;
+  RunOrDeferRasterCacheTask(
+      context, [this, cache_matrix = GetSubtreeCacheMatrix(matrix)](
+                   PrerollContext* raster_context) {
+        subtree_cached_ = raster_context->raster_cache->PrepareSubtree(
+            raster_context, this, cache_matrix);
+      });
+}
+
+bool ContainerLayer::TryToDrawSubtreeCache(PaintContext& context) const {
+  if (!subtree_cached_ || !context.raster_cache) {
+    return false;
+  }
+  SkAutoCanvasRestore save(context.internal_nodes_canvas, true);
+  context.internal_nodes_canvas->setMatrix(GetSubtreeCacheMatrix(
+      context.leaf_nodes_canvas->getTotalMatrix()));
+  SkPaint paint;
+  paint.setAlphaf(context.inherited_opacity);
+  return context.raster_cache->Draw(
+      this, *context.leaf_nodes_canvas,
+      context.inherited_opacity < SK_Scalar1 ? &paint : nullptr);
+}
+
 #if defined(LEGACY_FUCHSIA_EMBEDDER)
 
 void ContainerLayer::CheckForChildLayerBelow(PrerollContext* context) {
@@ -229,6 +480,24 @@ void ContainerLayer::UpdateSceneChildren(
 
 #endif
 
+namespace {
+
+// The implicit child container of a MergedContainerLayer. The parent caches
+// the rendering of its children itself, so the container is never cached as a
+// subtree as well.
+class MergedChildContainerLayer : public ContainerLayer {
+ public:
+  MergedChildContainerLayer() = default;
+
+ protected:
+  bool CanCacheSubtree() const override { return false; }
+
+ private:
+  FML_DISALLOW_COPY_AND_ASSIGN(MergedChildContainerLayer);
+};
+
+}  // namespace
+
 MergedContainerLayer::MergedContainerLayer() {
   // Ensure the layer has only one direct child.
   //
@@ -239,7 +508,7 @@ MergedContainerLayer::MergedContainerLayer() {
   // If multiple child layers are added, then this implicit container
   // child becomes the cacheable child, but at the potential cost of
   // not being as stable in the raster cache from frame to frame.
-  ContainerLayer::Add(std::make_shared<ContainerLayer>());
+  ContainerLayer::Add(std::make_shared<MergedChildContainerLayer>());
 }
 
 void MergedContainerLayer::AssignOldLayer(Layer* old_layer) {
@@ -15,13 +15,9 @@ class ContainerLayer : public Layer {
  public:
   ContainerLayer();
 
-#ifdef FLUTTER_ENABLE_DIFF_CONTEXT
-
   void Diff(DiffContext* context, const Layer* old_layer) override;
   void PreservePaintRegion(DiffContext* context) override;
 
-#endif  // FLUTTER_ENABLE_DIFF_CONTEXT
-
   virtual void Add(std::shared_ptr<Layer> layer);
 
   void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
@@ -34,17 +30,26 @@ class ContainerLayer : public Layer {
   const std::vector<std::shared_ptr<Layer>>& layers() const { return layers_; }
 
  protected:
-#ifdef FLUTTER_ENABLE_DIFF_CONTEXT
 
   void DiffChildren(DiffContext* context, const ContainerLayer* old_layer);
 
-#endif  // FLUTTER_ENABLE_DIFF_CONTEXT
-
   void PrerollChildren(PrerollContext* context,
                        const SkMatrix& child_matrix,
                        SkRect* child_paint_bounds);
   void PaintChildren(PaintContext& context) const;
 
+  // Whether, in the last PrerollChildren, every child reported that it can
+  // apply an inherited opacity and no two children overlap, so that painting
+  // the children with |PaintContext::inherited_opacity| looks the same as
+  // painting them into a saveLayer with that opacity.
+  //
+  // PrerollChildren itself leaves |PrerollContext::subtree_can_inherit_opacity|
+  // false. Layers that pass the inherited opacity on to their children report
+  // this value in their Preroll.
+  bool children_can_inherit_opacity() const {
+    return children_can_inherit_opacity_;
+  }
+
 #if defined(LEGACY_FUCHSIA_EMBEDDER)
   void UpdateSceneChildren(std::shared_ptr<SceneUpdateContext> context);
 #endif
@@ -63,8 +68,37 @@ class ContainerLayer : public Layer {
                                       Layer* layer,
                                       const SkMatrix& matrix);
 
+  // Subtree caching lets a plain ContainerLayer or TransformLayer that the
+  // framework retains across frames draw itself from the raster cache. The
+  // layer is the same object in each frame, so it renders the same as long as
+  // its ancestors only translate it. (See also
+  // RasterCache::SetSubtreeCachingEnabled.)
+  //
+  // Call at the start of Preroll. Returns true if the subtree has been
+  // rasterized already, in which case the paint bounds of the previous frame
+  // are still valid and the children don't need to be prerolled. The cached
+  // subtree can inherit opacity.
+  bool TryToReuseSubtreeCache(PrerollContext* context, const SkMatrix& matrix);
+
+  // Call at the end of Preroll, after restoring the cull rect of the parent.
+  // |subtree_needs_readback| tells whether any of the children reads back the
+  // surface, which prevents caching.
+  void TryToPrepareSubtreeCache(PrerollContext* context,
+                                const SkMatrix& matrix,
+                                bool subtree_needs_readback);
+
+  // Call at the start of Paint. Returns true if the subtree was drawn from the
+  // raster cache, with the inherited opacity of |context|.
+  bool TryToDrawSubtreeCache(PaintContext& context) const;
+
+  // Whether this layer may be cached as a subtree at all.
+  virtual bool CanCacheSubtree() const { return true; }
+
  private:
   std::vector<std::shared_ptr<Layer>> layers_;
+  // Whether the last Preroll prepared the subtree cache.
+  bool subtree_cached_ = false;
+  bool children_can_inherit_opacity_ = false;
 
   FML_DISALLOW_COPY_AND_ASSIGN(ContainerLayer);
 };
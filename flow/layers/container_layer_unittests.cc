@@ -4,11 +4,18 @@
 
 #include "flutter/flow/layers/container_layer.h"
 
+#include <algorithm>
+#include <variant>
+#include <vector>
+
+#include "flutter/flow/layers/picture_layer.h"
 #include "flutter/flow/testing/diff_context_test.h"
 #include "flutter/flow/testing/layer_test.h"
 #include "flutter/flow/testing/mock_layer.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/macros.h"
 #include "flutter/testing/mock_canvas.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
 
 namespace flutter {
 namespace testing {
@@ -269,7 +276,190 @@ TEST_F(ContainerLayerTest, MergedMultipleChildren) {
                                                child_path2, child_paint2}}}));
 }
 
-#ifdef FLUTTER_ENABLE_DIFF_CONTEXT
+static size_t CountDrawPathCalls(const MockCanvas& canvas) {
+  return std::count_if(canvas.draw_calls().begin(), canvas.draw_calls().end(),
+                       [](const MockCanvas::DrawCall& call) {
+                         return std::holds_alternative<
+                             MockCanvas::DrawPathData>(call.data);
+                       });
+}
+
+TEST_F(ContainerLayerTest, RetainedSubtreeIsCached) {
+  SkPath child_path;
+  child_path.addRect(5.0f, 6.0f, 20.5f, 21.5f);
+  auto mock_layer = std::make_shared<MockLayer>(child_path);
+  auto layer = std::make_shared<ContainerLayer>();
+  layer->Add(mock_layer);
+
+  use_mock_raster_cache();
+  raster_cache()->SetSubtreeCachingEnabled(true);
+  const auto& statistics = raster_cache()->subtree_cache_statistics();
+
+  // The children are painted until the layer has been retained for enough
+  // frames.
+  for (int i = 0; i < 2; i++) {
+    layer->Preroll(preroll_context(), SkMatrix::I());
+    EXPECT_EQ(statistics.misses, 1u);
+    layer->Paint(paint_context());
+    raster_cache()->SweepAfterFrame();
+  }
+  EXPECT_EQ(CountDrawPathCalls(mock_canvas()), 2u);
+
+  // The third frame rasterizes the subtree and draws the cache.
+  layer->Preroll(preroll_context(), SkMatrix::I());
+  EXPECT_EQ(statistics.rasterized, 1u);
+  EXPECT_EQ(raster_cache()->GetLayerCachedEntriesCount(), 1u);
+  layer->Paint(paint_context());
+  EXPECT_EQ(CountDrawPathCalls(mock_canvas()), 2u);
+  raster_cache()->SweepAfterFrame();
+
+  // Translating the layer draws the cache without prerolling the children.
+  const SkMatrix translation = SkMatrix::Translate(10.0f, 20.0f);
+  layer->Preroll(preroll_context(), translation);
+  EXPECT_EQ(statistics.hits, 1u);
+  EXPECT_EQ(mock_layer->parent_matrix(), SkMatrix::I());
+  EXPECT_EQ(layer->paint_bounds(), child_path.getBounds());
+  layer->Paint(paint_context());
+  EXPECT_EQ(CountDrawPathCalls(mock_canvas()), 2u);
+  raster_cache()->SweepAfterFrame();
+
+  // Scaling the layer prerolls the children again.
+  const SkMatrix scale = SkMatrix::Scale(2.0f, 2.0f);
+  layer->Preroll(preroll_context(), scale);
+  EXPECT_EQ(statistics.hits, 0u);
+  EXPECT_EQ(mock_layer->parent_matrix(), scale);
+}
+
+TEST_F(ContainerLayerTest, SubtreeCachingIsDisabledByDefault) {
+  SkPath child_path;
+  child_path.addRect(5.0f, 6.0f, 20.5f, 21.5f);
+  auto mock_layer = std::make_shared<MockLayer>(child_path);
+  auto layer = std::make_shared<ContainerLayer>();
+  layer->Add(mock_layer);
+
+  use_mock_raster_cache();
+  for (int i = 0; i < 3; i++) {
+    layer->Preroll(preroll_context(), SkMatrix::I());
+    layer->Paint(paint_context());
+    raster_cache()->SweepAfterFrame();
+  }
+  EXPECT_EQ(raster_cache()->GetLayerCachedEntriesCount(), 0u);
+  EXPECT_EQ(CountDrawPathCalls(mock_canvas()), 3u);
+}
+
+TEST_F(ContainerLayerTest, SubtreeReadingBackSurfaceIsNotCached) {
+  SkPath child_path;
+  child_path.addRect(5.0f, 6.0f, 20.5f, 21.5f);
+  auto mock_layer = std::make_shared<MockLayer>(
+      child_path, SkPaint(), false /* fake_has_platform_view */,
+      false /* fake_needs_system_composite */, true /* fake_reads_surface */);
+  auto layer = std::make_shared<ContainerLayer>();
+  layer->Add(mock_layer);
+
+  use_mock_raster_cache();
+  raster_cache()->SetSubtreeCachingEnabled(true);
+  for (int i = 0; i < 3; i++) {
+    preroll_context()->surface_needs_readback = false;
+    layer->Preroll(preroll_context(), SkMatrix::I());
+    EXPECT_TRUE(preroll_context()->surface_needs_readback);
+    raster_cache()->SweepAfterFrame();
+  }
+  EXPECT_EQ(raster_cache()->GetLayerCachedEntriesCount(), 0u);
+}
+
+TEST_F(ContainerLayerTest, PartiallyCulledSubtreeIsNotCached) {
+  SkPath child_path;
+  child_path.addRect(5.0f, 6.0f, 20.5f, 21.5f);
+  auto mock_layer = std::make_shared<MockLayer>(child_path);
+  auto layer = std::make_shared<ContainerLayer>();
+  layer->Add(mock_layer);
+
+  use_mock_raster_cache();
+  raster_cache()->SetSubtreeCachingEnabled(true);
+  preroll_context()->cull_rect = SkRect::MakeLTRB(0.0f, 0.0f, 10.0f, 10.0f);
+  for (int i = 0; i < 3; i++) {
+    layer->Preroll(preroll_context(), SkMatrix::I());
+    raster_cache()->SweepAfterFrame();
+  }
+  EXPECT_EQ(raster_cache()->GetLayerCachedEntriesCount(), 0u);
+}
+
+TEST_F(ContainerLayerTest, ConcurrentPrerollMergesChildrenInOrder) {
+  SkPath child_path1;
+  child_path1.addRect(5.0f, 6.0f, 20.5f, 21.5f);
+  SkPath child_path2;
+  child_path2.addRect(21.0f, 6.0f, 30.5f, 21.5f);
+  SkPath child_path3;
+  child_path3.addRect(8.0f, 2.0f, 16.5f, 14.5f);
+  auto mock_layer1 = std::make_shared<MockLayer>(child_path1);
+  auto mock_layer2 = std::make_shared<MockLayer>(
+      child_path2, SkPaint(), true /* fake_has_platform_view */);
+  auto mock_layer3 = std::make_shared<MockLayer>(
+      child_path3, SkPaint(), false /* fake_has_platform_view */,
+      false /* fake_needs_system_composite */, true /* fake_reads_surface */);
+  auto layer = std::make_shared<ContainerLayer>();
+  layer->Add(mock_layer1);
+  layer->Add(mock_layer2);
+  layer->Add(mock_layer3);
+
+  auto loop = fml::ConcurrentMessageLoop::Create(2);
+  auto task_runner = loop->GetTaskRunner();
+  preroll_context()->concurrent_preroll_task_runner = task_runner.get();
+  const SkMatrix matrix = SkMatrix::Translate(3.0f, 4.0f);
+  const SkRect cull_rect = SkRect::MakeLTRB(0.0f, 0.0f, 100.0f, 100.0f);
+  preroll_context()->cull_rect = cull_rect;
+  preroll_context()->mutators_stack.PushTransform(matrix);
+  layer->Preroll(preroll_context(), matrix);
+
+  SkRect expected_paint_bounds = child_path1.getBounds();
+  expected_paint_bounds.join(child_path2.getBounds());
+  expected_paint_bounds.join(child_path3.getBounds());
+  EXPECT_EQ(layer->paint_bounds(), expected_paint_bounds);
+  EXPECT_TRUE(preroll_context()->has_platform_view);
+  EXPECT_TRUE(preroll_context()->surface_needs_readback);
+  EXPECT_TRUE(layer->subtree_has_platform_view());
+  EXPECT_EQ(preroll_context()->cull_rect, cull_rect);
+  for (const auto& mock_layer : {mock_layer1, mock_layer2, mock_layer3}) {
+    EXPECT_EQ(mock_layer->parent_matrix(), matrix);
+    EXPECT_EQ(mock_layer->parent_cull_rect(), cull_rect);
+    EXPECT_EQ(mock_layer->parent_mutators(), preroll_context()->mutators_stack);
+    EXPECT_FALSE(mock_layer->parent_has_platform_view());
+  }
+}
+
+TEST_F(ContainerLayerTest, ConcurrentPrerollPreparesRasterCacheInOrder) {
+  const SkRect rect = SkRect::MakeLTRB(0.0f, 0.0f, 10.0f, 10.0f);
+  std::vector<sk_sp<SkPicture>> pictures;
+  auto layer = std::make_shared<ContainerLayer>();
+  for (int i = 0; i < 8; i++) {
+    SkPictureRecorder recorder;
+    recorder.beginRecording(rect)->drawRect(rect, SkPaint());
+    pictures.push_back(recorder.finishRecordingAsPicture());
+    layer->Add(std::make_shared<PictureLayer>(
+        SkPoint(), SkiaGPUObject<SkPicture>(pictures.back(), nullptr),
+        true /* is_complex */, false /* will_change */));
+  }
+
+  auto loop = fml::ConcurrentMessageLoop::Create(4);
+  auto task_runner = loop->GetTaskRunner();
+  preroll_context()->concurrent_preroll_task_runner = task_runner.get();
+  use_mock_raster_cache();
+  for (size_t i = 0; i < 3; i++) {
+    layer->Preroll(preroll_context(), SkMatrix::I());
+    EXPECT_EQ(raster_cache()->GetPictureCachedEntriesCount(), pictures.size());
+    if (i < 2) {
+      raster_cache()->SweepAfterFrame();
+    }
+  }
+
+  // As in a serial preroll, the pictures that are prepared first in the third
+  // frame are cached, up to the per frame limit.
+  for (size_t i = 0; i < pictures.size(); i++) {
+    EXPECT_EQ(raster_cache()->Draw(*pictures[i], mock_canvas()),
+              i < RasterCache::kDefaultPictureCacheLimitPerFrame)
+        << "picture " << i;
+  }
+}
 
 using ContainerLayerDiffTest = DiffContextTest;
 
@@ -474,7 +664,5 @@ TEST_F(ContainerLayerDiffTest, ReplaceLayer) {
   EXPECT_EQ(damage.frame_damage, SkIRect::MakeLTRB(200, 0, 250, 150));
 }
 
-#endif
-
 }  // namespace testing
 }  // namespace flutter
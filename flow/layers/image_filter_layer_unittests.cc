@@ -335,8 +335,6 @@ TEST_F(ImageFilterLayerTest, ChildrenNotCached) {
   EXPECT_FALSE(raster_cache()->Draw(mock_layer2.get(), cache_canvas));
 }
 
-#ifdef FLUTTER_ENABLE_DIFF_CONTEXT
-
 using ImageFilterLayerDiffTest = DiffContextTest;
 
 TEST_F(ImageFilterLayerDiffTest, ImageFilterLayer) {
@@ -385,7 +383,5 @@ TEST_F(ImageFilterLayerDiffTest, ImageFilterLayer) {
   EXPECT_EQ(damage.frame_damage, SkIRect::MakeLTRB(130, 130, 280, 280));
 }
 
-#endif
-
 }  // namespace testing
 }  // namespace flutter
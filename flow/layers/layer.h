@@ -5,7 +5,9 @@
 #ifndef FLUTTER_FLOW_LAYERS_LAYER_H_
 #define FLUTTER_FLOW_LAYERS_LAYER_H_
 
+#include <functional>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "flutter/common/graphics/texture.h"
@@ -15,6 +17,7 @@
 #include "flutter/flow/raster_cache.h"
 #include "flutter/fml/build_config.h"
 #include "flutter/fml/compiler_specific.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/logging.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/trace_event.h"
@@ -72,8 +75,50 @@ struct PrerollContext {
   // These allow us to track properties like elevation, opacity, and the
   // prescence of a texture layer during Preroll.
   bool has_texture_layer = false;
+
+  // Set by a layer during Preroll if it can apply an opacity inherited from
+  // an ancestor to everything it draws (see |PaintContext::inherited_opacity|),
+  // so that an ancestor OpacityLayer doesn't need a saveLayer. Parents reset it
+  // before prerolling each child.
+  bool subtree_can_inherit_opacity = false;
+
+  // Set while the descendants of an OpacityLayer are prerolled. Layers only
+  // work out |subtree_can_inherit_opacity| when it is set, since otherwise
+  // there is no opacity to inherit.
+  bool has_opacity_ancestor = false;
+
+  // If set, ContainerLayers preroll their children concurrently on this task
+  // runner. (See also CompositorContext::SetConcurrentPrerollTaskRunner.)
+  fml::ConcurrentTaskRunner* concurrent_preroll_task_runner = nullptr;
+
+  // Set while the layer is prerolled on a worker thread, concurrently with its
+  // siblings. The raster cache must then only be read. Operations that modify
+  // it are appended here with |RunOrDeferRasterCacheTask| and run on the
+  // raster thread, in order, once the siblings are prerolled.
+  std::vector<std::function<void(PrerollContext*)>>*
+      deferred_raster_cache_tasks = nullptr;
+
+  // Set by layers that can only be prerolled on the raster thread, such as
+  // platform views, if |deferred_raster_cache_tasks| is set. The child of the
+  // ContainerLayer that prerolled the layer concurrently is then prerolled
+  // again on the raster thread.
+  bool needs_serial_preroll = false;
 };
 
+// Runs |task| with |context|, or defers it if the layer is being prerolled
+// concurrently with its siblings (see
+// |PrerollContext::deferred_raster_cache_tasks|). The task must use the
+// PrerollContext that it is given, since it may run after |context| is gone.
+template <typename Task>
+void RunOrDeferRasterCacheTask(PrerollContext* context, Task&& task) {
+  if (context->deferred_raster_cache_tasks) {
+    context->deferred_raster_cache_tasks->emplace_back(
+        std::forward<Task>(task));
+  } else {
+    task(context);
+  }
+}
+
 class PictureLayer;
 class PerformanceOverlayLayer;
 class TextureLayer;
@@ -89,8 +134,6 @@ class Layer {
     original_layer_id_ = old_layer->original_layer_id_;
   }
 
-#ifdef FLUTTER_ENABLE_DIFF_CONTEXT
-
   // Used to establish link between old layer and new layer that replaces it.
   // If this method returns true, it is assumed that this layer replaces the old
   // layer in tree and is able to diff with it.
@@ -110,8 +153,6 @@ class Layer {
     context->SetLayerPaintRegion(this, context->GetOldLayerPaintRegion(this));
   }
 
-#endif  // FLUTTER_ENABLE_DIFF_CONTEXT
-
   virtual void Preroll(PrerollContext* context, const SkMatrix& matrix);
 
   // Used during Preroll by layers that employ a saveLayer to manage the
@@ -161,6 +202,10 @@ class Layer {
     const RasterCache* raster_cache;
     const bool checkerboard_offscreen_layers;
     const float frame_device_pixel_ratio;
+
+    // The opacity that a layer which reported |subtree_can_inherit_opacity|
+    // during Preroll applies to everything it draws.
+    SkScalar inherited_opacity = SK_Scalar1;
   };
 
   // Calls SkCanvas::saveLayer and restores the layer upon destruction. Also
@@ -258,8 +303,6 @@ class Layer {
 
   uint64_t unique_id() const { return unique_id_; }
 
-#ifdef FLUTTER_ENABLE_DIFF_CONTEXT
-
   virtual const PictureLayer* as_picture_layer() const { return nullptr; }
   virtual const TextureLayer* as_texture_layer() const { return nullptr; }
   virtual const PerformanceOverlayLayer* as_performance_overlay_layer() const {
@@ -267,8 +310,6 @@ class Layer {
   }
   virtual const testing::MockLayer* as_mock_layer() const { return nullptr; }
 
-#endif  // FLUTTER_ENABLE_DIFF_CONTEXT
-
  protected:
 #if defined(LEGACY_FUCHSIA_EMBEDDER)
   bool child_layer_exists_below_ = false;
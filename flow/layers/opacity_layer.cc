@@ -12,8 +12,6 @@ namespace flutter {
 OpacityLayer::OpacityLayer(SkAlpha alpha, const SkPoint& offset)
     : alpha_(alpha), offset_(offset) {}
 
-#ifdef FLUTTER_ENABLE_DIFF_CONTEXT
-
 void OpacityLayer::Diff(DiffContext* context, const Layer* old_layer) {
   DiffContext::AutoSubtreeRestore subtree(context);
   auto* prev = static_cast<const OpacityLayer*>(old_layer);
@@ -28,8 +26,6 @@ void OpacityLayer::Diff(DiffContext* context, const Layer* old_layer) {
   context->SetLayerPaintRegion(this, context->CurrentSubtreeRegion());
 }
 
-#endif  // FLUTTER_ENABLE_DIFF_CONTEXT
-
 void OpacityLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
   TRACE_EVENT0("flutter", "OpacityLayer::Preroll");
   FML_DCHECK(!GetChildContainer()->layers().empty());  // We can't be a leaf.
@@ -46,7 +42,12 @@ void OpacityLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
   context->mutators_stack.PushOpacity(alpha_);
   Layer::AutoPrerollSaveLayerState save =
       Layer::AutoPrerollSaveLayerState::Create(context);
-  ContainerLayer::Preroll(context, child_matrix);
+  SkRect child_paint_bounds = SkRect::MakeEmpty();
+  const bool has_opacity_ancestor = context->has_opacity_ancestor;
+  context->has_opacity_ancestor = true;
+  PrerollChildren(context, child_matrix, &child_paint_bounds);
+  context->has_opacity_ancestor = has_opacity_ancestor;
+  set_paint_bounds(child_paint_bounds);
   context->mutators_stack.Pop();
   context->mutators_stack.Pop();
 
@@ -60,6 +61,10 @@ void OpacityLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
 
   // Restore cull_rect
   context->cull_rect = context->cull_rect.makeOffset(offset_.fX, offset_.fY);
+
+  // An inherited opacity is combined with the opacity of this layer, whether
+  // that is applied by the raster cache, the saveLayer or the children.
+  context->subtree_can_inherit_opacity = true;
 }
 
 void OpacityLayer::Paint(PaintContext& context) const {
@@ -68,6 +73,7 @@ void OpacityLayer::Paint(PaintContext& context) const {
 
   SkPaint paint;
   paint.setAlpha(alpha_);
+  paint.setAlphaf(paint.getAlphaf() * context.inherited_opacity);
 
   SkAutoCanvasRestore save(context.internal_nodes_canvas, true);
   context.internal_nodes_canvas->translate(offset_.fX, offset_.fY);
@@ -83,6 +89,16 @@ void OpacityLayer::Paint(PaintContext& context) const {
     return;
   }
 
+  const SkScalar inherited_opacity = context.inherited_opacity;
+  if (children_can_inherit_opacity()) {
+    // The children don't overlap each other and apply the opacity to what
+    // they draw, so no offscreen layer is needed.
+    context.inherited_opacity = paint.getAlphaf();
+    PaintChildren(context);
+    context.inherited_opacity = inherited_opacity;
+    return;
+  }
+
   // Skia may clip the content with saveLayerBounds (although it's not a
   // guaranteed clip). So we have to provide a big enough saveLayerBounds. To do
   // so, we first remove the offset from paint bounds since it's already in the
@@ -90,7 +106,7 @@ void OpacityLayer::Paint(PaintContext& context) const {
   //
   // Note that the following lines are only accessible when the raster cache is
   // not available (e.g., when we're using the software backend in golden
-  // tests).
+  // tests) and the children can't inherit the opacity.
   SkRect saveLayerBounds;
   paint_bounds()
       .makeOffset(-offset_.fX, -offset_.fY)
@@ -98,7 +114,9 @@ void OpacityLayer::Paint(PaintContext& context) const {
 
   Layer::AutoSaveLayer save_layer =
       Layer::AutoSaveLayer::Create(context, saveLayerBounds, &paint);
+  context.inherited_opacity = SK_Scalar1;
   PaintChildren(context);
+  context.inherited_opacity = inherited_opacity;
 }
 
 #if defined(LEGACY_FUCHSIA_EMBEDDER)
@@ -5,10 +5,12 @@
 #include "flutter/flow/layers/opacity_layer.h"
 
 #include "flutter/flow/layers/clip_rect_layer.h"
+#include "flutter/flow/layers/picture_layer.h"
 #include "flutter/flow/testing/layer_test.h"
 #include "flutter/flow/testing/mock_layer.h"
 #include "flutter/fml/macros.h"
 #include "flutter/testing/mock_canvas.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
 
 namespace flutter {
 namespace testing {
@@ -136,6 +138,31 @@ TEST_F(OpacityLayerTest, ChildrenNotCached) {
   EXPECT_FALSE(raster_cache()->Draw(mock_layer2.get(), cache_canvas));
 }
 
+TEST_F(OpacityLayerTest, ChildContainerIsNotCachedAsSubtree) {
+  const SkAlpha alpha_half = 255 / 2;
+  const SkPath child_path1 = SkPath().addRect(SkRect::MakeWH(5.0f, 5.0f));
+  const SkPath child_path2 = SkPath().addRect(SkRect::MakeWH(5.0f, 5.0f));
+  auto mock_layer1 = std::make_shared<MockLayer>(child_path1);
+  auto mock_layer2 = std::make_shared<MockLayer>(child_path2);
+  auto layer =
+      std::make_shared<OpacityLayer>(alpha_half, SkPoint::Make(0.0f, 0.0f));
+  layer->Add(mock_layer1);
+  layer->Add(mock_layer2);
+
+  use_mock_raster_cache();
+  raster_cache()->SetSubtreeCachingEnabled(true);
+  const auto& statistics = raster_cache()->subtree_cache_statistics();
+
+  // The opacity layer caches its children, so the container that holds them
+  // is never prepared for subtree caching.
+  for (int i = 0; i < 3; i++) {
+    layer->Preroll(preroll_context(), SkMatrix::I());
+    EXPECT_EQ(statistics.misses, 0u);
+    EXPECT_EQ(statistics.rasterized, 0u);
+    raster_cache()->SweepAfterFrame();
+  }
+}
+
 TEST_F(OpacityLayerTest, FullyOpaque) {
   const SkPath child_path = SkPath().addRect(SkRect::MakeWH(5.0f, 5.0f));
   const SkPoint layer_offset = SkPoint::Make(0.5f, 1.5f);
@@ -427,5 +454,64 @@ TEST_F(OpacityLayerTest, CullRectIsTransformed) {
   EXPECT_EQ(mockLayer->parent_cull_rect().fTop, -20);
 }
 
+static std::shared_ptr<PictureLayer> CreateRectPictureLayer(
+    const SkRect& rect) {
+  SkPictureRecorder recorder;
+  recorder.beginRecording(rect)->drawRect(rect, SkPaint());
+  return std::make_shared<PictureLayer>(
+      SkPoint(),
+      SkiaGPUObject<SkPicture>(recorder.finishRecordingAsPicture(), nullptr),
+      false, false);
+}
+
+TEST_F(OpacityLayerTest, NonOverlappingPicturesInheritOpacity) {
+  const SkAlpha alpha_half = 255 / 2;
+  auto layer = std::make_shared<OpacityLayer>(alpha_half, SkPoint());
+  layer->Add(CreateRectPictureLayer(SkRect::MakeLTRB(0, 0, 10, 10)));
+  layer->Add(CreateRectPictureLayer(SkRect::MakeLTRB(20, 0, 30, 10)));
+
+  layer->Preroll(preroll_context(), SkMatrix());
+  layer->Paint(paint_context());
+
+  SkPaint opacity_paint;
+  opacity_paint.setAlpha(alpha_half);
+  SkPaint expected_paint;
+  expected_paint.setAlphaf(opacity_paint.getAlphaf());
+  int draw_rect_count = 0;
+  for (const auto& draw_call : mock_canvas().draw_calls()) {
+    EXPECT_FALSE(
+        std::holds_alternative<MockCanvas::SaveLayerData>(draw_call.data));
+    if (auto* draw_rect =
+            std::get_if<MockCanvas::DrawRectData>(&draw_call.data)) {
+      EXPECT_EQ(draw_rect->paint, expected_paint);
+      draw_rect_count++;
+    }
+  }
+  EXPECT_EQ(draw_rect_count, 2);
+  EXPECT_EQ(paint_context().inherited_opacity, SK_Scalar1);
+}
+
+TEST_F(OpacityLayerTest, OverlappingPicturesAreDrawnIntoASaveLayer) {
+  const SkAlpha alpha_half = 255 / 2;
+  auto layer = std::make_shared<OpacityLayer>(alpha_half, SkPoint());
+  layer->Add(CreateRectPictureLayer(SkRect::MakeLTRB(0, 0, 10, 10)));
+  layer->Add(CreateRectPictureLayer(SkRect::MakeLTRB(5, 0, 15, 10)));
+
+  layer->Preroll(preroll_context(), SkMatrix());
+  layer->Paint(paint_context());
+
+  int save_layer_count = 0;
+  for (const auto& draw_call : mock_canvas().draw_calls()) {
+    if (std::holds_alternative<MockCanvas::SaveLayerData>(draw_call.data)) {
+      save_layer_count++;
+    }
+    if (auto* draw_rect =
+            std::get_if<MockCanvas::DrawRectData>(&draw_call.data)) {
+      EXPECT_EQ(draw_rect->paint, SkPaint());
+    }
+  }
+  EXPECT_EQ(save_layer_count, 1);
+}
+
 }  // namespace testing
 }  // namespace flutter
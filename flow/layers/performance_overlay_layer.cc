@@ -14,6 +14,15 @@
 namespace flutter {
 namespace {
 
+SkFont MakeStatisticsFont(const std::string& font_path) {
+  SkFont font;
+  if (font_path != "") {
+    font = SkFont(SkTypeface::MakeFromFile(font_path.c_str()));
+  }
+  font.setSize(15);
+  return font;
+}
+
 void VisualizeStopWatch(SkCanvas* canvas,
                         const Stopwatch& stopwatch,
                         SkScalar x,
@@ -47,11 +56,7 @@ sk_sp<SkTextBlob> PerformanceOverlayLayer::MakeStatisticsText(
     const Stopwatch& stopwatch,
     const std::string& label_prefix,
     const std::string& font_path) {
-  SkFont font;
-  if (font_path != "") {
-    font = SkFont(SkTypeface::MakeFromFile(font_path.c_str()));
-  }
-  font.setSize(15);
+  SkFont font = MakeStatisticsFont(font_path);
 
   double max_ms_per_frame = stopwatch.MaxDelta().ToMillisecondsF();
   double average_ms_per_frame = stopwatch.AverageDelta().ToMillisecondsF();
@@ -66,6 +71,19 @@ sk_sp<SkTextBlob> PerformanceOverlayLayer::MakeStatisticsText(
                                   SkTextEncoding::kUTF8);
 }
 
+sk_sp<SkTextBlob> PerformanceOverlayLayer::MakeSubtreeCacheText(
+    const RasterCache::SubtreeCacheStatistics& statistics,
+    const std::string& font_path) {
+  std::stringstream stream;
+  stream << "Subtree cache  " << statistics.hits << " hits, "
+         << statistics.misses << " misses, " << statistics.rasterized
+         << " rasterized";
+  auto text = stream.str();
+  return SkTextBlob::MakeFromText(text.c_str(), text.size(),
+                                  MakeStatisticsFont(font_path),
+                                  SkTextEncoding::kUTF8);
+}
+
 PerformanceOverlayLayer::PerformanceOverlayLayer(uint64_t options,
                                                  const char* font_path)
     : options_(options) {
@@ -74,8 +92,6 @@ PerformanceOverlayLayer::PerformanceOverlayLayer(uint64_t options,
   }
 }
 
-#ifdef FLUTTER_ENABLE_DIFF_CONTEXT
-
 void PerformanceOverlayLayer::Diff(DiffContext* context,
                                    const Layer* old_layer) {
   DiffContext::AutoSubtreeRestore subtree(context);
@@ -88,8 +104,6 @@ void PerformanceOverlayLayer::Diff(DiffContext* context,
   context->SetLayerPaintRegion(this, context->CurrentSubtreeRegion());
 }
 
-#endif  // FLUTTER_ENABLE_DIFF_CONTEXT
-
 void PerformanceOverlayLayer::Paint(PaintContext& context) const {
   const int padding = 8;
 
@@ -109,6 +123,19 @@ void PerformanceOverlayLayer::Paint(PaintContext& context) const {
       height - padding, options_ & kVisualizeRasterizerStatistics,
       options_ & kDisplayRasterizerStatistics, "Raster", font_path_);
 
+  // Subtrees are prerolled before any layer is painted, so the statistics of
+  // the current frame are complete. They are shown one line above the raster
+  // statistics.
+  if ((options_ & kDisplayRasterizerStatistics) && context.raster_cache &&
+      context.raster_cache->subtree_caching_enabled()) {
+    auto text = MakeSubtreeCacheText(
+        context.raster_cache->subtree_cache_statistics(), font_path_);
+    SkPaint paint;
+    paint.setColor(SK_ColorGRAY);
+    context.leaf_nodes_canvas->drawTextBlob(text, x + 8,
+                                            y + height - padding - 28, paint);
+  }
+
   VisualizeStopWatch(context.leaf_nodes_canvas, context.ui_time, x, y + height,
                      width, height - padding,
                      options_ & kVisualizeEngineStatistics,
@@ -9,6 +9,7 @@
 
 #include "flutter/flow/instrumentation.h"
 #include "flutter/flow/layers/layer.h"
+#include "flutter/flow/raster_cache.h"
 #include "flutter/fml/macros.h"
 
 class SkTextBlob;
@@ -26,7 +27,9 @@ class PerformanceOverlayLayer : public Layer {
                                               const std::string& label_prefix,
                                               const std::string& font_path);
 
-#ifdef FLUTTER_ENABLE_DIFF_CONTEXT
+  static sk_sp<SkTextBlob> MakeSubtreeCacheText(
+      const RasterCache::SubtreeCacheStatistics& statistics,
+      const std::string& font_path);
 
   bool IsReplacing(DiffContext* context, const Layer* layer) const override {
     return layer->as_performance_overlay_layer() != nullptr;
@@ -38,8 +41,6 @@ class PerformanceOverlayLayer : public Layer {
     return this;
   }
 
-#endif  // FLUTTER_ENABLE_DIFF_CONTEXT
-
   explicit PerformanceOverlayLayer(uint64_t options,
                                    const char* font_path = nullptr);
 
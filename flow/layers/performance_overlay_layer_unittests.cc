@@ -183,6 +183,38 @@ TEST_F(PerformanceOverlayLayerTest, SimpleRasterizerStatistics) {
                                             text_position}}}));
 }
 
+TEST_F(PerformanceOverlayLayerTest, SubtreeCacheStatistics) {
+  const SkRect layer_bounds = SkRect::MakeLTRB(0.0f, 0.0f, 64.0f, 64.0f);
+  const uint64_t overlay_opts = kDisplayRasterizerStatistics;
+  auto layer = std::make_shared<PerformanceOverlayLayer>(overlay_opts);
+  layer->set_paint_bounds(layer_bounds);
+
+  use_mock_raster_cache();
+  raster_cache()->SetSubtreeCachingEnabled(true);
+  layer->Preroll(preroll_context(), SkMatrix());
+  layer->Paint(paint_context());
+
+  auto overlay_text = PerformanceOverlayLayer::MakeStatisticsText(
+      paint_context().raster_time, "Raster", "");
+  auto subtree_text = PerformanceOverlayLayer::MakeSubtreeCacheText(
+      raster_cache()->subtree_cache_statistics(), "");
+  SkPaint text_paint;
+  text_paint.setColor(SK_ColorGRAY);
+
+#if defined(OS_FUCHSIA)
+  GTEST_SKIP() << "Expectation requires a valid default font manager";
+#endif  // OS_FUCHSIA
+  EXPECT_EQ(mock_canvas().draw_calls(),
+            std::vector({MockCanvas::DrawCall{
+                             0, MockCanvas::DrawTextData{
+                                    overlay_text->serialize(SkSerialProcs{}),
+                                    text_paint, SkPoint::Make(16.0f, 22.0f)}},
+                         MockCanvas::DrawCall{
+                             0, MockCanvas::DrawTextData{
+                                    subtree_text->serialize(SkSerialProcs{}),
+                                    text_paint, SkPoint::Make(16.0f, 4.0f)}}}));
+}
+
 TEST(PerformanceOverlayLayerDefault, Gold) {
   TestPerformanceOverlayLayerGold(60);
 }
@@ -4,6 +4,8 @@
 
 #include "flutter/flow/layers/picture_layer.h"
 
+#include "flutter/flow/fingerprint_wstream.h"
+#include "flutter/flow/group_opacity.h"
 #include "flutter/fml/logging.h"
 #include "third_party/skia/include/core/SkSerialProcs.h"
 
@@ -18,8 +20,6 @@ PictureLayer::PictureLayer(const SkPoint& offset,
       is_complex_(is_complex),
       will_change_(will_change) {}
 
-#ifdef FLUTTER_ENABLE_DIFF_CONTEXT
-
 bool PictureLayer::IsReplacing(DiffContext* context, const Layer* layer) const {
   // Only return true for identical pictures; This way
   // ContainerLayer::DiffChildren can detect when a picture layer got inserted
@@ -62,19 +62,10 @@ bool PictureLayer::Compare(DiffContext::Statistics& statistics,
     return false;
   }
 
-  if (op_cnt_1 > 10) {
-    statistics.AddPictureTooComplexToCompare();
-    return false;
-  }
-
   statistics.AddDeepComparePicture();
 
-  // TODO(knopp) we don't actually need the data; this could be done without
-  // allocations by implementing stream that calculates SHA hash and
-  // comparing those hashes
-  auto d1 = l1->SerializedPicture();
-  auto d2 = l2->SerializedPicture();
-  auto res = d1->equals(d2.get());
+  auto res = l1->PictureFingerprint(statistics) ==
+             l2->PictureFingerprint(statistics);
   if (res) {
     statistics.AddDifferentInstanceButEqualPicture();
   } else {
@@ -83,8 +74,11 @@ bool PictureLayer::Compare(DiffContext::Statistics& statistics,
   return res;
 }
 
-sk_sp<SkData> PictureLayer::SerializedPicture() const {
-  if (!cached_serialized_picture_) {
+const PictureLayer::Fingerprint& PictureLayer::PictureFingerprint(
+    DiffContext::Statistics& statistics) const {
+  if (!cached_fingerprint_) {
+    TRACE_EVENT0("flutter", "PictureLayer::PictureFingerprint");
+    statistics.AddComputedPictureFingerprint();
     SkSerialProcs procs = {
         nullptr,
         nullptr,
@@ -99,13 +93,14 @@ sk_sp<SkData> PictureLayer::SerializedPicture() const {
         },
         nullptr,
     };
-    cached_serialized_picture_ = picture_.get()->serialize(&procs);
+    FingerprintWStream stream;
+    picture_.get()->serialize(&stream, &procs);
+    cached_fingerprint_ = {stream.hash_1(), stream.hash_2(),
+                           stream.bytesWritten()};
   }
-  return cached_serialized_picture_;
+  return *cached_fingerprint_;
 }
 
-#endif  // FLUTTER_ENABLE_DIFF_CONTEXT
-
 void PictureLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
   TRACE_EVENT0("flutter", "PictureLayer::Preroll");
 
@@ -115,7 +110,7 @@ void PictureLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
 
   SkPicture* sk_picture = picture();
 
-  if (auto* cache = context->raster_cache) {
+  if (context->raster_cache) {
     TRACE_EVENT0("flutter", "PictureLayer::RasterCache (Preroll)");
 
     SkMatrix ctm = matrix;
@@ -123,12 +118,26 @@ void PictureLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
 #ifndef SUPPORT_FRACTIONAL_TRANSLATION
     ctm = RasterCache::GetIntegralTransCTM(ctm);
 #endif
-    cache->Prepare(context->gr_context, sk_picture, ctm,
-                   context->dst_color_space, is_complex_, will_change_);
+    RunOrDeferRasterCacheTask(
+        context, [sk_picture, ctm, is_complex = is_complex_,
+                  will_change = will_change_](PrerollContext* raster_context) {
+          raster_context->raster_cache->Prepare(
+              raster_context->gr_context, sk_picture, ctm,
+              raster_context->dst_color_space, is_complex, will_change);
+        });
   }
 
   SkRect bounds = sk_picture->cullRect().makeOffset(offset_.x(), offset_.y());
   set_paint_bounds(bounds);
+
+  if (!context->has_opacity_ancestor) {
+    context->subtree_can_inherit_opacity = false;
+    return;
+  }
+  if (!can_inherit_opacity_) {
+    can_inherit_opacity_ = CanApplyGroupOpacity(*sk_picture);
+  }
+  context->subtree_can_inherit_opacity = *can_inherit_opacity_;
 }
 
 void PictureLayer::Paint(PaintContext& context) const {
@@ -143,11 +152,20 @@ void PictureLayer::Paint(PaintContext& context) const {
       context.leaf_nodes_canvas->getTotalMatrix()));
 #endif
 
+  const bool has_opacity = context.inherited_opacity < SK_Scalar1;
+  SkPaint opacity_paint;
+  opacity_paint.setAlphaf(context.inherited_opacity);
   if (context.raster_cache &&
-      context.raster_cache->Draw(*picture(), *context.leaf_nodes_canvas)) {
+      context.raster_cache->Draw(*picture(), *context.leaf_nodes_canvas,
+                                 has_opacity ? &opacity_paint : nullptr)) {
     TRACE_EVENT_INSTANT0("flutter", "raster cache hit");
     return;
   }
+  if (has_opacity) {
+    DrawPictureWithOpacity(*picture(), context.leaf_nodes_canvas,
+                           context.inherited_opacity);
+    return;
+  }
   picture()->playback(context.leaf_nodes_canvas);
 }
 
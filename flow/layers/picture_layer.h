@@ -6,6 +6,7 @@
 #define FLUTTER_FLOW_LAYERS_PICTURE_LAYER_H_
 
 #include <memory>
+#include <optional>
 
 #include "flutter/flow/layers/layer.h"
 #include "flutter/flow/raster_cache.h"
@@ -22,16 +23,12 @@ class PictureLayer : public Layer {
 
   SkPicture* picture() const { return picture_.get().get(); }
 
-#ifdef FLUTTER_ENABLE_DIFF_CONTEXT
-
   bool IsReplacing(DiffContext* context, const Layer* layer) const override;
 
   void Diff(DiffContext* context, const Layer* old_layer) override;
 
   const PictureLayer* as_picture_layer() const override { return this; }
 
-#endif  // FLUTTER_ENABLE_DIFF_CONTEXT
-
   void Preroll(PrerollContext* frame, const SkMatrix& matrix) override;
 
   void Paint(PaintContext& context) const override;
@@ -44,16 +41,31 @@ class PictureLayer : public Layer {
   bool is_complex_ = false;
   bool will_change_ = false;
 
-#ifdef FLUTTER_ENABLE_DIFF_CONTEXT
-
-  sk_sp<SkData> SerializedPicture() const;
-  mutable sk_sp<SkData> cached_serialized_picture_;
+  // A digest of the serialized picture. Two pictures with equal fingerprints
+  // are considered to draw the same content.
+  struct Fingerprint {
+    uint64_t hash_1 = 0;
+    uint64_t hash_2 = 0;
+    size_t size = 0;
+
+    bool operator==(const Fingerprint& other) const {
+      return hash_1 == other.hash_1 && hash_2 == other.hash_2 &&
+             size == other.size;
+    }
+  };
+
+  // Computes the fingerprint of the picture on first use and caches it on the
+  // layer, so a retained layer is only fingerprinted once.
+  const Fingerprint& PictureFingerprint(
+      DiffContext::Statistics& statistics) const;
+  mutable std::optional<Fingerprint> cached_fingerprint_;
+  // Whether the picture can inherit opacity, computed on the first Preroll of
+  // the layer. (See |CanApplyGroupOpacity|.)
+  std::optional<bool> can_inherit_opacity_;
   static bool Compare(DiffContext::Statistics& statistics,
                       const PictureLayer* l1,
                       const PictureLayer* l2);
 
-#endif  // FLUTTER_ENABLE_DIFF_CONTEXT
-
   FML_DISALLOW_COPY_AND_ASSIGN(PictureLayer);
 };
 
@@ -11,6 +11,7 @@
 #include "flutter/fml/macros.h"
 #include "flutter/testing/mock_canvas.h"
 #include "third_party/skia/include/core/SkPicture.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
 
 #ifndef SUPPORT_FRACTIONAL_TRANSLATION
 #include "flutter/flow/raster_cache.h"
@@ -99,7 +100,39 @@ TEST_F(PictureLayerTest, SimplePicture) {
   EXPECT_EQ(mock_canvas().draw_calls(), expected_draw_calls);
 }
 
-#ifdef FLUTTER_ENABLE_DIFF_CONTEXT
+TEST_F(PictureLayerTest, AppliesInheritedOpacityIfOpsDoNotOverlap) {
+  SkPictureRecorder recorder;
+  SkCanvas* recording_canvas =
+      recorder.beginRecording(SkRect::MakeLTRB(0, 0, 30, 10));
+  recording_canvas->drawRect(SkRect::MakeLTRB(0, 0, 10, 10), SkPaint());
+  recording_canvas->drawRect(SkRect::MakeLTRB(20, 0, 30, 10), SkPaint());
+  auto layer = std::make_shared<PictureLayer>(
+      SkPoint(),
+      SkiaGPUObject(recorder.finishRecordingAsPicture(), unref_queue()),
+      false, false);
+
+  // The picture is only analyzed below an OpacityLayer.
+  layer->Preroll(preroll_context(), SkMatrix());
+  EXPECT_FALSE(preroll_context()->subtree_can_inherit_opacity);
+
+  preroll_context()->has_opacity_ancestor = true;
+  layer->Preroll(preroll_context(), SkMatrix());
+  EXPECT_TRUE(preroll_context()->subtree_can_inherit_opacity);
+
+  paint_context().inherited_opacity = 0.5f;
+  layer->Paint(paint_context());
+  SkPaint expected_paint;
+  expected_paint.setAlphaf(0.5f);
+  int draw_rect_count = 0;
+  for (const auto& draw_call : mock_canvas().draw_calls()) {
+    if (auto* draw_rect =
+            std::get_if<MockCanvas::DrawRectData>(&draw_call.data)) {
+      EXPECT_EQ(draw_rect->paint, expected_paint);
+      draw_rect_count++;
+    }
+  }
+  EXPECT_EQ(draw_rect_count, 2);
+}
 
 using PictureLayerDiffTest = DiffContextTest;
 
@@ -155,7 +188,51 @@ TEST_F(PictureLayerDiffTest, PictureCompare) {
   EXPECT_EQ(damage.frame_damage, SkIRect::MakeLTRB(20, 20, 70, 70));
 }
 
-#endif
+TEST_F(PictureLayerDiffTest, ComplexPictureCompareByFingerprint) {
+  // Well above the number of ops that used to be considered too complex to
+  // compare.
+  auto create_complex_picture = [](uint32_t color) {
+    SkPictureRecorder recorder;
+    SkRect bounds = SkRect::MakeLTRB(10, 10, 110, 110);
+    SkCanvas* recording_canvas = recorder.beginRecording(bounds);
+    SkPaint paint(SkColor4f::FromBytes_RGBA(color));
+    for (int i = 0; i < 100; i++) {
+      recording_canvas->drawRect(SkRect::MakeXYWH(10 + i, 10 + i, 1, 1),
+                                 paint);
+    }
+    return recorder.finishRecordingAsPicture();
+  };
+
+  MockLayerTree tree1;
+  tree1.root()->Add(CreatePictureLayer(create_complex_picture(1)));
+  auto damage = DiffLayerTree(tree1, MockLayerTree());
+  EXPECT_EQ(damage.frame_damage, SkIRect::MakeLTRB(10, 10, 110, 110));
+
+  // Same content, different instance.
+  MockLayerTree tree2;
+  tree2.root()->Add(CreatePictureLayer(create_complex_picture(1)));
+  damage = DiffLayerTree(tree2, tree1);
+  EXPECT_TRUE(damage.frame_damage.isEmpty());
+  EXPECT_EQ(last_statistics().deep_compare_pictures(), 1);
+  EXPECT_EQ(last_statistics().different_instance_but_equal_pictures(), 1);
+  EXPECT_EQ(last_statistics().computed_picture_fingerprints(), 2);
+
+  // The fingerprint of the picture in tree2 is cached on its layer.
+  MockLayerTree tree3;
+  tree3.root()->Add(CreatePictureLayer(create_complex_picture(1)));
+  damage = DiffLayerTree(tree3, tree2);
+  EXPECT_TRUE(damage.frame_damage.isEmpty());
+  EXPECT_EQ(last_statistics().different_instance_but_equal_pictures(), 1);
+  EXPECT_EQ(last_statistics().computed_picture_fingerprints(), 1);
+
+  // Different color.
+  MockLayerTree tree4;
+  tree4.root()->Add(CreatePictureLayer(create_complex_picture(2)));
+  damage = DiffLayerTree(tree4, tree3);
+  EXPECT_EQ(damage.frame_damage, SkIRect::MakeLTRB(10, 10, 110, 110));
+  EXPECT_EQ(last_statistics().different_instance_but_equal_pictures(), 0);
+  EXPECT_EQ(last_statistics().new_pictures(), 1);
+}
 
 }  // namespace testing
 }  // namespace flutter
@@ -21,6 +21,11 @@ void PlatformViewLayer::Preroll(PrerollContext* context,
   set_paint_bounds(SkRect::MakeXYWH(offset_.x(), offset_.y(), size_.width(),
                                     size_.height()));
 
+  if (context->deferred_raster_cache_tasks) {
+    // The view embedder can only be used on the raster thread.
+    context->needs_serial_preroll = true;
+    return;
+  }
   if (context->view_embedder == nullptr) {
     FML_LOG(ERROR) << "Trying to embed a platform view but the PrerollContext "
                       "does not support embedding";
@@ -3,11 +3,13 @@
 // found in the LICENSE file.
 
 #include "flutter/flow/layers/clip_rect_layer.h"
+#include "flutter/flow/layers/container_layer.h"
 #include "flutter/flow/layers/platform_view_layer.h"
 
 #include "flutter/flow/testing/layer_test.h"
 #include "flutter/flow/testing/mock_embedder.h"
 #include "flutter/flow/testing/mock_layer.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/macros.h"
 #include "flutter/testing/mock_canvas.h"
 
@@ -93,5 +95,32 @@ TEST_F(PlatformViewLayerTest, ClippedPlatformViewPrerollsAndPaintsNothing) {
            MockCanvas::DrawCall{1, MockCanvas::RestoreData{0}}}));
 }
 
+TEST_F(PlatformViewLayerTest, IsPrerolledOnRasterThreadWithConcurrentPreroll) {
+  const SkSize layer_size = SkSize::Make(8.0f, 8.0f);
+  const int64_t view_id = 0;
+  auto layer =
+      std::make_shared<PlatformViewLayer>(SkPoint(), layer_size, view_id);
+  auto clip_layer = std::make_shared<ClipRectLayer>(
+      SkRect::MakeLTRB(0.0f, 0.0f, 10.0f, 10.0f), Clip::hardEdge);
+  clip_layer->Add(layer);
+  SkPath sibling_path;
+  sibling_path.addRect(20.0f, 20.0f, 30.0f, 30.0f);
+  auto container_layer = std::make_shared<ContainerLayer>();
+  container_layer->Add(clip_layer);
+  container_layer->Add(std::make_shared<MockLayer>(sibling_path));
+
+  auto loop = fml::ConcurrentMessageLoop::Create(2);
+  auto task_runner = loop->GetTaskRunner();
+  preroll_context()->concurrent_preroll_task_runner = task_runner.get();
+  auto embedder = MockViewEmbedder();
+  preroll_context()->view_embedder = &embedder;
+
+  container_layer->Preroll(preroll_context(), SkMatrix());
+  EXPECT_TRUE(preroll_context()->has_platform_view);
+  EXPECT_TRUE(layer->subtree_has_platform_view());
+  EXPECT_TRUE(clip_layer->subtree_has_platform_view());
+  EXPECT_TRUE(container_layer->subtree_has_platform_view());
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -26,8 +26,6 @@ TransformLayer::TransformLayer(const SkMatrix& transform)
   }
 }
 
-#ifdef FLUTTER_ENABLE_DIFF_CONTEXT
-
 void TransformLayer::Diff(DiffContext* context, const Layer* old_layer) {
   DiffContext::AutoSubtreeRestore subtree(context);
   auto* prev = static_cast<const TransformLayer*>(old_layer);
@@ -42,10 +40,11 @@ void TransformLayer::Diff(DiffContext* context, const Layer* old_layer) {
   context->SetLayerPaintRegion(this, context->CurrentSubtreeRegion());
 }
 
-#endif  // FLUTTER_ENABLE_DIFF_CONTEXT
-
 void TransformLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
   TRACE_EVENT0("flutter", "TransformLayer::Preroll");
+  if (TryToReuseSubtreeCache(context, matrix)) {
+    return;
+  }
 
   SkMatrix child_matrix;
   child_matrix.setConcat(matrix, transform_);
@@ -60,6 +59,8 @@ void TransformLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
     context->cull_rect = kGiantRect;
   }
 
+  bool needs_readback = context->surface_needs_readback;
+  context->surface_needs_readback = false;
   SkRect child_paint_bounds = SkRect::MakeEmpty();
   PrerollChildren(context, child_matrix, &child_paint_bounds);
 
@@ -68,6 +69,10 @@ void TransformLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
 
   context->cull_rect = previous_cull_rect;
   context->mutators_stack.Pop();
+
+  TryToPrepareSubtreeCache(context, matrix, context->surface_needs_readback);
+  context->surface_needs_readback |= needs_readback;
+  context->subtree_can_inherit_opacity = children_can_inherit_opacity();
 }
 
 #if defined(LEGACY_FUCHSIA_EMBEDDER)
@@ -89,6 +94,9 @@ void TransformLayer::UpdateScene(std::shared_ptr<SceneUpdateContext> context) {
 void TransformLayer::Paint(PaintContext& context) const {
   TRACE_EVENT0("flutter", "TransformLayer::Paint");
   FML_DCHECK(needs_painting(context));
+  if (TryToDrawSubtreeCache(context)) {
+    return;
+  }
 
   SkAutoCanvasRestore save(context.internal_nodes_canvas, true);
   context.internal_nodes_canvas->concat(transform_);
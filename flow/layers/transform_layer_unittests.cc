@@ -225,7 +225,36 @@ TEST_F(TransformLayerTest, NestedSeparated) {
                  MockCanvas::DrawCall{1, MockCanvas::RestoreData{0}}}));
 }
 
-#ifdef FLUTTER_ENABLE_DIFF_CONTEXT
+TEST_F(TransformLayerTest, RetainedSubtreeIsCachedWhileParentTranslates) {
+  SkPath child_path;
+  child_path.addRect(5.0f, 6.0f, 20.5f, 21.5f);
+  SkMatrix layer_transform = SkMatrix::Scale(2.0f, 2.0f);
+  auto mock_layer = std::make_shared<MockLayer>(child_path, SkPaint());
+  auto layer = std::make_shared<TransformLayer>(layer_transform);
+  layer->Add(mock_layer);
+
+  use_mock_raster_cache();
+  raster_cache()->SetSubtreeCachingEnabled(true);
+  for (int i = 0; i < 3; i++) {
+    SkMatrix parent_transform = SkMatrix::Translate(0.0f, 10.0f * i);
+    layer->Preroll(preroll_context(), parent_transform);
+    EXPECT_EQ(mock_layer->parent_matrix(),
+              SkMatrix::Concat(parent_transform, layer_transform));
+    raster_cache()->SweepAfterFrame();
+  }
+  EXPECT_EQ(raster_cache()->GetLayerCachedEntriesCount(), 1u);
+
+  layer->Preroll(preroll_context(), SkMatrix::Translate(0.0f, 30.0f));
+  EXPECT_EQ(raster_cache()->subtree_cache_statistics().hits, 1u);
+  EXPECT_EQ(mock_layer->parent_matrix(),
+            SkMatrix::Concat(SkMatrix::Translate(0.0f, 20.0f),
+                             layer_transform));
+  layer->Paint(paint_context());
+  for (const auto& draw_call : mock_canvas().draw_calls()) {
+    EXPECT_FALSE(std::holds_alternative<MockCanvas::DrawPathData>(
+        draw_call.data));
+  }
+}
 
 using TransformLayerLayerDiffTest = DiffContextTest;
 
@@ -333,7 +362,5 @@ TEST_F(TransformLayerLayerDiffTest, TransformNested) {
   EXPECT_EQ(damage.frame_damage, SkIRect::MakeLTRB(200, 200, 300, 302));
 }
 
-#endif
-
 }  // namespace testing
 }  // namespace flutter
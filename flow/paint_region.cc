@@ -2,8 +2,6 @@
 
 namespace flutter {
 
-#ifdef FLUTTER_ENABLE_DIFF_CONTEXT
-
 SkRect PaintRegion::ComputeBounds() const {
   SkRect res = SkRect::MakeEmpty();
   for (const auto& r : *this) {
@@ -12,6 +10,4 @@ SkRect PaintRegion::ComputeBounds() const {
   return res;
 }
 
-#endif  // FLUTTER_ENABLE_DIFF_CONTEXT
-
 }  // namespace flutter
@@ -4,8 +4,6 @@
 
 namespace flutter {
 
-#ifdef FLUTTER_ENABLE_DIFF_CONTEXT
-
 // Corresponds to area on the screen where the layer subtree has painted to.
 //
 // The area is used when adding damage of removed or dirty layer to overall
@@ -52,6 +50,4 @@ class PaintRegion {
   bool has_readback_ = false;
 };
 
-#endif
-
 }  // namespace flutter
@@ -4,9 +4,13 @@
 
 #include "flutter/flow/raster_cache.h"
 
+#include <algorithm>
+#include <mutex>
 #include <vector>
 
 #include "flutter/common/constants.h"
+#include "flutter/common/graphics/persistent_cache.h"
+#include "flutter/flow/fingerprint_wstream.h"
 #include "flutter/flow/layers/layer.h"
 #include "flutter/flow/paint_utils.h"
 #include "flutter/fml/logging.h"
@@ -14,7 +18,10 @@
 #include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkImage.h"
 #include "third_party/skia/include/core/SkPicture.h"
+#include "third_party/skia/include/core/SkSerialProcs.h"
+#include "third_party/skia/include/core/SkStream.h"
 #include "third_party/skia/include/core/SkSurface.h"
+#include "third_party/skia/include/core/SkTypeface.h"
 #include "third_party/skia/include/gpu/GrDirectContext.h"
 
 namespace flutter {
@@ -37,9 +44,11 @@ void RasterCacheResult::draw(SkCanvas& canvas, const SkPaint* paint) const {
 }
 
 RasterCache::RasterCache(size_t access_threshold,
-                         size_t picture_cache_limit_per_frame)
+                         size_t picture_cache_limit_per_frame,
+                         size_t max_retained_bytes)
     : access_threshold_(access_threshold),
       picture_cache_limit_per_frame_(picture_cache_limit_per_frame),
+      max_retained_bytes_(max_retained_bytes),
       checkerboard_images_(false) {}
 
 static bool CanRasterizePicture(SkPicture* picture) {
@@ -88,8 +97,29 @@ static bool IsPictureWorthRasterizing(SkPicture* picture,
   return picture->approximateOpCount() > 5;
 }
 
+// Returns true if |picture| may be played back on a thread other than the
+// raster thread. Texture backed images belong to a GrContext that must only be
+// used on its own thread, so pictures that reference them can't be rasterized
+// off the raster thread.
+static bool CanRasterizePictureOffThread(SkPicture* picture) {
+  TRACE_EVENT0("flutter", "RasterCache::CanRasterizePictureOffThread");
+  bool references_texture = false;
+  SkSerialProcs procs;
+  procs.fImageProc = [](SkImage* image, void* ctx) {
+    if (image->isTextureBacked()) {
+      *static_cast<bool*>(ctx) = true;
+    }
+    // Any non-null data prevents the image from being encoded.
+    return SkData::MakeEmpty();
+  };
+  procs.fImageCtx = &references_texture;
+  SkNullWStream stream;
+  picture->serialize(&stream, &procs);
+  return !references_texture;
+}
+
 /// @note Procedure doesn't copy all closures.
-static std::unique_ptr<RasterCacheResult> Rasterize(
+static sk_sp<SkImage> RasterizeToImage(
     GrDirectContext* context,
     const SkMatrix& ctm,
     SkColorSpace* dst_color_space,
@@ -121,8 +151,24 @@ static std::unique_ptr<RasterCacheResult> Rasterize(
     DrawCheckerboard(canvas, logical_rect);
   }
 
-  return std::make_unique<RasterCacheResult>(surface->makeImageSnapshot(),
-                                             logical_rect);
+  return surface->makeImageSnapshot();
+}
+
+/// @note Procedure doesn't copy all closures.
+static std::unique_ptr<RasterCacheResult> Rasterize(
+    GrDirectContext* context,
+    const SkMatrix& ctm,
+    SkColorSpace* dst_color_space,
+    bool checkerboard,
+    const SkRect& logical_rect,
+    const std::function<void(SkCanvas*)>& draw_function) {
+  sk_sp<SkImage> image = RasterizeToImage(context, ctm, dst_color_space,
+                                          checkerboard, logical_rect,
+                                          draw_function);
+  if (!image) {
+    return nullptr;
+  }
+  return std::make_unique<RasterCacheResult>(std::move(image), logical_rect);
 }
 
 std::unique_ptr<RasterCacheResult> RasterCache::RasterizePicture(
@@ -143,11 +189,68 @@ void RasterCache::Prepare(PrerollContext* context,
   Entry& entry = layer_cache_[cache_key];
   entry.access_count++;
   entry.used_this_frame = true;
+  entry.last_used_frame = frame_count_;
   if (!entry.image) {
     entry.image = RasterizeLayer(context, layer, ctm, checkerboard_images_);
   }
 }
 
+bool RasterCache::TouchSubtree(const Layer* layer, const SkMatrix& ctm) {
+  if (!subtree_caching_enabled_) {
+    return false;
+  }
+  LayerRasterCacheKey cache_key(layer->unique_id(), ctm);
+  auto it = layer_cache_.find(cache_key);
+  if (it == layer_cache_.end() || !it->second.image) {
+    return false;
+  }
+  Entry& entry = it->second;
+  entry.access_count++;
+  entry.used_this_frame = true;
+  entry.last_used_frame = frame_count_;
+  subtree_cache_statistics_.hits++;
+  return true;
+}
+
+bool RasterCache::HasSubtree(const Layer* layer, const SkMatrix& ctm) const {
+  if (!subtree_caching_enabled_) {
+    return false;
+  }
+  auto it = layer_cache_.find(LayerRasterCacheKey(layer->unique_id(), ctm));
+  return it != layer_cache_.end() && it->second.image;
+}
+
+bool RasterCache::PrepareSubtree(PrerollContext* context,
+                                 Layer* layer,
+                                 const SkMatrix& ctm) {
+  if (!subtree_caching_enabled_ || access_threshold_ == 0) {
+    return false;
+  }
+  LayerRasterCacheKey cache_key(layer->unique_id(), ctm);
+  Entry& entry = layer_cache_[cache_key];
+  entry.access_count++;
+  entry.used_this_frame = true;
+  entry.last_used_frame = frame_count_;
+  if (entry.image) {
+    return true;
+  }
+  // Entries that are not used in a frame are swept, so the access count only
+  // reaches the threshold if the layer was prerolled in consecutive frames.
+  if (entry.access_count < access_threshold_ ||
+      subtrees_cached_this_frame_ >= picture_cache_limit_per_frame_) {
+    subtree_cache_statistics_.misses++;
+    return false;
+  }
+  entry.image = RasterizeLayer(context, layer, ctm, checkerboard_images_);
+  if (!entry.image) {
+    subtree_cache_statistics_.misses++;
+    return false;
+  }
+  subtrees_cached_this_frame_++;
+  subtree_cache_statistics_.rasterized++;
+  return true;
+}
+
 std::unique_ptr<RasterCacheResult> RasterCache::RasterizeLayer(
     PrerollContext* context,
     Layer* layer,
@@ -189,7 +292,10 @@ bool RasterCache::Prepare(GrDirectContext* context,
   if (access_threshold_ == 0) {
     return false;
   }
-  if (picture_cached_this_frame_ >= picture_cache_limit_per_frame_) {
+  // Queueing an asynchronous rasterization is cheap. The limit is enforced
+  // when the result is adopted instead.
+  if (!async_rasterization_task_runner_ &&
+      picture_cached_this_frame_ >= picture_cache_limit_per_frame_) {
     return false;
   }
   if (!IsPictureWorthRasterizing(picture, will_change, is_complex)) {
@@ -210,35 +316,422 @@ bool RasterCache::Prepare(GrDirectContext* context,
 
   // Creates an entry, if not present prior.
   Entry& entry = picture_cache_[cache_key];
-  if (entry.access_count < access_threshold_) {
+  if (!entry.image && !entry.async_result && persistent_images_) {
+    PrepareFromPersistentImages(entry, picture, transformation_matrix,
+                                dst_color_space);
+  }
+  if (entry.access_count < access_threshold_ && !entry.async_result) {
     // Frame threshold has not yet been reached.
     return false;
   }
 
   if (!entry.image) {
+    if (entry.async_result || async_rasterization_task_runner_) {
+      return PrepareAsync(entry, context, picture, transformation_matrix,
+                          dst_color_space);
+    }
     entry.image = RasterizePicture(picture, context, transformation_matrix,
                                    dst_color_space, checkerboard_images_);
     picture_cached_this_frame_++;
+    StoreToPersistentImages(entry, picture, transformation_matrix,
+                            dst_color_space);
+  }
+  return true;
+}
+
+bool RasterCache::PrepareAsync(Entry& entry,
+                               GrDirectContext* context,
+                               SkPicture* picture,
+                               const SkMatrix& transformation_matrix,
+                               SkColorSpace* dst_color_space) {
+  if (!entry.async_result) {
+    if (!entry.can_rasterize_off_thread.has_value()) {
+      // Serializing the picture is not cheap. Wait for a frame that can cache
+      // the picture even if it has to be rasterized here, and remember the
+      // answer.
+      if (picture_cached_this_frame_ >= picture_cache_limit_per_frame_) {
+        return false;
+      }
+      entry.can_rasterize_off_thread = CanRasterizePictureOffThread(picture);
+    }
+    if (!entry.can_rasterize_off_thread.value()) {
+      if (picture_cached_this_frame_ >= picture_cache_limit_per_frame_) {
+        return false;
+      }
+      entry.image = RasterizePicture(picture, context, transformation_matrix,
+                                     dst_color_space, checkerboard_images_);
+      picture_cached_this_frame_++;
+      return true;
+    }
+
+    auto result = std::make_shared<AsyncRasterizationResult>();
+    entry.async_result = result;
+    async_rasterization_task_runner_->PostTask(
+        [result, picture = sk_ref_sp(picture), ctm = transformation_matrix,
+         dst_color_space = sk_ref_sp(dst_color_space),
+         checkerboard = checkerboard_images_]() {
+          TRACE_EVENT0("flutter", "RasterCache::RasterizePictureAsync");
+          sk_sp<SkImage> image = RasterizeToImage(
+              nullptr, ctm, dst_color_space.get(), checkerboard,
+              picture->cullRect(),
+              [&picture](SkCanvas* canvas) { canvas->drawPicture(picture); });
+          std::scoped_lock lock(result->mutex);
+          result->image = std::move(image);
+          result->done = true;
+        });
+    return false;
+  }
+
+  if (picture_cached_this_frame_ >= picture_cache_limit_per_frame_) {
+    return false;
+  }
+
+  sk_sp<SkImage> image;
+  {
+    std::scoped_lock lock(entry.async_result->mutex);
+    if (!entry.async_result->done) {
+      // Keep playing back the picture until the result is ready.
+      return false;
+    }
+    image = std::move(entry.async_result->image);
+  }
+  entry.async_result.reset();
+
+  if (!image) {
+    // Rasterization failed. A later Prepare will try again.
+    return false;
   }
+
+  if (context) {
+    TRACE_EVENT0("flutter", "RasterCache::UploadAsyncResult");
+    if (sk_sp<SkImage> texture_image = image->makeTextureImage(context)) {
+      image = std::move(texture_image);
+    }
+  }
+  entry.image = std::make_unique<RasterCacheResult>(std::move(image),
+                                                    picture->cullRect());
+  picture_cached_this_frame_++;
+  StoreToPersistentImages(entry, picture, transformation_matrix,
+                          dst_color_space);
   return true;
 }
 
-bool RasterCache::Draw(const SkPicture& picture, SkCanvas& canvas) const {
+void RasterCache::SetPersistentCacheTaskRunner(
+    std::shared_ptr<fml::ConcurrentTaskRunner> task_runner,
+    size_t max_bytes) {
+  persistent_cache_task_runner_ = std::move(task_runner);
+  if (!persistent_cache_task_runner_) {
+    persistent_images_.reset();
+    return;
+  }
+  persistent_images_ = std::make_shared<PersistentImages>();
+  persistent_images_->max_bytes = max_bytes;
+  persistent_cache_task_runner_->PostTask(
+      [persistent_images = persistent_images_]() {
+        auto images = PersistentCache::GetCacheForProcess()
+                          ->ListRasterCacheImages();
+        std::scoped_lock lock(persistent_images->mutex);
+        for (const auto& [key, bytes] : images) {
+          persistent_images->bytes += bytes;
+          persistent_images->images[std::string(
+              static_cast<const char*>(key->data()), key->size())] = {
+              bytes, 0, true};
+        }
+        persistent_images->loaded = true;
+      });
+}
+
+namespace {
+
+// Identifies a typeface by its descriptor and the sizes of its font tables,
+// which unlike its unique ID are the same in every run. Reading them doesn't
+// read the font data.
+sk_sp<SkData> SerializeTypefaceFingerprint(SkTypeface* typeface, void* ctx) {
+  FingerprintWStream stream;
+  typeface->serialize(&stream, SkTypeface::SerializeBehavior::kDontIncludeData);
+  stream.write32(typeface->countGlyphs());
+  stream.write32(typeface->getUnitsPerEm());
+  std::vector<SkFontTableTag> tags(typeface->countTables());
+  typeface->getTableTags(tags.data());
+  for (SkFontTableTag tag : tags) {
+    stream.write32(tag);
+    stream.write32(typeface->getTableSize(tag));
+  }
+  const uint64_t fingerprint[] = {stream.hash_1(), stream.hash_2()};
+  return SkData::MakeWithCopy(fingerprint, sizeof(fingerprint));
+}
+
+sk_sp<SkData> MakePersistentKeyData(const std::string& key) {
+  return SkData::MakeWithoutCopy(key.data(), key.size());
+}
+
+}  // namespace
+
+// Computing the key serializes the picture, so it is done on the persistent
+// cache task runner, and only once for each entry.
+class RasterCache::PersistentKey {
+ public:
+  PersistentKey(sk_sp<SkPicture> picture,
+                const SkMatrix& transformation_matrix,
+                sk_sp<SkColorSpace> dst_color_space)
+      : picture_(std::move(picture)),
+        transformation_matrix_(transformation_matrix),
+        dst_color_space_(std::move(dst_color_space)) {}
+
+  // The key, or an empty string if the picture can't be stored. May be
+  // called on several threads at once.
+  const std::string& Get() {
+    std::call_once(once_, [this]() {
+      key_ = Compute();
+      picture_.reset();
+      dst_color_space_.reset();
+    });
+    return key_;
+  }
+
+ private:
+  std::once_flag once_;
+  sk_sp<SkPicture> picture_;
+  const SkMatrix transformation_matrix_;
+  sk_sp<SkColorSpace> dst_color_space_;
+  std::string key_;
+
+  std::string Compute() const {
+    TRACE_EVENT0("flutter", "RasterCache::ComputePersistentKey");
+    bool references_images = false;
+    SkSerialProcs procs;
+    procs.fImageProc = [](SkImage* image, void* ctx) {
+      *static_cast<bool*>(ctx) = true;
+      // Any non-null data prevents the image from being encoded.
+      return SkData::MakeEmpty();
+    };
+    procs.fImageCtx = &references_images;
+    procs.fTypefaceProc = SerializeTypefaceFingerprint;
+    FingerprintWStream stream;
+    picture_->serialize(&stream, &procs);
+    if (references_images) {
+      return std::string();
+    }
+
+    // The key matches how the picture is cached in memory: translations are
+    // ignored.
+    SkMatrix matrix = PictureRasterCacheKey(0, transformation_matrix_).matrix();
+    SkScalar matrix_values[9];
+    matrix.get9(matrix_values);
+    const uint64_t values[] = {
+        stream.hash_1(),
+        stream.hash_2(),
+        stream.bytesWritten(),
+        dst_color_space_ ? dst_color_space_->toXYZD50Hash() : 0u,
+        dst_color_space_ ? dst_color_space_->transferFnHash() : 0u,
+    };
+    std::string key(reinterpret_cast<const char*>(values), sizeof(values));
+    key.append(reinterpret_cast<const char*>(matrix_values),
+               sizeof(matrix_values));
+    return key;
+  }
+};
+
+std::shared_ptr<RasterCache::PersistentKey> RasterCache::GetPersistentKey(
+    Entry& entry,
+    SkPicture* picture,
+    const SkMatrix& transformation_matrix,
+    SkColorSpace* dst_color_space) {
+  if (!entry.persistent_key) {
+    entry.persistent_key = std::make_shared<PersistentKey>(
+        sk_ref_sp(picture), transformation_matrix, sk_ref_sp(dst_color_space));
+  }
+  return entry.persistent_key;
+}
+
+void RasterCache::PrepareFromPersistentImages(
+    Entry& entry,
+    SkPicture* picture,
+    const SkMatrix& transformation_matrix,
+    SkColorSpace* dst_color_space) {
+  if (entry.checked_persistent_images) {
+    return;
+  }
+  {
+    std::scoped_lock lock(persistent_images_->mutex);
+    if (!persistent_images_->loaded) {
+      // Look again once the images are listed.
+      return;
+    }
+    if (persistent_images_->images.empty()) {
+      entry.checked_persistent_images = true;
+      return;
+    }
+  }
+  entry.checked_persistent_images = true;
+
+  // Until the task has looked for a stored image, the picture is played back
+  // as if it was being rasterized asynchronously. If there is none, the
+  // result has no image and the picture is cached as usual.
+  auto result = std::make_shared<AsyncRasterizationResult>();
+  entry.async_result = result;
+  const SkISize dimensions =
+      GetDeviceBounds(picture->cullRect(), transformation_matrix).size();
+  persistent_cache_task_runner_->PostTask(
+      [result, persistent_images = persistent_images_,
+       key = GetPersistentKey(entry, picture, transformation_matrix,
+                              dst_color_space),
+       dimensions]() {
+        TRACE_EVENT0("flutter", "RasterCache::DecodePersistentImage");
+        const std::string& key_string = key->Get();
+        bool stored = false;
+        if (!key_string.empty()) {
+          std::scoped_lock lock(persistent_images->mutex);
+          auto found = persistent_images->images.find(key_string);
+          if (found != persistent_images->images.end() &&
+              found->second.written) {
+            found->second.last_used = ++persistent_images->use_count;
+            stored = true;
+          }
+        }
+        sk_sp<SkData> data;
+        if (stored) {
+          data = PersistentCache::GetCacheForProcess()->LoadRasterCacheImage(
+              *MakePersistentKeyData(key_string));
+        }
+        sk_sp<SkImage> image = data ? SkImage::MakeFromEncoded(data) : nullptr;
+        if (image) {
+          image = image->makeRasterImage();
+        }
+        // Drawing the image requires it to cover the same device pixels as
+        // the picture.
+        if (image && (std::abs(image->width() - dimensions.width()) > 1 ||
+                      std::abs(image->height() - dimensions.height()) > 1)) {
+          image = nullptr;
+        }
+        std::scoped_lock lock(result->mutex);
+        result->image = std::move(image);
+        result->done = true;
+      });
+}
+
+void RasterCache::StoreToPersistentImages(
+    Entry& entry,
+    SkPicture* picture,
+    const SkMatrix& transformation_matrix,
+    SkColorSpace* dst_color_space) {
+  if (!persistent_images_ || checkerboard_images_) {
+    return;
+  }
+  {
+    std::scoped_lock lock(persistent_images_->mutex);
+    if (!persistent_images_->loaded) {
+      return;
+    }
+  }
+
+  persistent_cache_task_runner_->PostTask(
+      [persistent_images = persistent_images_,
+       key = GetPersistentKey(entry, picture, transformation_matrix,
+                              dst_color_space),
+       picture = sk_ref_sp(picture), ctm = transformation_matrix,
+       dst_color_space = sk_ref_sp(dst_color_space)]() {
+        TRACE_EVENT0("flutter", "RasterCache::StorePersistentImage");
+        const std::string& key_string = key->Get();
+        if (key_string.empty()) {
+          return;
+        }
+        {
+          std::scoped_lock lock(persistent_images->mutex);
+          if (!persistent_images->images.emplace(key_string, PersistentImage())
+                   .second) {
+            // Already stored, or being stored.
+            return;
+          }
+        }
+
+        sk_sp<SkImage> image = RasterizeToImage(
+            nullptr, ctm, dst_color_space.get(), false, picture->cullRect(),
+            [&picture](SkCanvas* canvas) { canvas->drawPicture(picture); });
+        sk_sp<SkData> data =
+            image ? image->encodeToData(SkEncodedImageFormat::kPNG, 100)
+                  : nullptr;
+
+        // The least recently used images that are removed to make room.
+        std::vector<std::string> evicted_keys;
+        {
+          std::scoped_lock lock(persistent_images->mutex);
+          auto stored = persistent_images->images.find(key_string);
+          if (!data || data->size() > persistent_images->max_bytes) {
+            persistent_images->images.erase(stored);
+            return;
+          }
+          while (persistent_images->bytes + data->size() >
+                 persistent_images->max_bytes) {
+            auto oldest = persistent_images->images.end();
+            for (auto it = persistent_images->images.begin();
+                 it != persistent_images->images.end(); ++it) {
+              if (it->second.written &&
+                  (oldest == persistent_images->images.end() ||
+                   it->second.last_used < oldest->second.last_used)) {
+                oldest = it;
+              }
+            }
+            if (oldest == persistent_images->images.end()) {
+              break;
+            }
+            persistent_images->bytes -= oldest->second.bytes;
+            oldest->second.written = false;
+            evicted_keys.push_back(oldest->first);
+          }
+          stored->second.bytes = data->size();
+          stored->second.last_used = ++persistent_images->use_count;
+          persistent_images->bytes += data->size();
+        }
+
+        // The files are written and removed on this task, and the keys are
+        // only released once that is done, so a file is never removed while
+        // another task stores it or the other way around.
+        PersistentCache* persistent_cache =
+            PersistentCache::GetCacheForProcess();
+        for (const std::string& evicted_key : evicted_keys) {
+          persistent_cache->RemoveRasterCacheImage(
+              *MakePersistentKeyData(evicted_key));
+        }
+        const bool written = persistent_cache->StoreRasterCacheImage(
+            *MakePersistentKeyData(key_string), *data);
+
+        std::scoped_lock lock(persistent_images->mutex);
+        for (const std::string& evicted_key : evicted_keys) {
+          persistent_images->images.erase(evicted_key);
+        }
+        auto stored = persistent_images->images.find(key_string);
+        if (written) {
+          stored->second.written = true;
+        } else {
+          persistent_images->bytes -= stored->second.bytes;
+          persistent_images->images.erase(stored);
+        }
+      });
+}
+
+bool RasterCache::Draw(const SkPicture& picture,
+                       SkCanvas& canvas,
+                       SkPaint* paint) const {
   PictureRasterCacheKey cache_key(picture.uniqueID(), canvas.getTotalMatrix());
   auto it = picture_cache_.find(cache_key);
   if (it == picture_cache_.end()) {
+    draw_statistics_.picture_misses++;
     return false;
   }
 
   Entry& entry = it->second;
   entry.access_count++;
   entry.used_this_frame = true;
+  entry.last_used_frame = frame_count_;
 
   if (entry.image) {
-    entry.image->draw(canvas, nullptr);
+    entry.image->draw(canvas, paint);
+    draw_statistics_.picture_hits++;
     return true;
   }
 
+  draw_statistics_.picture_misses++;
   return false;
 }
 
@@ -248,26 +741,71 @@ bool RasterCache::Draw(const Layer* layer,
   LayerRasterCacheKey cache_key(layer->unique_id(), canvas.getTotalMatrix());
   auto it = layer_cache_.find(cache_key);
   if (it == layer_cache_.end()) {
+    draw_statistics_.layer_misses++;
     return false;
   }
 
   Entry& entry = it->second;
   entry.access_count++;
   entry.used_this_frame = true;
+  entry.last_used_frame = frame_count_;
 
   if (entry.image) {
     entry.image->draw(canvas, paint);
+    draw_statistics_.layer_hits++;
     return true;
   }
 
+  draw_statistics_.layer_misses++;
   return false;
 }
 
 void RasterCache::SweepAfterFrame() {
-  SweepOneCacheAfterFrame(picture_cache_);
-  SweepOneCacheAfterFrame(layer_cache_);
+  if (max_retained_bytes_ == 0) {
+    SweepOneCacheAfterFrame(picture_cache_);
+    SweepOneCacheAfterFrame(layer_cache_);
+  } else {
+    SweepRetainedCachesAfterFrame();
+  }
   picture_cached_this_frame_ = 0;
+  subtrees_cached_this_frame_ = 0;
+  frame_count_++;
   TraceStatsToTimeline();
+  subtree_cache_statistics_ = {};
+  draw_statistics_ = {};
+}
+
+void RasterCache::SweepRetainedCachesAfterFrame() {
+  std::vector<EvictionCandidate> candidates;
+  SweepOneCacheRetainingImages(picture_cache_, candidates);
+  SweepOneCacheRetainingImages(layer_cache_, candidates);
+
+  size_t cache_bytes =
+      EstimatePictureCacheByteSize() + EstimateLayerCacheByteSize();
+  if (cache_bytes <= max_retained_bytes_) {
+    return;
+  }
+
+  TRACE_EVENT0("flutter", "RasterCache::EvictToBudget");
+  // Evict the least recently used entries first. Among entries that were last
+  // used in the same frame, evict the largest first so that fewer entries have
+  // to be re-rasterized later. Entries used in the frame that just ended are
+  // never candidates, so the current working set stays cached even if it
+  // alone exceeds the budget.
+  std::sort(candidates.begin(), candidates.end(),
+            [](const EvictionCandidate& a, const EvictionCandidate& b) {
+              if (a.last_used_frame != b.last_used_frame) {
+                return a.last_used_frame < b.last_used_frame;
+              }
+              return a.bytes > b.bytes;
+            });
+  for (const auto& candidate : candidates) {
+    if (cache_bytes <= max_retained_bytes_) {
+      break;
+    }
+    cache_bytes -= candidate.bytes;
+    candidate.evict();
+  }
 }
 
 void RasterCache::Clear() {
@@ -306,6 +844,13 @@ void RasterCache::TraceStatsToTimeline() const {
                     EstimateLayerCacheByteSize() / kMegaByteSizeInBytes,
                     "PictureCount", picture_cache_.size(), "PictureMBytes",
                     EstimatePictureCacheByteSize() / kMegaByteSizeInBytes);
+  if (subtree_caching_enabled_) {
+    FML_TRACE_COUNTER("flutter", "RasterCacheSubtrees",
+                      reinterpret_cast<int64_t>(this),  // Trace Counter ID
+                      "Hits", subtree_cache_statistics_.hits,      //
+                      "Misses", subtree_cache_statistics_.misses,  //
+                      "Rasterized", subtree_cache_statistics_.rasterized);
+  }
 
 #endif  // !FLUTTER_RELEASE
 }
@@ -5,10 +5,16 @@
 #ifndef FLUTTER_FLOW_RASTER_CACHE_H_
 #define FLUTTER_FLOW_RASTER_CACHE_H_
 
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "flutter/flow/raster_cache_key.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/weak_ptr.h"
 #include "third_party/skia/include/core/SkImage.h"
@@ -47,9 +53,19 @@ class RasterCache {
   // multiple frames.
   static constexpr int kDefaultPictureCacheLimitPerFrame = 3;
 
+  // Retaining entries across frames is disabled by default. Entries that are
+  // not used in a frame are evicted in the following |SweepAfterFrame|.
+  static constexpr size_t kDefaultMaxRetainedBytes = 0;
+
+  // The most encoded image bytes that are kept in the PersistentCache by
+  // default. Storing an image that doesn't fit removes the least recently used
+  // images.
+  static constexpr size_t kMaxPersistentImageBytes = 32 * 1024 * 1024;
+
   explicit RasterCache(
       size_t access_threshold = 3,
-      size_t picture_cache_limit_per_frame = kDefaultPictureCacheLimitPerFrame);
+      size_t picture_cache_limit_per_frame = kDefaultPictureCacheLimitPerFrame,
+      size_t max_retained_bytes = kDefaultMaxRetainedBytes);
 
   virtual ~RasterCache() = default;
 
@@ -132,6 +148,8 @@ class RasterCache {
   // 3. The picture is accessed too few times
   // 4. There are too many pictures to be cached in the current frame.
   //    (See also kDefaultPictureCacheLimitPerFrame.)
+  // 5. The picture is being rasterized asynchronously and the result is not
+  //    ready yet. (See also SetAsyncRasterizationTaskRunner.)
   bool Prepare(GrDirectContext* context,
                SkPicture* picture,
                const SkMatrix& transformation_matrix,
@@ -141,10 +159,41 @@ class RasterCache {
 
   void Prepare(PrerollContext* context, Layer* layer, const SkMatrix& ctm);
 
+  // Mark the raster cache of a retained layer subtree as used in this frame.
+  //
+  // Return true if the subtree has been rasterized with the given matrix, in
+  // which case its children don't need to be prerolled and the layer can be
+  // drawn with |Draw|. Always returns false unless subtree caching is enabled.
+  // (See also SetSubtreeCachingEnabled.)
+  bool TouchSubtree(const Layer* layer, const SkMatrix& ctm);
+
+  // Whether |TouchSubtree| would return true, without marking the subtree as
+  // used. Unlike the other methods, this may be called from several threads
+  // at once while the cache is not modified.
+  bool HasSubtree(const Layer* layer, const SkMatrix& ctm) const;
+
+  // Prepare the raster cache for a layer subtree that was prerolled with the
+  // given matrix.
+  //
+  // Return true if the cache is generated. The subtree is only rasterized once
+  // the same layer has been prerolled in |access_threshold| consecutive
+  // frames, which means that the framework retained it and that it renders the
+  // same as in the previous frames. We may also return false if there are too
+  // many subtrees to be cached in the current frame. (See also
+  // kDefaultPictureCacheLimitPerFrame.)
+  bool PrepareSubtree(PrerollContext* context,
+                      Layer* layer,
+                      const SkMatrix& ctm);
+
   // Find the raster cache for the picture and draw it to the canvas.
   //
+  // Additional paint can be given to change how the raster cache is drawn
+  // (e.g., draw the raster cache with some opacity).
+  //
   // Return true if it's found and drawn.
-  bool Draw(const SkPicture& picture, SkCanvas& canvas) const;
+  bool Draw(const SkPicture& picture,
+            SkCanvas& canvas,
+            SkPaint* paint = nullptr) const;
 
   // Find the raster cache for the layer and draw it to the canvas.
   //
@@ -156,12 +205,124 @@ class RasterCache {
             SkCanvas& canvas,
             SkPaint* paint = nullptr) const;
 
+  // Evict entries at the end of a frame.
+  //
+  // If |max_retained_bytes| is zero, every entry that was not used during the
+  // frame is evicted. Otherwise rasterized entries are kept across frames and
+  // only the least recently used ones are evicted once the combined
+  // |EstimatePictureCacheByteSize| and |EstimateLayerCacheByteSize| exceed
+  // |max_retained_bytes|.
   void SweepAfterFrame();
 
   void Clear();
 
   void SetCheckboardCacheImages(bool checkerboard);
 
+  /**
+   * @brief Set the byte budget of raster cache entries that may be retained
+   * across frames even if they are not used. A value of zero restores the
+   * default behavior of evicting every entry that was unused in a frame.
+   *
+   * If the new budget is smaller than the current cache size, entries are
+   * evicted on the next |SweepAfterFrame|.
+   */
+  void SetMaxRetainedBytes(size_t max_retained_bytes) {
+    max_retained_bytes_ = max_retained_bytes;
+  }
+
+  size_t GetMaxRetainedBytes() const { return max_retained_bytes_; }
+
+  /**
+   * @brief Rasterize pictures on |task_runner| instead of synchronously
+   * during |Prepare|.
+   *
+   * The picture is rasterized into a CPU backed image off the raster thread.
+   * A later |Prepare| for the same picture adopts the result, uploading it to
+   * the GrDirectContext if there is one. Until then the picture is not cached
+   * and is played back directly. Adopting results still counts against
+   * the per-frame picture cache limit.
+   *
+   * Pictures that reference texture backed images can only be played back on
+   * the raster thread and are still rasterized synchronously.
+   *
+   * @param task_runner the task runner to rasterize pictures on, or nullptr to
+   *        always rasterize synchronously.
+   */
+  void SetAsyncRasterizationTaskRunner(
+      std::shared_ptr<fml::ConcurrentTaskRunner> task_runner) {
+    async_rasterization_task_runner_ = std::move(task_runner);
+  }
+
+  /**
+   * @brief Keep rasterized pictures in the PersistentCache so that later runs
+   * of the application don't have to rasterize them again.
+   *
+   * The images stored by previous runs are loaded on |task_runner|. A picture
+   * whose content, transformation and destination color space match a stored
+   * image is loaded and decoded on |task_runner| the first time it is
+   * prepared, without waiting for the access threshold, and played back
+   * directly until the image is ready. When a picture is cached, it is also
+   * rasterized into a CPU backed image and encoded as a PNG on |task_runner|,
+   * and the PersistentCache writes it to disk on its worker task runner.
+   *
+   * The keys of the stored pictures are computed on |task_runner| too, since
+   * that serializes the pictures. Pictures that reference images are never
+   * stored, since images can't be identified across runs. Typefaces are
+   * identified by their descriptors and the sizes of their font tables.
+   *
+   * Once the stored images reach |max_bytes|, the least recently used ones are
+   * removed to make room for new ones. Images stored by previous runs count as
+   * used before all images used in this run.
+   *
+   * @param task_runner the task runner to load, decode and encode images on,
+   *        or nullptr to not use the PersistentCache.
+   * @param max_bytes the most encoded image bytes to keep in the
+   *        PersistentCache.
+   */
+  void SetPersistentCacheTaskRunner(
+      std::shared_ptr<fml::ConcurrentTaskRunner> task_runner,
+      size_t max_bytes = kMaxPersistentImageBytes);
+
+  /**
+   * @brief Cache the rendering of plain ContainerLayer and TransformLayer
+   * subtrees that the framework retains from one frame to the next.
+   *
+   * A retained subtree is rasterized once and then drawn as an image, even if
+   * the translation of its parent changes, until it stops being retained.
+   * Subtrees that contain platform views or textures, or that read back the
+   * surface, are never cached.
+   */
+  void SetSubtreeCachingEnabled(bool enabled) {
+    subtree_caching_enabled_ = enabled;
+  }
+
+  bool subtree_caching_enabled() const { return subtree_caching_enabled_; }
+
+  // How effective subtree caching has been in the current frame.
+  struct SubtreeCacheStatistics {
+    // Subtrees drawn from the cache without prerolling their children.
+    size_t hits = 0;
+    // Cacheable subtrees that were prerolled and painted as usual because
+    // they were not stable yet or the per frame limit was reached.
+    size_t misses = 0;
+    // Subtrees rasterized into the cache.
+    size_t rasterized = 0;
+  };
+
+  const SubtreeCacheStatistics& subtree_cache_statistics() const {
+    return subtree_cache_statistics_;
+  }
+
+  // How many |Draw| calls in the current frame found a rasterized entry.
+  struct DrawStatistics {
+    size_t picture_hits = 0;
+    size_t picture_misses = 0;
+    size_t layer_hits = 0;
+    size_t layer_misses = 0;
+  };
+
+  const DrawStatistics& draw_statistics() const { return draw_statistics_; }
+
   size_t GetCachedEntriesCount() const;
 
   size_t GetLayerCachedEntriesCount() const;
@@ -189,10 +350,67 @@ class RasterCache {
   size_t EstimateLayerCacheByteSize() const;
 
  private:
+  // The key of a picture in the PersistentCache. Defined in raster_cache.cc.
+  class PersistentKey;
+
+  // The result of a picture rasterization that runs on
+  // |async_rasterization_task_runner_|.
+  struct AsyncRasterizationResult {
+    std::mutex mutex;
+    bool done = false;
+    sk_sp<SkImage> image;
+  };
+
   struct Entry {
     bool used_this_frame = false;
     size_t access_count = 0;
+    // The |frame_count_| of the last frame that used this entry. Only
+    // consulted when entries are retained across frames.
+    size_t last_used_frame = 0;
     std::unique_ptr<RasterCacheResult> image;
+    // Set while the picture for this entry is being rasterized
+    // asynchronously, or decoded from the PersistentCache.
+    std::shared_ptr<AsyncRasterizationResult> async_result;
+    // Whether the picture can be rasterized asynchronously, once it has been
+    // checked by |PrepareAsync|.
+    std::optional<bool> can_rasterize_off_thread;
+    // Whether the PersistentCache images have been searched for this entry.
+    bool checked_persistent_images = false;
+    // The key of this entry in the PersistentCache. Created on first use.
+    std::shared_ptr<PersistentKey> persistent_key;
+  };
+
+  // An encoded image in the PersistentCache.
+  struct PersistentImage {
+    // The size of the encoded image, or 0 until it is encoded.
+    size_t bytes = 0;
+    // The |PersistentImages::use_count| when the image was last loaded or
+    // stored. Images stored by previous runs start out at 0.
+    uint64_t last_used = 0;
+    // Whether the file is written. An image that is being stored or removed
+    // keeps its key so that no other task writes or removes the same file,
+    // but it is neither loaded nor evicted.
+    bool written = false;
+  };
+
+  // The encoded images in the PersistentCache, indexed by their keys. The
+  // images themselves are only loaded when a picture needs them. Shared with
+  // the tasks that load and store them.
+  struct PersistentImages {
+    std::mutex mutex;
+    bool loaded = false;
+    size_t max_bytes = 0;
+    std::unordered_map<std::string, PersistentImage> images;
+    size_t bytes = 0;
+    uint64_t use_count = 0;
+  };
+
+  // An entry that may be evicted to bring the cache back under
+  // |max_retained_bytes_|.
+  struct EvictionCandidate {
+    size_t last_used_frame;
+    int64_t bytes;
+    std::function<void()> evict;
   };
 
   template <class Cache>
@@ -212,12 +430,74 @@ class RasterCache {
     }
   }
 
+  // Like |SweepOneCacheAfterFrame|, but entries that hold a rasterized image
+  // survive the sweep. Unused entries with an image are appended to
+  // |candidates| so they can be evicted if the cache is over budget.
+  template <class Cache>
+  static void SweepOneCacheRetainingImages(
+      Cache& cache,
+      std::vector<EvictionCandidate>& candidates) {
+    std::vector<typename Cache::iterator> dead;
+
+    for (auto it = cache.begin(); it != cache.end(); ++it) {
+      Entry& entry = it->second;
+      if (!entry.used_this_frame) {
+        if (entry.image) {
+          candidates.push_back({entry.last_used_frame,
+                                entry.image->image_bytes(),
+                                [&cache, it]() { cache.erase(it); }});
+        } else {
+          dead.push_back(it);
+        }
+      }
+      entry.used_this_frame = false;
+    }
+
+    for (auto it : dead) {
+      cache.erase(it);
+    }
+  }
+
+  void SweepRetainedCachesAfterFrame();
+
+  bool PrepareAsync(Entry& entry,
+                    GrDirectContext* context,
+                    SkPicture* picture,
+                    const SkMatrix& transformation_matrix,
+                    SkColorSpace* dst_color_space);
+
+  std::shared_ptr<PersistentKey> GetPersistentKey(
+      Entry& entry,
+      SkPicture* picture,
+      const SkMatrix& transformation_matrix,
+      SkColorSpace* dst_color_space);
+
+  // Starts looking up and decoding the stored image of the picture.
+  void PrepareFromPersistentImages(Entry& entry,
+                                   SkPicture* picture,
+                                   const SkMatrix& transformation_matrix,
+                                   SkColorSpace* dst_color_space);
+
+  void StoreToPersistentImages(Entry& entry,
+                               SkPicture* picture,
+                               const SkMatrix& transformation_matrix,
+                               SkColorSpace* dst_color_space);
+
   const size_t access_threshold_;
   const size_t picture_cache_limit_per_frame_;
   size_t picture_cached_this_frame_ = 0;
+  size_t subtrees_cached_this_frame_ = 0;
+  bool subtree_caching_enabled_ = false;
+  SubtreeCacheStatistics subtree_cache_statistics_;
+  mutable DrawStatistics draw_statistics_;
+  size_t max_retained_bytes_;
+  size_t frame_count_ = 0;
   mutable PictureRasterCacheKey::Map<Entry> picture_cache_;
   mutable LayerRasterCacheKey::Map<Entry> layer_cache_;
   bool checkerboard_images_;
+  std::shared_ptr<fml::ConcurrentTaskRunner> async_rasterization_task_runner_;
+  std::shared_ptr<fml::ConcurrentTaskRunner> persistent_cache_task_runner_;
+  std::shared_ptr<PersistentImages> persistent_images_;
 
   void TraceStatsToTimeline() const;
 
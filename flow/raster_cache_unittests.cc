@@ -4,7 +4,16 @@
 
 #include "flutter/flow/raster_cache.h"
 
+#include <algorithm>
+#include <vector>
+
+#include "flutter/common/graphics/persistent_cache.h"
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/file.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/synchronization/waitable_event.h"
 #include "gtest/gtest.h"
+#include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkPaint.h"
 #include "third_party/skia/include/core/SkPicture.h"
@@ -14,16 +23,80 @@ namespace flutter {
 namespace testing {
 namespace {
 
-sk_sp<SkPicture> GetSamplePicture() {
+sk_sp<SkPicture> GetSamplePicture(SkColor color = SK_ColorRED) {
   SkPictureRecorder recorder;
   recorder.beginRecording(SkRect::MakeWH(150, 100));
   SkPaint paint;
-  paint.setColor(SK_ColorRED);
+  paint.setColor(color);
   recorder.getRecordingCanvas()->drawRect(SkRect::MakeXYWH(10, 10, 80, 80),
                                           paint);
   return recorder.finishRecordingAsPicture();
 }
 
+// A RasterCache that counts how often a picture had to be rasterized.
+class CountingRasterCache : public RasterCache {
+ public:
+  CountingRasterCache(size_t access_threshold,
+                      size_t picture_cache_limit_per_frame,
+                      size_t max_retained_bytes)
+      : RasterCache(access_threshold,
+                    picture_cache_limit_per_frame,
+                    max_retained_bytes) {}
+
+  std::unique_ptr<RasterCacheResult> RasterizePicture(
+      SkPicture* picture,
+      GrDirectContext* context,
+      const SkMatrix& ctm,
+      SkColorSpace* dst_color_space,
+      bool checkerboard) const override {
+    rasterize_count_++;
+    return RasterCache::RasterizePicture(picture, context, ctm,
+                                         dst_color_space, checkerboard);
+  }
+
+  size_t rasterize_count() const { return rasterize_count_; }
+
+ private:
+  mutable size_t rasterize_count_ = 0;
+};
+
+// Simulates a list of |pictures| that is scrolled down and back up again
+// while |viewport_size| items are visible. Each scroll position is held for
+// two frames.
+size_t RunScrollBackWorkload(CountingRasterCache& cache,
+                             const std::vector<sk_sp<SkPicture>>& pictures,
+                             size_t viewport_size) {
+  const std::vector<size_t> first_visible_items = {
+      0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 3, 3, 2, 2, 1, 1, 0, 0};
+  FML_CHECK(pictures.size() >=
+            *std::max_element(first_visible_items.begin(),
+                              first_visible_items.end()) +
+                viewport_size);
+
+  SkMatrix matrix = SkMatrix::I();
+  SkCanvas dummy_canvas;
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  for (size_t first : first_visible_items) {
+    for (size_t i = first; i < first + viewport_size; i++) {
+      cache.Prepare(NULL, pictures[i].get(), matrix, srgb.get(), true, false);
+      cache.Draw(*pictures[i], dummy_canvas);
+    }
+    cache.SweepAfterFrame();
+  }
+  return cache.rasterize_count();
+}
+
+// Waits for the tasks posted to a task runner with a single worker.
+void WaitForTasks(const std::shared_ptr<fml::ConcurrentTaskRunner>& runner) {
+  fml::AutoResetWaitableEvent latch;
+  runner->PostTask([&latch]() { latch.Signal(); });
+  latch.Wait();
+}
+
+size_t CountPersistentRasterCacheImages() {
+  return PersistentCache::GetCacheForProcess()->ListRasterCacheImages().size();
+}
+
 }  // namespace
 
 TEST(RasterCache, SimpleInitialization) {
@@ -65,6 +138,37 @@ TEST(RasterCache, ThresholdIsRespected) {
   ASSERT_TRUE(cache.Draw(*picture, dummy_canvas));
 }
 
+TEST(RasterCache, DrawStatisticsCountHitsAndMissesOfTheFrame) {
+  flutter::RasterCache cache(1);
+  SkMatrix matrix = SkMatrix::I();
+  auto picture = GetSamplePicture();
+  auto other_picture = GetSamplePicture();
+  SkCanvas dummy_canvas;
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+
+  // The picture is drawn directly in the first frame.
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+  EXPECT_EQ(cache.draw_statistics().picture_hits, 0u);
+  EXPECT_EQ(cache.draw_statistics().picture_misses, 1u);
+  cache.SweepAfterFrame();
+
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_TRUE(cache.Draw(*picture, dummy_canvas));
+  ASSERT_TRUE(cache.Draw(*picture, dummy_canvas));
+  ASSERT_FALSE(cache.Draw(*other_picture, dummy_canvas));
+  EXPECT_EQ(cache.draw_statistics().picture_hits, 2u);
+  EXPECT_EQ(cache.draw_statistics().picture_misses, 1u);
+  EXPECT_EQ(cache.draw_statistics().layer_hits, 0u);
+  EXPECT_EQ(cache.draw_statistics().layer_misses, 0u);
+
+  cache.SweepAfterFrame();
+  EXPECT_EQ(cache.draw_statistics().picture_hits, 0u);
+  EXPECT_EQ(cache.draw_statistics().picture_misses, 0u);
+}
+
 TEST(RasterCache, AccessThresholdOfZeroDisablesCaching) {
   size_t threshold = 0;
   flutter::RasterCache cache(threshold);
@@ -164,5 +268,254 @@ TEST(RasterCache, DeviceRectRoundOut) {
   ASSERT_TRUE(cache.Draw(*picture, canvas));
 }
 
+TEST(RasterCache, RetainedEntriesSurviveUnusedFrames) {
+  size_t threshold = 1;
+  size_t max_retained_bytes = 1024 * 1024;
+  flutter::RasterCache cache(threshold,
+                             RasterCache::kDefaultPictureCacheLimitPerFrame,
+                             max_retained_bytes);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture = GetSamplePicture();
+
+  SkCanvas dummy_canvas;
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_FALSE(cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true,
+                             false));  // 1
+  ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+
+  cache.SweepAfterFrame();
+
+  ASSERT_TRUE(cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true,
+                            false));  // 2
+  ASSERT_TRUE(cache.Draw(*picture, dummy_canvas));
+
+  cache.SweepAfterFrame();
+  cache.SweepAfterFrame();  // Extra frames without a Get image access.
+  cache.SweepAfterFrame();
+
+  ASSERT_EQ(cache.GetPictureCachedEntriesCount(), 1u);
+  ASSERT_TRUE(cache.Draw(*picture, dummy_canvas));
+
+  // Dropping the budget evicts the entry on the next sweep.
+  cache.SetMaxRetainedBytes(1);
+  cache.SweepAfterFrame();
+  cache.SweepAfterFrame();
+  ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+}
+
+TEST(RasterCache, RetainedEntriesAreEvictedLeastRecentlyUsedFirst) {
+  // Each sample picture rasterizes to a 150x100 N32 image.
+  const size_t picture_bytes = 150 * 100 * 4;
+  flutter::RasterCache cache(1, 10, 2 * picture_bytes);
+
+  SkMatrix matrix = SkMatrix::I();
+  SkCanvas dummy_canvas;
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+
+  auto prepare_and_draw = [&](const sk_sp<SkPicture>& picture) {
+    cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false);
+    return cache.Draw(*picture, dummy_canvas);
+  };
+
+  auto a = GetSamplePicture();
+  auto b = GetSamplePicture();
+  auto c = GetSamplePicture();
+
+  // Each picture reaches the access threshold in one frame and is rasterized
+  // in the next, so |a| ends up being the least recently used entry.
+  ASSERT_FALSE(prepare_and_draw(a));
+  cache.SweepAfterFrame();
+  ASSERT_TRUE(prepare_and_draw(a));
+  ASSERT_FALSE(prepare_and_draw(b));
+  cache.SweepAfterFrame();
+  ASSERT_TRUE(prepare_and_draw(b));
+  ASSERT_FALSE(prepare_and_draw(c));
+  cache.SweepAfterFrame();
+  ASSERT_EQ(cache.EstimatePictureCacheByteSize(), 2 * picture_bytes);
+
+  // Rasterizing |c| goes over budget. |a| is the least recently used entry.
+  ASSERT_TRUE(prepare_and_draw(c));
+  cache.SweepAfterFrame();
+  ASSERT_EQ(cache.EstimatePictureCacheByteSize(), 2 * picture_bytes);
+  ASSERT_FALSE(cache.Draw(*a, dummy_canvas));
+  ASSERT_TRUE(cache.Draw(*b, dummy_canvas));
+  ASSERT_TRUE(cache.Draw(*c, dummy_canvas));
+}
+
+TEST(RasterCache, RetainedEntriesSaveRerasterizationsOnScrollBack) {
+  const size_t viewport_size = 4;
+  std::vector<sk_sp<SkPicture>> pictures;
+  for (size_t i = 0; i < 8; i++) {
+    pictures.push_back(GetSamplePicture());
+  }
+
+  CountingRasterCache sweeping_cache(1, 10, 0);
+  size_t sweeping_rasterizations =
+      RunScrollBackWorkload(sweeping_cache, pictures, viewport_size);
+
+  CountingRasterCache retaining_cache(1, 10, 1024 * 1024);
+  size_t retaining_rasterizations =
+      RunScrollBackWorkload(retaining_cache, pictures, viewport_size);
+
+  FML_LOG(INFO) << "Scroll-back workload rasterizations: "
+                << sweeping_rasterizations << " when sweeping unused entries, "
+                << retaining_rasterizations << " when retaining entries.";
+
+  // Every item that leaves the viewport is rasterized again when it scrolls
+  // back in unless it is retained.
+  ASSERT_EQ(sweeping_rasterizations, 12u);
+  // With retention, every picture is rasterized exactly once.
+  ASSERT_EQ(retaining_rasterizations, pictures.size());
+  ASSERT_EQ(retaining_cache.GetPictureCachedEntriesCount(), pictures.size());
+}
+
+TEST(RasterCache, PersistentImagesAreDrawnInLaterRuns) {
+  fml::ScopedTemporaryDirectory dir;
+  PersistentCache::SetCacheDirectoryPath(dir.path());
+  PersistentCache::SetCacheRasterImages(true);
+  PersistentCache::ResetCacheForProcess();
+  auto loop = fml::ConcurrentMessageLoop::Create(1);
+  auto task_runner = loop->GetTaskRunner();
+
+  SkMatrix matrix = SkMatrix::I();
+  SkCanvas dummy_canvas;
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+
+  {
+    CountingRasterCache cache(1, 10, 0);
+    cache.SetPersistentCacheTaskRunner(task_runner);
+    WaitForTasks(task_runner);
+
+    auto picture = GetSamplePicture();
+    ASSERT_FALSE(
+        cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+    ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+    ASSERT_TRUE(
+        cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+    ASSERT_EQ(cache.rasterize_count(), 1u);
+    WaitForTasks(task_runner);
+  }
+  ASSERT_EQ(CountPersistentRasterCacheImages(), 1u);
+
+  {
+    // A later run records a new picture with the same content.
+    CountingRasterCache cache(3, 10, 0);
+    cache.SetPersistentCacheTaskRunner(task_runner);
+    WaitForTasks(task_runner);
+
+    auto picture = GetSamplePicture();
+    // The stored image is decoded without waiting for the access threshold.
+    cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false);
+    WaitForTasks(task_runner);
+    ASSERT_TRUE(
+        cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+    ASSERT_TRUE(cache.Draw(*picture, dummy_canvas));
+    ASSERT_EQ(cache.rasterize_count(), 0u);
+
+    // Pictures at a different scale are not matched.
+    SkMatrix scaled = SkMatrix::Scale(2, 2);
+    ASSERT_FALSE(
+        cache.Prepare(NULL, picture.get(), scaled, srgb.get(), true, false));
+  }
+
+  PersistentCache::SetCacheDirectoryPath("");
+  PersistentCache::SetCacheRasterImages(false);
+  PersistentCache::ResetCacheForProcess();
+}
+
+TEST(RasterCache, PersistentImagesEvictTheLeastRecentlyUsedImages) {
+  fml::ScopedTemporaryDirectory dir;
+  PersistentCache::SetCacheDirectoryPath(dir.path());
+  PersistentCache::SetCacheRasterImages(true);
+  PersistentCache::ResetCacheForProcess();
+  auto loop = fml::ConcurrentMessageLoop::Create(1);
+  auto task_runner = loop->GetTaskRunner();
+
+  SkMatrix matrix = SkMatrix::I();
+  SkCanvas dummy_canvas;
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+
+  {
+    CountingRasterCache cache(1, 10, 0);
+    cache.SetPersistentCacheTaskRunner(task_runner);
+    WaitForTasks(task_runner);
+    auto picture = GetSamplePicture(SK_ColorRED);
+    cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false);
+    cache.Draw(*picture, dummy_canvas);
+    ASSERT_TRUE(
+        cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+    WaitForTasks(task_runner);
+  }
+  auto images = PersistentCache::GetCacheForProcess()->ListRasterCacheImages();
+  ASSERT_EQ(images.size(), 1u);
+  sk_sp<SkData> first_key = images[0].first;
+  const size_t image_bytes = images[0].second;
+
+  {
+    // There is only room for one of the images.
+    CountingRasterCache cache(1, 10, 0);
+    cache.SetPersistentCacheTaskRunner(task_runner, image_bytes * 3 / 2);
+    WaitForTasks(task_runner);
+    auto picture = GetSamplePicture(SK_ColorBLUE);
+    // The lookup of the stored images misses.
+    cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false);
+    cache.Draw(*picture, dummy_canvas);
+    WaitForTasks(task_runner);
+    ASSERT_FALSE(
+        cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+    ASSERT_TRUE(
+        cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+    ASSERT_EQ(cache.rasterize_count(), 1u);
+    WaitForTasks(task_runner);
+  }
+  images = PersistentCache::GetCacheForProcess()->ListRasterCacheImages();
+  ASSERT_EQ(images.size(), 1u);
+  EXPECT_FALSE(images[0].first->equals(first_key.get()));
+
+  PersistentCache::SetCacheDirectoryPath("");
+  PersistentCache::SetCacheRasterImages(false);
+  PersistentCache::ResetCacheForProcess();
+}
+
+TEST(RasterCache, PicturesWithImagesAreNotPersisted) {
+  fml::ScopedTemporaryDirectory dir;
+  PersistentCache::SetCacheDirectoryPath(dir.path());
+  PersistentCache::SetCacheRasterImages(true);
+  PersistentCache::ResetCacheForProcess();
+  auto loop = fml::ConcurrentMessageLoop::Create(1);
+  auto task_runner = loop->GetTaskRunner();
+
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(10, 10);
+  bitmap.eraseColor(SK_ColorBLUE);
+  SkPictureRecorder recorder;
+  recorder.beginRecording(SkRect::MakeWH(150, 100));
+  recorder.getRecordingCanvas()->drawImage(SkImage::MakeFromBitmap(bitmap), 10,
+                                           10);
+  sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+  SkMatrix matrix = SkMatrix::I();
+  SkCanvas dummy_canvas;
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+
+  CountingRasterCache cache(1, 10, 0);
+  cache.SetPersistentCacheTaskRunner(task_runner);
+  WaitForTasks(task_runner);
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  WaitForTasks(task_runner);
+  ASSERT_EQ(CountPersistentRasterCacheImages(), 0u);
+
+  PersistentCache::SetCacheDirectoryPath("");
+  PersistentCache::SetCacheRasterImages(false);
+  PersistentCache::ResetCacheForProcess();
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -4,24 +4,52 @@
 
 #include "rtree.h"
 
-#include <list>
+#include <algorithm>
+#include <array>
 
 #include "flutter/fml/logging.h"
 #include "third_party/skia/include/core/SkBBHFactory.h"
 
 namespace flutter {
 
-RTree::RTree() : bbh_{SkRTreeFactory{}()}, all_ops_count_(0) {}
+RTree::RTree() : all_ops_count_(0) {}
 
 void RTree::insert(const SkRect boundsArray[],
                    const SkBBoxHierarchy::Metadata metadata[],
                    int N) {
   FML_DCHECK(0 == all_ops_count_);
-  bbh_->insert(boundsArray, metadata, N);
+  nodes_.clear();
+  is_draw_.assign(N, false);
+  if (N <= 0) {
+    return;
+  }
+
+  // A full tree has N leaves and fewer than N / (kBranchFactor - 1) branches,
+  // plus at most one partial branch per level.
+  nodes_.reserve(N + N / (kBranchFactor - 1) + 8);
   for (int i = 0; i < N; i++) {
-    if (metadata != nullptr && metadata[i].isDraw) {
-      draw_op_[i] = boundsArray[i];
+    SkRect bounds = boundsArray[i];
+    bounds.sort();
+    nodes_.push_back({bounds, 0, 0});
+    is_draw_[i] = metadata != nullptr && metadata[i].isDraw;
+  }
+
+  // Build the branches bottom up until a level has a single node, the root.
+  size_t level_start = 0;
+  size_t level_end = nodes_.size();
+  while (level_end - level_start > 1) {
+    for (size_t first = level_start; first < level_end;
+         first += kBranchFactor) {
+      const int count = static_cast<int>(
+          std::min<size_t>(kBranchFactor, level_end - first));
+      SkRect bounds = SkRect::MakeEmpty();
+      for (size_t child = first; child < first + count; child++) {
+        bounds.join(nodes_[child].bounds);
+      }
+      nodes_.push_back({bounds, static_cast<int>(first), count});
     }
+    level_start = level_end;
+    level_end = nodes_.size();
   }
   all_ops_count_ = N;
 }
@@ -31,58 +59,138 @@ void RTree::insert(const SkRect boundsArray[], int N) {
 }
 
 void RTree::search(const SkRect& query, std::vector<int>* results) const {
-  bbh_->search(query, results);
+  if (nodes_.empty()) {
+    return;
+  }
+  // Every level holds at most kBranchFactor - 1 pending siblings of the node
+  // that is visited, and a tree of up to INT_MAX operations has fewer than 10
+  // levels, so the pending nodes always fit in a fixed size stack.
+  std::array<int, 10 * kBranchFactor> stack;
+  size_t stack_size = 0;
+  stack[stack_size++] = static_cast<int>(nodes_.size()) - 1;
+  while (stack_size > 0) {
+    const int index = stack[--stack_size];
+    const Node& node = nodes_[index];
+    if (!SkRect::Intersects(node.bounds, query)) {
+      continue;
+    }
+    if (index < all_ops_count_) {
+      results->push_back(index);
+      continue;
+    }
+    // Push the children in reverse so that they are visited, and the leaves
+    // reported, in recording order.
+    for (int child = node.first_child + node.child_count - 1;
+         child >= node.first_child; child--) {
+      stack[stack_size++] = child;
+    }
+  }
 }
 
-std::list<SkRect> RTree::searchNonOverlappingDrawnRects(
+namespace {
+
+// The union of one or more drawn rects.
+struct Cluster {
+  SkRect rect;
+  // The index of the first drawing operation in the cluster.
+  int first_op;
+  bool merged = false;
+};
+
+// Joins intersecting clusters until no two clusters intersect.
+//
+// Each pass sweeps over the clusters in order of their left edges, and only
+// compares a cluster with the clusters whose right edges reach past its left
+// edge. Joining two clusters can make the result intersect a cluster that
+// was already swept past, so passes are repeated until one makes no joins.
+// That is rare, so this is O(n log n) in practice.
+void JoinIntersectingClusters(std::vector<Cluster>& clusters) {
+  std::vector<Cluster> swept;
+  std::vector<size_t> active;
+  bool joined_any = true;
+  while (joined_any && clusters.size() > 1) {
+    joined_any = false;
+    std::sort(clusters.begin(), clusters.end(),
+              [](const Cluster& a, const Cluster& b) {
+                return a.rect.fLeft < b.rect.fLeft;
+              });
+    swept.clear();
+    active.clear();
+    for (const Cluster& cluster : clusters) {
+      Cluster current = cluster;
+      // Clusters that end before this one starts can't intersect this or any
+      // later cluster in this pass.
+      active.erase(std::remove_if(active.begin(), active.end(),
+                                  [&](size_t index) {
+                                    return swept[index].rect.fRight <=
+                                           current.rect.fLeft;
+                                  }),
+                   active.end());
+      // The current cluster grows with each join, so keep looking until no
+      // active cluster intersects it.
+      bool joined = true;
+      while (joined) {
+        joined = false;
+        for (size_t i = 0; i < active.size();) {
+          Cluster& other = swept[active[i]];
+          if (SkRect::Intersects(other.rect, current.rect)) {
+            current.rect.join(other.rect);
+            current.first_op = std::min(current.first_op, other.first_op);
+            other.merged = true;
+            active[i] = active.back();
+            active.pop_back();
+            joined = joined_any = true;
+          } else {
+            i++;
+          }
+        }
+      }
+      active.push_back(swept.size());
+      swept.push_back(current);
+    }
+    clusters.clear();
+    for (const Cluster& cluster : swept) {
+      if (!cluster.merged) {
+        clusters.push_back(cluster);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+std::vector<SkRect> RTree::searchNonOverlappingDrawnRects(
     const SkRect& query) const {
   // Get the indexes for the operations that intersect with the query rect.
   std::vector<int> intermediary_results;
   search(query, &intermediary_results);
 
-  std::list<SkRect> final_results;
+  std::vector<Cluster> clusters;
+  clusters.reserve(intermediary_results.size());
   for (int index : intermediary_results) {
-    auto draw_op = draw_op_.find(index);
     // Ignore records that don't draw anything.
-    if (draw_op == draw_op_.end()) {
-      continue;
-    }
-    auto current_record_rect = draw_op->second;
-    auto replaced_existing_rect = false;
-    // // If the current record rect intersects with any of the rects in the
-    // // result list, then join them, and update the rect in final_results.
-    std::list<SkRect>::iterator curr_rect_itr = final_results.begin();
-    std::list<SkRect>::iterator first_intersecting_rect_itr;
-    while (!replaced_existing_rect && curr_rect_itr != final_results.end()) {
-      if (SkRect::Intersects(*curr_rect_itr, current_record_rect)) {
-        replaced_existing_rect = true;
-        first_intersecting_rect_itr = curr_rect_itr;
-        curr_rect_itr->join(current_record_rect);
-      }
-      curr_rect_itr++;
-    }
-    // It's possible that the result contains duplicated rects at this point.
-    // For example, consider a result list that contains rects A, B. If a
-    // new rect C is a superset of A and B, then A and B are the same set after
-    // the merge. As a result, find such cases and remove them from the result
-    // list.
-    while (replaced_existing_rect && curr_rect_itr != final_results.end()) {
-      if (SkRect::Intersects(*curr_rect_itr, *first_intersecting_rect_itr)) {
-        first_intersecting_rect_itr->join(*curr_rect_itr);
-        curr_rect_itr = final_results.erase(curr_rect_itr);
-      } else {
-        curr_rect_itr++;
-      }
-    }
-    if (!replaced_existing_rect) {
-      final_results.push_back(current_record_rect);
+    if (is_draw_[index]) {
+      clusters.push_back({nodes_[index].bounds, index});
     }
   }
+
+  JoinIntersectingClusters(clusters);
+
+  std::sort(clusters.begin(), clusters.end(),
+            [](const Cluster& a, const Cluster& b) {
+              return a.first_op < b.first_op;
+            });
+  std::vector<SkRect> final_results;
+  final_results.reserve(clusters.size());
+  for (const Cluster& cluster : clusters) {
+    final_results.push_back(cluster.rect);
+  }
   return final_results;
 }
 
 size_t RTree::bytesUsed() const {
-  return bbh_->bytesUsed();
+  return sizeof(*this) + nodes_.capacity() * sizeof(Node) +
+         is_draw_.capacity() / 8;
 }
 
 RTreeFactory::RTreeFactory() {
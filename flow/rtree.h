@@ -5,27 +5,37 @@
 #ifndef FLUTTER_FLOW_RTREE_H_
 #define FLUTTER_FLOW_RTREE_H_
 
-#include <list>
-#include <map>
+#include <vector>
 
 #include "third_party/skia/include/core/SkBBHFactory.h"
 #include "third_party/skia/include/core/SkTypes.h"
 
 namespace flutter {
 /**
- * An R-Tree implementation that forwards calls to an SkRTree.
+ * An R-Tree that is bulk loaded with the bounds of the operations recorded in
+ * a picture.
+ *
+ * The nodes of the tree are stored in a single contiguous vector. The leaves
+ * come first, one per operation in recording order, followed by each level
+ * of branches. Recorded operations tend to be spatially coherent, so grouping
+ * consecutive operations gives tight bounds without sorting.
  *
  * This implementation provides a searchNonOverlappingDrawnRects method,
  * which can be used to query the rects for the operations recorded in the tree.
  */
 class RTree : public SkBBoxHierarchy {
  public:
+  // The maximum number of children of a branch.
+  static constexpr int kBranchFactor = 16;
+
   RTree();
 
   void insert(const SkRect[],
               const SkBBoxHierarchy::Metadata[],
               int N) override;
   void insert(const SkRect[], int N) override;
+  // Appends the indexes of the operations that intersect with the query rect
+  // to |results|, in recording order.
   void search(const SkRect& query, std::vector<int>* results) const override;
   size_t bytesUsed() const override;
 
@@ -34,17 +44,25 @@ class RTree : public SkBBoxHierarchy {
   //
   // When two rects intersect with each other, they are joined into a single
   // rect which also intersects with the query rect. In other words, the bounds
-  // of each rect in the result list are mutually exclusive.
-  std::list<SkRect> searchNonOverlappingDrawnRects(const SkRect& query) const;
+  // of each rect in the result list are mutually exclusive. The rects are
+  // ordered by the first drawing operation that they contain.
+  std::vector<SkRect> searchNonOverlappingDrawnRects(const SkRect& query) const;
 
   // Insertion count (not overall node count, which may be greater).
   int getCount() const { return all_ops_count_; }
 
  private:
-  // A map containing the draw operation rects keyed off the operation index
-  // in the insert call.
-  std::map<int, SkRect> draw_op_;
-  sk_sp<SkBBoxHierarchy> bbh_;
+  struct Node {
+    SkRect bounds;
+    // The index of the first child of a branch in |nodes_|. Unused for
+    // leaves, whose index in |nodes_| is the index of their operation.
+    int first_child;
+    int child_count;
+  };
+
+  std::vector<Node> nodes_;
+  // Whether the operation at each index draws anything.
+  std::vector<bool> is_draw_;
   int all_ops_count_;
 };
 
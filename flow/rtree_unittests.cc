@@ -4,6 +4,8 @@
 
 #include "rtree.h"
 
+#include <random>
+
 #include "flutter/testing/testing.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkPictureRecorder.h"
@@ -231,5 +233,104 @@ TEST(RTree, searchNonOverlappingDrawnRectsJoinRectsWhenIntersectedCase3) {
   ASSERT_EQ(*hits.begin(), SkRect::MakeLTRB(50, 50, 620, 300));
 }
 
+TEST(RTree, searchReturnsIndexesInRecordingOrder) {
+  auto rtree_factory = RTreeFactory();
+  auto recorder = std::make_unique<SkPictureRecorder>();
+  auto recording_canvas =
+      recorder->beginRecording(SkRect::MakeIWH(1000, 1000), &rtree_factory);
+
+  auto rect_paint = SkPaint();
+  rect_paint.setColor(SkColors::kCyan);
+  rect_paint.setStyle(SkPaint::Style::kFill_Style);
+
+  // Record enough rects in a scattered order to need several levels of
+  // branches.
+  const int rect_count = RTree::kBranchFactor * RTree::kBranchFactor + 3;
+  for (int i = 0; i < rect_count; i++) {
+    int column = (i * 7) % 20;
+    int row = (i * 13) % 20;
+    recording_canvas->drawRect(
+        SkRect::MakeXYWH(column * 50, row * 50, 40, 40), rect_paint);
+  }
+  recorder->finishRecordingAsPicture();
+
+  auto rtree = rtree_factory.getInstance();
+  ASSERT_EQ(rtree->getCount(), rect_count);
+
+  std::vector<int> results;
+  rtree->search(SkRect::MakeIWH(1000, 1000), &results);
+  ASSERT_EQ(results.size(), static_cast<size_t>(rect_count));
+  for (int i = 0; i < rect_count; i++) {
+    ASSERT_EQ(results[i], i);
+  }
+
+  // Every 20th rect is recorded at the origin.
+  results.clear();
+  rtree->search(SkRect::MakeLTRB(5, 5, 15, 15), &results);
+  ASSERT_EQ(results.size(), static_cast<size_t>(rect_count / 20 + 1));
+  for (size_t i = 0; i < results.size(); i++) {
+    ASSERT_EQ(results[i], static_cast<int>(i) * 20);
+  }
+}
+
+TEST(RTree, searchNonOverlappingDrawnRectsRandomRects) {
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<float> position(0, 1000);
+  std::uniform_real_distribution<float> extent(1, 120);
+
+  for (int iteration = 0; iteration < 50; iteration++) {
+    auto rtree_factory = RTreeFactory();
+    auto recorder = std::make_unique<SkPictureRecorder>();
+    auto recording_canvas =
+        recorder->beginRecording(SkRect::MakeIWH(1100, 1100), &rtree_factory);
+
+    auto rect_paint = SkPaint();
+    rect_paint.setColor(SkColors::kCyan);
+    rect_paint.setStyle(SkPaint::Style::kFill_Style);
+
+    std::vector<SkRect> rects;
+    for (int i = 0; i < 200; i++) {
+      rects.push_back(SkRect::MakeXYWH(position(generator), position(generator),
+                                       extent(generator), extent(generator)));
+      recording_canvas->drawRect(rects.back(), rect_paint);
+    }
+    recorder->finishRecordingAsPicture();
+
+    SkRect query = SkRect::MakeLTRB(250, 250, 750, 750);
+    auto hits =
+        rtree_factory.getInstance()->searchNonOverlappingDrawnRects(query);
+
+    // The rects in the result are mutually exclusive.
+    for (size_t i = 0; i < hits.size(); i++) {
+      for (size_t j = i + 1; j < hits.size(); j++) {
+        ASSERT_FALSE(SkRect::Intersects(hits[i], hits[j]));
+      }
+    }
+
+    // Every drawn rect that intersects the query is covered by exactly one
+    // rect in the result, and the result is ordered by the first drawn rect
+    // that each rect covers.
+    size_t next_hit = 0;
+    for (const SkRect& rect : rects) {
+      if (!SkRect::Intersects(rect, query)) {
+        continue;
+      }
+      size_t covering_hit = hits.size();
+      for (size_t i = 0; i < hits.size(); i++) {
+        if (hits[i].contains(rect)) {
+          covering_hit = i;
+          break;
+        }
+      }
+      ASSERT_LT(covering_hit, hits.size());
+      ASSERT_LE(covering_hit, next_hit);
+      if (covering_hit == next_hit) {
+        next_hit++;
+      }
+    }
+    ASSERT_EQ(next_hit, hits.size());
+  }
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -6,6 +6,7 @@
 #define FLUTTER_FLOW_SURFACE_FRAME_H_
 
 #include <memory>
+#include <optional>
 
 #include "flutter/common/graphics/gl_context_switch.h"
 #include "flutter/fml/macros.h"
@@ -21,6 +22,34 @@ class SurfaceFrame {
   using SubmitCallback =
       std::function<bool(const SurfaceFrame& surface_frame, SkCanvas* canvas)>;
 
+  // Information about the underlying framebuffer, provided by the surface
+  // that acquired the frame.
+  struct FramebufferInfo {
+    // Whether painting may be restricted to the damaged area of the frame.
+    // When set, the rasterizer diffs each layer tree against the previous one
+    // and reports the result through |SubmitInfo|.
+    bool supports_partial_repaint = false;
+
+    // The area of the framebuffer whose contents differ from the previously
+    // rasterized frame, e.g. because the framebuffer was last painted a few
+    // frames ago. If not set, the contents of the framebuffer are undefined
+    // and the whole frame must be repainted.
+    std::optional<SkIRect> existing_damage;
+  };
+
+  // Information about the frame being submitted, provided by the rasterizer.
+  // All rects are in the coordinates of the layer tree.
+  struct SubmitInfo {
+    // The area of the frame that changed since the previous frame. If not set,
+    // the whole frame is assumed to have changed.
+    std::optional<SkIRect> frame_damage;
+
+    // The area of the framebuffer that was repainted for this frame. This is
+    // |frame_damage| plus the existing damage of the framebuffer. If not set,
+    // the whole framebuffer was repainted.
+    std::optional<SkIRect> buffer_damage;
+  };
+
   SurfaceFrame(sk_sp<SkSurface> surface,
                bool supports_readback,
                const SubmitCallback& submit_callback);
@@ -42,10 +71,22 @@ class SurfaceFrame {
 
   bool supports_readback() { return supports_readback_; }
 
+  void set_framebuffer_info(const FramebufferInfo& framebuffer_info) {
+    framebuffer_info_ = framebuffer_info;
+  }
+  const FramebufferInfo& framebuffer_info() const { return framebuffer_info_; }
+
+  void set_submit_info(const SubmitInfo& submit_info) {
+    submit_info_ = submit_info;
+  }
+  const SubmitInfo& submit_info() const { return submit_info_; }
+
  private:
   bool submitted_ = false;
   sk_sp<SkSurface> surface_;
   bool supports_readback_;
+  FramebufferInfo framebuffer_info_;
+  SubmitInfo submit_info_;
   SubmitCallback submit_callback_;
   std::unique_ptr<GLContextResult> context_result_;
 
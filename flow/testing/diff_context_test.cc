@@ -3,8 +3,6 @@
 namespace flutter {
 namespace testing {
 
-#ifdef FLUTTER_ENABLE_DIFF_CONTEXT
-
 DiffContextTest::DiffContextTest()
     : unref_queue_(fml::MakeRefCounted<SkiaUnrefQueue>(
           GetCurrentTaskRunner(),
@@ -20,6 +18,7 @@ Damage DiffContextTest::DiffLayerTree(MockLayerTree& layer_tree,
   dc.PushCullRect(
       SkRect::MakeIWH(layer_tree.size().width(), layer_tree.size().height()));
   layer_tree.root()->Diff(&dc, old_layer_tree.root());
+  last_statistics_ = dc.statistics();
   return dc.ComputeDamage(additional_damage);
 }
 
@@ -47,7 +46,5 @@ std::shared_ptr<ContainerLayer> DiffContextTest::CreateContainerLayer(
   return res;
 }
 
-#endif  // FLUTTER_ENABLE_DIFF_CONTEXT
-
 }  // namespace testing
 }  // namespace flutter
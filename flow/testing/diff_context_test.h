@@ -7,8 +7,6 @@
 namespace flutter {
 namespace testing {
 
-#ifdef FLUTTER_ENABLE_DIFF_CONTEXT
-
 class MockLayerTree {
  public:
   explicit MockLayerTree(SkISize size = SkISize::Make(1000, 1000))
@@ -36,6 +34,11 @@ class DiffContextTest : public ThreadTest {
                        const MockLayerTree& old_layer_tree,
                        const SkIRect& additional_damage = SkIRect::MakeEmpty());
 
+  // Statistics collected by the last DiffLayerTree call.
+  const DiffContext::Statistics& last_statistics() const {
+    return last_statistics_;
+  }
+
   // Create picture consisting of filled rect with given color; Being able
   // to specify different color is useful to test deep comparison of pictures
   sk_sp<SkPicture> CreatePicture(const SkRect& bounds, uint32_t color);
@@ -56,9 +59,8 @@ class DiffContextTest : public ThreadTest {
 
  private:
   fml::RefPtr<SkiaUnrefQueue> unref_queue_;
+  DiffContext::Statistics last_statistics_;
 };
 
-#endif  // FLUTTER_ENABLE_DIFF_CONTEXT
-
 }  // namespace testing
 }  // namespace flutter
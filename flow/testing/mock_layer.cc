@@ -18,8 +18,6 @@ MockLayer::MockLayer(SkPath path,
       fake_needs_system_composite_(fake_needs_system_composite),
       fake_reads_surface_(fake_reads_surface) {}
 
-#ifdef FLUTTER_ENABLE_DIFF_CONTEXT
-
 bool MockLayer::IsReplacing(DiffContext* context, const Layer* layer) const {
   // Similar to PictureLayer, only return true for identical mock layers;
   // That way ContainerLayer::DiffChildren can properly detect mock layer
@@ -35,8 +33,6 @@ void MockLayer::Diff(DiffContext* context, const Layer* old_layer) {
   context->SetLayerPaintRegion(this, context->CurrentSubtreeRegion());
 }
 
-#endif
-
 void MockLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
   parent_mutators_ = context->mutators_stack;
   parent_matrix_ = matrix;
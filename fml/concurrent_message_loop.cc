@@ -5,6 +5,7 @@
 #include "flutter/fml/concurrent_message_loop.h"
 
 #include <algorithm>
+#include <iterator>
 
 #include "flutter/fml/thread.h"
 #include "flutter/fml/trace_event.h"
@@ -12,18 +13,28 @@
 namespace fml {
 
 std::shared_ptr<ConcurrentMessageLoop> ConcurrentMessageLoop::Create(
-    size_t worker_count) {
+    size_t worker_count,
+    WorkerStartCallback on_worker_start) {
   return std::shared_ptr<ConcurrentMessageLoop>{
-      new ConcurrentMessageLoop(worker_count)};
+      new ConcurrentMessageLoop(worker_count, on_worker_start)};
 }
 
-ConcurrentMessageLoop::ConcurrentMessageLoop(size_t worker_count)
+ConcurrentMessageLoop::ConcurrentMessageLoop(
+    size_t worker_count,
+    const WorkerStartCallback& on_worker_start)
     : worker_count_(std::max<size_t>(worker_count, 1ul)) {
   for (size_t i = 0; i < worker_count_; ++i) {
-    workers_.emplace_back([i, this]() {
+    worker_queues_.emplace_back(std::make_unique<Worker>());
+  }
+
+  for (size_t i = 0; i < worker_count_; ++i) {
+    workers_.emplace_back([i, this, on_worker_start]() {
       fml::Thread::SetCurrentThreadName(
           std::string{"io.worker." + std::to_string(i + 1)});
-      WorkerMain();
+      if (on_worker_start) {
+        on_worker_start(i);
+      }
+      WorkerMain(i);
     });
   }
 
@@ -47,59 +58,147 @@ std::shared_ptr<ConcurrentTaskRunner> ConcurrentMessageLoop::GetTaskRunner() {
   return std::make_shared<ConcurrentTaskRunner>(weak_from_this());
 }
 
+size_t ConcurrentMessageLoop::GetWorkerIndexForPost() {
+  // Tasks posted by a worker go to its own queue. Idle workers will steal
+  // them if the worker is busy.
+  const auto thread_id = std::this_thread::get_id();
+  for (size_t i = 0; i < worker_thread_ids_.size(); ++i) {
+    if (worker_thread_ids_[i] == thread_id) {
+      return i;
+    }
+  }
+  return next_worker_++ % worker_count_;
+}
+
 void ConcurrentMessageLoop::PostTask(const fml::closure& task) {
   if (!task) {
     return;
   }
 
-  std::unique_lock lock(tasks_mutex_);
-
   // Don't just drop tasks on the floor in case of shutdown.
   if (shutdown_) {
     FML_DLOG(WARNING)
         << "Tried to post a task to shutdown concurrent message "
            "loop. The task will be executed on the callers thread.";
-    lock.unlock();
     task();
     return;
   }
 
-  tasks_.push(task);
+  {
+    auto& worker = *worker_queues_[GetWorkerIndexForPost()];
+    std::scoped_lock lock(worker.mutex);
+    worker.tasks.push_back(task);
+    pending_tasks_++;
+  }
+
+  WakeUpIdleWorkers(1);
+}
+
+void ConcurrentMessageLoop::PostTasks(std::vector<fml::closure> tasks) {
+  tasks.erase(std::remove_if(tasks.begin(), tasks.end(),
+                             [](const fml::closure& task) { return !task; }),
+              tasks.end());
+  if (tasks.empty()) {
+    return;
+  }
+
+  if (shutdown_) {
+    FML_DLOG(WARNING)
+        << "Tried to post tasks to shutdown concurrent message "
+           "loop. The tasks will be executed on the callers thread.";
+    for (const auto& task : tasks) {
+      task();
+    }
+    return;
+  }
 
-  // Unlock the mutex before notifying the condition variable because that mutex
-  // has to be acquired on the other thread anyway. Waiting in this scope till
-  // it is acquired there is a pessimization.
-  lock.unlock();
+  // Spread the tasks evenly over the workers so that each worker queue is
+  // locked at most once.
+  const size_t first_worker = next_worker_.fetch_add(worker_count_);
+  const size_t tasks_per_worker =
+      (tasks.size() + worker_count_ - 1) / worker_count_;
+  auto next_task = tasks.begin();
+  for (size_t i = 0; next_task != tasks.end(); ++i) {
+    const size_t count = std::min<size_t>(
+        tasks_per_worker, std::distance(next_task, tasks.end()));
+    auto& worker = *worker_queues_[(first_worker + i) % worker_count_];
+    std::scoped_lock lock(worker.mutex);
+    worker.tasks.insert(worker.tasks.end(), std::make_move_iterator(next_task),
+                        std::make_move_iterator(next_task + count));
+    pending_tasks_ += count;
+    next_task += count;
+  }
 
-  tasks_condition_.notify_one();
+  WakeUpIdleWorkers(tasks.size());
 }
 
-void ConcurrentMessageLoop::WorkerMain() {
-  while (true) {
-    std::unique_lock lock(tasks_mutex_);
-    tasks_condition_.wait(lock, [&]() {
-      return tasks_.size() > 0 || shutdown_ || HasThreadTasksLocked();
-    });
+void ConcurrentMessageLoop::WakeUpIdleWorkers(size_t task_count) {
+  // Idle workers register themselves before checking for pending tasks, so
+  // either they see the new tasks or the new tasks see them.
+  const size_t idle_workers = idle_workers_;
+  if (idle_workers == 0) {
+    return;
+  }
 
-    // Shutdown cannot be read with the task mutex unlocked.
+  // Acquiring the mutex makes sure that a worker that has just found no
+  // pending tasks is actually waiting before it is notified.
+  { std::scoped_lock lock(idle_mutex_); }
+  if (task_count >= idle_workers) {
+    idle_condition_.notify_all();
+  } else {
+    for (size_t i = 0; i < task_count; ++i) {
+      idle_condition_.notify_one();
+    }
+  }
+}
+
+fml::closure ConcurrentMessageLoop::TakeTask(size_t worker_index) {
+  for (size_t i = 0; i < worker_count_; ++i) {
+    auto& worker = *worker_queues_[(worker_index + i) % worker_count_];
+    std::scoped_lock lock(worker.mutex);
+    if (!worker.tasks.empty()) {
+      fml::closure task = std::move(worker.tasks.front());
+      worker.tasks.pop_front();
+      pending_tasks_--;
+      return task;
+    }
+  }
+  return nullptr;
+}
+
+void ConcurrentMessageLoop::WorkerMain(size_t worker_index) {
+  auto& worker = *worker_queues_[worker_index];
+  bool yielded = false;
+  while (true) {
     bool shutdown_now = shutdown_;
-    fml::closure task;
+    fml::closure task = TakeTask(worker_index);
     std::vector<fml::closure> thread_tasks;
 
-    if (tasks_.size() != 0) {
-      task = tasks_.front();
-      tasks_.pop();
+    if (worker.has_thread_tasks) {
+      std::scoped_lock lock(worker.mutex);
+      std::swap(thread_tasks, worker.thread_tasks);
+      worker.has_thread_tasks = false;
     }
 
-    if (HasThreadTasksLocked()) {
-      thread_tasks = GetThreadTasksLocked();
-      FML_DCHECK(!HasThreadTasksLocked());
+    if (!task && thread_tasks.empty() && !shutdown_now) {
+      // Tasks are often posted in quick succession. Give the posting threads
+      // a chance to run once before going to sleep as waking up again is much
+      // more expensive.
+      if (!yielded) {
+        yielded = true;
+        std::this_thread::yield();
+        continue;
+      }
+      yielded = false;
+      std::unique_lock lock(idle_mutex_);
+      idle_workers_++;
+      idle_condition_.wait(lock, [&]() {
+        return pending_tasks_ > 0 || shutdown_ || worker.has_thread_tasks;
+      });
+      idle_workers_--;
+      continue;
     }
 
-    // Don't hold onto the mutex while tasks are being executed as they could
-    // themselves try to post more tasks to the message loop.
-    lock.unlock();
-
     TRACE_EVENT0("flutter", "ConcurrentWorkerWake");
     // Execute the primary task we woke up for.
     if (task) {
@@ -118,9 +217,9 @@ void ConcurrentMessageLoop::WorkerMain() {
 }
 
 void ConcurrentMessageLoop::Terminate() {
-  std::scoped_lock lock(tasks_mutex_);
+  std::scoped_lock lock(idle_mutex_);
   shutdown_ = true;
-  tasks_condition_.notify_all();
+  idle_condition_.notify_all();
 }
 
 void ConcurrentMessageLoop::PostTaskToAllWorkers(fml::closure task) {
@@ -128,24 +227,14 @@ void ConcurrentMessageLoop::PostTaskToAllWorkers(fml::closure task) {
     return;
   }
 
-  std::scoped_lock lock(tasks_mutex_);
-  for (const auto& worker_thread_id : worker_thread_ids_) {
-    thread_tasks_[worker_thread_id].emplace_back(task);
+  for (const auto& worker : worker_queues_) {
+    std::scoped_lock lock(worker->mutex);
+    worker->thread_tasks.emplace_back(task);
+    worker->has_thread_tasks = true;
   }
-  tasks_condition_.notify_all();
-}
-
-bool ConcurrentMessageLoop::HasThreadTasksLocked() const {
-  return thread_tasks_.count(std::this_thread::get_id()) > 0;
-}
 
-std::vector<fml::closure> ConcurrentMessageLoop::GetThreadTasksLocked() {
-  auto found = thread_tasks_.find(std::this_thread::get_id());
-  FML_DCHECK(found != thread_tasks_.end());
-  std::vector<fml::closure> pending_tasks;
-  std::swap(pending_tasks, found->second);
-  thread_tasks_.erase(found);
-  return pending_tasks;
+  std::scoped_lock lock(idle_mutex_);
+  idle_condition_.notify_all();
 }
 
 ConcurrentTaskRunner::ConcurrentTaskRunner(
@@ -170,4 +259,20 @@ void ConcurrentTaskRunner::PostTask(const fml::closure& task) {
   task();
 }
 
+void ConcurrentTaskRunner::PostTasks(std::vector<fml::closure> tasks) {
+  if (auto loop = weak_loop_.lock()) {
+    loop->PostTasks(std::move(tasks));
+    return;
+  }
+
+  FML_DLOG(WARNING)
+      << "Tried to post to a concurrent message loop that has already died. "
+         "Executing the tasks on the callers thread.";
+  for (const auto& task : tasks) {
+    if (task) {
+      task();
+    }
+  }
+}
+
 }  // namespace fml
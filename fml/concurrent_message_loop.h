@@ -5,10 +5,14 @@
 #ifndef FLUTTER_FML_CONCURRENT_MESSAGE_LOOP_H_
 #define FLUTTER_FML_CONCURRENT_MESSAGE_LOOP_H_
 
+#include <atomic>
 #include <condition_variable>
-#include <map>
-#include <queue>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 #include "flutter/fml/closure.h"
 #include "flutter/fml/macros.h"
@@ -21,8 +25,16 @@ class ConcurrentTaskRunner;
 class ConcurrentMessageLoop
     : public std::enable_shared_from_this<ConcurrentMessageLoop> {
  public:
+  //----------------------------------------------------------------------------
+  /// Invoked on each worker thread before it runs any tasks, with the index of
+  /// the worker. This is the place to set the CPU affinity or the priority of
+  /// the worker threads.
+  ///
+  using WorkerStartCallback = std::function<void(size_t worker_index)>;
+
   static std::shared_ptr<ConcurrentMessageLoop> Create(
-      size_t worker_count = std::thread::hardware_concurrency());
+      size_t worker_count = std::thread::hardware_concurrency(),
+      WorkerStartCallback on_worker_start = nullptr);
 
   ~ConcurrentMessageLoop();
 
@@ -37,24 +49,43 @@ class ConcurrentMessageLoop
  private:
   friend ConcurrentTaskRunner;
 
+  // Each worker has its own queue of tasks. A worker runs the tasks from its
+  // own queue first and steals tasks from the queues of the other workers
+  // once it runs out.
+  struct Worker {
+    std::mutex mutex;
+    std::deque<fml::closure> tasks;
+    std::vector<fml::closure> thread_tasks;
+    std::atomic_bool has_thread_tasks = false;
+  };
+
   size_t worker_count_ = 0;
   std::vector<std::thread> workers_;
-  std::mutex tasks_mutex_;
-  std::condition_variable tasks_condition_;
-  std::queue<fml::closure> tasks_;
+  std::vector<std::unique_ptr<Worker>> worker_queues_;
   std::vector<std::thread::id> worker_thread_ids_;
-  std::map<std::thread::id, std::vector<fml::closure>> thread_tasks_;
-  bool shutdown_ = false;
+  std::atomic_size_t next_worker_ = 0;
+  // The number of tasks in all worker queues. Only modified with the mutex of
+  // the worker queue the task is added to or taken from held.
+  std::atomic_size_t pending_tasks_ = 0;
+  std::atomic_size_t idle_workers_ = 0;
+  std::mutex idle_mutex_;
+  std::condition_variable idle_condition_;
+  std::atomic_bool shutdown_ = false;
 
-  ConcurrentMessageLoop(size_t worker_count);
+  ConcurrentMessageLoop(size_t worker_count,
+                        const WorkerStartCallback& on_worker_start);
 
-  void WorkerMain();
+  void WorkerMain(size_t worker_index);
 
   void PostTask(const fml::closure& task);
 
-  bool HasThreadTasksLocked() const;
+  void PostTasks(std::vector<fml::closure> tasks);
+
+  size_t GetWorkerIndexForPost();
 
-  std::vector<fml::closure> GetThreadTasksLocked();
+  fml::closure TakeTask(size_t worker_index);
+
+  void WakeUpIdleWorkers(size_t task_count);
 
   FML_DISALLOW_COPY_AND_ASSIGN(ConcurrentMessageLoop);
 };
@@ -67,6 +98,13 @@ class ConcurrentTaskRunner : public BasicTaskRunner {
 
   void PostTask(const fml::closure& task) override;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Posts all of the given tasks at once. This is cheaper than
+  ///             posting the tasks one by one as the tasks are spread over
+  ///             the workers with a single lock acquisition per worker.
+  ///
+  void PostTasks(std::vector<fml::closure> tasks);
+
  private:
   friend ConcurrentMessageLoop;
 
@@ -0,0 +1,178 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/concurrent_message_loop.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
+
+namespace fml {
+namespace benchmarking {
+
+namespace {
+
+// A pool where all workers share a single queue guarded by one mutex. This
+// is how ConcurrentMessageLoop used to schedule tasks and serves as the
+// reference the work-stealing scheduler is compared against.
+class SingleQueueWorkerPool {
+ public:
+  explicit SingleQueueWorkerPool(size_t worker_count) {
+    for (size_t i = 0; i < worker_count; ++i) {
+      workers_.emplace_back([this]() { WorkerMain(); });
+    }
+  }
+
+  ~SingleQueueWorkerPool() {
+    {
+      std::scoped_lock lock(mutex_);
+      shutdown_ = true;
+    }
+    condition_.notify_all();
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  void PostTask(const fml::closure& task) {
+    {
+      std::scoped_lock lock(mutex_);
+      tasks_.push(task);
+    }
+    condition_.notify_one();
+  }
+
+  void PostTasks(std::vector<fml::closure> tasks) {
+    for (const auto& task : tasks) {
+      PostTask(task);
+    }
+  }
+
+ private:
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::queue<fml::closure> tasks_;
+  bool shutdown_ = false;
+
+  void WorkerMain() {
+    while (true) {
+      std::unique_lock lock(mutex_);
+      condition_.wait(lock, [&]() { return !tasks_.empty() || shutdown_; });
+      if (tasks_.empty()) {
+        return;
+      }
+      fml::closure task = std::move(tasks_.front());
+      tasks_.pop();
+      lock.unlock();
+      task();
+    }
+  }
+};
+
+class WorkStealingWorkerPool {
+ public:
+  explicit WorkStealingWorkerPool(size_t worker_count)
+      : loop_(ConcurrentMessageLoop::Create(worker_count)),
+        task_runner_(loop_->GetTaskRunner()) {}
+
+  void PostTask(const fml::closure& task) { task_runner_->PostTask(task); }
+
+  void PostTasks(std::vector<fml::closure> tasks) {
+    task_runner_->PostTasks(std::move(tasks));
+  }
+
+ private:
+  std::shared_ptr<ConcurrentMessageLoop> loop_;
+  std::shared_ptr<ConcurrentTaskRunner> task_runner_;
+};
+
+constexpr size_t kWorkerCount = 4;
+constexpr size_t kProducerCount = 4;
+
+}  // namespace
+
+// Many small tasks posted one by one from several threads.
+template <class WorkerPool>
+static void BM_PostSmallTasks(benchmark::State& state) {  // NOLINT
+  WorkerPool pool(kWorkerCount);
+  const size_t num_tasks = state.range(0);
+  while (state.KeepRunning()) {
+    CountDownLatch latch(num_tasks);
+    std::vector<std::thread> producers;
+    for (size_t i = 0; i < kProducerCount; ++i) {
+      producers.emplace_back([&pool, &latch, num_tasks]() {
+        for (size_t j = 0; j < num_tasks / kProducerCount; ++j) {
+          pool.PostTask([&latch]() { latch.CountDown(); });
+        }
+      });
+    }
+    for (auto& producer : producers) {
+      producer.join();
+    }
+    latch.Wait();
+  }
+  state.SetItemsProcessed(state.iterations() * num_tasks);
+}
+
+// Many small tasks posted as a single batch.
+template <class WorkerPool>
+static void BM_PostSmallTaskBatch(benchmark::State& state) {  // NOLINT
+  WorkerPool pool(kWorkerCount);
+  const size_t num_tasks = state.range(0);
+  while (state.KeepRunning()) {
+    CountDownLatch latch(num_tasks);
+    std::vector<fml::closure> tasks(num_tasks,
+                                    [&latch]() { latch.CountDown(); });
+    pool.PostTasks(std::move(tasks));
+    latch.Wait();
+  }
+  state.SetItemsProcessed(state.iterations() * num_tasks);
+}
+
+// Small tasks that are posted by tasks already running on the workers.
+template <class WorkerPool>
+static void BM_PostNestedSmallTasks(benchmark::State& state) {  // NOLINT
+  WorkerPool pool(kWorkerCount);
+  const size_t num_tasks = state.range(0);
+  while (state.KeepRunning()) {
+    CountDownLatch latch(num_tasks);
+    for (size_t i = 0; i < kWorkerCount; ++i) {
+      pool.PostTask([&pool, &latch, num_tasks]() {
+        for (size_t j = 0; j < num_tasks / kWorkerCount; ++j) {
+          pool.PostTask([&latch]() { latch.CountDown(); });
+        }
+      });
+    }
+    latch.Wait();
+  }
+  state.SetItemsProcessed(state.iterations() * num_tasks);
+}
+
+BENCHMARK_TEMPLATE(BM_PostSmallTasks, SingleQueueWorkerPool)
+    ->Arg(10000)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_PostSmallTasks, WorkStealingWorkerPool)
+    ->Arg(10000)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_PostSmallTaskBatch, SingleQueueWorkerPool)
+    ->Arg(10000)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_PostSmallTaskBatch, WorkStealingWorkerPool)
+    ->Arg(10000)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_PostNestedSmallTasks, SingleQueueWorkerPool)
+    ->Arg(10000)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_PostNestedSmallTasks, WorkStealingWorkerPool)
+    ->Arg(10000)
+    ->UseRealTime();
+
+}  // namespace benchmarking
+}  // namespace fml
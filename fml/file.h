@@ -72,6 +72,9 @@ bool IsFile(const std::string& path);
 
 bool TruncateFile(const fml::UniqueFD& file, size_t size);
 
+// Reads the size of the given file into |size| without mapping or reading it.
+bool GetFileSize(const fml::UniqueFD& file, size_t* size);
+
 bool FileExists(const fml::UniqueFD& base_directory, const char* path);
 
 bool UnlinkDirectory(const char* path);
@@ -253,6 +253,26 @@ TEST(FileTest, AtomicWriteTest) {
   ASSERT_TRUE(fml::UnlinkFile(dir.fd(), "precious_data"));
 }
 
+TEST(FileTest, CanGetFileSize) {
+  fml::ScopedTemporaryDirectory dir;
+
+  const std::string contents = "These are my contents.";
+
+  auto data = std::make_unique<fml::DataMapping>(
+      std::vector<uint8_t>{contents.begin(), contents.end()});
+  ASSERT_TRUE(fml::WriteAtomically(dir.fd(), "sized_data", *data));
+
+  size_t size = 0;
+  ASSERT_TRUE(fml::GetFileSize(
+      fml::OpenFile(dir.fd(), "sized_data", false, fml::FilePermission::kRead),
+      &size));
+  ASSERT_EQ(size, contents.size());
+  ASSERT_FALSE(fml::GetFileSize(fml::UniqueFD(), &size));
+
+  // Cleanup.
+  ASSERT_TRUE(fml::UnlinkFile(dir.fd(), "sized_data"));
+}
+
 TEST(FileTest, EmptyMappingTest) {
   fml::ScopedTemporaryDirectory dir;
 
@@ -32,6 +32,16 @@ class Mapping {
   FML_DISALLOW_COPY_AND_ASSIGN(Mapping);
 };
 
+//------------------------------------------------------------------------------
+/// @brief      Asks the operating system to start reading the pages backing
+///             `mapping` from storage, so that the first access to them does
+///             not block on disk. This is only a hint and returns immediately.
+///
+/// @return     Whether the hint was given. This is false on platforms that do
+///             not support it.
+///
+bool PrefetchMapping(const Mapping& mapping);
+
 class FileMapping final : public Mapping {
  public:
   enum class Protection {
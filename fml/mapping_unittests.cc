@@ -3,10 +3,36 @@
 // found in the LICENSE file.
 
 #include "flutter/fml/mapping.h"
+
+#include "flutter/fml/build_config.h"
+#include "flutter/fml/file.h"
 #include "flutter/testing/testing.h"
 
 namespace fml {
 
+TEST(PrefetchMapping, FileMapping) {
+  fml::ScopedTemporaryDirectory dir;
+  ASSERT_TRUE(fml::WriteAtomically(dir.fd(), "data",
+                                   DataMapping(std::string(10000, 'a'))));
+  auto mapping = FileMapping::CreateReadOnly(dir.fd(), "data");
+  ASSERT_NE(mapping, nullptr);
+#if OS_WIN
+  EXPECT_FALSE(PrefetchMapping(*mapping));
+#else
+  EXPECT_TRUE(PrefetchMapping(*mapping));
+  // Slices need not be page aligned.
+  NonOwnedMapping slice(mapping->GetMapping() + 100, 5000);
+  EXPECT_TRUE(PrefetchMapping(slice));
+#endif  // OS_WIN
+  EXPECT_EQ(mapping->GetMapping()[9999], 'a');
+  fml::UnlinkFile(dir.fd(), "data");
+}
+
+TEST(PrefetchMapping, EmptyMapping) {
+  MallocMapping mapping;
+  EXPECT_FALSE(PrefetchMapping(mapping));
+}
+
 TEST(MallocMapping, EmptyContructor) {
   MallocMapping mapping;
   ASSERT_EQ(nullptr, mapping.GetMapping());
@@ -36,7 +36,7 @@ class TaskSourceGradeHolder {
 };
 }  // namespace
 
-// Guarded by creation_mutex_.
+// Each thread only ever accesses its own instance, so this needs no lock.
 FML_THREAD_LOCAL ThreadLocalUniquePtr<TaskSourceGradeHolder>
     tls_task_source_grade;
 
@@ -49,6 +49,69 @@ TaskQueueEntry::TaskQueueEntry(TaskQueueId created_for_arg)
   task_source = std::make_unique<TaskSource>(created_for);
 }
 
+// Holds the lock of a queue entry and, if the queue is merged, of the entry
+// it is merged with. Since a queue can only be merged with one other queue,
+// this covers every entry an operation on a merged pair of queues may touch.
+class MessageLoopTaskQueues::MergedQueuesLock {
+ public:
+  MergedQueuesLock(const MessageLoopTaskQueues& queues, TaskQueueId queue_id)
+      : entry_(queues.GetEntry(queue_id)) {
+    FML_CHECK(entry_) << "Task queue " << queue_id << " does not exist.";
+    entry_->mutex.lock();
+    // The merge partner can only change while the entry's lock is released,
+    // so it has to be checked again after acquiring both locks.
+    for (;;) {
+      const TaskQueueId partner_id = GetPartner(*entry_);
+      if (partner_id == _kUnmerged) {
+        return;
+      }
+      entry_->mutex.unlock();
+      partner_ = queues.GetEntry(partner_id);
+      if (!partner_) {
+        // The pair is being disposed, and |Dispose| unmerges it before
+        // erasing the partner, so the merge state is up to date once the
+        // entry is locked again.
+        entry_->mutex.lock();
+        continue;
+      }
+      std::lock(entry_->mutex, partner_->mutex);
+      if (GetPartner(*entry_) == partner_id) {
+        return;
+      }
+      partner_->mutex.unlock();
+      partner_ = nullptr;
+    }
+  }
+
+  ~MergedQueuesLock() {
+    if (partner_) {
+      partner_->mutex.unlock();
+    }
+    entry_->mutex.unlock();
+  }
+
+  TaskQueueEntry* entry() const { return entry_.get(); }
+
+  TaskQueueEntry* at(TaskQueueId queue_id) const {
+    if (entry_->created_for == queue_id) {
+      return entry_.get();
+    }
+    FML_CHECK(partner_ && partner_->created_for == queue_id)
+        << "Task queue " << queue_id << " is not locked.";
+    return partner_.get();
+  }
+
+ private:
+  std::shared_ptr<TaskQueueEntry> entry_;
+  std::shared_ptr<TaskQueueEntry> partner_;
+
+  static TaskQueueId GetPartner(const TaskQueueEntry& entry) {
+    return entry.owner_of != _kUnmerged ? entry.owner_of : entry.subsumed_by;
+  }
+
+  FML_DISALLOW_COPY_ASSIGN_AND_MOVE(MergedQueuesLock);
+};
+
 fml::RefPtr<MessageLoopTaskQueues> MessageLoopTaskQueues::GetInstance() {
   std::scoped_lock creation(creation_mutex_);
   if (!instance_) {
@@ -60,10 +123,10 @@ fml::RefPtr<MessageLoopTaskQueues> MessageLoopTaskQueues::GetInstance() {
 }
 
 TaskQueueId MessageLoopTaskQueues::CreateTaskQueue() {
-  std::lock_guard guard(queue_mutex_);
-  TaskQueueId loop_id = TaskQueueId(task_queue_id_counter_);
-  ++task_queue_id_counter_;
-  queue_entries_[loop_id] = std::make_unique<TaskQueueEntry>(loop_id);
+  TaskQueueId loop_id = TaskQueueId(task_queue_id_counter_++);
+  auto& shard = queue_table_[loop_id % kQueueTableShardCount];
+  std::lock_guard guard(shard.mutex);
+  shard.entries[loop_id] = std::make_shared<TaskQueueEntry>(loop_id);
   return loop_id;
 }
 
@@ -72,30 +135,59 @@ MessageLoopTaskQueues::MessageLoopTaskQueues()
 
 MessageLoopTaskQueues::~MessageLoopTaskQueues() = default;
 
+std::shared_ptr<TaskQueueEntry> MessageLoopTaskQueues::GetEntry(
+    TaskQueueId queue_id) const {
+  const auto& shard = queue_table_[queue_id % kQueueTableShardCount];
+  std::lock_guard guard(shard.mutex);
+  auto found = shard.entries.find(queue_id);
+  if (found == shard.entries.end()) {
+    return nullptr;
+  }
+  return found->second;
+}
+
+void MessageLoopTaskQueues::EraseEntry(TaskQueueId queue_id) {
+  auto& shard = queue_table_[queue_id % kQueueTableShardCount];
+  std::lock_guard guard(shard.mutex);
+  shard.entries.erase(queue_id);
+}
+
 void MessageLoopTaskQueues::Dispose(TaskQueueId queue_id) {
-  std::lock_guard guard(queue_mutex_);
-  const auto& queue_entry = queue_entries_.at(queue_id);
-  FML_DCHECK(queue_entry->subsumed_by == _kUnmerged);
-  TaskQueueId subsumed = queue_entry->owner_of;
-  queue_entries_.erase(queue_id);
+  TaskQueueId subsumed = _kUnmerged;
+  {
+    MergedQueuesLock lock(*this, queue_id);
+    FML_DCHECK(lock.entry()->subsumed_by == _kUnmerged);
+    subsumed = lock.entry()->owner_of;
+    // Unmerge the pair before erasing it, so that a concurrent
+    // |MergedQueuesLock| never waits for a partner that no longer exists.
+    if (subsumed != _kUnmerged) {
+      lock.at(subsumed)->subsumed_by = _kUnmerged;
+      lock.entry()->owner_of = _kUnmerged;
+    }
+    const TaskQueueId owner = lock.entry()->subsumed_by;
+    if (owner != _kUnmerged) {
+      lock.at(owner)->owner_of = _kUnmerged;
+      lock.entry()->subsumed_by = _kUnmerged;
+    }
+  }
+  EraseEntry(queue_id);
   if (subsumed != _kUnmerged) {
-    queue_entries_.erase(subsumed);
+    EraseEntry(subsumed);
   }
 }
 
 void MessageLoopTaskQueues::DisposeTasks(TaskQueueId queue_id) {
-  std::lock_guard guard(queue_mutex_);
-  const auto& queue_entry = queue_entries_.at(queue_id);
+  MergedQueuesLock lock(*this, queue_id);
+  const auto& queue_entry = lock.entry();
   FML_DCHECK(queue_entry->subsumed_by == _kUnmerged);
   TaskQueueId subsumed = queue_entry->owner_of;
   queue_entry->task_source->ShutDown();
   if (subsumed != _kUnmerged) {
-    queue_entries_.at(subsumed)->task_source->ShutDown();
+    lock.at(subsumed)->task_source->ShutDown();
   }
 }
 
 TaskSourceGrade MessageLoopTaskQueues::GetCurrentTaskSourceGrade() {
-  std::scoped_lock creation(creation_mutex_);
   return tls_task_source_grade.get()->task_source_grade;
 }
 
@@ -104,9 +196,9 @@ void MessageLoopTaskQueues::RegisterTask(
     const fml::closure& task,
     fml::TimePoint target_time,
     fml::TaskSourceGrade task_source_grade) {
-  std::lock_guard guard(queue_mutex_);
   size_t order = order_++;
-  const auto& queue_entry = queue_entries_.at(queue_id);
+  MergedQueuesLock lock(*this, queue_id);
+  const auto& queue_entry = lock.entry();
   queue_entry->task_source->RegisterTask(
       {order, task, target_time, task_source_grade});
   TaskQueueId loop_to_wake = queue_id;
@@ -115,54 +207,52 @@ void MessageLoopTaskQueues::RegisterTask(
   }
 
   // This can happen when the secondary tasks are paused.
-  if (HasPendingTasksUnlocked(loop_to_wake)) {
-    WakeUpUnlocked(loop_to_wake, GetNextWakeTimeUnlocked(loop_to_wake));
+  if (HasPendingTasksUnlocked(lock, loop_to_wake)) {
+    WakeUpUnlocked(lock, loop_to_wake,
+                   GetNextWakeTimeUnlocked(lock, loop_to_wake));
   }
 }
 
 bool MessageLoopTaskQueues::HasPendingTasks(TaskQueueId queue_id) const {
-  std::lock_guard guard(queue_mutex_);
-  return HasPendingTasksUnlocked(queue_id);
+  MergedQueuesLock lock(*this, queue_id);
+  return HasPendingTasksUnlocked(lock, queue_id);
 }
 
 fml::closure MessageLoopTaskQueues::GetNextTaskToRun(TaskQueueId queue_id,
                                                      fml::TimePoint from_time) {
-  std::lock_guard guard(queue_mutex_);
-  if (!HasPendingTasksUnlocked(queue_id)) {
+  MergedQueuesLock lock(*this, queue_id);
+  if (!HasPendingTasksUnlocked(lock, queue_id)) {
     return nullptr;
   }
-  TaskSource::TopTask top = PeekNextTaskUnlocked(queue_id);
+  TaskSource::TopTask top = PeekNextTaskUnlocked(lock, queue_id, from_time);
 
-  if (!HasPendingTasksUnlocked(queue_id)) {
-    WakeUpUnlocked(queue_id, fml::TimePoint::Max());
+  if (!HasPendingTasksUnlocked(lock, queue_id)) {
+    WakeUpUnlocked(lock, queue_id, fml::TimePoint::Max());
   } else {
-    WakeUpUnlocked(queue_id, GetNextWakeTimeUnlocked(queue_id));
+    WakeUpUnlocked(lock, queue_id, GetNextWakeTimeUnlocked(lock, queue_id));
   }
 
   if (top.task.GetTargetTime() > from_time) {
     return nullptr;
   }
   fml::closure invocation = top.task.GetTask();
-  queue_entries_.at(top.task_queue_id)
-      ->task_source->PopTask(top.task.GetTaskSourceGrade());
-  {
-    std::scoped_lock creation(creation_mutex_);
-    const auto task_source_grade = top.task.GetTaskSourceGrade();
-    tls_task_source_grade.reset(new TaskSourceGradeHolder{task_source_grade});
-  }
+  const auto task_source_grade = top.task.GetTaskSourceGrade();
+  lock.at(top.task_queue_id)->task_source->PopTask(task_source_grade);
+  tls_task_source_grade.reset(new TaskSourceGradeHolder{task_source_grade});
   return invocation;
 }
 
-void MessageLoopTaskQueues::WakeUpUnlocked(TaskQueueId queue_id,
+void MessageLoopTaskQueues::WakeUpUnlocked(const MergedQueuesLock& lock,
+                                           TaskQueueId queue_id,
                                            fml::TimePoint time) const {
-  if (queue_entries_.at(queue_id)->wakeable) {
-    queue_entries_.at(queue_id)->wakeable->WakeUp(time);
+  if (lock.at(queue_id)->wakeable) {
+    lock.at(queue_id)->wakeable->WakeUp(time);
   }
 }
 
 size_t MessageLoopTaskQueues::GetNumPendingTasks(TaskQueueId queue_id) const {
-  std::lock_guard guard(queue_mutex_);
-  const auto& queue_entry = queue_entries_.at(queue_id);
+  MergedQueuesLock lock(*this, queue_id);
+  const auto& queue_entry = lock.entry();
   if (queue_entry->subsumed_by != _kUnmerged) {
     return 0;
   }
@@ -172,7 +262,7 @@ size_t MessageLoopTaskQueues::GetNumPendingTasks(TaskQueueId queue_id) const {
 
   TaskQueueId subsumed = queue_entry->owner_of;
   if (subsumed != _kUnmerged) {
-    const auto& subsumed_entry = queue_entries_.at(subsumed);
+    const auto& subsumed_entry = lock.at(subsumed);
     total_tasks += subsumed_entry->task_source->GetNumPendingTasks();
   }
   return total_tasks;
@@ -181,33 +271,33 @@ size_t MessageLoopTaskQueues::GetNumPendingTasks(TaskQueueId queue_id) const {
 void MessageLoopTaskQueues::AddTaskObserver(TaskQueueId queue_id,
                                             intptr_t key,
                                             const fml::closure& callback) {
-  std::lock_guard guard(queue_mutex_);
   FML_DCHECK(callback != nullptr) << "Observer callback must be non-null.";
-  queue_entries_.at(queue_id)->task_observers[key] = callback;
+  MergedQueuesLock lock(*this, queue_id);
+  lock.entry()->task_observers[key] = callback;
 }
 
 void MessageLoopTaskQueues::RemoveTaskObserver(TaskQueueId queue_id,
                                                intptr_t key) {
-  std::lock_guard guard(queue_mutex_);
-  queue_entries_.at(queue_id)->task_observers.erase(key);
+  MergedQueuesLock lock(*this, queue_id);
+  lock.entry()->task_observers.erase(key);
 }
 
 std::vector<fml::closure> MessageLoopTaskQueues::GetObserversToNotify(
     TaskQueueId queue_id) const {
-  std::lock_guard guard(queue_mutex_);
+  MergedQueuesLock lock(*this, queue_id);
   std::vector<fml::closure> observers;
 
-  if (queue_entries_.at(queue_id)->subsumed_by != _kUnmerged) {
+  if (lock.entry()->subsumed_by != _kUnmerged) {
     return observers;
   }
 
-  for (const auto& observer : queue_entries_.at(queue_id)->task_observers) {
+  for (const auto& observer : lock.entry()->task_observers) {
     observers.push_back(observer.second);
   }
 
-  TaskQueueId subsumed = queue_entries_.at(queue_id)->owner_of;
+  TaskQueueId subsumed = lock.entry()->owner_of;
   if (subsumed != _kUnmerged) {
-    for (const auto& observer : queue_entries_.at(subsumed)->task_observers) {
+    for (const auto& observer : lock.at(subsumed)->task_observers) {
       observers.push_back(observer.second);
     }
   }
@@ -217,19 +307,19 @@ std::vector<fml::closure> MessageLoopTaskQueues::GetObserversToNotify(
 
 void MessageLoopTaskQueues::SetWakeable(TaskQueueId queue_id,
                                         fml::Wakeable* wakeable) {
-  std::lock_guard guard(queue_mutex_);
-  FML_CHECK(!queue_entries_.at(queue_id)->wakeable)
-      << "Wakeable can only be set once.";
-  queue_entries_.at(queue_id)->wakeable = wakeable;
+  MergedQueuesLock lock(*this, queue_id);
+  FML_CHECK(!lock.entry()->wakeable) << "Wakeable can only be set once.";
+  lock.entry()->wakeable = wakeable;
 }
 
 bool MessageLoopTaskQueues::Merge(TaskQueueId owner, TaskQueueId subsumed) {
   if (owner == subsumed) {
     return true;
   }
-  std::lock_guard guard(queue_mutex_);
-  auto& owner_entry = queue_entries_.at(owner);
-  auto& subsumed_entry = queue_entries_.at(subsumed);
+  auto owner_entry = GetEntry(owner);
+  auto subsumed_entry = GetEntry(subsumed);
+  FML_CHECK(owner_entry && subsumed_entry);
+  std::scoped_lock lock(owner_entry->mutex, subsumed_entry->mutex);
 
   if (owner_entry->owner_of == subsumed) {
     return true;
@@ -248,30 +338,45 @@ bool MessageLoopTaskQueues::Merge(TaskQueueId owner, TaskQueueId subsumed) {
   owner_entry->owner_of = subsumed;
   subsumed_entry->subsumed_by = owner;
 
-  if (HasPendingTasksUnlocked(owner)) {
-    WakeUpUnlocked(owner, GetNextWakeTimeUnlocked(owner));
+  // Both locks are already held, so the wake up can't go through a
+  // |MergedQueuesLock|.
+  if (!owner_entry->task_source->IsEmpty() ||
+      !subsumed_entry->task_source->IsEmpty()) {
+    const DelayedTask* next_task = nullptr;
+    for (const auto* entry : {owner_entry.get(), subsumed_entry.get()}) {
+      if (entry->task_source->IsEmpty()) {
+        continue;
+      }
+      const DelayedTask& task = entry->task_source->Top().task;
+      if (!next_task || *next_task > task) {
+        next_task = &task;
+      }
+    }
+    if (owner_entry->wakeable) {
+      owner_entry->wakeable->WakeUp(next_task->GetTargetTime());
+    }
   }
 
   return true;
 }
 
 bool MessageLoopTaskQueues::Unmerge(TaskQueueId owner) {
-  std::lock_guard guard(queue_mutex_);
-  const auto& owner_entry = queue_entries_.at(owner);
+  MergedQueuesLock lock(*this, owner);
+  const auto& owner_entry = lock.entry();
   const TaskQueueId subsumed = owner_entry->owner_of;
   if (subsumed == _kUnmerged) {
     return false;
   }
 
-  queue_entries_.at(subsumed)->subsumed_by = _kUnmerged;
+  lock.at(subsumed)->subsumed_by = _kUnmerged;
   owner_entry->owner_of = _kUnmerged;
 
-  if (HasPendingTasksUnlocked(owner)) {
-    WakeUpUnlocked(owner, GetNextWakeTimeUnlocked(owner));
+  if (HasPendingTasksUnlocked(lock, owner)) {
+    WakeUpUnlocked(lock, owner, GetNextWakeTimeUnlocked(lock, owner));
   }
 
-  if (HasPendingTasksUnlocked(subsumed)) {
-    WakeUpUnlocked(subsumed, GetNextWakeTimeUnlocked(subsumed));
+  if (HasPendingTasksUnlocked(lock, subsumed)) {
+    WakeUpUnlocked(lock, subsumed, GetNextWakeTimeUnlocked(lock, subsumed));
   }
 
   return true;
@@ -279,36 +384,39 @@ bool MessageLoopTaskQueues::Unmerge(TaskQueueId owner) {
 
 bool MessageLoopTaskQueues::Owns(TaskQueueId owner,
                                  TaskQueueId subsumed) const {
-  std::lock_guard guard(queue_mutex_);
-  return owner != _kUnmerged && subsumed != _kUnmerged &&
-         subsumed == queue_entries_.at(owner)->owner_of;
+  if (owner == _kUnmerged || subsumed == _kUnmerged) {
+    return false;
+  }
+  MergedQueuesLock lock(*this, owner);
+  return subsumed == lock.entry()->owner_of;
 }
 
 TaskQueueId MessageLoopTaskQueues::GetSubsumedTaskQueueId(
     TaskQueueId owner) const {
-  std::lock_guard guard(queue_mutex_);
-  return queue_entries_.at(owner)->owner_of;
+  MergedQueuesLock lock(*this, owner);
+  return lock.entry()->owner_of;
 }
 
 void MessageLoopTaskQueues::PauseSecondarySource(TaskQueueId queue_id) {
-  std::lock_guard guard(queue_mutex_);
-  queue_entries_.at(queue_id)->task_source->PauseSecondary();
+  MergedQueuesLock lock(*this, queue_id);
+  lock.entry()->task_source->PauseSecondary();
 }
 
 void MessageLoopTaskQueues::ResumeSecondarySource(TaskQueueId queue_id) {
-  std::lock_guard guard(queue_mutex_);
-  queue_entries_.at(queue_id)->task_source->ResumeSecondary();
+  MergedQueuesLock lock(*this, queue_id);
+  lock.entry()->task_source->ResumeSecondary();
   // Schedule a wake as needed.
-  if (HasPendingTasksUnlocked(queue_id)) {
-    WakeUpUnlocked(queue_id, GetNextWakeTimeUnlocked(queue_id));
+  if (HasPendingTasksUnlocked(lock, queue_id)) {
+    WakeUpUnlocked(lock, queue_id, GetNextWakeTimeUnlocked(lock, queue_id));
   }
 }
 
 // Subsumed queues will never have pending tasks.
 // Owning queues will consider both their and their subsumed tasks.
 bool MessageLoopTaskQueues::HasPendingTasksUnlocked(
+    const MergedQueuesLock& lock,
     TaskQueueId queue_id) const {
-  const auto& entry = queue_entries_.at(queue_id);
+  const auto& entry = lock.at(queue_id);
   bool is_subsumed = entry->subsumed_by != _kUnmerged;
   if (is_subsumed) {
     return false;
@@ -323,45 +431,48 @@ bool MessageLoopTaskQueues::HasPendingTasksUnlocked(
     // this is not an owner and queue is empty.
     return false;
   } else {
-    return !queue_entries_.at(subsumed)->task_source->IsEmpty();
+    return !lock.at(subsumed)->task_source->IsEmpty();
   }
 }
 
 fml::TimePoint MessageLoopTaskQueues::GetNextWakeTimeUnlocked(
+    const MergedQueuesLock& lock,
     TaskQueueId queue_id) const {
-  return PeekNextTaskUnlocked(queue_id).task.GetTargetTime();
+  return PeekNextTaskUnlocked(lock, queue_id, fml::TimePoint::Min())
+      .task.GetTargetTime();
 }
 
 TaskSource::TopTask MessageLoopTaskQueues::PeekNextTaskUnlocked(
-    TaskQueueId owner) const {
-  FML_DCHECK(HasPendingTasksUnlocked(owner));
-  const auto& entry = queue_entries_.at(owner);
+    const MergedQueuesLock& lock,
+    TaskQueueId owner,
+    fml::TimePoint from_time) const {
+  FML_DCHECK(HasPendingTasksUnlocked(lock, owner));
+  const auto& entry = lock.at(owner);
   const TaskQueueId subsumed = entry->owner_of;
   if (subsumed == _kUnmerged) {
-    return entry->task_source->Top();
+    return entry->task_source->Top(from_time);
   }
 
   TaskSource* owner_tasks = entry->task_source.get();
-  TaskSource* subsumed_tasks = queue_entries_.at(subsumed)->task_source.get();
+  TaskSource* subsumed_tasks = lock.at(subsumed)->task_source.get();
 
   // we are owning another task queue
   const bool subsumed_has_task = !subsumed_tasks->IsEmpty();
   const bool owner_has_task = !owner_tasks->IsEmpty();
-  fml::TaskQueueId top_queue_id = owner;
   if (owner_has_task && subsumed_has_task) {
-    const auto owner_task = owner_tasks->Top();
-    const auto subsumed_task = subsumed_tasks->Top();
-    if (owner_task.task > subsumed_task.task) {
-      top_queue_id = subsumed;
+    const auto owner_task = owner_tasks->Top(from_time);
+    const auto subsumed_task = subsumed_tasks->Top(from_time);
+    if (TaskSource::RunsBefore(subsumed_task.task, owner_task.task,
+                               from_time)) {
+      return subsumed_task;
     } else {
-      top_queue_id = owner;
+      return owner_task;
     }
   } else if (owner_has_task) {
-    top_queue_id = owner;
+    return owner_tasks->Top(from_time);
   } else {
-    top_queue_id = subsumed;
+    return subsumed_tasks->Top(from_time);
   }
-  return queue_entries_.at(top_queue_id)->task_source->Top();
 }
 
 }  // namespace fml
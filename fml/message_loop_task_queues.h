@@ -5,7 +5,10 @@
 #ifndef FLUTTER_FML_MESSAGE_LOOP_TASK_QUEUES_H_
 #define FLUTTER_FML_MESSAGE_LOOP_TASK_QUEUES_H_
 
+#include <array>
+#include <atomic>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <vector>
 
@@ -13,7 +16,6 @@
 #include "flutter/fml/delayed_task.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/ref_counted.h"
-#include "flutter/fml/synchronization/shared_mutex.h"
 #include "flutter/fml/task_queue_id.h"
 #include "flutter/fml/task_source.h"
 #include "flutter/fml/wakeable.h"
@@ -27,6 +29,9 @@ static const TaskQueueId _kUnmerged = TaskQueueId(TaskQueueId::kUnmerged);
 class TaskQueueEntry {
  public:
   using TaskObservers = std::map<intptr_t, fml::closure>;
+  // Guards all of the fields below. Operations that involve a pair of merged
+  // queues hold the mutexes of both entries.
+  std::mutex mutex;
   Wakeable* wakeable;
   TaskObservers task_observers;
   std::unique_ptr<TaskSource> task_source;
@@ -54,6 +59,11 @@ enum class FlushType {
 // This class keeps track of all the tasks and observers that
 // need to be run on it's MessageLoopImpl. This also wakes up the
 // loop at the required times.
+//
+// There is a single instance per process that is shared by every engine. To
+// keep unrelated queues from contending with each other, each queue is
+// guarded by its own lock, and the table of queues is split into shards that
+// are locked independently.
 class MessageLoopTaskQueues
     : public fml::RefCountedThreadSafe<MessageLoopTaskQueues> {
  public:
@@ -127,27 +137,43 @@ class MessageLoopTaskQueues
   void ResumeSecondarySource(TaskQueueId queue_id);
 
  private:
-  class MergedQueuesRunner;
+  class MergedQueuesLock;
 
   MessageLoopTaskQueues();
 
   ~MessageLoopTaskQueues();
 
-  void WakeUpUnlocked(TaskQueueId queue_id, fml::TimePoint time) const;
+  std::shared_ptr<TaskQueueEntry> GetEntry(TaskQueueId queue_id) const;
 
-  bool HasPendingTasksUnlocked(TaskQueueId queue_id) const;
+  void EraseEntry(TaskQueueId queue_id);
 
-  TaskSource::TopTask PeekNextTaskUnlocked(TaskQueueId owner) const;
+  void WakeUpUnlocked(const MergedQueuesLock& lock,
+                      TaskQueueId queue_id,
+                      fml::TimePoint time) const;
 
-  fml::TimePoint GetNextWakeTimeUnlocked(TaskQueueId queue_id) const;
+  bool HasPendingTasksUnlocked(const MergedQueuesLock& lock,
+                               TaskQueueId queue_id) const;
+
+  TaskSource::TopTask PeekNextTaskUnlocked(const MergedQueuesLock& lock,
+                                           TaskQueueId owner,
+                                           fml::TimePoint from_time) const;
+
+  fml::TimePoint GetNextWakeTimeUnlocked(const MergedQueuesLock& lock,
+                                         TaskQueueId queue_id) const;
 
   static std::mutex creation_mutex_;
   static fml::RefPtr<MessageLoopTaskQueues> instance_;
 
-  mutable std::mutex queue_mutex_;
-  std::map<TaskQueueId, std::unique_ptr<TaskQueueEntry>> queue_entries_;
+  static constexpr size_t kQueueTableShardCount = 16;
+
+  struct QueueTableShard {
+    mutable std::mutex mutex;
+    std::map<TaskQueueId, std::shared_ptr<TaskQueueEntry>> entries;
+  };
+
+  std::array<QueueTableShard, kQueueTableShardCount> queue_table_;
 
-  size_t task_queue_id_counter_;
+  std::atomic_size_t task_queue_id_counter_;
 
   std::atomic_int order_;
 
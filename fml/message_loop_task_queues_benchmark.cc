@@ -66,5 +66,88 @@ static void BM_RegisterAndGetTasks(benchmark::State& state) {  // NOLINT
 
 BENCHMARK(BM_RegisterAndGetTasks);
 
+// Many threads posting to the same task queue, as happens when several
+// engine threads post to the platform task runner.
+static void BM_RegisterTasksFromManyThreads(
+    benchmark::State& state) {  // NOLINT
+  auto task_queues = fml::MessageLoopTaskQueues::GetInstance();
+  const int num_producers = state.range(0);
+  const int num_tasks_per_producer = 1000;
+  const fml::TimePoint past = fml::TimePoint::Now();
+
+  while (state.KeepRunning()) {
+    const TaskQueueId queue_id = task_queues->CreateTaskQueue();
+
+    std::vector<std::thread> threads;
+    CountDownLatch tasks_registered(num_producers);
+    for (int i = 0; i < num_producers; i++) {
+      threads.emplace_back([&task_queues, queue_id, past, &tasks_registered]() {
+        for (int j = 0; j < num_tasks_per_producer; j++) {
+          task_queues->RegisterTask(queue_id, [] {}, past);
+        }
+        tasks_registered.CountDown();
+      });
+    }
+
+    int num_invocations = 0;
+    const int num_tasks = num_producers * num_tasks_per_producer;
+    while (num_invocations < num_tasks) {
+      if (task_queues->GetNextTaskToRun(queue_id, fml::TimePoint::Now())) {
+        num_invocations++;
+      }
+    }
+    tasks_registered.Wait();
+
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    task_queues->Dispose(queue_id);
+  }
+}
+
+BENCHMARK(BM_RegisterTasksFromManyThreads)->Arg(1)->Arg(4)->Arg(8);
+
+// Engines that each run their own producer and consumer on their own task
+// queue. Operations on unrelated task queues should not contend.
+static void BM_IndependentTaskQueues(benchmark::State& state) {  // NOLINT
+  auto task_queues = fml::MessageLoopTaskQueues::GetInstance();
+  const int num_engines = state.range(0);
+  const int num_tasks_per_engine = 1000;
+  const fml::TimePoint past = fml::TimePoint::Now();
+
+  while (state.KeepRunning()) {
+    std::vector<TaskQueueId> queue_ids;
+    for (int i = 0; i < num_engines; i++) {
+      queue_ids.push_back(task_queues->CreateTaskQueue());
+    }
+
+    std::vector<std::thread> threads;
+    for (const auto queue_id : queue_ids) {
+      threads.emplace_back([&task_queues, queue_id, past]() {
+        for (int j = 0; j < num_tasks_per_engine; j++) {
+          task_queues->RegisterTask(queue_id, [] {}, past);
+        }
+      });
+      threads.emplace_back([&task_queues, queue_id]() {
+        int num_invocations = 0;
+        while (num_invocations < num_tasks_per_engine) {
+          if (task_queues->GetNextTaskToRun(queue_id, fml::TimePoint::Now())) {
+            num_invocations++;
+          }
+        }
+      });
+    }
+
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    for (const auto queue_id : queue_ids) {
+      task_queues->Dispose(queue_id);
+    }
+  }
+}
+
+BENCHMARK(BM_IndependentTaskQueues)->Arg(1)->Arg(4)->Arg(8);
+
 }  // namespace benchmarking
 }  // namespace fml
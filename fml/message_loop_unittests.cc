@@ -6,7 +6,9 @@
 
 #include "flutter/fml/message_loop.h"
 
+#include <atomic>
 #include <iostream>
+#include <set>
 #include <thread>
 
 #include "flutter/fml/build_config.h"
@@ -316,3 +318,76 @@ TEST(MessageLoop, CanCreateConcurrentMessageLoop) {
   latch.Wait();
   ASSERT_GE(thread_ids.size(), 1u);
 }
+
+TEST(MessageLoop, ConcurrentMessageLoopRunsBatchOfTasks) {
+  auto loop = fml::ConcurrentMessageLoop::Create(4);
+  auto task_runner = loop->GetTaskRunner();
+  const size_t kCount = 1000;
+  fml::CountDownLatch latch(kCount);
+  std::atomic_size_t run_count = 0;
+  std::vector<fml::closure> tasks;
+  for (size_t i = 0; i < kCount; ++i) {
+    tasks.push_back([&]() {
+      run_count++;
+      latch.CountDown();
+    });
+  }
+  task_runner->PostTasks(std::move(tasks));
+  latch.Wait();
+  ASSERT_EQ(run_count, kCount);
+}
+
+TEST(MessageLoop, ConcurrentMessageLoopWorkersStealTasksPostedByWorker) {
+  auto loop = fml::ConcurrentMessageLoop::Create(4);
+  auto task_runner = loop->GetTaskRunner();
+  const size_t kCount = 8;
+  fml::CountDownLatch latch(kCount);
+  fml::AutoResetWaitableEvent release;
+  std::mutex thread_ids_mutex;
+  std::set<std::thread::id> thread_ids;
+  // All of the tasks are queued on the worker that runs the first task. That
+  // worker stays blocked until the other workers have run all of them.
+  task_runner->PostTask([&]() {
+    for (size_t i = 0; i < kCount; ++i) {
+      task_runner->PostTask([&]() {
+        std::scoped_lock lock(thread_ids_mutex);
+        thread_ids.insert(std::this_thread::get_id());
+        latch.CountDown();
+      });
+    }
+    latch.Wait();
+    release.Signal();
+  });
+  release.Wait();
+  ASSERT_GE(thread_ids.size(), 1u);
+}
+
+TEST(MessageLoop, ConcurrentMessageLoopRunsWorkerStartCallbackOnEachWorker) {
+  const size_t kWorkerCount = 4;
+  std::mutex worker_indices_mutex;
+  std::set<size_t> worker_indices;
+  fml::CountDownLatch latch(kWorkerCount);
+  auto loop = fml::ConcurrentMessageLoop::Create(
+      kWorkerCount, [&](size_t worker_index) {
+        std::scoped_lock lock(worker_indices_mutex);
+        worker_indices.insert(worker_index);
+        latch.CountDown();
+      });
+  latch.Wait();
+  ASSERT_EQ(worker_indices, std::set<size_t>({0, 1, 2, 3}));
+}
+
+TEST(MessageLoop, ConcurrentMessageLoopRunsTaskOnAllWorkers) {
+  const size_t kWorkerCount = 4;
+  auto loop = fml::ConcurrentMessageLoop::Create(kWorkerCount);
+  fml::CountDownLatch latch(kWorkerCount);
+  std::mutex thread_ids_mutex;
+  std::set<std::thread::id> thread_ids;
+  loop->PostTaskToAllWorkers([&]() {
+    std::scoped_lock lock(thread_ids_mutex);
+    thread_ids.insert(std::this_thread::get_id());
+    latch.CountDown();
+  });
+  latch.Wait();
+  ASSERT_EQ(thread_ids.size(), kWorkerCount);
+}
@@ -159,6 +159,20 @@ bool TruncateFile(const fml::UniqueFD& file, size_t size) {
   return ::ftruncate(file.get(), size) == 0;
 }
 
+bool GetFileSize(const fml::UniqueFD& file, size_t* size) {
+  if (!file.is_valid()) {
+    return false;
+  }
+
+  struct stat stat_result = {};
+  if (::fstat(file.get(), &stat_result) != 0) {
+    return false;
+  }
+
+  *size = stat_result.st_size;
+  return true;
+}
+
 bool UnlinkDirectory(const char* path) {
   return UnlinkDirectory(fml::UniqueFD{AT_FDCWD}, path);
 }
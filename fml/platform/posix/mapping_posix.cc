@@ -50,6 +50,20 @@ Mapping::Mapping() = default;
 
 Mapping::~Mapping() = default;
 
+bool PrefetchMapping(const Mapping& mapping) {
+  if (mapping.GetMapping() == nullptr || mapping.GetSize() == 0) {
+    return false;
+  }
+  // The range must start on a page boundary, which slices of larger mappings
+  // do not necessarily do.
+  static const uintptr_t page_size = ::sysconf(_SC_PAGESIZE);
+  const uintptr_t start = reinterpret_cast<uintptr_t>(mapping.GetMapping());
+  const uintptr_t aligned_start = start & ~(page_size - 1);
+  return ::madvise(reinterpret_cast<void*>(aligned_start),
+                   start - aligned_start + mapping.GetSize(),
+                   MADV_WILLNEED) == 0;
+}
+
 FileMapping::FileMapping(const fml::UniqueFD& handle,
                          std::initializer_list<Protection> protection)
     : size_(0), mapping_(nullptr) {
@@ -378,6 +378,17 @@ bool TruncateFile(const fml::UniqueFD& file, size_t size) {
   return true;
 }
 
+bool GetFileSize(const fml::UniqueFD& file, size_t* size) {
+  LARGE_INTEGER large_size;
+  if (!::GetFileSizeEx(file.get(), &large_size)) {
+    FML_DLOG(ERROR) << "Could not read the file size. "
+                    << GetLastErrorMessage();
+    return false;
+  }
+  *size = large_size.QuadPart;
+  return true;
+}
+
 bool FileExists(const fml::UniqueFD& base_directory, const char* path) {
   return GetFileAttributesForUtf8Path(base_directory, path) !=
          INVALID_FILE_ATTRIBUTES;
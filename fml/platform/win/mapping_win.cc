@@ -20,6 +20,10 @@ Mapping::Mapping() = default;
 
 Mapping::~Mapping() = default;
 
+bool PrefetchMapping(const Mapping& mapping) {
+  return false;
+}
+
 static bool IsWritable(
     std::initializer_list<FileMapping::Protection> protection_flags) {
   for (auto protection : protection_flags) {
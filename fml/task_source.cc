@@ -6,6 +6,8 @@
 
 #include "flutter/fml/task_source.h"
 
+#include "flutter/fml/logging.h"
+
 namespace fml {
 
 TaskSource::TaskSource(TaskQueueId task_queue_id)
@@ -16,40 +18,37 @@ TaskSource::~TaskSource() {
 }
 
 void TaskSource::ShutDown() {
+  user_interaction_task_queue_ = {};
   primary_task_queue_ = {};
   secondary_task_queue_ = {};
+  idle_task_queue_ = {};
 }
 
-void TaskSource::RegisterTask(const DelayedTask& task) {
-  switch (task.GetTaskSourceGrade()) {
+fml::DelayedTaskQueue& TaskSource::GetTaskQueue(TaskSourceGrade grade) {
+  switch (grade) {
     case TaskSourceGrade::kUserInteraction:
-      primary_task_queue_.push(task);
-      break;
+      return user_interaction_task_queue_;
     case TaskSourceGrade::kUnspecified:
-      primary_task_queue_.push(task);
-      break;
+      return primary_task_queue_;
     case TaskSourceGrade::kDartMicroTasks:
-      secondary_task_queue_.push(task);
-      break;
+      return secondary_task_queue_;
+    case TaskSourceGrade::kIdle:
+      return idle_task_queue_;
   }
+  FML_UNREACHABLE();
+}
+
+void TaskSource::RegisterTask(const DelayedTask& task) {
+  GetTaskQueue(task.GetTaskSourceGrade()).push(task);
 }
 
 void TaskSource::PopTask(TaskSourceGrade grade) {
-  switch (grade) {
-    case TaskSourceGrade::kUserInteraction:
-      primary_task_queue_.pop();
-      break;
-    case TaskSourceGrade::kUnspecified:
-      primary_task_queue_.pop();
-      break;
-    case TaskSourceGrade::kDartMicroTasks:
-      secondary_task_queue_.pop();
-      break;
-  }
+  GetTaskQueue(grade).pop();
 }
 
 size_t TaskSource::GetNumPendingTasks() const {
-  size_t size = primary_task_queue_.size();
+  size_t size = user_interaction_task_queue_.size() +
+                primary_task_queue_.size() + idle_task_queue_.size();
   if (secondary_pause_requests_ == 0) {
     size += secondary_task_queue_.size();
   }
@@ -61,34 +60,62 @@ bool TaskSource::IsEmpty() const {
 }
 
 TaskSource::TopTask TaskSource::Top() const {
+  return Top(fml::TimePoint::Min());
+}
+
+TaskSource::TopTask TaskSource::Top(fml::TimePoint from_time) const {
   FML_CHECK(!IsEmpty());
-  if (secondary_pause_requests_ > 0 || secondary_task_queue_.empty()) {
-    const auto& primary_top = primary_task_queue_.top();
-    return {
-        .task_queue_id = task_queue_id_,
-        .task = primary_top,
-    };
-  } else if (primary_task_queue_.empty()) {
-    const auto& secondary_top = secondary_task_queue_.top();
-    return {
-        .task_queue_id = task_queue_id_,
-        .task = secondary_top,
-    };
-  } else {
-    const auto& primary_top = primary_task_queue_.top();
-    const auto& secondary_top = secondary_task_queue_.top();
-    if (primary_top > secondary_top) {
-      return {
-          .task_queue_id = task_queue_id_,
-          .task = secondary_top,
-      };
-    } else {
-      return {
-          .task_queue_id = task_queue_id_,
-          .task = primary_top,
-      };
+  const DelayedTask* top = nullptr;
+  auto consider = [&](const fml::DelayedTaskQueue& queue) {
+    if (queue.empty()) {
+      return;
+    }
+    if (!top || RunsBefore(queue.top(), *top, from_time)) {
+      top = &queue.top();
+    }
+  };
+  consider(user_interaction_task_queue_);
+  consider(primary_task_queue_);
+  if (secondary_pause_requests_ == 0) {
+    consider(secondary_task_queue_);
+  }
+  consider(idle_task_queue_);
+  return {
+      .task_queue_id = task_queue_id_,
+      .task = *top,
+  };
+}
+
+// Lower values run first among due tasks.
+static int GetPriorityLane(TaskSourceGrade grade) {
+  switch (grade) {
+    case TaskSourceGrade::kUserInteraction:
+      return 0;
+    case TaskSourceGrade::kUnspecified:
+    case TaskSourceGrade::kDartMicroTasks:
+      return 1;
+    case TaskSourceGrade::kIdle:
+      return 2;
+  }
+  FML_UNREACHABLE();
+}
+
+bool TaskSource::RunsBefore(const DelayedTask& task,
+                            const DelayedTask& other,
+                            fml::TimePoint from_time) {
+  const bool task_due = task.GetTargetTime() <= from_time;
+  const bool other_due = other.GetTargetTime() <= from_time;
+  if (task_due != other_due) {
+    return task_due;
+  }
+  if (task_due) {
+    const int task_lane = GetPriorityLane(task.GetTaskSourceGrade());
+    const int other_lane = GetPriorityLane(other.GetTaskSourceGrade());
+    if (task_lane != other_lane) {
+      return task_lane < other_lane;
     }
   }
+  return other > task;
 }
 
 void TaskSource::PauseSecondary() {
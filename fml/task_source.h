@@ -20,6 +20,11 @@ class MessageLoopTaskQueues;
  * dispatcher. `TaskSourceGrade` determines what task heap the task is assigned
  * to.
  *
+ * In addition, `TaskSourceGrade::kUserInteraction` and `TaskSourceGrade::kIdle`
+ * tasks are kept in heaps of their own that act as priority lanes: among the
+ * tasks that are due, user interaction tasks run first and idle tasks run
+ * last.
+ *
  * Registering Tasks
  * -----------------
  * The task dispatcher associates a task source with each `TaskQueueID`. When
@@ -65,6 +70,20 @@ class TaskSource {
   /// the secondary heap has been paused or not.
   TopTask Top() const;
 
+  /// Returns the task that should run at `from_time`, taking into account
+  /// whether the secondary heap has been paused or not. If any task is due at
+  /// `from_time`, this is the due task of the highest priority lane. Otherwise
+  /// it is the same task as `Top`.
+  TopTask Top(fml::TimePoint from_time) const;
+
+  /// Returns true if `task` should run before `other` at `from_time`. Due
+  /// tasks run before tasks that are not due yet. Among due tasks, the
+  /// priority lane of the `TaskSourceGrade` decides first. Otherwise tasks run
+  /// in the order of their scheduled time.
+  static bool RunsBefore(const DelayedTask& task,
+                         const DelayedTask& other,
+                         fml::TimePoint from_time);
+
   /// Pause providing tasks from secondary task heap.
   void PauseSecondary();
 
@@ -73,10 +92,14 @@ class TaskSource {
 
  private:
   const fml::TaskQueueId task_queue_id_;
+  fml::DelayedTaskQueue user_interaction_task_queue_;
   fml::DelayedTaskQueue primary_task_queue_;
   fml::DelayedTaskQueue secondary_task_queue_;
+  fml::DelayedTaskQueue idle_task_queue_;
   int secondary_pause_requests_ = 0;
 
+  fml::DelayedTaskQueue& GetTaskQueue(TaskSourceGrade grade);
+
   FML_DISALLOW_COPY_ASSIGN_AND_MOVE(TaskSource);
 };
 
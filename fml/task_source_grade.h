@@ -14,13 +14,18 @@ namespace fml {
  */
 enum class TaskSourceGrade {
   /// This `TaskSourceGrade` indicates that a task is critical to user
-  /// interaction.
+  /// interaction, for example producing the next frame. Once due, these tasks
+  /// run ahead of tasks of any other grade.
   kUserInteraction,
   /// This `TaskSourceGrade` indicates that a task corresponds to servicing a
   /// dart micro task. These aren't critical to user interaction.
   kDartMicroTasks,
   /// The absence of a specialized `TaskSourceGrade`.
   kUnspecified,
+  /// This `TaskSourceGrade` indicates that a task may be deferred, for example
+  /// notifying the engine that it is idle. These tasks only run when no task
+  /// of another grade is due.
+  kIdle,
 };
 
 }  // namespace fml
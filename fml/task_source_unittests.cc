@@ -96,5 +96,58 @@ TEST(TaskSourceTests, OrderingMultiTaskHeapsSecondaryPaused) {
   ASSERT_EQ(value, 1);
 }
 
+TEST(TaskSourceTests, UserInteractionTasksRunFirstOnceDue) {
+  TaskSource task_source = TaskSource(TaskQueueId(1));
+  auto time_stamp = fml::TimePoint::Now();
+  int value = 0;
+  task_source.RegisterTask(
+      {1, [&] { value = 1; }, time_stamp, TaskSourceGrade::kUnspecified});
+  task_source.RegisterTask({2, [&] { value = 7; },
+                            time_stamp + fml::TimeDelta::FromMilliseconds(1),
+                            TaskSourceGrade::kUserInteraction});
+
+  // Before the user interaction task is due, the earlier task runs first.
+  ASSERT_EQ(task_source.Top(time_stamp).task.GetTaskSourceGrade(),
+            TaskSourceGrade::kUnspecified);
+
+  auto from_time = time_stamp + fml::TimeDelta::FromMilliseconds(2);
+  auto top_task = task_source.Top(from_time);
+  top_task.task.GetTask()();
+  task_source.PopTask(top_task.task.GetTaskSourceGrade());
+  ASSERT_EQ(value, 7);
+
+  auto second_task = task_source.Top(from_time);
+  second_task.task.GetTask()();
+  task_source.PopTask(second_task.task.GetTaskSourceGrade());
+  ASSERT_EQ(value, 1);
+}
+
+TEST(TaskSourceTests, IdleTasksRunLast) {
+  TaskSource task_source = TaskSource(TaskQueueId(1));
+  auto time_stamp = fml::TimePoint::Now();
+  int value = 0;
+  task_source.RegisterTask(
+      {1, [&] { value = 1; }, time_stamp, TaskSourceGrade::kIdle});
+  task_source.RegisterTask({2, [&] { value = 7; },
+                            time_stamp + fml::TimeDelta::FromMilliseconds(1),
+                            TaskSourceGrade::kDartMicroTasks});
+  task_source.RegisterTask({3, [&] { value = 3; },
+                            time_stamp + fml::TimeDelta::FromMilliseconds(5),
+                            TaskSourceGrade::kUnspecified});
+
+  auto from_time = time_stamp + fml::TimeDelta::FromMilliseconds(2);
+  auto top_task = task_source.Top(from_time);
+  top_task.task.GetTask()();
+  task_source.PopTask(top_task.task.GetTaskSourceGrade());
+  ASSERT_EQ(value, 7);
+
+  // The remaining unspecified task is not due yet, so the idle task runs.
+  auto second_task = task_source.Top(from_time);
+  second_task.task.GetTask()();
+  task_source.PopTask(second_task.task.GetTaskSourceGrade());
+  ASSERT_EQ(value, 1);
+  ASSERT_EQ(task_source.GetNumPendingTasks(), 1u);
+}
+
 }  // namespace testing
 }  // namespace fml
@@ -49,6 +49,40 @@ void createPath() {
 }
 void _validatePath(Path path) native 'ValidatePath';
 
+@pragma('vm:entry-point')
+void recordCanvasCommands() {
+  final PictureRecorder recorder = PictureRecorder();
+  final Canvas canvas = Canvas(recorder);
+  final Paint paint = Paint()..color = const Color(0xFF00FF00);
+  canvas.save();
+  canvas.translate(10, 20);
+  canvas.drawRect(const Rect.fromLTRB(0, 0, 10, 10), paint);
+  canvas.drawPath(Path()..addRect(const Rect.fromLTRB(0, 0, 5, 5)), paint);
+  canvas.restore();
+  canvas.drawRect(const Rect.fromLTRB(20, 20, 30, 30), paint);
+  canvas.rotate(1.1);
+  canvas.drawRect(const Rect.fromLTRB(20, 20, 30, 30), paint);
+  _validateCanvasCommands(recorder.endRecording());
+}
+void _validateCanvasCommands(Picture picture) native 'ValidateCanvasCommands';
+
+// Records 5000 operations of the kind that widgets paint. Used by
+// ui_benchmarks.
+@pragma('vm:entry-point')
+void recordSmallOperations() {
+  final PictureRecorder recorder = PictureRecorder();
+  final Canvas canvas = Canvas(recorder);
+  final Paint paint = Paint()..color = const Color(0xFF2196F3);
+  for (int i = 0; i < 1000; i++) {
+    canvas.save();
+    canvas.translate((i % 40) * 10.0, (i ~/ 40) * 10.0);
+    canvas.drawRect(const Rect.fromLTRB(0, 0, 8, 8), paint);
+    canvas.drawCircle(const Offset(4, 4), 2, paint);
+    canvas.restore();
+  }
+  recorder.endRecording().dispose();
+}
+
 @pragma('vm:entry-point')
 void frameCallback(FrameInfo info) {
   print('called back');
@@ -3856,6 +3856,12 @@ enum ClipOp {
   intersect,
 }
 
+// Whether the draw operations of a [Canvas] are recorded into a command buffer
+// that is replayed with one native call per flush, rather than making a native
+// call each. Set with the --enable-canvas-command-buffer engine flag.
+final bool _canvasCommandBufferEnabled = _isCanvasCommandBufferEnabled();
+bool _isCanvasCommandBufferEnabled() native 'Canvas_isCommandBufferEnabled';
+
 /// An interface for recording graphical operations.
 ///
 /// [Canvas] objects are used in creating [Picture] objects, which can
@@ -3894,6 +3900,12 @@ class Canvas extends NativeFieldWrapperClass2 {
     _recorder!._canvas = this;
     cullRect ??= Rect.largest;
     _constructor(recorder, cullRect.left, cullRect.top, cullRect.right, cullRect.bottom);
+    if (_canvasCommandBufferEnabled) {
+      final Uint32List commands = Uint32List(_kCommandBufferCapacity);
+      _commands = commands;
+      _commandFloats = Float32List.view(commands.buffer);
+      _commandData = ByteData.view(commands.buffer);
+    }
   }
   void _constructor(PictureRecorder recorder,
                     double left,
@@ -3906,6 +3918,104 @@ class Canvas extends NativeFieldWrapperClass2 {
   // garbage collected until PictureRecorder.endRecording is called.
   PictureRecorder? _recorder;
 
+  // The command buffer, or null if it is disabled.
+  //
+  // The operations that don't reference native objects other than the canvas
+  // are recorded into the buffer, one word for the command followed by one
+  // word for each argument, and replayed natively by [_flushCommands]. All
+  // other operations flush the buffer first, so that the native canvas sees
+  // the operations in order.
+  //
+  // The encoding must be kept in sync with the command reader in canvas.cc.
+  Uint32List? _commands;
+  Float32List? _commandFloats;
+  ByteData? _commandData;
+  int _commandCount = 0;
+
+  static const int _kCommandBufferCapacity = 2048;
+  static const int _kPaintWordCount = Paint._kDataByteCount >> 2;
+
+  static const int _kSaveCommand = 0;
+  static const int _kSaveLayerWithoutBoundsCommand = 1;
+  static const int _kSaveLayerCommand = 2;
+  static const int _kRestoreCommand = 3;
+  static const int _kTranslateCommand = 4;
+  static const int _kScaleCommand = 5;
+  static const int _kRotateCommand = 6;
+  static const int _kSkewCommand = 7;
+  static const int _kClipRectCommand = 8;
+  static const int _kClipRRectCommand = 9;
+  static const int _kDrawColorCommand = 10;
+  static const int _kDrawLineCommand = 11;
+  static const int _kDrawPaintCommand = 12;
+  static const int _kDrawRectCommand = 13;
+  static const int _kDrawRRectCommand = 14;
+  static const int _kDrawDRRectCommand = 15;
+  static const int _kDrawOvalCommand = 16;
+  static const int _kDrawCircleCommand = 17;
+  static const int _kDrawArcCommand = 18;
+
+  // Whether an operation with the given paint can be recorded into the command
+  // buffer. Shaders and filters are native objects.
+  bool _canRecord(Paint paint) => _commands != null && paint._objects == null;
+
+  // Adds a command with `argumentCount` argument words to the command buffer,
+  // and returns the index of its first argument.
+  int _addCommand(int command, int argumentCount) {
+    if (_commandCount + 1 + argumentCount > _kCommandBufferCapacity)
+      _flushCommands();
+    final int index = _commandCount;
+    _commands![index] = command;
+    _commandCount = index + 1 + argumentCount;
+    return index + 1;
+  }
+
+  // Angles take two words, since the native canvas converts them to degrees
+  // with double precision.
+  void _setCommandDouble(int index, double value) {
+    _commandData!.setFloat64(index << 2, value, _kFakeHostEndian);
+  }
+
+  void _setCommandRect(int index, Rect rect) {
+    final Float32List floats = _commandFloats!;
+    floats[index] = rect.left;
+    floats[index + 1] = rect.top;
+    floats[index + 2] = rect.right;
+    floats[index + 3] = rect.bottom;
+  }
+
+  void _setCommandRRect(int index, RRect rrect) {
+    final Float32List floats = _commandFloats!;
+    floats[index] = rrect.left;
+    floats[index + 1] = rrect.top;
+    floats[index + 2] = rrect.right;
+    floats[index + 3] = rrect.bottom;
+    floats[index + 4] = rrect.tlRadiusX;
+    floats[index + 5] = rrect.tlRadiusY;
+    floats[index + 6] = rrect.trRadiusX;
+    floats[index + 7] = rrect.trRadiusY;
+    floats[index + 8] = rrect.brRadiusX;
+    floats[index + 9] = rrect.brRadiusY;
+    floats[index + 10] = rrect.blRadiusX;
+    floats[index + 11] = rrect.blRadiusY;
+  }
+
+  void _setCommandPaint(int index, Paint paint) {
+    final Uint32List commands = _commands!;
+    final ByteData data = paint._data;
+    for (int i = 0; i < _kPaintWordCount; i += 1)
+      commands[index + i] = data.getUint32(i << 2, _kFakeHostEndian);
+  }
+
+  void _flushCommands() {
+    final int count = _commandCount;
+    if (count == 0)
+      return;
+    _commandCount = 0;
+    _executeCommands(_commands!, count);
+  }
+  void _executeCommands(Uint32List commands, int count) native 'Canvas_executeCommands';
+
   /// Saves a copy of the current transform and clip on the save stack.
   ///
   /// Call [restore] to pop the save stack.
@@ -3914,7 +4024,14 @@ class Canvas extends NativeFieldWrapperClass2 {
   ///
   ///  * [saveLayer], which does the same thing but additionally also groups the
   ///    commands done until the matching [restore].
-  void save() native 'Canvas_save';
+  void save() {
+    if (_commands != null) {
+      _addCommand(_kSaveCommand, 0);
+      return;
+    }
+    _save();
+  }
+  void _save() native 'Canvas_save';
 
   /// Saves a copy of the current transform and clip on the save stack, and then
   /// creates a new group which subsequent calls will become a part of. When the
@@ -4028,9 +4145,21 @@ class Canvas extends NativeFieldWrapperClass2 {
   void saveLayer(Rect? bounds, Paint paint) {
     assert(paint != null);
     if (bounds == null) {
+      if (_canRecord(paint)) {
+        _setCommandPaint(_addCommand(_kSaveLayerWithoutBoundsCommand, _kPaintWordCount), paint);
+        return;
+      }
+      _flushCommands();
       _saveLayerWithoutBounds(paint._objects, paint._data);
     } else {
       assert(_rectIsValid(bounds));
+      if (_canRecord(paint)) {
+        final int index = _addCommand(_kSaveLayerCommand, 4 + _kPaintWordCount);
+        _setCommandRect(index, bounds);
+        _setCommandPaint(index + 4, paint);
+        return;
+      }
+      _flushCommands();
       _saveLayer(bounds.left, bounds.top, bounds.right, bounds.bottom,
                  paint._objects, paint._data);
     }
@@ -4051,7 +4180,14 @@ class Canvas extends NativeFieldWrapperClass2 {
   ///
   /// If the state was pushed with with [saveLayer], then this call will also
   /// cause the new layer to be composited into the previous layer.
-  void restore() native 'Canvas_restore';
+  void restore() {
+    if (_commands != null) {
+      _addCommand(_kRestoreCommand, 0);
+      return;
+    }
+    _restore();
+  }
+  void _restore() native 'Canvas_restore';
 
   /// Returns the number of items on the save stack, including the
   /// initial state. This means it returns 1 for a clean canvas, and
@@ -4059,11 +4195,24 @@ class Canvas extends NativeFieldWrapperClass2 {
   /// each matching call to [restore] decrements it.
   ///
   /// This number cannot go below 1.
-  int getSaveCount() native 'Canvas_getSaveCount';
+  int getSaveCount() {
+    _flushCommands();
+    return _getSaveCount();
+  }
+  int _getSaveCount() native 'Canvas_getSaveCount';
 
   /// Add a translation to the current transform, shifting the coordinate space
   /// horizontally by the first argument and vertically by the second argument.
-  void translate(double dx, double dy) native 'Canvas_translate';
+  void translate(double dx, double dy) {
+    if (_commands != null) {
+      final int index = _addCommand(_kTranslateCommand, 2);
+      _commandFloats![index] = dx;
+      _commandFloats![index + 1] = dy;
+      return;
+    }
+    _translate(dx, dy);
+  }
+  void _translate(double dx, double dy) native 'Canvas_translate';
 
   /// Add an axis-aligned scale to the current transform, scaling by the first
   /// argument in the horizontal direction and the second in the vertical
@@ -4071,18 +4220,42 @@ class Canvas extends NativeFieldWrapperClass2 {
   ///
   /// If [sy] is unspecified, [sx] will be used for the scale in both
   /// directions.
-  void scale(double sx, [double? sy]) => _scale(sx, sy ?? sx);
+  void scale(double sx, [double? sy]) {
+    if (_commands != null) {
+      final int index = _addCommand(_kScaleCommand, 2);
+      _commandFloats![index] = sx;
+      _commandFloats![index + 1] = sy ?? sx;
+      return;
+    }
+    _scale(sx, sy ?? sx);
+  }
 
   void _scale(double sx, double sy) native 'Canvas_scale';
 
   /// Add a rotation to the current transform. The argument is in radians clockwise.
-  void rotate(double radians) native 'Canvas_rotate';
+  void rotate(double radians) {
+    if (_commands != null) {
+      _setCommandDouble(_addCommand(_kRotateCommand, 2), radians);
+      return;
+    }
+    _rotate(radians);
+  }
+  void _rotate(double radians) native 'Canvas_rotate';
 
   /// Add an axis-aligned skew to the current transform, with the first argument
   /// being the horizontal skew in rise over run units clockwise around the
   /// origin, and the second argument being the vertical skew in rise over run
   /// units clockwise around the origin.
-  void skew(double sx, double sy) native 'Canvas_skew';
+  void skew(double sx, double sy) {
+    if (_commands != null) {
+      final int index = _addCommand(_kSkewCommand, 2);
+      _commandFloats![index] = sx;
+      _commandFloats![index + 1] = sy;
+      return;
+    }
+    _skew(sx, sy);
+  }
+  void _skew(double sx, double sy) native 'Canvas_skew';
 
   /// Multiply the current transform by the specified 4⨉4 transformation matrix
   /// specified as a list of values in column-major order.
@@ -4090,6 +4263,7 @@ class Canvas extends NativeFieldWrapperClass2 {
     assert(matrix4 != null);
     if (matrix4.length != 16)
       throw ArgumentError('"matrix4" must have 16 entries.');
+    _flushCommands();
     _transform(matrix4);
   }
   void _transform(Float64List matrix4) native 'Canvas_transform';
@@ -4109,6 +4283,13 @@ class Canvas extends NativeFieldWrapperClass2 {
     assert(_rectIsValid(rect));
     assert(clipOp != null);
     assert(doAntiAlias != null);
+    if (_commands != null) {
+      final int index = _addCommand(_kClipRectCommand, 6);
+      _setCommandRect(index, rect);
+      _commands![index + 4] = clipOp.index;
+      _commands![index + 5] = doAntiAlias ? 1 : 0;
+      return;
+    }
     _clipRect(rect.left, rect.top, rect.right, rect.bottom, clipOp.index, doAntiAlias);
   }
   void _clipRect(double left,
@@ -4129,6 +4310,12 @@ class Canvas extends NativeFieldWrapperClass2 {
   void clipRRect(RRect rrect, {bool doAntiAlias = true}) {
     assert(_rrectIsValid(rrect));
     assert(doAntiAlias != null);
+    if (_commands != null) {
+      final int index = _addCommand(_kClipRRectCommand, 13);
+      _setCommandRRect(index, rrect);
+      _commands![index + 12] = doAntiAlias ? 1 : 0;
+      return;
+    }
     _clipRRect(rrect._value32, doAntiAlias);
   }
   void _clipRRect(Float32List rrect, bool doAntiAlias) native 'Canvas_clipRRect';
@@ -4145,6 +4332,7 @@ class Canvas extends NativeFieldWrapperClass2 {
   void clipPath(Path path, {bool doAntiAlias = true}) {
     assert(path != null); // path is checked on the engine side
     assert(doAntiAlias != null);
+    _flushCommands();
     _clipPath(path, doAntiAlias);
   }
   void _clipPath(Path path, bool doAntiAlias) native 'Canvas_clipPath';
@@ -4155,6 +4343,12 @@ class Canvas extends NativeFieldWrapperClass2 {
   void drawColor(Color color, BlendMode blendMode) {
     assert(color != null);
     assert(blendMode != null);
+    if (_commands != null) {
+      final int index = _addCommand(_kDrawColorCommand, 2);
+      _commands![index] = color.value;
+      _commands![index + 1] = blendMode.index;
+      return;
+    }
     _drawColor(color.value, blendMode.index);
   }
   void _drawColor(int color, int blendMode) native 'Canvas_drawColor';
@@ -4167,6 +4361,17 @@ class Canvas extends NativeFieldWrapperClass2 {
     assert(_offsetIsValid(p1));
     assert(_offsetIsValid(p2));
     assert(paint != null);
+    if (_canRecord(paint)) {
+      final int index = _addCommand(_kDrawLineCommand, 4 + _kPaintWordCount);
+      final Float32List floats = _commandFloats!;
+      floats[index] = p1.dx;
+      floats[index + 1] = p1.dy;
+      floats[index + 2] = p2.dx;
+      floats[index + 3] = p2.dy;
+      _setCommandPaint(index + 4, paint);
+      return;
+    }
+    _flushCommands();
     _drawLine(p1.dx, p1.dy, p2.dx, p2.dy, paint._objects, paint._data);
   }
   void _drawLine(double x1,
@@ -4182,6 +4387,11 @@ class Canvas extends NativeFieldWrapperClass2 {
   /// [drawColor] instead.
   void drawPaint(Paint paint) {
     assert(paint != null);
+    if (_canRecord(paint)) {
+      _setCommandPaint(_addCommand(_kDrawPaintCommand, _kPaintWordCount), paint);
+      return;
+    }
+    _flushCommands();
     _drawPaint(paint._objects, paint._data);
   }
   void _drawPaint(List<dynamic>? paintObjects, ByteData paintData) native 'Canvas_drawPaint';
@@ -4191,6 +4401,13 @@ class Canvas extends NativeFieldWrapperClass2 {
   void drawRect(Rect rect, Paint paint) {
     assert(_rectIsValid(rect));
     assert(paint != null);
+    if (_canRecord(paint)) {
+      final int index = _addCommand(_kDrawRectCommand, 4 + _kPaintWordCount);
+      _setCommandRect(index, rect);
+      _setCommandPaint(index + 4, paint);
+      return;
+    }
+    _flushCommands();
     _drawRect(rect.left, rect.top, rect.right, rect.bottom,
               paint._objects, paint._data);
   }
@@ -4206,6 +4423,13 @@ class Canvas extends NativeFieldWrapperClass2 {
   void drawRRect(RRect rrect, Paint paint) {
     assert(_rrectIsValid(rrect));
     assert(paint != null);
+    if (_canRecord(paint)) {
+      final int index = _addCommand(_kDrawRRectCommand, 12 + _kPaintWordCount);
+      _setCommandRRect(index, rrect);
+      _setCommandPaint(index + 12, paint);
+      return;
+    }
+    _flushCommands();
     _drawRRect(rrect._value32, paint._objects, paint._data);
   }
   void _drawRRect(Float32List rrect,
@@ -4221,6 +4445,14 @@ class Canvas extends NativeFieldWrapperClass2 {
     assert(_rrectIsValid(outer));
     assert(_rrectIsValid(inner));
     assert(paint != null);
+    if (_canRecord(paint)) {
+      final int index = _addCommand(_kDrawDRRectCommand, 24 + _kPaintWordCount);
+      _setCommandRRect(index, outer);
+      _setCommandRRect(index + 12, inner);
+      _setCommandPaint(index + 24, paint);
+      return;
+    }
+    _flushCommands();
     _drawDRRect(outer._value32, inner._value32, paint._objects, paint._data);
   }
   void _drawDRRect(Float32List outer,
@@ -4234,6 +4466,13 @@ class Canvas extends NativeFieldWrapperClass2 {
   void drawOval(Rect rect, Paint paint) {
     assert(_rectIsValid(rect));
     assert(paint != null);
+    if (_canRecord(paint)) {
+      final int index = _addCommand(_kDrawOvalCommand, 4 + _kPaintWordCount);
+      _setCommandRect(index, rect);
+      _setCommandPaint(index + 4, paint);
+      return;
+    }
+    _flushCommands();
     _drawOval(rect.left, rect.top, rect.right, rect.bottom,
               paint._objects, paint._data);
   }
@@ -4251,6 +4490,16 @@ class Canvas extends NativeFieldWrapperClass2 {
   void drawCircle(Offset c, double radius, Paint paint) {
     assert(_offsetIsValid(c));
     assert(paint != null);
+    if (_canRecord(paint)) {
+      final int index = _addCommand(_kDrawCircleCommand, 3 + _kPaintWordCount);
+      final Float32List floats = _commandFloats!;
+      floats[index] = c.dx;
+      floats[index + 1] = c.dy;
+      floats[index + 2] = radius;
+      _setCommandPaint(index + 3, paint);
+      return;
+    }
+    _flushCommands();
     _drawCircle(c.dx, c.dy, radius, paint._objects, paint._data);
   }
   void _drawCircle(double x,
@@ -4273,6 +4522,16 @@ class Canvas extends NativeFieldWrapperClass2 {
   void drawArc(Rect rect, double startAngle, double sweepAngle, bool useCenter, Paint paint) {
     assert(_rectIsValid(rect));
     assert(paint != null);
+    if (_canRecord(paint)) {
+      final int index = _addCommand(_kDrawArcCommand, 9 + _kPaintWordCount);
+      _setCommandRect(index, rect);
+      _setCommandDouble(index + 4, startAngle);
+      _setCommandDouble(index + 6, sweepAngle);
+      _commands![index + 8] = useCenter ? 1 : 0;
+      _setCommandPaint(index + 9, paint);
+      return;
+    }
+    _flushCommands();
     _drawArc(rect.left, rect.top, rect.right, rect.bottom, startAngle,
              sweepAngle, useCenter, paint._objects, paint._data);
   }
@@ -4294,6 +4553,7 @@ class Canvas extends NativeFieldWrapperClass2 {
   void drawPath(Path path, Paint paint) {
     assert(path != null); // path is checked on the engine side
     assert(paint != null);
+    _flushCommands();
     _drawPath(path, paint._objects, paint._data);
   }
   void _drawPath(Path path,
@@ -4306,6 +4566,7 @@ class Canvas extends NativeFieldWrapperClass2 {
     assert(image != null); // image is checked on the engine side
     assert(_offsetIsValid(offset));
     assert(paint != null);
+    _flushCommands();
     _drawImage(image._image, offset.dx, offset.dy, paint._objects, paint._data, paint.filterQuality.index);
   }
   void _drawImage(_Image image,
@@ -4329,6 +4590,7 @@ class Canvas extends NativeFieldWrapperClass2 {
     assert(_rectIsValid(src));
     assert(_rectIsValid(dst));
     assert(paint != null);
+    _flushCommands();
     _drawImageRect(image._image,
                    src.left,
                    src.top,
@@ -4373,6 +4635,7 @@ class Canvas extends NativeFieldWrapperClass2 {
     assert(_rectIsValid(center));
     assert(_rectIsValid(dst));
     assert(paint != null);
+    _flushCommands();
     _drawImageNine(image._image,
                    center.left,
                    center.top,
@@ -4403,6 +4666,7 @@ class Canvas extends NativeFieldWrapperClass2 {
   /// [PictureRecorder].
   void drawPicture(Picture picture) {
     assert(picture != null); // picture is checked on the engine side
+    _flushCommands();
     _drawPicture(picture);
   }
   void _drawPicture(Picture picture) native 'Canvas_drawPicture';
@@ -4430,6 +4694,7 @@ class Canvas extends NativeFieldWrapperClass2 {
   void drawParagraph(Paragraph paragraph, Offset offset) {
     assert(paragraph != null);
     assert(_offsetIsValid(offset));
+    _flushCommands();
     paragraph._paint(this, offset.dx, offset.dy);
   }
 
@@ -4445,6 +4710,7 @@ class Canvas extends NativeFieldWrapperClass2 {
     assert(pointMode != null);
     assert(points != null);
     assert(paint != null);
+    _flushCommands();
     _drawPoints(paint._objects, paint._data, pointMode.index, _encodePointList(points));
   }
 
@@ -4463,6 +4729,7 @@ class Canvas extends NativeFieldWrapperClass2 {
     assert(paint != null);
     if (points.length % 2 != 0)
       throw ArgumentError('"points" must have an even number of values.');
+    _flushCommands();
     _drawPoints(paint._objects, paint._data, pointMode.index, points);
   }
 
@@ -4484,6 +4751,7 @@ class Canvas extends NativeFieldWrapperClass2 {
     assert(vertices != null); // vertices is checked on the engine side
     assert(paint != null);
     assert(blendMode != null);
+    _flushCommands();
     _drawVertices(vertices, blendMode.index, paint._objects, paint._data);
   }
   void _drawVertices(Vertices vertices,
@@ -4662,6 +4930,7 @@ class Canvas extends NativeFieldWrapperClass2 {
     final Float32List? cullRectBuffer = cullRect?._value32;
     final int qualityIndex = paint.filterQuality.index;
 
+    _flushCommands();
     _drawAtlas(
       paint._objects, paint._data, qualityIndex, atlas._image, rstTransformBuffer, rectBuffer,
       colorBuffer, (blendMode ?? BlendMode.src).index, cullRectBuffer
@@ -4831,6 +5100,7 @@ class Canvas extends NativeFieldWrapperClass2 {
       throw ArgumentError('If non-null, "colors" length must be one fourth the length of "rstTransforms" and "rects".');
     final int qualityIndex = paint.filterQuality.index;
 
+    _flushCommands();
     _drawAtlas(
       paint._objects, paint._data, qualityIndex, atlas._image, rstTransforms, rects,
       colors, (blendMode ?? BlendMode.src).index, cullRect?._value32
@@ -4857,6 +5127,7 @@ class Canvas extends NativeFieldWrapperClass2 {
     assert(path != null); // path is checked on the engine side
     assert(color != null);
     assert(transparentOccluder != null);
+    _flushCommands();
     _drawShadow(path, color.value, elevation, transparentOccluder);
   }
   void _drawShadow(Path path,
@@ -4945,6 +5216,7 @@ class PictureRecorder extends NativeFieldWrapperClass2 {
   Picture endRecording() {
     if (_canvas == null)
       throw StateError('PictureRecorder did not start recording.');
+    _canvas!._flushCommands();
     final Picture picture = Picture._();
     _endRecording(picture);
     _canvas!._recorder = null;
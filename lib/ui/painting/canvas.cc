@@ -6,6 +6,7 @@
 #include "flutter/lib/ui/painting/image_filter.h"
 
 #include <cmath>
+#include <cstring>
 
 #include "flutter/flow/layers/physical_shape_layer.h"
 #include "flutter/lib/ui/painting/image.h"
@@ -30,6 +31,11 @@ static void Canvas_constructor(Dart_NativeArguments args) {
   DartCallConstructor(&Canvas::Create, args);
 }
 
+static void Canvas_isCommandBufferEnabled(Dart_NativeArguments args) {
+  Dart_SetBooleanReturnValue(
+      args, UIDartState::Current()->enable_canvas_command_buffer());
+}
+
 IMPLEMENT_WRAPPERTYPEINFO(ui, Canvas);
 
 #define FOR_EACH_BINDING(V)         \
@@ -63,12 +69,15 @@ IMPLEMENT_WRAPPERTYPEINFO(ui, Canvas);
   V(Canvas, drawPoints)             \
   V(Canvas, drawVertices)           \
   V(Canvas, drawAtlas)              \
-  V(Canvas, drawShadow)
+  V(Canvas, drawShadow)             \
+  V(Canvas, executeCommands)
 
 FOR_EACH_BINDING(DART_NATIVE_CALLBACK)
 
 void Canvas::RegisterNatives(tonic::DartLibraryNatives* natives) {
   natives->Register({{"Canvas_constructor", Canvas_constructor, 6, true},
+                     {"Canvas_isCommandBufferEnabled",
+                      Canvas_isCommandBufferEnabled, 0, true},
                      FOR_EACH_BINDING(DART_REGISTER_NATIVE)});
 }
 
@@ -88,6 +97,120 @@ fml::RefPtr<Canvas> Canvas::Create(PictureRecorder* recorder,
   return canvas;
 }
 
+namespace {
+
+// The draw operations that painting.dart records into the command buffer of
+// a Canvas. Each command is followed by its arguments, one 32-bit word each,
+// except for angles, which are doubles that take two words.
+// Must be kept in sync with the command constants in painting.dart.
+enum CanvasCommand : uint32_t {
+  kSaveCommand,
+  kSaveLayerWithoutBoundsCommand,
+  kSaveLayerCommand,
+  kRestoreCommand,
+  kTranslateCommand,
+  kScaleCommand,
+  kRotateCommand,
+  kSkewCommand,
+  kClipRectCommand,
+  kClipRRectCommand,
+  kDrawColorCommand,
+  kDrawLineCommand,
+  kDrawPaintCommand,
+  kDrawRectCommand,
+  kDrawRRectCommand,
+  kDrawDRRectCommand,
+  kDrawOvalCommand,
+  kDrawCircleCommand,
+  kDrawArcCommand,
+  kCommandCount,
+};
+
+constexpr size_t kPaintWordCount = Paint::kDataByteCount / sizeof(uint32_t);
+constexpr size_t kRectWordCount = 4;
+constexpr size_t kRRectWordCount = 12;
+
+// The number of argument words of each command.
+constexpr size_t kCommandArgumentWordCounts[kCommandCount] = {
+    0,                                      // kSaveCommand
+    kPaintWordCount,                        // kSaveLayerWithoutBoundsCommand
+    kRectWordCount + kPaintWordCount,       // kSaveLayerCommand
+    0,                                      // kRestoreCommand
+    2,                                      // kTranslateCommand
+    2,                                      // kScaleCommand
+    2,                                      // kRotateCommand
+    2,                                      // kSkewCommand
+    kRectWordCount + 2,                     // kClipRectCommand
+    kRRectWordCount + 1,                    // kClipRRectCommand
+    2,                                      // kDrawColorCommand
+    4 + kPaintWordCount,                    // kDrawLineCommand
+    kPaintWordCount,                        // kDrawPaintCommand
+    kRectWordCount + kPaintWordCount,       // kDrawRectCommand
+    kRRectWordCount + kPaintWordCount,      // kDrawRRectCommand
+    2 * kRRectWordCount + kPaintWordCount,  // kDrawDRRectCommand
+    kRectWordCount + kPaintWordCount,       // kDrawOvalCommand
+    3 + kPaintWordCount,                    // kDrawCircleCommand
+    kRectWordCount + 5 + kPaintWordCount,   // kDrawArcCommand
+};
+
+// Reads the arguments of the commands in a command buffer, in order.
+class CommandReader {
+ public:
+  CommandReader(const uint32_t* words, size_t count)
+      : position_(words), end_(words + count) {}
+
+  bool done() const { return position_ == end_; }
+
+  // Whether |count| more words can be read.
+  bool CanRead(size_t count) const {
+    return count <= static_cast<size_t>(end_ - position_);
+  }
+
+  uint32_t ReadWord() { return *position_++; }
+
+  float ReadFloat() {
+    float value;
+    memcpy(&value, position_++, sizeof(value));
+    return value;
+  }
+
+  double ReadDouble() {
+    double value;
+    memcpy(&value, position_, sizeof(value));
+    position_ += sizeof(value) / sizeof(uint32_t);
+    return value;
+  }
+
+  SkRect ReadRect() {
+    float values[kRectWordCount];
+    ReadFloats(values, kRectWordCount);
+    return SkRect::MakeLTRB(values[0], values[1], values[2], values[3]);
+  }
+
+  RRect ReadRRect() {
+    float values[kRRectWordCount];
+    ReadFloats(values, kRRectWordCount);
+    return RRect::FromValues(values);
+  }
+
+  Paint ReadPaint() {
+    Paint paint(position_);
+    position_ += kPaintWordCount;
+    return paint;
+  }
+
+ private:
+  const uint32_t* position_;
+  const uint32_t* const end_;
+
+  void ReadFloats(float* values, size_t count) {
+    memcpy(values, position_, count * sizeof(float));
+    position_ += count;
+  }
+};
+
+}  // namespace
+
 Canvas::Canvas(SkCanvas* canvas) : canvas_(canvas) {}
 
 Canvas::~Canvas() {}
@@ -486,6 +609,148 @@ void Canvas::drawShadow(const CanvasPath* path,
                                           elevation, transparentOccluder, dpr);
 }
 
+void Canvas::executeCommands(const tonic::Uint32List& commands, int count) {
+  if (!canvas_) {
+    return;
+  }
+  if (count < 0 || count > commands.num_elements()) {
+    Dart_ThrowException(
+        ToDart("Canvas command buffer is shorter than its command count."));
+    return;
+  }
+
+  const PaintData paint_data;
+  CommandReader reader(commands.data(), count);
+  while (!reader.done()) {
+    const uint32_t command = reader.ReadWord();
+    if (command >= kCommandCount ||
+        !reader.CanRead(kCommandArgumentWordCounts[command])) {
+      Dart_ThrowException(ToDart("Canvas command buffer is malformed."));
+      return;
+    }
+    // The arguments are read into locals first, since the order in which
+    // function arguments are evaluated is unspecified.
+    switch (command) {
+      case kSaveCommand:
+        save();
+        break;
+      case kSaveLayerWithoutBoundsCommand: {
+        Paint paint = reader.ReadPaint();
+        saveLayerWithoutBounds(paint, paint_data);
+        break;
+      }
+      case kSaveLayerCommand: {
+        SkRect bounds = reader.ReadRect();
+        Paint paint = reader.ReadPaint();
+        saveLayer(bounds.left(), bounds.top(), bounds.right(), bounds.bottom(),
+                  paint, paint_data);
+        break;
+      }
+      case kRestoreCommand:
+        restore();
+        break;
+      case kTranslateCommand: {
+        float dx = reader.ReadFloat();
+        float dy = reader.ReadFloat();
+        translate(dx, dy);
+        break;
+      }
+      case kScaleCommand: {
+        float sx = reader.ReadFloat();
+        float sy = reader.ReadFloat();
+        scale(sx, sy);
+        break;
+      }
+      case kRotateCommand:
+        rotate(reader.ReadDouble());
+        break;
+      case kSkewCommand: {
+        float sx = reader.ReadFloat();
+        float sy = reader.ReadFloat();
+        skew(sx, sy);
+        break;
+      }
+      case kClipRectCommand: {
+        SkRect rect = reader.ReadRect();
+        SkClipOp clip_op = static_cast<SkClipOp>(reader.ReadWord());
+        bool anti_alias = reader.ReadWord() != 0;
+        clipRect(rect.left(), rect.top(), rect.right(), rect.bottom(), clip_op,
+                 anti_alias);
+        break;
+      }
+      case kClipRRectCommand: {
+        RRect rrect = reader.ReadRRect();
+        bool anti_alias = reader.ReadWord() != 0;
+        clipRRect(rrect, anti_alias);
+        break;
+      }
+      case kDrawColorCommand: {
+        SkColor color = reader.ReadWord();
+        SkBlendMode blend_mode = static_cast<SkBlendMode>(reader.ReadWord());
+        drawColor(color, blend_mode);
+        break;
+      }
+      case kDrawLineCommand: {
+        SkRect points = reader.ReadRect();
+        Paint paint = reader.ReadPaint();
+        drawLine(points.left(), points.top(), points.right(), points.bottom(),
+                 paint, paint_data);
+        break;
+      }
+      case kDrawPaintCommand: {
+        Paint paint = reader.ReadPaint();
+        drawPaint(paint, paint_data);
+        break;
+      }
+      case kDrawRectCommand: {
+        SkRect rect = reader.ReadRect();
+        Paint paint = reader.ReadPaint();
+        drawRect(rect.left(), rect.top(), rect.right(), rect.bottom(), paint,
+                 paint_data);
+        break;
+      }
+      case kDrawRRectCommand: {
+        RRect rrect = reader.ReadRRect();
+        Paint paint = reader.ReadPaint();
+        drawRRect(rrect, paint, paint_data);
+        break;
+      }
+      case kDrawDRRectCommand: {
+        RRect outer = reader.ReadRRect();
+        RRect inner = reader.ReadRRect();
+        Paint paint = reader.ReadPaint();
+        drawDRRect(outer, inner, paint, paint_data);
+        break;
+      }
+      case kDrawOvalCommand: {
+        SkRect rect = reader.ReadRect();
+        Paint paint = reader.ReadPaint();
+        drawOval(rect.left(), rect.top(), rect.right(), rect.bottom(), paint,
+                 paint_data);
+        break;
+      }
+      case kDrawCircleCommand: {
+        float x = reader.ReadFloat();
+        float y = reader.ReadFloat();
+        float radius = reader.ReadFloat();
+        Paint paint = reader.ReadPaint();
+        drawCircle(x, y, radius, paint, paint_data);
+        break;
+      }
+      case kDrawArcCommand: {
+        SkRect rect = reader.ReadRect();
+        double start_angle = reader.ReadDouble();
+        double sweep_angle = reader.ReadDouble();
+        bool use_center = reader.ReadWord() != 0;
+        Paint paint = reader.ReadPaint();
+        drawArc(rect.left(), rect.top(), rect.right(), rect.bottom(),
+                start_angle, sweep_angle, use_center, paint, paint_data);
+        break;
+      }
+    }
+  }
+}
+
 void Canvas::Invalidate() {
   canvas_ = nullptr;
   if (dart_wrapper()) {
@@ -168,6 +168,12 @@ class Canvas : public RefCountedDartWrappable<Canvas> {
                   double elevation,
                   bool transparentOccluder);
 
+  // Replays the first |count| words of |commands|, in which painting.dart
+  // records draw operations that don't reference other native objects when
+  // the canvas command buffer is enabled. See
+  // |Settings::enable_canvas_command_buffer|.
+  void executeCommands(const tonic::Uint32List& commands, int count);
+
   SkCanvas* canvas() const { return canvas_; }
   void Invalidate();
 
@@ -0,0 +1,99 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/canvas.h"
+
+#include <cmath>
+#include <memory>
+#include <variant>
+#include <vector>
+
+#include "flutter/common/task_runners.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/lib/ui/painting/picture.h"
+#include "flutter/runtime/dart_vm.h"
+#include "flutter/shell/common/shell_test.h"
+#include "flutter/shell/common/thread_host.h"
+#include "flutter/testing/mock_canvas.h"
+#include "flutter/testing/testing.h"
+
+namespace flutter {
+namespace testing {
+
+TEST_F(ShellTest, CanvasCommandBufferKeepsTheOrderOfOperations) {
+  auto message_latch = std::make_shared<fml::AutoResetWaitableEvent>();
+
+  auto native_validate_picture = [message_latch](Dart_NativeArguments args) {
+    EXPECT_TRUE(UIDartState::Current()->enable_canvas_command_buffer());
+    auto handle = Dart_GetNativeArgument(args, 0);
+    intptr_t peer = 0;
+    Dart_Handle result = Dart_GetNativeInstanceField(
+        handle, tonic::DartWrappable::kPeerIndex, &peer);
+    ASSERT_FALSE(Dart_IsError(result));
+    Picture* picture = reinterpret_cast<Picture*>(peer);
+    ASSERT_TRUE(picture);
+
+    MockCanvas canvas;
+    picture->picture()->playback(&canvas);
+
+    // The rects are recorded into the command buffer, and the path is drawn
+    // with a native call that flushes the buffer first.
+    std::vector<MockCanvas::DrawCall> draw_calls;
+    for (const auto& draw_call : canvas.draw_calls()) {
+      if (std::holds_alternative<MockCanvas::DrawRectData>(draw_call.data) ||
+          std::holds_alternative<MockCanvas::DrawPathData>(draw_call.data) ||
+          std::holds_alternative<MockCanvas::ConcatMatrixData>(
+              draw_call.data)) {
+        draw_calls.push_back(draw_call);
+      }
+    }
+    ASSERT_EQ(draw_calls.size(), 6u);
+    EXPECT_EQ(std::get<MockCanvas::ConcatMatrixData>(draw_calls[0].data).matrix,
+              SkM44::Translate(10, 20));
+    EXPECT_EQ(std::get<MockCanvas::DrawRectData>(draw_calls[1].data).rect,
+              SkRect::MakeLTRB(0, 0, 10, 10));
+    EXPECT_TRUE(
+        std::holds_alternative<MockCanvas::DrawPathData>(draw_calls[2].data));
+    EXPECT_EQ(draw_calls[2].layer, draw_calls[1].layer);
+    EXPECT_EQ(std::get<MockCanvas::DrawRectData>(draw_calls[3].data).rect,
+              SkRect::MakeLTRB(20, 20, 30, 30));
+    EXPECT_LT(draw_calls[3].layer, draw_calls[1].layer);
+    // The angle is recorded with double precision, as the native call gets
+    // it.
+    SkMatrix rotation;
+    rotation.setRotate(1.1 * 180.0 / M_PI);
+    EXPECT_EQ(std::get<MockCanvas::ConcatMatrixData>(draw_calls[4].data).matrix,
+              SkM44(rotation));
+    message_latch->Signal();
+  };
+
+  Settings settings = CreateSettingsForFixture();
+  settings.enable_canvas_command_buffer = true;
+  TaskRunners task_runners("test",                  // label
+                           GetCurrentTaskRunner(),  // platform
+                           CreateNewThread(),       // raster
+                           CreateNewThread(),       // ui
+                           CreateNewThread()        // io
+  );
+
+  AddNativeCallback("ValidateCanvasCommands",
+                    CREATE_NATIVE_ENTRY(native_validate_picture));
+
+  std::unique_ptr<Shell> shell =
+      CreateShell(std::move(settings), std::move(task_runners));
+
+  ASSERT_TRUE(shell->IsSetup());
+  auto configuration = RunConfiguration::InferFromSettings(settings);
+  configuration.SetEntrypoint("recordCanvasCommands");
+
+  shell->RunEngine(std::move(configuration), [](auto result) {
+    ASSERT_EQ(result, Engine::RunStatus::Success);
+  });
+
+  message_latch->Wait();
+  DestroyShell(std::move(shell), std::move(task_runners));
+}
+
+}  // namespace testing
+}  // namespace flutter
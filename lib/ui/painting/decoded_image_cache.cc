@@ -0,0 +1,152 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/decoded_image_cache.h"
+
+#include <cstring>
+
+#include "flutter/fml/hash_combine.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+namespace {
+
+// Hashes 8 bytes at a time. This only needs to spread distinct images well,
+// collisions are resolved by comparing the bytes.
+uint64_t HashBytes(const uint8_t* bytes, size_t size) {
+  constexpr uint64_t kMultiplier = 0x9e3779b97f4a7c15ull;
+  uint64_t hash = size * kMultiplier;
+  size_t offset = 0;
+  for (; offset + sizeof(uint64_t) <= size; offset += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, bytes + offset, sizeof(word));
+    hash = (hash ^ word) * kMultiplier;
+    hash ^= hash >> 32;
+  }
+  for (; offset < size; ++offset) {
+    hash = (hash ^ bytes[offset]) * kMultiplier;
+  }
+  return hash ^ (hash >> 29);
+}
+
+}  // namespace
+
+bool DecodedImageCache::Key::operator==(const Key& other) const {
+  return data_hash == other.data_hash && data_size == other.data_size &&
+         target_width == other.target_width &&
+         target_height == other.target_height &&
+         color_type == other.color_type;
+}
+
+std::size_t DecodedImageCache::KeyHash::operator()(const Key& key) const {
+  return fml::HashCombine(key.data_hash, key.data_size, key.target_width,
+                          key.target_height, static_cast<int>(key.color_type));
+}
+
+DecodedImageCache::DecodedImageCache(size_t max_bytes)
+    : max_bytes_(max_bytes) {}
+
+DecodedImageCache::~DecodedImageCache() = default;
+
+DecodedImageCache::Key DecodedImageCache::MakeKey(const SkData& data,
+                                                  uint32_t target_width,
+                                                  uint32_t target_height,
+                                                  SkColorType color_type) {
+  return {HashBytes(data.bytes(), data.size()), data.size(), target_width,
+          target_height, color_type};
+}
+
+sk_sp<SkImage> DecodedImageCache::Get(const Key& key,
+                                      const sk_sp<SkData>& data) {
+  std::scoped_lock lock(mutex_);
+  auto found = index_.find(key);
+  if (found == index_.end() || !found->second->data->equals(data.get())) {
+    miss_count_++;
+    TraceCountersLocked();
+    return nullptr;
+  }
+  hit_count_++;
+  entries_.splice(entries_.begin(), entries_, found->second);
+  TraceCountersLocked();
+  return found->second->image;
+}
+
+void DecodedImageCache::Put(const Key& key,
+                            sk_sp<SkData> data,
+                            sk_sp<SkImage> image) {
+  if (!data || !image) {
+    return;
+  }
+  const size_t bytes = data->size() + image->imageInfo().computeMinByteSize();
+  std::scoped_lock lock(mutex_);
+  if (bytes > max_bytes_) {
+    return;
+  }
+  auto found = index_.find(key);
+  if (found != index_.end()) {
+    byte_size_ -= found->second->bytes;
+    entries_.erase(found->second);
+    index_.erase(found);
+  }
+  entries_.push_front({key, std::move(data), std::move(image), bytes});
+  index_[key] = entries_.begin();
+  byte_size_ += bytes;
+  EvictToMaxBytesLocked();
+  TraceCountersLocked();
+}
+
+void DecodedImageCache::Clear() {
+  std::scoped_lock lock(mutex_);
+  entries_.clear();
+  index_.clear();
+  byte_size_ = 0;
+  TraceCountersLocked();
+}
+
+void DecodedImageCache::SetMaxBytes(size_t max_bytes) {
+  std::scoped_lock lock(mutex_);
+  max_bytes_ = max_bytes;
+  EvictToMaxBytesLocked();
+}
+
+size_t DecodedImageCache::GetMaxBytes() const {
+  std::scoped_lock lock(mutex_);
+  return max_bytes_;
+}
+
+size_t DecodedImageCache::GetByteSize() const {
+  std::scoped_lock lock(mutex_);
+  return byte_size_;
+}
+
+size_t DecodedImageCache::GetHitCount() const {
+  std::scoped_lock lock(mutex_);
+  return hit_count_;
+}
+
+size_t DecodedImageCache::GetMissCount() const {
+  std::scoped_lock lock(mutex_);
+  return miss_count_;
+}
+
+void DecodedImageCache::EvictToMaxBytesLocked() {
+  while (byte_size_ > max_bytes_ && !entries_.empty()) {
+    const Entry& entry = entries_.back();
+    byte_size_ -= entry.bytes;
+    index_.erase(entry.key);
+    entries_.pop_back();
+  }
+}
+
+void DecodedImageCache::TraceCountersLocked() const {
+#if !FLUTTER_RELEASE
+  FML_TRACE_COUNTER("flutter", "DecodedImageCache",
+                    reinterpret_cast<int64_t>(this), "Hits", hit_count_,
+                    "Misses", miss_count_, "ImageCount", entries_.size(),
+                    "MBytes", byte_size_ / (1024 * 1024));
+#endif  // !FLUTTER_RELEASE
+}
+
+}  // namespace flutter
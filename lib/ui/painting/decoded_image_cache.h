@@ -0,0 +1,98 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_DECODED_IMAGE_CACHE_H_
+#define FLUTTER_LIB_UI_PAINTING_DECODED_IMAGE_CACHE_H_
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include "flutter/fml/macros.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkImageInfo.h"
+#include "third_party/skia/include/core/SkRefCnt.h"
+
+namespace flutter {
+
+// A cache of decoded raster images, keyed by the contents of the encoded
+// image and the size and color type the image was decoded to. This lets
+// repeated decodes of the same image bytes at the same size, such as an
+// avatar shown on several screens, skip decompression.
+//
+// The cache is safe to use from multiple threads. Cached images are evicted
+// in least recently used order once the combined size of the encoded and
+// decoded images exceeds the byte budget. A budget of 0 disables the cache.
+class DecodedImageCache {
+ public:
+  struct Key {
+    uint64_t data_hash;
+    size_t data_size;
+    uint32_t target_width;
+    uint32_t target_height;
+    SkColorType color_type;
+
+    bool operator==(const Key& other) const;
+  };
+
+  explicit DecodedImageCache(size_t max_bytes = 0);
+
+  ~DecodedImageCache();
+
+  static Key MakeKey(const SkData& data,
+                     uint32_t target_width,
+                     uint32_t target_height,
+                     SkColorType color_type);
+
+  // Returns the image cached for the key if it was decoded from the same
+  // bytes as |data|, or nullptr.
+  sk_sp<SkImage> Get(const Key& key, const sk_sp<SkData>& data);
+
+  void Put(const Key& key, sk_sp<SkData> data, sk_sp<SkImage> image);
+
+  void Clear();
+
+  void SetMaxBytes(size_t max_bytes);
+
+  size_t GetMaxBytes() const;
+
+  size_t GetByteSize() const;
+
+  size_t GetHitCount() const;
+
+  size_t GetMissCount() const;
+
+ private:
+  struct KeyHash {
+    std::size_t operator()(const Key& key) const;
+  };
+
+  struct Entry {
+    Key key;
+    sk_sp<SkData> data;
+    sk_sp<SkImage> image;
+    size_t bytes;
+  };
+
+  mutable std::mutex mutex_;
+  size_t max_bytes_;
+  size_t byte_size_ = 0;
+  size_t hit_count_ = 0;
+  size_t miss_count_ = 0;
+  // Most recently used entries are at the front.
+  std::list<Entry> entries_;
+  std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index_;
+
+  void EvictToMaxBytesLocked();
+
+  void TraceCountersLocked() const;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DecodedImageCache);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_DECODED_IMAGE_CACHE_H_
@@ -0,0 +1,128 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/decoded_image_cache.h"
+
+#include <vector>
+
+#include "flutter/testing/testing.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+sk_sp<SkData> MakeData(size_t size, uint8_t value) {
+  std::vector<uint8_t> bytes(size, value);
+  return SkData::MakeWithCopy(bytes.data(), bytes.size());
+}
+
+sk_sp<SkImage> MakeImage(int width, int height) {
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(width, height);
+  bitmap.eraseColor(SK_ColorRED);
+  bitmap.setImmutable();
+  return SkImage::MakeFromBitmap(bitmap);
+}
+
+DecodedImageCache::Key MakeKey(const sk_sp<SkData>& data,
+                               uint32_t width,
+                               uint32_t height) {
+  return DecodedImageCache::MakeKey(*data, width, height, kN32_SkColorType);
+}
+
+}  // namespace
+
+TEST(DecodedImageCacheTest, ZeroBudgetCachesNothing) {
+  DecodedImageCache cache;
+  auto data = MakeData(16, 1);
+  auto key = MakeKey(data, 10, 10);
+  cache.Put(key, data, MakeImage(10, 10));
+  ASSERT_EQ(cache.GetByteSize(), 0u);
+  ASSERT_EQ(cache.Get(key, data), nullptr);
+}
+
+TEST(DecodedImageCacheTest, CountsHitsAndMisses) {
+  DecodedImageCache cache(1024 * 1024);
+  auto data = MakeData(16, 1);
+  auto image = MakeImage(10, 10);
+  auto key = MakeKey(data, 10, 10);
+
+  ASSERT_EQ(cache.Get(key, data), nullptr);
+  cache.Put(key, data, image);
+  ASSERT_EQ(cache.Get(key, data), image);
+  // Equal bytes in a different buffer are a hit too.
+  ASSERT_EQ(cache.Get(key, MakeData(16, 1)), image);
+
+  ASSERT_EQ(cache.GetHitCount(), 2u);
+  ASSERT_EQ(cache.GetMissCount(), 1u);
+  ASSERT_EQ(cache.GetByteSize(), 16u + 10 * 10 * 4);
+}
+
+TEST(DecodedImageCacheTest, KeyIncludesTargetSizeAndColorType) {
+  DecodedImageCache cache(1024 * 1024);
+  auto data = MakeData(16, 1);
+  cache.Put(MakeKey(data, 10, 10), data, MakeImage(10, 10));
+
+  ASSERT_EQ(cache.Get(MakeKey(data, 20, 10), data), nullptr);
+  ASSERT_EQ(cache.Get(DecodedImageCache::MakeKey(*data, 10, 10,
+                                                 kRGBA_F16_SkColorType),
+                      data),
+            nullptr);
+  ASSERT_NE(cache.Get(MakeKey(data, 10, 10), data), nullptr);
+}
+
+TEST(DecodedImageCacheTest, DifferentBytesWithSameKeyMiss) {
+  DecodedImageCache cache(1024 * 1024);
+  auto data = MakeData(16, 1);
+  auto key = MakeKey(data, 10, 10);
+  cache.Put(key, data, MakeImage(10, 10));
+
+  // Simulate a hash collision by looking up other bytes with the same key.
+  ASSERT_EQ(cache.Get(key, MakeData(16, 2)), nullptr);
+  ASSERT_EQ(cache.GetMissCount(), 1u);
+}
+
+TEST(DecodedImageCacheTest, EvictsLeastRecentlyUsedImages) {
+  const size_t entry_bytes = 16 + 10 * 10 * 4;
+  DecodedImageCache cache(entry_bytes * 2);
+  auto data_1 = MakeData(16, 1);
+  auto data_2 = MakeData(16, 2);
+  auto data_3 = MakeData(16, 3);
+
+  cache.Put(MakeKey(data_1, 10, 10), data_1, MakeImage(10, 10));
+  cache.Put(MakeKey(data_2, 10, 10), data_2, MakeImage(10, 10));
+  // Touch the first image so that the second one is evicted next.
+  ASSERT_NE(cache.Get(MakeKey(data_1, 10, 10), data_1), nullptr);
+  cache.Put(MakeKey(data_3, 10, 10), data_3, MakeImage(10, 10));
+
+  ASSERT_EQ(cache.GetByteSize(), entry_bytes * 2);
+  ASSERT_NE(cache.Get(MakeKey(data_1, 10, 10), data_1), nullptr);
+  ASSERT_EQ(cache.Get(MakeKey(data_2, 10, 10), data_2), nullptr);
+  ASSERT_NE(cache.Get(MakeKey(data_3, 10, 10), data_3), nullptr);
+
+  cache.SetMaxBytes(entry_bytes);
+  ASSERT_EQ(cache.GetByteSize(), entry_bytes);
+  ASSERT_NE(cache.Get(MakeKey(data_3, 10, 10), data_3), nullptr);
+}
+
+TEST(DecodedImageCacheTest, DoesNotCacheImagesLargerThanBudget) {
+  DecodedImageCache cache(100);
+  auto data = MakeData(16, 1);
+  cache.Put(MakeKey(data, 10, 10), data, MakeImage(10, 10));
+  ASSERT_EQ(cache.GetByteSize(), 0u);
+}
+
+TEST(DecodedImageCacheTest, ClearRemovesAllImages) {
+  DecodedImageCache cache(1024 * 1024);
+  auto data = MakeData(16, 1);
+  cache.Put(MakeKey(data, 10, 10), data, MakeImage(10, 10));
+  cache.Clear();
+  ASSERT_EQ(cache.GetByteSize(), 0u);
+  ASSERT_EQ(cache.Get(MakeKey(data, 10, 10), data), nullptr);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -18,6 +18,7 @@ ImageDecoder::ImageDecoder(
     : runners_(std::move(runners)),
       concurrent_task_runner_(std::move(concurrent_task_runner)),
       io_manager_(std::move(io_manager)),
+      decoded_image_cache_(std::make_shared<DecodedImageCache>()),
       weak_factory_(this) {
   FML_DCHECK(runners_.IsValid());
   FML_DCHECK(runners_.GetUITaskRunner()->RunsTasksOnCurrentThread())
@@ -26,9 +27,24 @@ ImageDecoder::ImageDecoder(
 
 ImageDecoder::~ImageDecoder() = default;
 
+static bool AllocatePixels(SkBitmap& bitmap,
+                           const SkImageInfo& info,
+                           size_t* allocated_pixel_bytes) {
+  if (!bitmap.tryAllocPixels(info)) {
+    FML_LOG(ERROR) << "Failed to allocate memory for bitmap of size "
+                   << info.computeMinByteSize() << "B";
+    return false;
+  }
+  if (allocated_pixel_bytes) {
+    *allocated_pixel_bytes += bitmap.computeByteSize();
+  }
+  return true;
+}
+
 static sk_sp<SkImage> ResizeRasterImage(sk_sp<SkImage> image,
                                         const SkISize& resized_dimensions,
-                                        const fml::tracing::TraceFlow& flow) {
+                                        const fml::tracing::TraceFlow& flow,
+                                        size_t* allocated_pixel_bytes) {
   FML_DCHECK(!image->isTextureBacked());
 
   TRACE_EVENT0("flutter", __FUNCTION__);
@@ -47,9 +63,8 @@ static sk_sp<SkImage> ResizeRasterImage(sk_sp<SkImage> image,
       image->imageInfo().makeDimensions(resized_dimensions);
 
   SkBitmap scaled_bitmap;
-  if (!scaled_bitmap.tryAllocPixels(scaled_image_info)) {
-    FML_LOG(ERROR) << "Failed to allocate memory for bitmap of size "
-                   << scaled_image_info.computeMinByteSize() << "B";
+  if (!AllocatePixels(scaled_bitmap, scaled_image_info,
+                      allocated_pixel_bytes)) {
     return nullptr;
   }
 
@@ -95,19 +110,113 @@ static sk_sp<SkImage> ImageFromDecompressedData(
   }
 
   return ResizeRasterImage(std::move(image),
-                           SkISize::Make(target_width, target_height), flow);
+                           SkISize::Make(target_width, target_height), flow,
+                           nullptr);
+}
+
+// Decodes the image one stripe of rows at a time and averages each
+// |factor| x |factor| block of decoded pixels into a single pixel. This is
+// used for codecs that cannot decode at a smaller size themselves so that the
+// image never has to be held in memory at its full resolution.
+//
+// Returns nullptr if the image cannot be decoded this way, in which case the
+// caller should fall back to decoding the full image.
+static sk_sp<SkImage> ImageFromCompressedDataByStripes(
+    ImageDescriptor* descriptor,
+    const SkISize& resized_dimensions,
+    const fml::tracing::TraceFlow& flow,
+    size_t* allocated_pixel_bytes) {
+  const SkImageInfo& info = descriptor->image_info();
+  const SkISize source_dimensions = info.dimensions();
+  const int factor =
+      std::min(source_dimensions.width() / resized_dimensions.width(),
+               source_dimensions.height() / resized_dimensions.height());
+  if (factor < 2 || info.colorType() != kN32_SkColorType) {
+    return nullptr;
+  }
+
+  // The descriptor's generator can't be used from multiple threads and does
+  // not support scanline decoding. Decoding with a separate codec also means
+  // that the EXIF orientation has to be applied here, which is only done for
+  // the common case of images that don't need to be reoriented.
+  std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(descriptor->data());
+  if (!codec || codec->getOrigin() != kTopLeft_SkEncodedOrigin ||
+      codec->dimensions() != source_dimensions ||
+      codec->getScanlineOrder() != SkCodec::kTopDown_SkScanlineOrder ||
+      codec->startScanlineDecode(info) != SkCodec::kSuccess) {
+    return nullptr;
+  }
+
+  TRACE_EVENT0("flutter", __FUNCTION__);
+  flow.Step(__FUNCTION__);
+
+  SkBitmap stripe;
+  if (!AllocatePixels(stripe, info.makeWH(source_dimensions.width(), factor),
+                      allocated_pixel_bytes)) {
+    return nullptr;
+  }
+
+  const SkISize downsampled_dimensions = SkISize::Make(
+      (source_dimensions.width() + factor - 1) / factor,
+      (source_dimensions.height() + factor - 1) / factor);
+  SkBitmap downsampled;
+  if (!AllocatePixels(downsampled, info.makeDimensions(downsampled_dimensions),
+                      allocated_pixel_bytes)) {
+    return nullptr;
+  }
+
+  for (int y = 0; y < downsampled_dimensions.height(); ++y) {
+    const int rows = std::min(factor, source_dimensions.height() - y * factor);
+    if (codec->getScanlines(stripe.getAddr(0, 0), rows, stripe.rowBytes()) !=
+        rows) {
+      FML_DLOG(ERROR) << "Could not decode rows of image.";
+      return nullptr;
+    }
+    auto* dst = static_cast<uint8_t*>(downsampled.getAddr(0, y));
+    for (int x = 0; x < downsampled_dimensions.width(); ++x) {
+      const int columns =
+          std::min(factor, source_dimensions.width() - x * factor);
+      uint32_t sums[4] = {0, 0, 0, 0};
+      for (int row = 0; row < rows; ++row) {
+        const auto* src =
+            static_cast<const uint8_t*>(stripe.getAddr(x * factor, row));
+        for (int column = 0; column < columns * 4; ++column) {
+          sums[column % 4] += src[column];
+        }
+      }
+      // Channels are averaged independently, which is correct for any
+      // 8888 color type with premultiplied or opaque alpha.
+      const uint32_t count = rows * columns;
+      for (int channel = 0; channel < 4; ++channel) {
+        dst[x * 4 + channel] = (sums[channel] + count / 2) / count;
+      }
+    }
+  }
+
+  stripe.reset();
+  downsampled.setImmutable();
+  auto downsampled_image = SkImage::MakeFromBitmap(downsampled);
+  if (!downsampled_image) {
+    return nullptr;
+  }
+  return ResizeRasterImage(std::move(downsampled_image), resized_dimensions,
+                           flow, allocated_pixel_bytes);
 }
 
 sk_sp<SkImage> ImageFromCompressedData(ImageDescriptor* descriptor,
                                        uint32_t target_width,
                                        uint32_t target_height,
-                                       const fml::tracing::TraceFlow& flow) {
+                                       const fml::tracing::TraceFlow& flow,
+                                       size_t* allocated_pixel_bytes) {
   TRACE_EVENT0("flutter", __FUNCTION__);
   flow.Step(__FUNCTION__);
 
   if (!descriptor->should_resize(target_width, target_height)) {
     // No resizing requested. Just decode & rasterize the image.
     sk_sp<SkImage> image = descriptor->image();
+    if (image && allocated_pixel_bytes) {
+      *allocated_pixel_bytes += descriptor->image_info().computeMinByteSize();
+    }
     return image ? image->makeRasterImage() : nullptr;
   }
 
@@ -128,9 +237,8 @@ sk_sp<SkImage> ImageFromCompressedData(ImageDescriptor* descriptor,
         descriptor->image_info().makeDimensions(decode_dimensions);
 
     SkBitmap scaled_bitmap;
-    if (!scaled_bitmap.tryAllocPixels(scaled_image_info)) {
-      FML_LOG(ERROR) << "Failed to allocate memory for bitmap of size "
-                     << scaled_image_info.computeMinByteSize() << "B";
+    if (!AllocatePixels(scaled_bitmap, scaled_image_info,
+                        allocated_pixel_bytes)) {
       return nullptr;
     }
 
@@ -148,7 +256,14 @@ sk_sp<SkImage> ImageFromCompressedData(ImageDescriptor* descriptor,
         return nullptr;
       }
       return ResizeRasterImage(std::move(decoded_image), resized_dimensions,
-                               flow);
+                               flow, allocated_pixel_bytes);
+    }
+  } else if (!resized_dimensions.isEmpty()) {
+    // Otherwise, avoid decoding the full image if it is being scaled down by
+    // a large enough factor.
+    if (auto image = ImageFromCompressedDataByStripes(
+            descriptor, resized_dimensions, flow, allocated_pixel_bytes)) {
+      return image;
     }
   }
 
@@ -156,8 +271,12 @@ sk_sp<SkImage> ImageFromCompressedData(ImageDescriptor* descriptor,
   if (!image) {
     return nullptr;
   }
+  if (allocated_pixel_bytes) {
+    *allocated_pixel_bytes += descriptor->image_info().computeMinByteSize();
+  }
 
-  return ResizeRasterImage(std::move(image), resized_dimensions, flow);
+  return ResizeRasterImage(std::move(image), resized_dimensions, flow,
+                           allocated_pixel_bytes);
 }
 
 static SkiaGPUObject<SkImage> UploadRasterImage(
@@ -270,20 +389,36 @@ void ImageDecoder::Decode(fml::RefPtr<ImageDescriptor> descriptor_ref_ptr,
                          result,                                  //
                          target_width = target_width,             //
                          target_height = target_height,           //
+                         cache = decoded_image_cache_,            //
                          flow = std::move(flow)                   //
   ]() mutable {
-        // Step 1: Decompress the image.
+        // Step 1: Decompress the image or find it in the cache.
         // On Worker.
 
-        auto decompressed = raw_descriptor->is_compressed()
-                                ? ImageFromCompressedData(raw_descriptor,  //
-                                                          target_width,    //
-                                                          target_height,   //
-                                                          flow)
-                                : ImageFromDecompressedData(raw_descriptor,  //
-                                                            target_width,    //
-                                                            target_height,   //
-                                                            flow);
+        sk_sp<SkImage> decompressed;
+        if (raw_descriptor->is_compressed()) {
+          std::optional<DecodedImageCache::Key> cache_key;
+          if (cache->GetMaxBytes() > 0) {
+            cache_key = DecodedImageCache::MakeKey(
+                *raw_descriptor->data(), target_width, target_height,
+                raw_descriptor->image_info().colorType());
+            decompressed = cache->Get(*cache_key, raw_descriptor->data());
+          }
+          if (!decompressed) {
+            decompressed = ImageFromCompressedData(raw_descriptor,  //
+                                                   target_width,    //
+                                                   target_height,   //
+                                                   flow);
+            if (decompressed && cache_key) {
+              cache->Put(*cache_key, raw_descriptor->data(), decompressed);
+            }
+          }
+        } else {
+          decompressed = ImageFromDecompressedData(raw_descriptor,  //
+                                                   target_width,    //
+                                                   target_height,   //
+                                                   flow);
+        }
 
         if (!decompressed) {
           FML_DLOG(ERROR) << "Could not decompress image.";
@@ -331,4 +466,9 @@ fml::WeakPtr<ImageDecoder> ImageDecoder::GetWeakPtr() const {
   return weak_factory_.GetWeakPtr();
 }
 
+const std::shared_ptr<DecodedImageCache>& ImageDecoder::GetDecodedImageCache()
+    const {
+  return decoded_image_cache_;
+}
+
 }  // namespace flutter
@@ -15,6 +15,7 @@
 #include "flutter/fml/mapping.h"
 #include "flutter/fml/trace_event.h"
 #include "flutter/lib/ui/io_manager.h"
+#include "flutter/lib/ui/painting/decoded_image_cache.h"
 #include "flutter/lib/ui/painting/image_descriptor.h"
 #include "third_party/skia/include/core/SkData.h"
 #include "third_party/skia/include/core/SkImage.h"
@@ -52,19 +53,30 @@ class ImageDecoder {
 
   fml::WeakPtr<ImageDecoder> GetWeakPtr() const;
 
+  // The cache of images decompressed by this decoder. The cache is disabled
+  // until it is given a byte budget.
+  const std::shared_ptr<DecodedImageCache>& GetDecodedImageCache() const;
+
  private:
   TaskRunners runners_;
   std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner_;
   fml::WeakPtr<IOManager> io_manager_;
+  std::shared_ptr<DecodedImageCache> decoded_image_cache_;
   fml::WeakPtrFactory<ImageDecoder> weak_factory_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(ImageDecoder);
 };
 
-sk_sp<SkImage> ImageFromCompressedData(ImageDescriptor* descriptor,
-                                       uint32_t target_width,
-                                       uint32_t target_height,
-                                       const fml::tracing::TraceFlow& flow);
+// Decodes the compressed image of the descriptor at the target size. If
+// |allocated_pixel_bytes| is not null, the size of all pixel buffers allocated
+// during the decode is added to it. This bounds the memory high-water mark of
+// the decode.
+sk_sp<SkImage> ImageFromCompressedData(
+    ImageDescriptor* descriptor,
+    uint32_t target_width,
+    uint32_t target_height,
+    const fml::tracing::TraceFlow& flow,
+    size_t* allocated_pixel_bytes = nullptr);
 
 }  // namespace flutter
 
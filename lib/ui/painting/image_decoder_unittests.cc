@@ -4,6 +4,8 @@
 
 #include "flutter/lib/ui/painting/image_decoder.h"
 
+#include <array>
+
 #include "flutter/common/task_runners.h"
 #include "flutter/fml/mapping.h"
 #include "flutter/fml/synchronization/waitable_event.h"
@@ -593,6 +595,74 @@ TEST(ImageDecoderTest, VerifySubpixelDecodingPreservesExifOrientation) {
   assert_image(decode(300, 100));
 }
 
+TEST(ImageDecoderTest, VerifyDownscaledDecodingBoundsPixelMemory) {
+  // PNG codecs can't decode at a smaller size, so the full image used to be
+  // decoded before being resized.
+  auto data = OpenFixtureAsSkData("Horizontal.png");
+  auto codec = SkCodec::MakeFromData(data);
+  ASSERT_TRUE(codec);
+  auto descriptor =
+      fml::MakeRefCounted<ImageDescriptor>(data, std::move(codec));
+  ASSERT_EQ(descriptor->image_info().dimensions(), SkISize::Make(300, 100));
+  const size_t full_size_bytes =
+      descriptor->image_info().computeMinByteSize();
+
+  size_t allocated_pixel_bytes = 0;
+  auto image = ImageFromCompressedData(descriptor.get(), 30, 10,
+                                       fml::tracing::TraceFlow(""),
+                                       &allocated_pixel_bytes);
+  ASSERT_TRUE(image);
+  ASSERT_EQ(image->dimensions(), SkISize::Make(30, 10));
+  ASSERT_GT(allocated_pixel_bytes, 0u);
+  // The pixel memory allocated while decoding is an upper bound for the high
+  // water mark of the decode.
+  ASSERT_LT(allocated_pixel_bytes, full_size_bytes / 4);
+
+  // Averaging blocks of pixels preserves the average color of the image.
+  auto average_color = [](const sk_sp<SkImage>& image) {
+    SkBitmap bitmap;
+    EXPECT_TRUE(bitmap.tryAllocPixels(image->imageInfo()));
+    EXPECT_TRUE(image->readPixels(bitmap.pixmap(), 0, 0));
+    double sums[3] = {0, 0, 0};
+    for (int y = 0; y < bitmap.height(); ++y) {
+      for (int x = 0; x < bitmap.width(); ++x) {
+        const SkColor color = bitmap.getColor(x, y);
+        sums[0] += SkColorGetR(color);
+        sums[1] += SkColorGetG(color);
+        sums[2] += SkColorGetB(color);
+      }
+    }
+    const double count = bitmap.width() * bitmap.height();
+    return std::array<double, 3>{sums[0] / count, sums[1] / count,
+                                 sums[2] / count};
+  };
+  auto full_size_image = SkImage::MakeFromEncoded(data);
+  ASSERT_TRUE(full_size_image);
+  const auto expected = average_color(full_size_image);
+  const auto actual = average_color(image);
+  for (size_t channel = 0; channel < 3; ++channel) {
+    ASSERT_NEAR(actual[channel], expected[channel], 1.0);
+  }
+}
+
+TEST(ImageDecoderTest, VerifyUnscaledDecodingAllocatesFullSizeImage) {
+  auto data = OpenFixtureAsSkData("Horizontal.png");
+  auto codec = SkCodec::MakeFromData(data);
+  ASSERT_TRUE(codec);
+  auto descriptor =
+      fml::MakeRefCounted<ImageDescriptor>(data, std::move(codec));
+
+  // Scaling down by less than a factor of two still decodes the full image.
+  size_t allocated_pixel_bytes = 0;
+  auto image = ImageFromCompressedData(descriptor.get(), 200, 80,
+                                       fml::tracing::TraceFlow(""),
+                                       &allocated_pixel_bytes);
+  ASSERT_TRUE(image);
+  ASSERT_EQ(image->dimensions(), SkISize::Make(200, 80));
+  ASSERT_GE(allocated_pixel_bytes,
+            descriptor->image_info().computeMinByteSize());
+}
+
 TEST_F(ImageDecoderFixtureTest,
        MultiFrameCodecCanBeCollectedBeforeIOTasksFinish) {
   // This test verifies that the MultiFrameCodec safely shares state between
@@ -686,5 +756,80 @@ TEST_F(ImageDecoderFixtureTest,
   latch.Wait();
 }
 
+TEST_F(ImageDecoderFixtureTest, MultiFrameCodecPrefetchesFramesInOrder) {
+  auto gif_mapping = OpenFixtureAsSkData("hello_loop_2.gif");
+  ASSERT_TRUE(gif_mapping);
+
+  auto gif_codec = std::shared_ptr<SkCodecImageGenerator>(
+      static_cast<SkCodecImageGenerator*>(
+          SkCodecImageGenerator::MakeFromEncodedCodec(gif_mapping).release()));
+  ASSERT_TRUE(gif_codec);
+  const int frame_count = gif_codec->getFrameCount();
+  ASSERT_GT(frame_count, 1);
+
+  auto io_task_runner = CreateNewThread("io");
+  fml::AutoResetWaitableEvent latch;
+  io_task_runner->PostTask([&]() {
+    TestIOManager io_manager(io_task_runner);
+    MultiFrameCodec::PrefetchStateForTesting state(gif_codec);
+
+    int duration = 0;
+    EXPECT_TRUE(state.GetNextFrame(io_manager.GetResourceContext(),
+                                   io_manager.GetSkiaUnrefQueue(), &duration));
+
+    state.PrefetchFrames(io_manager.GetResourceContext(),
+                         io_manager.GetSkiaUnrefQueue());
+    EXPECT_GT(state.GetPrefetchedFrameCount(), 0u);
+    EXPECT_LE(state.GetPrefetchedFrameCount(),
+              MultiFrameCodec::PrefetchStateForTesting::kMaxPrefetchedFrames);
+
+    // Prefetched frames are returned in playback order, and decoding resumes
+    // after them once they have all been returned.
+    const size_t frames_to_check = state.GetPrefetchedFrameCount() + 1;
+    for (size_t i = 1; i <= frames_to_check; ++i) {
+      SkCodec::FrameInfo frame_info{0};
+      gif_codec->getFrameInfo(i % frame_count, &frame_info);
+      EXPECT_TRUE(state.GetNextFrame(io_manager.GetResourceContext(),
+                                     io_manager.GetSkiaUnrefQueue(),
+                                     &duration));
+      EXPECT_EQ(duration, frame_info.fDuration);
+    }
+    latch.Signal();
+  });
+  latch.Wait();
+}
+
+TEST_F(ImageDecoderFixtureTest, MultiFrameCodecStopsPrefetchingWhenCollected) {
+  auto gif_mapping = OpenFixtureAsSkData("hello_loop_2.gif");
+  ASSERT_TRUE(gif_mapping);
+
+  auto gif_codec = std::shared_ptr<SkCodecImageGenerator>(
+      static_cast<SkCodecImageGenerator*>(
+          SkCodecImageGenerator::MakeFromEncodedCodec(gif_mapping).release()));
+  ASSERT_TRUE(gif_codec);
+
+  auto io_task_runner = CreateNewThread("io");
+  std::unique_ptr<TestIOManager> io_manager;
+  std::weak_ptr<void> weak_state;
+  fml::AutoResetWaitableEvent latch;
+  io_task_runner->PostTask([&]() {
+    io_manager = std::make_unique<TestIOManager>(io_task_runner);
+    MultiFrameCodec::PrefetchStateForTesting state(gif_codec);
+    state.SchedulePrefetch(io_task_runner, io_manager->GetWeakIOManager());
+    EXPECT_TRUE(state.IsPrefetchPending());
+    // Collect the state before the prefetch task runs.
+    weak_state = state.Release();
+    latch.Signal();
+  });
+  latch.Wait();
+
+  io_task_runner->PostTask([&]() {
+    EXPECT_TRUE(weak_state.expired());
+    io_manager.reset();
+    latch.Signal();
+  });
+  latch.Wait();
+}
+
 }  // namespace testing
 }  // namespace flutter
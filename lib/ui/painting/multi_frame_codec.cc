@@ -5,6 +5,7 @@
 #include "flutter/lib/ui/painting/multi_frame_codec.h"
 
 #include "flutter/fml/make_copyable.h"
+#include "flutter/fml/trace_event.h"
 #include "flutter/lib/ui/painting/image.h"
 #include "third_party/dart/runtime/include/dart_api.h"
 #include "third_party/skia/include/core/SkPixelRef.h"
@@ -22,6 +23,9 @@ MultiFrameCodec::State::State(std::shared_ptr<SkCodecImageGenerator> generator)
     : generator_(std::move(generator)),
       frameCount_(generator_->getFrameCount()),
       repetitionCount_(generator_->getRepetitionCount()),
+      frameByteSize_(generator_->getInfo()
+                         .makeColorType(kN32_SkColorType)
+                         .computeMinByteSize()),
       nextFrameIndex_(0) {}
 
 static void InvokeNextFrameCallback(
@@ -132,6 +136,78 @@ sk_sp<SkImage> MultiFrameCodec::State::GetNextFrameImage(
   }
 }
 
+MultiFrameCodec::State::DecodedFrame MultiFrameCodec::State::DecodeNextFrame(
+    fml::WeakPtr<GrDirectContext> resourceContext,
+    fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue) {
+  DecodedFrame frame;
+  sk_sp<SkImage> skImage = GetNextFrameImage(resourceContext);
+  if (skImage) {
+    frame.image = {std::move(skImage), std::move(unref_queue)};
+    SkCodec::FrameInfo skFrameInfo{0};
+    generator_->getFrameInfo(nextFrameIndex_, &skFrameInfo);
+    frame.duration = skFrameInfo.fDuration;
+  }
+  nextFrameIndex_ = (nextFrameIndex_ + 1) % frameCount_;
+  decodedFrameCount_++;
+  return frame;
+}
+
+MultiFrameCodec::State::DecodedFrame MultiFrameCodec::State::GetNextFrame(
+    fml::WeakPtr<GrDirectContext> resourceContext,
+    fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue) {
+  if (prefetchedFrames_.empty()) {
+    return DecodeNextFrame(std::move(resourceContext), std::move(unref_queue));
+  }
+  DecodedFrame frame = std::move(prefetchedFrames_.front());
+  prefetchedFrames_.pop_front();
+  return frame;
+}
+
+bool MultiFrameCodec::State::ShouldPrefetchFrame() const {
+  if (frameCount_ <= 1 || prefetchedFrames_.size() >= kMaxPrefetchedFrames ||
+      (prefetchedFrames_.size() + 1) * frameByteSize_ > kMaxPrefetchedBytes) {
+    return false;
+  }
+  if (repetitionCount_ != SkCodec::kRepetitionCountInfinite &&
+      decodedFrameCount_ >=
+          static_cast<int64_t>(frameCount_) * (repetitionCount_ + 1)) {
+    return false;
+  }
+  return true;
+}
+
+void MultiFrameCodec::State::PrefetchFrame(
+    fml::WeakPtr<GrDirectContext> resourceContext,
+    fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue) {
+  TRACE_EVENT0("flutter", "MultiFrameCodec::PrefetchFrame");
+  prefetchedFrames_.push_back(
+      DecodeNextFrame(std::move(resourceContext), std::move(unref_queue)));
+}
+
+void MultiFrameCodec::State::SchedulePrefetch(
+    std::weak_ptr<State> weak_state,
+    fml::RefPtr<fml::TaskRunner> io_task_runner,
+    fml::WeakPtr<IOManager> io_manager) {
+  auto state = weak_state.lock();
+  if (!state || state->prefetchPending_ || !state->ShouldPrefetchFrame()) {
+    return;
+  }
+  state->prefetchPending_ = true;
+  io_task_runner->PostTask([weak_state, io_task_runner, io_manager]() {
+    auto state = weak_state.lock();
+    if (!state) {
+      return;
+    }
+    state->prefetchPending_ = false;
+    if (!io_manager || !state->ShouldPrefetchFrame()) {
+      return;
+    }
+    state->PrefetchFrame(io_manager->GetResourceContext(),
+                         io_manager->GetSkiaUnrefQueue());
+    SchedulePrefetch(weak_state, io_task_runner, io_manager);
+  });
+}
+
 void MultiFrameCodec::State::GetNextFrameAndInvokeCallback(
     std::unique_ptr<DartPersistentValue> callback,
     fml::RefPtr<fml::TaskRunner> ui_task_runner,
@@ -139,16 +215,13 @@ void MultiFrameCodec::State::GetNextFrameAndInvokeCallback(
     fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue,
     size_t trace_id) {
   fml::RefPtr<CanvasImage> image = nullptr;
-  int duration = 0;
-  sk_sp<SkImage> skImage = GetNextFrameImage(resourceContext);
-  if (skImage) {
+  DecodedFrame frame =
+      GetNextFrame(std::move(resourceContext), std::move(unref_queue));
+  const int duration = frame.duration;
+  if (frame.image.get()) {
     image = CanvasImage::Create();
-    image->set_image({skImage, std::move(unref_queue)});
-    SkCodec::FrameInfo skFrameInfo{0};
-    generator_->getFrameInfo(nextFrameIndex_, &skFrameInfo);
-    duration = skFrameInfo.fDuration;
+    image->set_image(std::move(frame.image));
   }
-  nextFrameIndex_ = (nextFrameIndex_ + 1) % frameCount_;
 
   ui_task_runner->PostTask(fml::MakeCopyable([callback = std::move(callback),
                                               image = std::move(image),
@@ -175,6 +248,7 @@ Dart_Handle MultiFrameCodec::getNextFrame(Dart_Handle callback_handle) {
            tonic::DartState::Current(), callback_handle),
        weak_state = std::weak_ptr<MultiFrameCodec::State>(state_), trace_id,
        ui_task_runner = task_runners.GetUITaskRunner(),
+       io_task_runner = task_runners.GetIOTaskRunner(),
        io_manager = dart_state->GetIOManager()]() mutable {
         auto state = weak_state.lock();
         if (!state) {
@@ -186,11 +260,57 @@ Dart_Handle MultiFrameCodec::getNextFrame(Dart_Handle callback_handle) {
             std::move(callback), std::move(ui_task_runner),
             io_manager->GetResourceContext(), io_manager->GetSkiaUnrefQueue(),
             trace_id);
+        State::SchedulePrefetch(std::move(weak_state),
+                                std::move(io_task_runner), io_manager);
       }));
 
   return Dart_Null();
 }
 
+MultiFrameCodec::PrefetchStateForTesting::PrefetchStateForTesting(
+    std::shared_ptr<SkCodecImageGenerator> generator)
+    : state_(std::make_shared<State>(std::move(generator))) {}
+
+sk_sp<SkImage> MultiFrameCodec::PrefetchStateForTesting::GetNextFrame(
+    fml::WeakPtr<GrDirectContext> resourceContext,
+    fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue,
+    int* duration) {
+  State::DecodedFrame frame =
+      state_->GetNextFrame(std::move(resourceContext), std::move(unref_queue));
+  *duration = frame.duration;
+  return frame.image.get();
+}
+
+void MultiFrameCodec::PrefetchStateForTesting::PrefetchFrames(
+    fml::WeakPtr<GrDirectContext> resourceContext,
+    fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue) {
+  while (state_->ShouldPrefetchFrame()) {
+    state_->PrefetchFrame(resourceContext, unref_queue);
+  }
+}
+
+void MultiFrameCodec::PrefetchStateForTesting::SchedulePrefetch(
+    fml::RefPtr<fml::TaskRunner> io_task_runner,
+    fml::WeakPtr<IOManager> io_manager) {
+  State::SchedulePrefetch(state_, std::move(io_task_runner),
+                          std::move(io_manager));
+}
+
+size_t MultiFrameCodec::PrefetchStateForTesting::GetPrefetchedFrameCount()
+    const {
+  return state_->prefetchedFrames_.size();
+}
+
+bool MultiFrameCodec::PrefetchStateForTesting::IsPrefetchPending() const {
+  return state_->prefetchPending_;
+}
+
+std::weak_ptr<void> MultiFrameCodec::PrefetchStateForTesting::Release() {
+  std::weak_ptr<void> weak_state = state_;
+  state_.reset();
+  return weak_state;
+}
+
 int MultiFrameCodec::frameCount() const {
   return state_->frameCount_;
 }
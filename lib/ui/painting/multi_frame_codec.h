@@ -5,7 +5,11 @@
 #ifndef FLUTTER_LIB_UI_PAINTING_MUTLI_FRAME_CODEC_H_
 #define FLUTTER_LIB_UI_PAINTING_MUTLI_FRAME_CODEC_H_
 
+#include <deque>
+
+#include "flutter/flow/skia_gpu_object.h"
 #include "flutter/fml/macros.h"
+#include "flutter/lib/ui/io_manager.h"
 #include "flutter/lib/ui/painting/codec.h"
 #include "third_party/skia/src/codec/SkCodecImageGenerator.h"
 
@@ -37,11 +41,25 @@ class MultiFrameCodec : public Codec {
   // shares it with the IO task runner's decoding work, and sets the live_
   // member to false when it is destructed.
   struct State {
+    // A decoded frame and how long it should be displayed for.
+    struct DecodedFrame {
+      SkiaGPUObject<SkImage> image;
+      int duration = 0;
+    };
+
+    // Frames are decoded ahead of the requests for them so that the time it
+    // takes to decode a frame doesn't delay the frame that displays it. The
+    // number of frames decoded ahead is limited by both a count and the
+    // memory used by the decoded frames.
+    static constexpr size_t kMaxPrefetchedFrames = 3;
+    static constexpr size_t kMaxPrefetchedBytes = 32 * 1024 * 1024;
+
     State(std::shared_ptr<SkCodecImageGenerator> generator);
 
     const std::shared_ptr<SkCodecImageGenerator> generator_;
     const int frameCount_;
     const int repetitionCount_;
+    const size_t frameByteSize_;
 
     // The non-const members and functions below here are only read or written
     // to on the IO thread. They are not safe to access or write on the UI
@@ -53,9 +71,45 @@ class MultiFrameCodec : public Codec {
     // The index of the last decoded required frame.
     int lastRequiredFrameIndex_ = -1;
 
+    // Frames that were decoded ahead of being requested, in playback order.
+    // Frames are always decoded in order, so the frames they depend on are
+    // decoded before them whether or not they are prefetched.
+    std::deque<DecodedFrame> prefetchedFrames_;
+
+    // The number of frames decoded so far, including prefetched frames.
+    int64_t decodedFrameCount_ = 0;
+
+    // Whether a task to prefetch a frame is pending on the IO task runner.
+    bool prefetchPending_ = false;
+
     sk_sp<SkImage> GetNextFrameImage(
         fml::WeakPtr<GrDirectContext> resourceContext);
 
+    // Decodes the frame at |nextFrameIndex_| and advances to the next frame.
+    DecodedFrame DecodeNextFrame(
+        fml::WeakPtr<GrDirectContext> resourceContext,
+        fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue);
+
+    // Returns the oldest prefetched frame, or decodes the next frame if none
+    // have been prefetched.
+    DecodedFrame GetNextFrame(fml::WeakPtr<GrDirectContext> resourceContext,
+                              fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue);
+
+    // Whether another frame may be decoded ahead without exceeding the
+    // prefetch limits or decoding past the last repetition of the animation.
+    bool ShouldPrefetchFrame() const;
+
+    void PrefetchFrame(fml::WeakPtr<GrDirectContext> resourceContext,
+                       fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue);
+
+    // Prefetches frames one task at a time on the IO task runner until the
+    // prefetch limits are reached, so that requests for frames are not
+    // blocked behind prefetching. Prefetching stops when the codec is
+    // collected or when no more frames are requested.
+    static void SchedulePrefetch(std::weak_ptr<State> weak_state,
+                                 fml::RefPtr<fml::TaskRunner> io_task_runner,
+                                 fml::WeakPtr<IOManager> io_manager);
+
     void GetNextFrameAndInvokeCallback(
         std::unique_ptr<DartPersistentValue> callback,
         fml::RefPtr<fml::TaskRunner> ui_task_runner,
@@ -69,6 +123,45 @@ class MultiFrameCodec : public Codec {
 
   FML_FRIEND_MAKE_REF_COUNTED(MultiFrameCodec);
   FML_FRIEND_REF_COUNTED_THREAD_SAFE(MultiFrameCodec);
+
+ public:
+  // Lets tests decode and prefetch the frames of an animated image the way a
+  // MultiFrameCodec does, without a Dart callback. Like the decoding work of
+  // the codec, it must only be used on the IO task runner.
+  class PrefetchStateForTesting {
+   public:
+    static constexpr size_t kMaxPrefetchedFrames = State::kMaxPrefetchedFrames;
+
+    explicit PrefetchStateForTesting(
+        std::shared_ptr<SkCodecImageGenerator> generator);
+
+    // Returns the oldest prefetched frame, or decodes the next frame if none
+    // have been prefetched, along with its duration.
+    sk_sp<SkImage> GetNextFrame(
+        fml::WeakPtr<GrDirectContext> resourceContext,
+        fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue,
+        int* duration);
+
+    // Prefetches frames until the prefetch limits are reached.
+    void PrefetchFrames(fml::WeakPtr<GrDirectContext> resourceContext,
+                        fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue);
+
+    void SchedulePrefetch(fml::RefPtr<fml::TaskRunner> io_task_runner,
+                          fml::WeakPtr<IOManager> io_manager);
+
+    size_t GetPrefetchedFrameCount() const;
+
+    bool IsPrefetchPending() const;
+
+    // Drops the state, as collecting the codec does, and returns a weak
+    // reference to it.
+    std::weak_ptr<void> Release();
+
+   private:
+    std::shared_ptr<State> state_;
+
+    FML_DISALLOW_COPY_AND_ASSIGN(PrefetchStateForTesting);
+  };
 };
 
 }  // namespace flutter
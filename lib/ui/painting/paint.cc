@@ -33,7 +33,6 @@ constexpr int kMaskFilterBlurStyleIndex = 10;
 constexpr int kMaskFilterSigmaIndex = 11;
 constexpr int kInvertColorIndex = 12;
 constexpr int kDitherIndex = 13;
-constexpr size_t kDataByteCount = 56;  // 4 * (last index + 1)
 
 // Indices for objects.
 constexpr int kShaderIndex = 0;
@@ -75,7 +74,6 @@ Paint::Paint(Dart_Handle paint_objects, Dart_Handle paint_data) {
   FML_CHECK(byte_data.length_in_bytes() == kDataByteCount);
 
   const uint32_t* uint_data = static_cast<const uint32_t*>(byte_data.data());
-  const float* float_data = static_cast<const float*>(byte_data.data());
 
   Dart_Handle values[kObjectCount];
   if (!Dart_IsNull(paint_objects)) {
@@ -112,6 +110,17 @@ Paint::Paint(Dart_Handle paint_objects, Dart_Handle paint_data) {
     }
   }
 
+  DecodeData(uint_data);
+}
+
+Paint::Paint(const void* data) : is_null_(false) {
+  DecodeData(data);
+}
+
+void Paint::DecodeData(const void* data) {
+  const uint32_t* uint_data = static_cast<const uint32_t*>(data);
+  const float* float_data = static_cast<const float*>(data);
+
   paint_.setAntiAlias(uint_data[kIsAntiAliasIndex] == 0);
 
   uint32_t encoded_color = uint_data[kColorIndex];
@@ -12,14 +12,23 @@ namespace flutter {
 
 class Paint {
  public:
+  // The size of the data that painting.dart encodes a Paint into.
+  static constexpr size_t kDataByteCount = 56;  // 4 * (last index + 1)
+
   Paint() = default;
   Paint(Dart_Handle paint_objects, Dart_Handle paint_data);
 
+  // Decodes a Paint that has no shader, color filter or image filter from the
+  // |kDataByteCount| bytes of its encoded data.
+  explicit Paint(const void* data);
+
   const SkPaint* paint() const { return is_null_ ? nullptr : &paint_; }
 
  private:
   friend struct tonic::DartConverter<Paint>;
 
+  void DecodeData(const void* data);
+
   SkPaint paint_;
   bool is_null_ = true;
 };
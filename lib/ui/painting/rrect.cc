@@ -10,6 +10,23 @@
 
 using flutter::RRect;
 
+namespace flutter {
+
+RRect RRect::FromValues(const float* values) {
+  SkVector radii[4] = {{values[4], values[5]},
+                       {values[6], values[7]},
+                       {values[8], values[9]},
+                       {values[10], values[11]}};
+
+  RRect result;
+  result.sk_rrect.setRectRadii(
+      SkRect::MakeLTRB(values[0], values[1], values[2], values[3]), radii);
+  result.is_null = false;
+  return result;
+}
+
+}  // namespace flutter
+
 namespace tonic {
 
 // Construct an SkRRect from a Dart RRect object.
@@ -18,22 +35,13 @@ namespace tonic {
 RRect DartConverter<flutter::RRect>::FromDart(Dart_Handle value) {
   Float32List buffer(value);
 
-  RRect result;
-  result.is_null = true;
   if (buffer.data() == nullptr) {
+    RRect result;
+    result.is_null = true;
     return result;
   }
 
-  SkVector radii[4] = {{buffer[4], buffer[5]},
-                       {buffer[6], buffer[7]},
-                       {buffer[8], buffer[9]},
-                       {buffer[10], buffer[11]}};
-
-  result.sk_rrect.setRectRadii(
-      SkRect::MakeLTRB(buffer[0], buffer[1], buffer[2], buffer[3]), radii);
-
-  result.is_null = false;
-  return result;
+  return RRect::FromValues(buffer.data());
 }
 
 RRect DartConverter<flutter::RRect>::FromArguments(Dart_NativeArguments args,
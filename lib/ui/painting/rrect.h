@@ -13,6 +13,10 @@ namespace flutter {
 
 class RRect {
  public:
+  // Constructs an RRect from the 12 values that painting.dart encodes an
+  // RRect into: left, top, right, bottom and the radii of the 4 corners.
+  static RRect FromValues(const float* values);
+
   SkRRect sk_rrect;
   bool is_null;
 };
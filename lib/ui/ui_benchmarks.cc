@@ -112,9 +112,46 @@ static void BM_PathVolatilityTracker(benchmark::State& state) {
   }
 }
 
+// Records a picture with 5000 small operations in Dart. If |state.range(0)| is
+// not zero, the Canvas records them into its command buffer rather than making
+// a native call for each.
+static void BM_CanvasRecordSmallOperations(benchmark::State& state) {
+  ThreadHost thread_host("test",
+                         ThreadHost::Type::Platform | ThreadHost::Type::RASTER |
+                             ThreadHost::Type::IO | ThreadHost::Type::UI);
+  TaskRunners task_runners("test", thread_host.platform_thread->GetTaskRunner(),
+                           thread_host.raster_thread->GetTaskRunner(),
+                           thread_host.ui_thread->GetTaskRunner(),
+                           thread_host.io_thread->GetTaskRunner());
+  Fixture fixture;
+  auto settings = fixture.CreateSettingsForFixture();
+  settings.enable_canvas_command_buffer = state.range(0) != 0;
+  auto vm_ref = DartVMRef::Create(settings);
+  auto isolate =
+      testing::RunDartCodeInIsolate(vm_ref, settings, task_runners, "main", {},
+                                    testing::GetDefaultKernelFilePath(), {});
+
+  while (state.KeepRunning()) {
+    bool successful = isolate->RunInIsolateScope([]() -> bool {
+      Dart_Handle result = Dart_Invoke(
+          Dart_RootLibrary(),
+          Dart_NewStringFromCString("recordSmallOperations"), 0, nullptr);
+      return !Dart_IsError(result);
+    });
+    FML_CHECK(successful);
+  }
+  state.SetItemsProcessed(state.iterations() * 5000);
+}
+
 BENCHMARK(BM_PlatformMessageResponseDartComplete)
     ->Unit(benchmark::kMicrosecond);
 
 BENCHMARK(BM_PathVolatilityTracker)->Unit(benchmark::kMillisecond);
 
+BENCHMARK(BM_CanvasRecordSmallOperations)
+    ->ArgName("command_buffer")
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMicrosecond);
+
 }  // namespace flutter
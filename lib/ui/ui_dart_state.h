@@ -90,6 +90,8 @@ class UIDartState : public tonic::DartState {
 
   bool enable_skparagraph() const;
 
+  bool enable_canvas_command_buffer() const;
+
   template <class T>
   static flutter::SkiaGPUObject<T> CreateGPUObject(sk_sp<T> object) {
     if (!object) {
@@ -119,7 +121,8 @@ class UIDartState : public tonic::DartState {
               std::shared_ptr<IsolateNameServer> isolate_name_server,
               bool is_root_isolate_,
               std::shared_ptr<VolatilePathTracker> volatile_path_tracker,
-              bool enable_skparagraph);
+              bool enable_skparagraph,
+              bool enable_canvas_command_buffer);
 
   ~UIDartState() override;
 
@@ -155,6 +158,7 @@ class UIDartState : public tonic::DartState {
   LogMessageCallback log_message_callback_;
   const std::shared_ptr<IsolateNameServer> isolate_name_server_;
   const bool enable_skparagraph_;
+  const bool enable_canvas_command_buffer_;
 
   void AddOrRemoveTaskObserver(bool add);
 };
@@ -4,6 +4,7 @@
 
 #include "flutter/lib/ui/window/platform_configuration.h"
 
+#include <cstdlib>
 #include <cstring>
 
 #include "flutter/lib/ui/compositing/scene.h"
@@ -194,6 +195,29 @@ Dart_Handle ToByteData(const fml::Mapping& buffer) {
   return tonic::DartByteData::Create(buffer.GetMapping(), buffer.GetSize());
 }
 
+// Payloads at least this large are handed to Dart as external typed data.
+const size_t kExternalMessageDataThreshold = 1000;
+
+void FreeMessageData(void* isolate_callback_data, void* peer) {
+  free(peer);
+}
+
+// Unlike ToByteData, this takes ownership of the buffer and gives it to Dart
+// without copying it if it is too large to be allocated in the Dart heap.
+Dart_Handle MessageDataToByteData(fml::MallocMapping data) {
+  if (data.GetSize() < kExternalMessageDataThreshold) {
+    return ToByteData(data);
+  }
+  const size_t size = data.GetSize();
+  uint8_t* bytes = data.Release();
+  Dart_Handle handle = Dart_NewExternalTypedDataWithFinalizer(
+      Dart_TypedData_kByteData, bytes, size, bytes, size, FreeMessageData);
+  if (Dart_IsError(handle)) {
+    free(bytes);
+  }
+  return handle;
+}
+
 }  // namespace
 
 PlatformConfigurationClient::~PlatformConfigurationClient() {}
@@ -316,7 +340,8 @@ void PlatformConfiguration::DispatchPlatformMessage(
   }
   tonic::DartState::Scope scope(dart_state);
   Dart_Handle data_handle =
-      (message->hasData()) ? ToByteData(message->data()) : Dart_Null();
+      (message->hasData()) ? MessageDataToByteData(message->releaseData())
+                           : Dart_Null();
   if (Dart_IsError(data_handle)) {
     FML_DLOG(WARNING)
         << "Dropping platform message because of a Dart error on channel: "
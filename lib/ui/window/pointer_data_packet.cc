@@ -20,4 +20,10 @@ void PointerDataPacket::SetPointerData(size_t i, const PointerData& data) {
   memcpy(&data_[i * sizeof(PointerData)], &data, sizeof(PointerData));
 }
 
+PointerData PointerDataPacket::GetPointerData(size_t i) const {
+  PointerData result;
+  memcpy(&result, &data_[i * sizeof(PointerData)], sizeof(PointerData));
+  return result;
+}
+
 }  // namespace flutter
@@ -41,6 +41,66 @@ std::unique_ptr<PointerDataPacket> PointerDataPacketConverter::Convert(
   return converted_packet;
 }
 
+// static
+std::vector<PointerData> PointerDataPacketConverter::CoalesceMoves(
+    const std::vector<PointerData>& pointer_data,
+    std::vector<int64_t>* earliest_time_stamps) {
+  std::vector<PointerData> coalesced;
+  coalesced.reserve(pointer_data.size());
+  // Whether the event at the same index in |coalesced| was merged into a
+  // later event.
+  std::vector<bool> merged;
+  merged.reserve(pointer_data.size());
+  // The earliest time stamp of the events merged into the event at the same
+  // index in |coalesced|.
+  std::vector<int64_t> earliest;
+  earliest.reserve(pointer_data.size());
+  // The index in |coalesced| of the move or hover that a later event of the
+  // same device can still be merged into.
+  std::map<int64_t, size_t> mergeable;
+  for (const PointerData& data : pointer_data) {
+    bool is_move = data.signal_kind == PointerData::SignalKind::kNone &&
+                   (data.change == PointerData::Change::kMove ||
+                    data.change == PointerData::Change::kHover);
+    auto iter = mergeable.find(data.device);
+    coalesced.push_back(data);
+    merged.push_back(false);
+    earliest.push_back(data.time_stamp);
+    if (is_move && iter != mergeable.end()) {
+      const PointerData& previous = coalesced[iter->second];
+      if (previous.change == data.change && previous.buttons == data.buttons) {
+        // The merged event takes the place of the latest event, so that the
+        // events stay in the order of their time stamps.
+        coalesced.back().physical_delta_x += previous.physical_delta_x;
+        coalesced.back().physical_delta_y += previous.physical_delta_y;
+        merged[iter->second] = true;
+        // Events that are not stamped have a time stamp of 0.
+        if (earliest[iter->second] > 0) {
+          earliest.back() = earliest[iter->second];
+        }
+      }
+    }
+    if (is_move) {
+      mergeable[data.device] = coalesced.size() - 1;
+    } else if (iter != mergeable.end()) {
+      mergeable.erase(iter);
+    }
+  }
+  size_t kept = 0;
+  for (size_t i = 0; i < coalesced.size(); ++i) {
+    if (!merged[i]) {
+      earliest[kept] = earliest[i];
+      coalesced[kept++] = coalesced[i];
+    }
+  }
+  coalesced.resize(kept);
+  if (earliest_time_stamps) {
+    earliest.resize(kept);
+    *earliest_time_stamps = std::move(earliest);
+  }
+  return coalesced;
+}
+
 void PointerDataPacketConverter::ConvertPointerData(
     PointerData pointer_data,
     std::vector<PointerData>& converted_pointers) {
@@ -91,6 +91,32 @@ class PointerDataPacketConverter {
   std::unique_ptr<PointerDataPacket> Convert(
       std::unique_ptr<PointerDataPacket> packet);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Merges consecutive move or hover events of the same pointer
+  ///             in already converted pointer data. The merged event keeps
+  ///             the latest event's position, time stamp and other fields,
+  ///             and the sum of the merged events' deltas.
+  ///
+  ///             Only events with the same change and buttons are merged, and
+  ///             any other event of a pointer ends its run of mergeable
+  ///             events, so the sequence of transitions seen per pointer is
+  ///             unchanged. A merged event takes the place of the last
+  ///             event of its run, so events of other pointers are not
+  ///             reordered and time stamps stay in order.
+  ///
+  /// @param[in]  pointer_data             The converted pointer data, in
+  ///                                      dispatch order.
+  /// @param[out] earliest_time_stamps     If not null, receives the earliest
+  ///                                      time stamp of the events merged
+  ///                                      into each returned event, so that
+  ///                                      their latency can be measured.
+  ///
+  /// @return     The pointer data with the moves and hovers merged.
+  ///
+  static std::vector<PointerData> CoalesceMoves(
+      const std::vector<PointerData>& pointer_data,
+      std::vector<int64_t>* earliest_time_stamps = nullptr);
+
  private:
   std::map<int64_t, PointerState> states_;
 
@@ -599,5 +599,86 @@ TEST(PointerDataPacketConverterTest, CanConvetScroll) {
   ASSERT_EQ(result[6].scroll_delta_y, 0.0);
 }
 
+TEST(PointerDataPacketConverterTest, CanCoalesceMoves) {
+  PointerDataPacketConverter converter;
+  auto packet = std::make_unique<PointerDataPacket>(9);
+  PointerData data;
+  CreateSimulatedPointerData(data, PointerData::Change::kDown, 0, 0.0, 0.0, 1);
+  data.time_stamp = 0;
+  packet->SetPointerData(0, data);
+  CreateSimulatedPointerData(data, PointerData::Change::kMove, 0, 1.0, 0.0, 1);
+  data.time_stamp = 1;
+  packet->SetPointerData(1, data);
+  CreateSimulatedPointerData(data, PointerData::Change::kDown, 1, 5.0, 5.0, 1);
+  data.time_stamp = 2;
+  packet->SetPointerData(2, data);
+  CreateSimulatedPointerData(data, PointerData::Change::kMove, 0, 3.0, 2.0, 1);
+  data.time_stamp = 3;
+  packet->SetPointerData(3, data);
+  CreateSimulatedPointerData(data, PointerData::Change::kMove, 1, 6.0, 5.0, 1);
+  data.time_stamp = 4;
+  packet->SetPointerData(4, data);
+  CreateSimulatedPointerData(data, PointerData::Change::kMove, 0, 6.0, 6.0, 1);
+  data.time_stamp = 5;
+  packet->SetPointerData(5, data);
+  CreateSimulatedPointerData(data, PointerData::Change::kUp, 0, 6.0, 6.0, 0);
+  data.time_stamp = 6;
+  packet->SetPointerData(6, data);
+  CreateSimulatedPointerData(data, PointerData::Change::kMove, 1, 8.0, 5.0, 1);
+  data.time_stamp = 7;
+  packet->SetPointerData(7, data);
+  CreateSimulatedPointerData(data, PointerData::Change::kMove, 1, 9.0, 7.0, 1);
+  data.time_stamp = 8;
+  packet->SetPointerData(8, data);
+  auto converted_packet = converter.Convert(std::move(packet));
+
+  std::vector<PointerData> converted;
+  UnpackPointerPacket(converted, std::move(converted_packet));
+  ASSERT_EQ(converted.size(), (size_t)11);
+
+  std::vector<int64_t> earliest_time_stamps;
+  std::vector<PointerData> result = PointerDataPacketConverter::CoalesceMoves(
+      converted, &earliest_time_stamps);
+
+  ASSERT_EQ(result.size(), (size_t)7);
+  ASSERT_EQ(earliest_time_stamps.size(), (size_t)7);
+  ASSERT_EQ(result[0].change, PointerData::Change::kAdd);
+  ASSERT_EQ(result[1].change, PointerData::Change::kDown);
+  ASSERT_EQ(result[1].device, 0);
+  ASSERT_EQ(result[2].change, PointerData::Change::kAdd);
+  ASSERT_EQ(result[3].change, PointerData::Change::kDown);
+  ASSERT_EQ(result[3].device, 1);
+
+  // The three moves of device 0 are merged into the last one, after the
+  // events of device 1 that came before it.
+  ASSERT_EQ(result[4].change, PointerData::Change::kMove);
+  ASSERT_EQ(result[4].device, 0);
+  ASSERT_EQ(result[4].physical_x, 6.0);
+  ASSERT_EQ(result[4].physical_y, 6.0);
+  ASSERT_EQ(result[4].physical_delta_x, 6.0);
+  ASSERT_EQ(result[4].physical_delta_y, 6.0);
+  ASSERT_EQ(result[4].time_stamp, 5);
+  ASSERT_EQ(earliest_time_stamps[4], 1);
+
+  ASSERT_EQ(result[5].change, PointerData::Change::kUp);
+  ASSERT_EQ(result[5].device, 0);
+  ASSERT_EQ(earliest_time_stamps[5], 6);
+
+  // The up of device 0 doesn't end the run of moves of device 1.
+  ASSERT_EQ(result[6].change, PointerData::Change::kMove);
+  ASSERT_EQ(result[6].device, 1);
+  ASSERT_EQ(result[6].physical_x, 9.0);
+  ASSERT_EQ(result[6].physical_y, 7.0);
+  ASSERT_EQ(result[6].physical_delta_x, 4.0);
+  ASSERT_EQ(result[6].physical_delta_y, 2.0);
+  ASSERT_EQ(result[6].time_stamp, 8);
+  ASSERT_EQ(earliest_time_stamps[6], 4);
+
+  // The time stamps stay in order.
+  for (size_t i = 1; i < result.size(); i++) {
+    ASSERT_LE(result[i - 1].time_stamp, result[i].time_stamp);
+  }
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -352,7 +352,8 @@ DartIsolate::DartIsolate(
                   DartVMRef::GetIsolateNameServer(),
                   is_root_isolate,
                   std::move(volatile_path_tracker),
-                  settings.enable_skparagraph),
+                  settings.enable_skparagraph,
+                  settings.enable_canvas_command_buffer),
       may_insecurely_connect_to_all_domains_(
           settings.may_insecurely_connect_to_all_domains),
       domain_network_policy_(settings.domain_network_policy) {
@@ -5,6 +5,7 @@
 #include "flutter/shell/common/animator.h"
 
 #include "flutter/flow/frame_timings.h"
+#include "flutter/fml/message_loop_task_queues.h"
 #include "flutter/fml/time/time_point.h"
 #include "flutter/fml/trace_event.h"
 #include "third_party/dart/runtime/include/dart_tools_api.h"
@@ -82,6 +83,13 @@ void Animator::EnqueueTraceFlowId(uint64_t trace_flow_id) {
       });
 }
 
+void Animator::EnqueueInputEventTimes(
+    const std::vector<fml::TimePoint>& event_times) {
+  FML_DCHECK(task_runners_.GetUITaskRunner()->RunsTasksOnCurrentThread());
+  input_event_times_.insert(input_event_times_.end(), event_times.begin(),
+                            event_times.end());
+}
+
 // This Parity is used by the timeline component to correctly align
 // GPU Workloads events with their respective Framework Workload.
 const char* Animator::FrameParity() {
@@ -113,6 +121,10 @@ void Animator::BeginFrame(
     TRACE_FLOW_END("flutter", "PointerEvent", trace_flow_id);
     trace_flow_ids_.pop_front();
   }
+  if (!input_event_times_.empty()) {
+    frame_timings_recorder_->RecordInputEvents(input_event_times_);
+    input_event_times_.clear();
+  }
 
   frame_scheduled_ = false;
   notify_idle_task_id_++;
@@ -158,7 +170,7 @@ void Animator::BeginFrame(
     // viewport event).  Because of this, we hold off on calling
     // |OnAnimatorNotifyIdle| for a little bit, as that could cause garbage
     // collection to trigger at a highly undesirable time.
-    task_runners_.GetUITaskRunner()->PostDelayedTask(
+    fml::closure notify_idle_task =
         [self = weak_factory_.GetWeakPtr(),
          notify_idle_task_id = notify_idle_task_id_]() {
           if (!self) {
@@ -174,8 +186,17 @@ void Animator::BeginFrame(
             self->delegate_.OnAnimatorNotifyIdle(Dart_TimelineGetMicros() +
                                                  100000);
           }
-        },
-        kNotifyIdleTaskWaitTime);
+        };
+#ifdef OS_FUCHSIA
+    task_runners_.GetUITaskRunner()->PostDelayedTask(notify_idle_task,
+                                                     kNotifyIdleTaskWaitTime);
+#else
+    // The notification can wait for the other tasks that are due.
+    fml::MessageLoopTaskQueues::GetInstance()->RegisterTask(
+        task_runners_.GetUITaskRunner()->GetTaskQueueId(), notify_idle_task,
+        fml::TimePoint::Now() + kNotifyIdleTaskWaitTime,
+        fml::TaskSourceGrade::kIdle);
+#endif
   }
 }
 
@@ -298,6 +319,9 @@ void Animator::ScheduleMaybeClearTraceFlowIds() {
             self->trace_flow_ids_.pop_front();
           }
         }
+        if (!self->frame_scheduled_) {
+          self->input_event_times_.clear();
+        }
       });
 }
 
@@ -6,6 +6,7 @@
 #define FLUTTER_SHELL_COMMON_ANIMATOR_H_
 
 #include <deque>
+#include <vector>
 
 #include "flutter/common/task_runners.h"
 #include "flutter/flow/frame_timings.h"
@@ -82,6 +83,12 @@ class Animator final {
   // active rendering.
   void EnqueueTraceFlowId(uint64_t trace_flow_id);
 
+  // Records the time stamps of dispatched pointer events, so that the input
+  // latency of the next frame can be reported in its |FrameTiming|. Events
+  // that are dispatched while no frame is scheduled are dropped at the next
+  // vsync, like the trace flows of |EnqueueTraceFlowId|.
+  void EnqueueInputEventTimes(const std::vector<fml::TimePoint>& event_times);
+
  private:
   using LayerTreePipeline = Pipeline<flutter::LayerTree>;
 
@@ -96,7 +103,8 @@ class Animator final {
 
   const char* FrameParity();
 
-  // Clear |trace_flow_ids_| if |frame_scheduled_| is false.
+  // Clear |trace_flow_ids_| and |input_event_times_| if |frame_scheduled_| is
+  // false.
   void ScheduleMaybeClearTraceFlowIds();
 
   Delegate& delegate_;
@@ -115,6 +123,7 @@ class Animator final {
   bool dimension_change_pending_;
   SkISize last_layer_tree_size_ = {0, 0};
   std::deque<uint64_t> trace_flow_ids_;
+  std::vector<fml::TimePoint> input_event_times_;
 
   fml::WeakPtrFactory<Animator> weak_factory_;
 
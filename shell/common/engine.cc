@@ -10,6 +10,7 @@
 #include <utility>
 #include <vector>
 
+#include "flutter/common/graphics/persistent_cache.h"
 #include "flutter/common/settings.h"
 #include "flutter/fml/eintr_wrapper.h"
 #include "flutter/fml/file.h"
@@ -63,6 +64,8 @@ Engine::Engine(
       task_runners_(std::move(task_runners)),
       weak_factory_(this) {
   pointer_data_dispatcher_ = dispatcher_maker(*this);
+  image_decoder_.GetDecodedImageCache()->SetMaxBytes(
+      settings_.decoded_image_cache_max_bytes);
 }
 
 Engine::Engine(Delegate& delegate,
@@ -194,6 +197,11 @@ Engine::RunStatus Engine::Run(RunConfiguration configuration) {
   last_entry_point_ = configuration.GetEntrypoint();
   last_entry_point_library_ = configuration.GetEntrypointLibrary();
 
+  if (settings_.asset_access_trace_frame_count > 0 &&
+      !asset_access_trace_started_) {
+    StartAssetAccessTrace(configuration.GetAssetManager());
+  }
+
   UpdateAssetManager(configuration.GetAssetManager());
 
   if (runtime_controller_->IsRootIsolateRunning()) {
@@ -223,6 +231,33 @@ Engine::RunStatus Engine::Run(RunConfiguration configuration) {
 void Engine::BeginFrame(fml::TimePoint frame_time) {
   TRACE_EVENT0("flutter", "Engine::BeginFrame");
   runtime_controller_->BeginFrame(frame_time);
+  if (asset_access_trace_frames_left_ > 0 &&
+      --asset_access_trace_frames_left_ == 0) {
+    FinishAssetAccessTrace();
+  }
+}
+
+void Engine::StartAssetAccessTrace(
+    std::shared_ptr<AssetManager> asset_manager) {
+  asset_access_trace_started_ = true;
+  if (!asset_manager) {
+    return;
+  }
+  // Prefetch what the previous launch used while fonts are registered and the
+  // isolate starts, and record what this launch uses for the next one.
+  auto persistent_cache = PersistentCache::GetCacheForProcess();
+  asset_manager->PrefetchAssets(persistent_cache->LoadAssetAccessTrace(),
+                                task_runners_.GetIOTaskRunner());
+  asset_manager->StartRecordingAccesses();
+  traced_asset_manager_ = std::move(asset_manager);
+  asset_access_trace_frames_left_ = settings_.asset_access_trace_frame_count;
+}
+
+void Engine::FinishAssetAccessTrace() {
+  TRACE_EVENT0("flutter", "Engine::FinishAssetAccessTrace");
+  PersistentCache::GetCacheForProcess()->StoreAssetAccessTrace(
+      traced_asset_manager_->StopRecordingAccesses());
+  traced_asset_manager_.reset();
 }
 
 void Engine::ReportTimings(std::vector<int64_t> timings) {
@@ -234,6 +269,10 @@ void Engine::HintFreed(size_t size) {
   hint_freed_bytes_since_last_call_ += size;
 }
 
+void Engine::NotifyLowMemoryWarning() {
+  image_decoder_.GetDecodedImageCache()->Clear();
+}
+
 void Engine::NotifyIdle(int64_t deadline) {
   auto trace_event = std::to_string(deadline - Dart_TimelineGetMicros());
   TRACE_EVENT1("flutter", "Engine::NotifyIdle", "deadline_now_delta",
@@ -540,6 +579,30 @@ void Engine::ScheduleSecondaryVsyncCallback(uintptr_t id,
   animator_->ScheduleSecondaryVsyncCallback(id, callback);
 }
 
+void Engine::RecordInputEventTimes(const std::vector<int64_t>& time_stamps) {
+  // |PointerData::time_stamp| is in microseconds on the clock of
+  // |fml::TimePoint::Now|, which the embedder API documents as the clock of
+  // |FlutterEngineGetCurrentTime|. The raster end time the input latency is
+  // measured against comes from the same clock.
+  std::vector<fml::TimePoint> event_times;
+  event_times.reserve(time_stamps.size());
+  const fml::TimePoint now = fml::TimePoint::Now();
+  for (int64_t time_stamp : time_stamps) {
+    // Embedders that don't stamp their events leave the time stamp at 0.
+    if (time_stamp <= 0) {
+      continue;
+    }
+    fml::TimePoint event_time = fml::TimePoint::FromEpochDelta(
+        fml::TimeDelta::FromMicroseconds(time_stamp));
+    // A time stamp in the future can only come from another clock, and its
+    // latency would be meaningless.
+    if (event_time <= now) {
+      event_times.push_back(event_time);
+    }
+  }
+  animator_->EnqueueInputEventTimes(event_times);
+}
+
 void Engine::HandleAssetPlatformMessage(
     std::unique_ptr<PlatformMessage> message) {
   fml::RefPtr<PlatformMessageResponse> response = message->response();
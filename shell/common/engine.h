@@ -551,6 +551,13 @@ class Engine final : public RuntimeDelegate,
   ///
   void NotifyIdle(int64_t deadline);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Notifies the engine that the embedder has received a low
+  ///             memory warning. The engine drops the decoded images it keeps
+  ///             for reuse.
+  ///
+  void NotifyLowMemoryWarning();
+
   //----------------------------------------------------------------------------
   /// @brief      Dart code cannot fully measure the time it takes for a
   ///             specific frame to be rendered. This is because Dart code only
@@ -815,6 +822,9 @@ class Engine final : public RuntimeDelegate,
   void ScheduleSecondaryVsyncCallback(uintptr_t id,
                                       const fml::closure& callback) override;
 
+  // |PointerDataDispatcher::Delegate|
+  void RecordInputEventTimes(const std::vector<int64_t>& time_stamps) override;
+
   //----------------------------------------------------------------------------
   /// @brief      Get the last Entrypoint that was used in the RunConfiguration
   ///             when |Engine::Run| was called.
@@ -925,9 +935,18 @@ class Engine final : public RuntimeDelegate,
   ImageGeneratorRegistry image_generator_registry_;
   TaskRunners task_runners_;
   size_t hint_freed_bytes_since_last_call_ = 0;
+  // The asset manager whose accesses are being recorded, and the number of
+  // frames left to record. See |Settings::asset_access_trace_frame_count|.
+  std::shared_ptr<AssetManager> traced_asset_manager_;
+  size_t asset_access_trace_frames_left_ = 0;
+  bool asset_access_trace_started_ = false;
   fml::TimePoint last_hint_freed_call_time_;
   fml::WeakPtrFactory<Engine> weak_factory_;
 
+  void StartAssetAccessTrace(std::shared_ptr<AssetManager> asset_manager);
+
+  void FinishAssetAccessTrace();
+
   // |RuntimeDelegate|
   std::string DefaultRouteName() override;
 
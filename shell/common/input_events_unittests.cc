@@ -353,6 +353,62 @@ TEST_F(ShellTest, CanCorrectlyPipePointerPacket) {
   ASSERT_FALSE(DartVMRef::IsInstanceRunning());
 }
 
+TEST_F(ShellTest, CoalescesPointerMovesWithinFrame) {
+  auto settings = CreateSettingsForFixture();
+  settings.enable_pointer_event_coalescing = true;
+  std::unique_ptr<Shell> shell = CreateShell(settings, true);
+
+  auto configuration = RunConfiguration::InferFromSettings(settings);
+  configuration.SetEntrypoint("onPointerDataPacketMain");
+  fml::AutoResetWaitableEvent reportLatch;
+  std::vector<std::vector<int64_t>> reported_sequences;
+  auto nativeOnPointerDataPacket = [&reportLatch, &reported_sequences](
+                                       Dart_NativeArguments args) {
+    Dart_Handle exception = nullptr;
+    reported_sequences.push_back(
+        tonic::DartConverter<std::vector<int64_t>>::FromArguments(args, 0,
+                                                                  exception));
+    reportLatch.Signal();
+  };
+  AddNativeCallback("NativeOnPointerDataPacket",
+                    CREATE_NATIVE_ENTRY(nativeOnPointerDataPacket));
+  ASSERT_TRUE(configuration.IsValid());
+  RunEngine(shell.get(), std::move(configuration));
+
+  // The first packet of a frame is dispatched right away.
+  auto packet = std::make_unique<PointerDataPacket>(2);
+  PointerData data;
+  CreateSimulatedPointerData(data, PointerData::Change::kAdd, 0.0, 0.0);
+  packet->SetPointerData(0, data);
+  CreateSimulatedPointerData(data, PointerData::Change::kDown, 0.0, 0.0);
+  packet->SetPointerData(1, data);
+  ShellTest::DispatchPointerData(shell.get(), std::move(packet));
+  reportLatch.Wait();
+
+  // The moves received until the next vsync are merged into one.
+  for (int i = 1; i <= 3; i++) {
+    packet = std::make_unique<PointerDataPacket>(1);
+    CreateSimulatedPointerData(data, PointerData::Change::kMove, i, 2.0 * i);
+    packet->SetPointerData(0, data);
+    ShellTest::DispatchPointerData(shell.get(), std::move(packet));
+  }
+  bool will_draw_new_frame;
+  ShellTest::VSyncFlush(shell.get(), will_draw_new_frame);
+  reportLatch.Wait();
+
+  ASSERT_EQ(reported_sequences.size(), 2u);
+  ASSERT_EQ(reported_sequences[0].size(), 2u);
+  ASSERT_EQ(PointerData::Change(reported_sequences[0][0]),
+            PointerData::Change::kAdd);
+  ASSERT_EQ(PointerData::Change(reported_sequences[0][1]),
+            PointerData::Change::kDown);
+  ASSERT_EQ(reported_sequences[1].size(), 1u);
+  ASSERT_EQ(PointerData::Change(reported_sequences[1][0]),
+            PointerData::Change::kMove);
+
+  DestroyShell(std::move(shell));
+}
+
 TEST_F(ShellTest, CanCorrectlySynthesizePointerPacket) {
   // Sets up shell with test fixture.
   auto settings = CreateSettingsForFixture();
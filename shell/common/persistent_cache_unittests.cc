@@ -362,5 +362,66 @@ TEST_F(PersistentCacheTest, PurgeAllowsFutureSkSLCache) {
   DestroyShell(std::move(shell));
 }
 
+TEST_F(PersistentCacheTest, CanStoreAndLoadRasterCacheImages) {
+  fml::ScopedTemporaryDirectory base_dir;
+  ASSERT_TRUE(base_dir.fd().is_valid());
+  PersistentCache::SetCacheDirectoryPath(base_dir.path());
+  PersistentCache::ResetCacheForProcess();
+
+  sk_sp<SkData> key = SkData::MakeWithCString("key");
+  sk_sp<SkData> image = SkData::MakeWithCString("image");
+
+  // Nothing is stored unless the raster cache images are enabled.
+  auto persistent_cache = PersistentCache::GetCacheForProcess();
+  ASSERT_FALSE(persistent_cache->StoreRasterCacheImage(*key, *image));
+
+  PersistentCache::SetCacheRasterImages(true);
+  PersistentCache::ResetCacheForProcess();
+  persistent_cache = PersistentCache::GetCacheForProcess();
+  ASSERT_EQ(persistent_cache->ListRasterCacheImages().size(), 0u);
+
+  ASSERT_TRUE(persistent_cache->StoreRasterCacheImage(*key, *image));
+
+  auto images = persistent_cache->ListRasterCacheImages();
+  ASSERT_EQ(images.size(), 1u);
+  ASSERT_TRUE(images[0].first->equals(key.get()));
+  ASSERT_EQ(images[0].second, image->size());
+  sk_sp<SkData> loaded_image = persistent_cache->LoadRasterCacheImage(*key);
+  ASSERT_TRUE(loaded_image);
+  ASSERT_TRUE(loaded_image->equals(image.get()));
+
+  persistent_cache->RemoveRasterCacheImage(*key);
+  ASSERT_EQ(persistent_cache->ListRasterCacheImages().size(), 0u);
+  ASSERT_FALSE(persistent_cache->LoadRasterCacheImage(*key));
+
+  // Cleanup
+  fml::RemoveFilesInDirectory(base_dir.fd());
+  PersistentCache::SetCacheDirectoryPath("");
+  PersistentCache::SetCacheRasterImages(false);
+  PersistentCache::ResetCacheForProcess();
+}
+
+TEST_F(PersistentCacheTest, CanStoreAndLoadAssetAccessTrace) {
+  fml::ScopedTemporaryDirectory base_dir;
+  ASSERT_TRUE(base_dir.fd().is_valid());
+  PersistentCache::SetCacheDirectoryPath(base_dir.path());
+  PersistentCache::ResetCacheForProcess();
+
+  auto persistent_cache = PersistentCache::GetCacheForProcess();
+  ASSERT_TRUE(persistent_cache->LoadAssetAccessTrace().empty());
+
+  // Without worker task runners the file is written synchronously.
+  std::vector<std::string> asset_names = {"FontManifest.json",
+                                          "fonts/MaterialIcons-Regular.otf",
+                                          "assets/images/logo.png"};
+  persistent_cache->StoreAssetAccessTrace(asset_names);
+  ASSERT_EQ(persistent_cache->LoadAssetAccessTrace(), asset_names);
+
+  // Cleanup
+  fml::RemoveFilesInDirectory(base_dir.fd());
+  PersistentCache::SetCacheDirectoryPath("");
+  PersistentCache::ResetCacheForProcess();
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -0,0 +1,64 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/platform_message_batcher.h"
+
+#include <string>
+
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+std::shared_ptr<PlatformMessageBatcher> PlatformMessageBatcher::Create(
+    fml::RefPtr<fml::TaskRunner> task_runner,
+    MessageHandler handler) {
+  return std::shared_ptr<PlatformMessageBatcher>(
+      new PlatformMessageBatcher(std::move(task_runner), std::move(handler)));
+}
+
+PlatformMessageBatcher::PlatformMessageBatcher(
+    fml::RefPtr<fml::TaskRunner> task_runner,
+    MessageHandler handler)
+    : task_runner_(std::move(task_runner)), handler_(std::move(handler)) {}
+
+PlatformMessageBatcher::~PlatformMessageBatcher() = default;
+
+void PlatformMessageBatcher::AddMessage(
+    std::unique_ptr<PlatformMessage> message) {
+  bool is_first_message;
+  {
+    std::scoped_lock lock(messages_mutex_);
+    is_first_message = messages_.empty();
+    messages_.push_back(std::move(message));
+  }
+
+  // A task is already pending for the other messages of the batch.
+  if (!is_first_message) {
+    return;
+  }
+
+  task_runner_->PostTask([weak_batcher = weak_from_this()]() {
+    if (auto batcher = weak_batcher.lock()) {
+      batcher->DeliverMessages();
+    }
+  });
+}
+
+void PlatformMessageBatcher::DeliverMessages() {
+  FML_DCHECK(task_runner_->RunsTasksOnCurrentThread());
+
+  std::vector<std::unique_ptr<PlatformMessage>> messages;
+  {
+    std::scoped_lock lock(messages_mutex_);
+    messages.swap(messages_);
+  }
+
+  TRACE_EVENT1("flutter", "PlatformMessageBatcher::DeliverMessages", "count",
+               std::to_string(messages.size()).c_str());
+  for (auto& message : messages) {
+    handler_(std::move(message));
+  }
+}
+
+}  // namespace flutter
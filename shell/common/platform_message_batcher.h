@@ -0,0 +1,75 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_PLATFORM_MESSAGE_BATCHER_H_
+#define FLUTTER_SHELL_COMMON_PLATFORM_MESSAGE_BATCHER_H_
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/task_runner.h"
+#include "flutter/lib/ui/window/platform_message.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      Delivers platform messages on a task runner in batches.
+///
+///             Posting a task for every message is expensive for channels that
+///             send thousands of small messages per second, like sensor
+///             streams. Instead, the batcher queues the messages and posts a
+///             single task that delivers all messages queued before it runs.
+///             While the target thread is busy, for example with a frame, all
+///             the messages sent in the meantime are delivered by one task.
+///
+///             Messages are delivered in the order they were added. Since the
+///             task of a batch is posted for its first message, the later
+///             messages of a batch may be delivered before other tasks that
+///             were posted to the task runner before them.
+///
+///             This class is thread safe.
+///
+class PlatformMessageBatcher
+    : public std::enable_shared_from_this<PlatformMessageBatcher> {
+ public:
+  using MessageHandler =
+      std::function<void(std::unique_ptr<PlatformMessage> message)>;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Creates a batcher that delivers messages to the handler on
+  ///             the given task runner.
+  ///
+  static std::shared_ptr<PlatformMessageBatcher> Create(
+      fml::RefPtr<fml::TaskRunner> task_runner,
+      MessageHandler handler);
+
+  ~PlatformMessageBatcher();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Queues a message for delivery with the current batch. Posts
+  ///             the task that delivers the batch if the message is the first
+  ///             one in it.
+  ///
+  void AddMessage(std::unique_ptr<PlatformMessage> message);
+
+ private:
+  const fml::RefPtr<fml::TaskRunner> task_runner_;
+  const MessageHandler handler_;
+  std::mutex messages_mutex_;
+  std::vector<std::unique_ptr<PlatformMessage>> messages_;
+
+  PlatformMessageBatcher(fml::RefPtr<fml::TaskRunner> task_runner,
+                         MessageHandler handler);
+
+  void DeliverMessages();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(PlatformMessageBatcher);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_PLATFORM_MESSAGE_BATCHER_H_
@@ -0,0 +1,99 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#define FML_USED_ON_EMBEDDER
+
+#include "flutter/shell/common/platform_message_batcher.h"
+
+#include <string>
+#include <vector>
+
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/thread.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+std::unique_ptr<PlatformMessage> CreateMessage(const std::string& channel) {
+  return std::make_unique<PlatformMessage>(channel, nullptr);
+}
+
+void WaitForTasks(const fml::RefPtr<fml::TaskRunner>& task_runner) {
+  fml::AutoResetWaitableEvent latch;
+  task_runner->PostTask([&latch]() { latch.Signal(); });
+  latch.Wait();
+}
+
+}  // namespace
+
+TEST(PlatformMessageBatcherTest, DeliversQueuedMessagesInOneTask) {
+  fml::Thread thread("platform_message_batcher_test");
+  auto task_runner = thread.GetTaskRunner();
+
+  std::vector<std::string> delivered;
+  auto batcher = PlatformMessageBatcher::Create(
+      task_runner, [&delivered](std::unique_ptr<PlatformMessage> message) {
+        delivered.push_back(message->channel());
+      });
+
+  // Keep the thread busy while the batch is queued.
+  fml::AutoResetWaitableEvent busy_latch;
+  task_runner->PostTask([&busy_latch]() { busy_latch.Wait(); });
+
+  batcher->AddMessage(CreateMessage("a"));
+  batcher->AddMessage(CreateMessage("b"));
+  task_runner->PostTask([&delivered]() { delivered.push_back("task"); });
+  batcher->AddMessage(CreateMessage("c"));
+
+  busy_latch.Signal();
+  WaitForTasks(task_runner);
+
+  // All messages are delivered by the task posted for the first one.
+  EXPECT_EQ(delivered, (std::vector<std::string>{"a", "b", "c", "task"}));
+}
+
+TEST(PlatformMessageBatcherTest, StartsNewBatchAfterDelivery) {
+  fml::Thread thread("platform_message_batcher_test");
+  auto task_runner = thread.GetTaskRunner();
+
+  std::vector<std::string> delivered;
+  auto batcher = PlatformMessageBatcher::Create(
+      task_runner, [&delivered](std::unique_ptr<PlatformMessage> message) {
+        delivered.push_back(message->channel());
+      });
+
+  batcher->AddMessage(CreateMessage("a"));
+  WaitForTasks(task_runner);
+  EXPECT_EQ(delivered, (std::vector<std::string>{"a"}));
+
+  batcher->AddMessage(CreateMessage("b"));
+  WaitForTasks(task_runner);
+  EXPECT_EQ(delivered, (std::vector<std::string>{"a", "b"}));
+}
+
+TEST(PlatformMessageBatcherTest, DropsMessagesAfterDestruction) {
+  fml::Thread thread("platform_message_batcher_test");
+  auto task_runner = thread.GetTaskRunner();
+
+  fml::AutoResetWaitableEvent busy_latch;
+  task_runner->PostTask([&busy_latch]() { busy_latch.Wait(); });
+
+  bool delivered = false;
+  auto batcher = PlatformMessageBatcher::Create(
+      task_runner, [&delivered](std::unique_ptr<PlatformMessage> message) {
+        delivered = true;
+      });
+  batcher->AddMessage(CreateMessage("a"));
+  batcher.reset();
+
+  busy_latch.Signal();
+  WaitForTasks(task_runner);
+  EXPECT_FALSE(delivered);
+}
+
+}  // namespace testing
+}  // namespace flutter
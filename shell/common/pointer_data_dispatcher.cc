@@ -5,6 +5,7 @@
 #include "flutter/shell/common/pointer_data_dispatcher.h"
 
 #include "flutter/fml/trace_event.h"
+#include "flutter/lib/ui/window/pointer_data_packet_converter.h"
 
 namespace flutter {
 
@@ -15,6 +16,11 @@ SmoothPointerDataDispatcher::SmoothPointerDataDispatcher(Delegate& delegate)
     : DefaultPointerDataDispatcher(delegate), weak_factory_(this) {}
 SmoothPointerDataDispatcher::~SmoothPointerDataDispatcher() = default;
 
+CoalescingPointerDataDispatcher::CoalescingPointerDataDispatcher(
+    Delegate& delegate)
+    : DefaultPointerDataDispatcher(delegate), weak_factory_(this) {}
+CoalescingPointerDataDispatcher::~CoalescingPointerDataDispatcher() = default;
+
 void DefaultPointerDataDispatcher::DispatchPacket(
     std::unique_ptr<PointerDataPacket> packet,
     uint64_t trace_flow_id) {
@@ -68,4 +74,72 @@ void SmoothPointerDataDispatcher::DispatchPendingPacket() {
   ScheduleSecondaryVsyncCallback();
 }
 
+void CoalescingPointerDataDispatcher::DispatchPacket(
+    std::unique_ptr<PointerDataPacket> packet,
+    uint64_t trace_flow_id) {
+  TRACE_EVENT0("flutter", "CoalescingPointerDataDispatcher::DispatchPacket");
+  TRACE_FLOW_STEP("flutter", "PointerEvent", trace_flow_id);
+
+  if (is_pointer_data_in_progress_) {
+    for (size_t i = 0; i < packet->GetLength(); i++) {
+      pending_pointer_data_.push_back(packet->GetPointerData(i));
+    }
+    pending_trace_flow_ids_.push_back(trace_flow_id);
+  } else {
+    FML_DCHECK(pending_pointer_data_.empty());
+    std::vector<int64_t> time_stamps(packet->GetLength());
+    for (size_t i = 0; i < packet->GetLength(); i++) {
+      time_stamps[i] = packet->GetPointerData(i).time_stamp;
+    }
+    delegate_.RecordInputEventTimes(time_stamps);
+    DefaultPointerDataDispatcher::DispatchPacket(std::move(packet),
+                                                 trace_flow_id);
+  }
+  is_pointer_data_in_progress_ = true;
+  ScheduleSecondaryVsyncCallback();
+}
+
+void CoalescingPointerDataDispatcher::ScheduleSecondaryVsyncCallback() {
+  delegate_.ScheduleSecondaryVsyncCallback(
+      reinterpret_cast<uintptr_t>(this),
+      [dispatcher = weak_factory_.GetWeakPtr()]() {
+        if (dispatcher && dispatcher->is_pointer_data_in_progress_) {
+          if (!dispatcher->pending_trace_flow_ids_.empty()) {
+            dispatcher->DispatchPendingPointerData();
+          } else {
+            dispatcher->is_pointer_data_in_progress_ = false;
+          }
+        }
+      });
+}
+
+void CoalescingPointerDataDispatcher::DispatchPendingPointerData() {
+  FML_DCHECK(!pending_trace_flow_ids_.empty());
+  FML_DCHECK(is_pointer_data_in_progress_);
+  TRACE_EVENT1("flutter",
+               "CoalescingPointerDataDispatcher::DispatchPendingPointerData",
+               "events", std::to_string(pending_pointer_data_.size()).c_str());
+  std::vector<int64_t> time_stamps;
+  std::vector<PointerData> coalesced =
+      PointerDataPacketConverter::CoalesceMoves(pending_pointer_data_,
+                                                &time_stamps);
+  auto packet = std::make_unique<PointerDataPacket>(coalesced.size());
+  for (size_t i = 0; i < coalesced.size(); i++) {
+    packet->SetPointerData(i, coalesced[i]);
+  }
+  // The merged packet continues the flow of the latest packet. The flows of
+  // the packets merged into it end here.
+  uint64_t trace_flow_id = pending_trace_flow_ids_.back();
+  pending_trace_flow_ids_.pop_back();
+  for (uint64_t merged_trace_flow_id : pending_trace_flow_ids_) {
+    TRACE_FLOW_END("flutter", "PointerEvent", merged_trace_flow_id);
+  }
+  pending_pointer_data_.clear();
+  pending_trace_flow_ids_.clear();
+  delegate_.RecordInputEventTimes(time_stamps);
+  DefaultPointerDataDispatcher::DispatchPacket(std::move(packet),
+                                               trace_flow_id);
+  ScheduleSecondaryVsyncCallback();
+}
+
 }  // namespace flutter
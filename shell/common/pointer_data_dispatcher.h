@@ -64,6 +64,16 @@ class PointerDataDispatcher {
     virtual void ScheduleSecondaryVsyncCallback(
         uintptr_t id,
         const fml::closure& callback) = 0;
+
+    //--------------------------------------------------------------------------
+    /// @brief    Record when the dispatched pointer events were created, so
+    ///           that their latency is reported by the next frame. Only
+    ///           `CoalescingPointerDataDispatcher` tracks the latency.
+    ///
+    /// @param[in]  time_stamps  The `PointerData::time_stamp`s of the events,
+    ///                          in microseconds.
+    virtual void RecordInputEventTimes(
+        const std::vector<int64_t>& time_stamps) = 0;
   };
 
   //----------------------------------------------------------------------------
@@ -164,6 +174,48 @@ class SmoothPointerDataDispatcher : public DefaultPointerDataDispatcher {
   FML_DISALLOW_COPY_AND_ASSIGN(SmoothPointerDataDispatcher);
 };
 
+//------------------------------------------------------------------------------
+/// A dispatcher that merges the move and hover events a pointer receives within
+/// one frame, for input devices that sample much faster than the display
+/// refreshes (such as 1000Hz mice and touch panels).
+///
+/// Like `SmoothPointerDataDispatcher`, the first packet of a frame is
+/// dispatched right away. Packets that arrive while a dispatch is still in
+/// progress are held until the next vsync, where their events are concatenated
+/// and their consecutive moves and hovers are merged per pointer by
+/// `PointerDataPacketConverter::CoalesceMoves` before being dispatched as one
+/// packet. The framework then handles one move per pointer and frame, with the
+/// latest position and the summed deltas, instead of one per sample.
+///
+/// The time stamps of the dispatched events are recorded for the input latency
+/// of `FrameTiming`. A merged event is recorded with the time stamp of the
+/// earliest event merged into it.
+class CoalescingPointerDataDispatcher : public DefaultPointerDataDispatcher {
+ public:
+  CoalescingPointerDataDispatcher(Delegate& delegate);
+
+  // |PointerDataDispatcer|
+  void DispatchPacket(std::unique_ptr<PointerDataPacket> packet,
+                      uint64_t trace_flow_id) override;
+
+  virtual ~CoalescingPointerDataDispatcher();
+
+ private:
+  // The events of the packets received since the last dispatch, in order.
+  std::vector<PointerData> pending_pointer_data_;
+  std::vector<uint64_t> pending_trace_flow_ids_;
+
+  bool is_pointer_data_in_progress_ = false;
+
+  fml::WeakPtrFactory<CoalescingPointerDataDispatcher> weak_factory_;
+
+  void DispatchPendingPointerData();
+
+  void ScheduleSecondaryVsyncCallback();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(CoalescingPointerDataDispatcher);
+};
+
 //--------------------------------------------------------------------------
 /// @brief      Signature for constructing PointerDataDispatcher.
 ///
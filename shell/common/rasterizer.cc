@@ -98,10 +98,48 @@ void Rasterizer::Setup(std::unique_ptr<Surface> surface) {
       }
     });
   }
+  if (staged_sksl_warm_up_ && !sksl_warm_up_) {
+    StartSkSLWarmUp();
+  }
+}
+
+void Rasterizer::StartSkSLWarmUp() {
+  // The compiled shaders belong to the context, so a warm-up for another
+  // context starts over.
+  GrDirectContext* context = surface_->GetContext();
+  if (context != sksl_warm_up_context_) {
+    sksl_warm_up_context_ = context;
+    sksl_warm_up_compiled_count_ = 0;
+    sksl_warm_up_done_ = false;
+  }
+  if (sksl_warm_up_done_) {
+    return;
+  }
+  const auto& task_runners = delegate_.GetTaskRunners();
+  sksl_warm_up_ = std::make_unique<StagedSkSLWarmUp>(
+      task_runners.GetRasterTaskRunner(), task_runners.GetIOTaskRunner());
+  // The warm-up is destroyed before the surface in |Teardown|, so the surface
+  // outlives every compilation.
+  sksl_warm_up_->Start(
+      [surface = surface_.get()](const PersistentCache::SkSLCache& sksl) {
+        auto context_switch = surface->MakeRenderContextCurrent();
+        if (!context_switch->GetResult()) {
+          return false;
+        }
+        GrDirectContext* context = surface->GetContext();
+        return context != nullptr &&
+               context->precompileShader(*sksl.first, *sksl.second);
+      },
+      sksl_warm_up_compiled_count_);
 }
 
 void Rasterizer::Teardown() {
   compositor_context_->OnGrContextDestroyed();
+  if (sksl_warm_up_) {
+    sksl_warm_up_compiled_count_ = sksl_warm_up_->GetCompiledCount();
+    sksl_warm_up_done_ = sksl_warm_up_->IsDone();
+    sksl_warm_up_.reset();
+  }
   surface_.reset();
   last_layer_tree_.reset();
 
@@ -488,11 +526,39 @@ RasterStatus Rasterizer::DrawToSurface(
   );
 
   if (compositor_frame) {
-    RasterStatus raster_status = compositor_frame->Raster(layer_tree, false);
+    // The external view embedder composites the whole root surface itself, so
+    // partial repaint is only used when it does not submit the frame.
+    bool disable_partial_repaint =
+        external_view_embedder_ &&
+        (!raster_thread_merger_ || raster_thread_merger_->IsMerged());
+
+    // Redrawing the last layer tree (e.g. after the surface was recreated)
+    // has nothing to diff against, so it repaints the whole frame.
+    FrameDamage damage;
+    FrameDamage* frame_damage = nullptr;
+    if (!disable_partial_repaint &&
+        frame->framebuffer_info().supports_partial_repaint &&
+        last_layer_tree_.get() != &layer_tree) {
+      damage.SetPreviousLayerTree(last_layer_tree_.get());
+      const auto& existing_damage = frame->framebuffer_info().existing_damage;
+      damage.AddAdditionalDamage(
+          existing_damage ? *existing_damage
+                          : SkIRect::MakeSize(layer_tree.frame_size()));
+      frame_damage = &damage;
+    }
+
+    RasterStatus raster_status =
+        compositor_frame->Raster(layer_tree, false, frame_damage);
     if (raster_status == RasterStatus::kFailed ||
         raster_status == RasterStatus::kSkipAndRetry) {
       return raster_status;
     }
+
+    SurfaceFrame::SubmitInfo submit_info;
+    submit_info.frame_damage = damage.GetFrameDamage();
+    submit_info.buffer_damage = damage.GetBufferDamage();
+    frame->set_submit_info(submit_info);
+
     if (shared_engine_block_thread_merging_ && raster_thread_merger_ &&
         raster_thread_merger_->IsMerged()) {
       // TODO(73620): Remove when platform views are accounted for.
@@ -543,7 +609,7 @@ static sk_sp<SkData> ScreenshotLayerTreeAsPicture(
   auto frame = compositor_context.ACQUIRE_FRAME(
       nullptr, recorder.getRecordingCanvas(), nullptr,
       root_surface_transformation, false, true, nullptr);
-  frame->Raster(*tree, true);
+  frame->Raster(*tree, true, nullptr);
 
 #if defined(OS_FUCHSIA)
   SkSerialProcs procs = {0};
@@ -611,7 +677,7 @@ sk_sp<SkData> Rasterizer::ScreenshotLayerTreeAsImage(
       surface_context, canvas, nullptr, root_surface_transformation, false,
       true, nullptr);
   canvas->clear(SK_ColorTRANSPARENT);
-  frame->Raster(*tree, true);
+  frame->Raster(*tree, true, nullptr);
   canvas->flush();
 
   // Prepare an image from the surface, this image may potentially be on th GPU.
@@ -24,6 +24,7 @@
 #include "flutter/fml/time/time_point.h"
 #include "flutter/lib/ui/snapshot_delegate.h"
 #include "flutter/shell/common/pipeline.h"
+#include "flutter/shell/common/staged_sksl_warmup.h"
 
 namespace flutter {
 
@@ -437,6 +438,17 @@ class Rasterizer final : public SnapshotDelegate {
   ///
   void DisableThreadMergerIfNeeded();
 
+  //----------------------------------------------------------------------------
+  /// @brief      Sets whether the known SkSLs are precompiled by a
+  ///             `StagedSkSLWarmUp` once the rasterizer is set up with a
+  ///             surface. `PersistentCache::SetStagedSkSLWarmUp` must be set
+  ///             to the same value so that the surface does not precompile
+  ///             them itself.
+  ///
+  /// @param[in]  enabled  Whether to precompile the known SkSLs in stages.
+  ///
+  void SetStagedSkSLWarmUp(bool enabled) { staged_sksl_warm_up_ = enabled; }
+
   /// @brief   Mechanism to stop thread merging when using shared engine
   ///          components.
   /// @details This is a temporary workaround until thread merging can be
@@ -463,6 +475,14 @@ class Rasterizer final : public SnapshotDelegate {
   fml::TaskRunnerAffineWeakPtrFactory<Rasterizer> weak_factory_;
   std::shared_ptr<ExternalViewEmbedder> external_view_embedder_;
   bool shared_engine_block_thread_merging_ = false;
+  bool staged_sksl_warm_up_ = false;
+  std::unique_ptr<StagedSkSLWarmUp> sksl_warm_up_;
+  // The context that the SkSLs were last warmed up for, and how far the
+  // warm-up got, so that setting the rasterizer up again with a surface of
+  // the same context doesn't compile them again.
+  GrDirectContext* sksl_warm_up_context_ = nullptr;
+  size_t sksl_warm_up_compiled_count_ = 0;
+  bool sksl_warm_up_done_ = false;
 
   // |SnapshotDelegate|
   sk_sp<SkImage> MakeRasterSnapshot(sk_sp<SkPicture> picture,
@@ -471,6 +491,8 @@ class Rasterizer final : public SnapshotDelegate {
   // |SnapshotDelegate|
   sk_sp<SkImage> ConvertToRasterImage(sk_sp<SkImage> image) override;
 
+  void StartSkSLWarmUp();
+
   sk_sp<SkData> ScreenshotLayerTreeAsImage(
       flutter::LayerTree* tree,
       flutter::CompositorContext& compositor_context,
@@ -9,6 +9,7 @@
 #include <memory>
 
 #include "flutter/flow/frame_timings.h"
+#include "flutter/flow/layers/container_layer.h"
 #include "flutter/fml/time/time_point.h"
 #include "flutter/shell/common/thread_host.h"
 #include "flutter/testing/testing.h"
@@ -314,4 +315,68 @@ TEST(RasterizerTest, externalViewEmbedderDoesntEndFrameWhenNoSurfaceIsSet) {
   });
   latch.Wait();
 }
+
+TEST(RasterizerTest, drawWithPartialRepaintSubmitsFrameDamage) {
+  std::string test_name =
+      ::testing::UnitTest::GetInstance()->current_test_info()->name();
+  ThreadHost thread_host("io.flutter.test." + test_name + ".",
+                         ThreadHost::Type::Platform | ThreadHost::Type::RASTER |
+                             ThreadHost::Type::IO | ThreadHost::Type::UI);
+  TaskRunners task_runners("test", thread_host.platform_thread->GetTaskRunner(),
+                           thread_host.raster_thread->GetTaskRunner(),
+                           thread_host.ui_thread->GetTaskRunner(),
+                           thread_host.io_thread->GetTaskRunner());
+  MockDelegate delegate;
+  EXPECT_CALL(delegate, GetTaskRunners())
+      .WillRepeatedly(ReturnRef(task_runners));
+  EXPECT_CALL(delegate, OnFrameRasterized(_)).Times(2);
+  auto rasterizer = std::make_unique<Rasterizer>(delegate);
+  auto surface = std::make_unique<MockSurface>();
+
+  std::vector<SurfaceFrame::SubmitInfo> submit_infos;
+  auto create_surface_frame = [&](std::optional<SkIRect> existing_damage) {
+    auto surface_frame = std::make_unique<SurfaceFrame>(
+        /*surface=*/SkSurface::MakeNull(100, 100), /*supports_readback=*/true,
+        /*submit_callback=*/[&](const SurfaceFrame& frame, SkCanvas*) {
+          submit_infos.push_back(frame.submit_info());
+          return true;
+        });
+    SurfaceFrame::FramebufferInfo framebuffer_info;
+    framebuffer_info.supports_partial_repaint = true;
+    framebuffer_info.existing_damage = existing_damage;
+    surface_frame->set_framebuffer_info(framebuffer_info);
+    return surface_frame;
+  };
+  // The first framebuffer has undefined contents, the second one holds the
+  // first frame.
+  EXPECT_CALL(*surface, AcquireFrame(SkISize::Make(100, 100)))
+      .WillOnce(Return(ByMove(create_surface_frame(std::nullopt))))
+      .WillOnce(Return(ByMove(create_surface_frame(SkIRect::MakeEmpty()))));
+
+  rasterizer->Setup(std::move(surface));
+  fml::AutoResetWaitableEvent latch;
+  thread_host.raster_thread->GetTaskRunner()->PostTask([&] {
+    auto root_layer = std::make_shared<ContainerLayer>();
+    auto no_discard = [](LayerTree&) { return false; };
+    for (int i = 0; i < 2; i++) {
+      auto pipeline = fml::AdoptRef(new Pipeline<LayerTree>(/*depth=*/10));
+      auto layer_tree =
+          std::make_unique<LayerTree>(/*frame_size=*/SkISize::Make(100, 100),
+                                      /*device_pixel_ratio=*/1.0f);
+      layer_tree->set_root_layer(root_layer);
+      bool result = pipeline->Produce().Complete(std::move(layer_tree));
+      EXPECT_TRUE(result);
+      rasterizer->Draw(CreateFinishedBuildRecorder(), pipeline, no_discard);
+    }
+    latch.Signal();
+  });
+  latch.Wait();
+
+  ASSERT_EQ(submit_infos.size(), 2u);
+  EXPECT_EQ(submit_infos[0].frame_damage, SkIRect::MakeWH(100, 100));
+  EXPECT_EQ(submit_infos[0].buffer_damage, SkIRect::MakeWH(100, 100));
+  // Nothing changed in the second frame.
+  EXPECT_EQ(submit_infos[1].frame_damage, SkIRect::MakeEmpty());
+  EXPECT_EQ(submit_infos[1].buffer_damage, SkIRect::MakeEmpty());
+}
 }  // namespace flutter
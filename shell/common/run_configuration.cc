@@ -7,6 +7,7 @@
 #include <sstream>
 
 #include "flutter/assets/directory_asset_bundle.h"
+#include "flutter/assets/packed_asset_bundle.h"
 #include "flutter/common/graphics/persistent_cache.h"
 #include "flutter/fml/file.h"
 #include "flutter/fml/unique_fd.h"
@@ -19,6 +20,13 @@ RunConfiguration RunConfiguration::InferFromSettings(
     fml::RefPtr<fml::TaskRunner> io_worker) {
   auto asset_manager = std::make_shared<AssetManager>();
 
+  if (!settings.asset_pack_path.empty()) {
+    asset_manager->PushBack(std::make_unique<PackedAssetBundle>(
+        fml::OpenFile(settings.asset_pack_path.c_str(), false,
+                      fml::FilePermission::kRead),
+        true));
+  }
+
   if (fml::UniqueFD::traits_type::IsValid(settings.assets_dir)) {
     asset_manager->PushBack(std::make_unique<DirectoryAssetBundle>(
         fml::Duplicate(settings.assets_dir), true));
@@ -58,7 +66,7 @@ bool RunConfiguration::IsValid() const {
 }
 
 bool RunConfiguration::AddAssetResolver(
-    std::unique_ptr<AssetResolver> resolver) {
+    std::shared_ptr<AssetResolver> resolver) {
   if (!resolver || !resolver->IsValid()) {
     return false;
   }
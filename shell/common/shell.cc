@@ -118,6 +118,9 @@ void PerformInitializationTasks(Settings& settings) {
   });
 
   PersistentCache::SetCacheSkSL(settings.cache_sksl);
+  PersistentCache::SetStagedSkSLWarmUp(settings.staged_sksl_warm_up);
+  PersistentCache::SetCacheRasterImages(
+      settings.raster_cache_persistent_images);
 }
 
 }  // namespace
@@ -192,6 +195,26 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
   ]() {
         TRACE_EVENT0("flutter", "ShellSetupGPUSubsystem");
         std::unique_ptr<Rasterizer> rasterizer(on_create_rasterizer(*shell));
+        RasterCache& raster_cache =
+            rasterizer->compositor_context()->raster_cache();
+        raster_cache.SetMaxRetainedBytes(
+            shell->GetSettings().raster_cache_max_retained_bytes);
+        if (shell->GetSettings().raster_cache_async_rasterization) {
+          raster_cache.SetAsyncRasterizationTaskRunner(
+              shell->GetDartVM()->GetConcurrentWorkerTaskRunner());
+        }
+        if (shell->GetSettings().raster_cache_persistent_images) {
+          raster_cache.SetPersistentCacheTaskRunner(
+              shell->GetDartVM()->GetConcurrentWorkerTaskRunner());
+        }
+        raster_cache.SetSubtreeCachingEnabled(
+            shell->GetSettings().raster_cache_subtrees);
+        if (shell->GetSettings().concurrent_preroll) {
+          rasterizer->compositor_context()->SetConcurrentPrerollTaskRunner(
+              shell->GetDartVM()->GetConcurrentWorkerTaskRunner());
+        }
+        rasterizer->SetStagedSkSLWarmUp(
+            shell->GetSettings().staged_sksl_warm_up);
         snapshot_delegate_promise.set_value(rasterizer->GetSnapshotDelegate());
         rasterizer_promise.set_value(std::move(rasterizer));
       });
@@ -248,6 +271,11 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
   // Send dispatcher_maker to the engine constructor because shell won't have
   // platform_view set until Shell::Setup is called later.
   auto dispatcher_maker = platform_view->GetDispatcherMaker();
+  if (shell->GetSettings().enable_pointer_event_coalescing) {
+    dispatcher_maker = [](PointerDataDispatcher::Delegate& delegate) {
+      return std::make_unique<CoalescingPointerDataDispatcher>(delegate);
+    };
+  }
 
   // Create the engine on the UI thread.
   std::promise<std::unique_ptr<Engine>> engine_promise;
@@ -538,6 +566,11 @@ void Shell::NotifyLowMemoryWarning() const {
         TRACE_EVENT_ASYNC_END0("flutter", "Shell::NotifyLowMemoryWarning",
                                trace_id);
       });
+  task_runners_.GetUITaskRunner()->PostTask([engine = weak_engine_]() {
+    if (engine) {
+      engine->NotifyLowMemoryWarning();
+    }
+  });
   // The IO Manager uses resource cache limits of 0, so it is not necessary
   // to purge them.
 }
@@ -641,6 +674,21 @@ bool Shell::Setup(std::unique_ptr<PlatformView> platform_view,
   weak_rasterizer_ = rasterizer_->GetWeakPtr();
   weak_platform_view_ = platform_view_->GetWeakPtr();
 
+  engine_message_batcher_ = PlatformMessageBatcher::Create(
+      task_runners_.GetUITaskRunner(),
+      [engine = weak_engine_](std::unique_ptr<PlatformMessage> message) {
+        if (engine) {
+          engine->DispatchPlatformMessage(std::move(message));
+        }
+      });
+  platform_view_message_batcher_ = PlatformMessageBatcher::Create(
+      task_runners_.GetPlatformTaskRunner(),
+      [view = weak_platform_view_](std::unique_ptr<PlatformMessage> message) {
+        if (view) {
+          view->HandlePlatformMessage(std::move(message));
+        }
+      });
+
   // Setup the time-consuming default font manager right after engine created.
   fml::TaskRunner::RunNowOrPostTask(task_runners_.GetUITaskRunner(),
                                     [engine = weak_engine_] {
@@ -941,6 +989,11 @@ void Shell::OnPlatformViewDispatchPlatformMessage(
   FML_DCHECK(is_setup_);
   FML_DCHECK(task_runners_.GetPlatformTaskRunner()->RunsTasksOnCurrentThread());
 
+  if (IsPlatformMessageChannelBatched(message->channel())) {
+    engine_message_batcher_->AddMessage(std::move(message));
+    return;
+  }
+
   task_runners_.GetUITaskRunner()->PostTask(fml::MakeCopyable(
       [engine = engine_->GetWeakPtr(), message = std::move(message)]() mutable {
         if (engine) {
@@ -1210,6 +1263,11 @@ void Shell::OnEngineHandlePlatformMessage(
     return;
   }
 
+  if (IsPlatformMessageChannelBatched(message->channel())) {
+    platform_view_message_batcher_->AddMessage(std::move(message));
+    return;
+  }
+
   task_runners_.GetPlatformTaskRunner()->PostTask(
       fml::MakeCopyable([view = platform_view_->GetWeakPtr(),
                          message = std::move(message)]() mutable {
@@ -1367,6 +1425,13 @@ void Shell::OnFrameRasterized(const FrameTiming& timing) {
     settings_.frame_rasterized_callback(timing);
   }
 
+  if (timing.GetInputEventCount() > 0) {
+    FML_TRACE_COUNTER(
+        "flutter", "InputLatency", reinterpret_cast<int64_t>(this),
+        "MeanMicros", timing.GetMeanInputLatency().ToMicroseconds(),
+        "MaxMicros", timing.GetMaxInputLatency().ToMicroseconds());
+  }
+
   if (!needs_report_timings_) {
     return;
   }
@@ -1637,6 +1702,21 @@ double Shell::GetMainDisplayRefreshRate() {
   return display_manager_->GetMainDisplayRefreshRate();
 }
 
+void Shell::SetPlatformMessageChannelBatched(const std::string& channel,
+                                             bool batched) {
+  std::scoped_lock lock(batched_channels_mutex_);
+  if (batched) {
+    batched_channels_.insert(channel);
+  } else {
+    batched_channels_.erase(channel);
+  }
+}
+
+bool Shell::IsPlatformMessageChannelBatched(const std::string& channel) const {
+  std::scoped_lock lock(batched_channels_mutex_);
+  return batched_channels_.count(channel) > 0;
+}
+
 bool Shell::OnServiceProtocolGetSkSLs(
     const ServiceProtocol::Handler::ServiceProtocolMap& params,
     rapidjson::Document* response) {
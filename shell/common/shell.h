@@ -7,6 +7,7 @@
 
 #include <functional>
 #include <mutex>
+#include <set>
 #include <string_view>
 #include <unordered_map>
 
@@ -35,6 +36,7 @@
 #include "flutter/shell/common/animator.h"
 #include "flutter/shell/common/display_manager.h"
 #include "flutter/shell/common/engine.h"
+#include "flutter/shell/common/platform_message_batcher.h"
 #include "flutter/shell/common/platform_view.h"
 #include "flutter/shell/common/rasterizer.h"
 #include "flutter/shell/common/shell_io_manager.h"
@@ -368,6 +370,19 @@ class Shell final : public PlatformView::Delegate,
   ///
   double GetMainDisplayRefreshRate();
 
+  //----------------------------------------------------------------------------
+  /// @brief      Sets whether the platform messages on a channel are delivered
+  ///             in batches, in both directions. This saves a task post per
+  ///             message on high-rate channels, at the cost of ordering the
+  ///             messages of the channel relative to other events. See
+  ///             `PlatformMessageBatcher`.
+  ///
+  /// @param[in]  channel  The name of the channel.
+  /// @param[in]  batched  Whether messages on the channel are batched.
+  ///
+  void SetPlatformMessageChannelBatched(const std::string& channel,
+                                        bool batched);
+
  private:
   using ServiceProtocolHandler =
       std::function<bool(const ServiceProtocol::Handler::ServiceProtocolMap&,
@@ -391,6 +406,15 @@ class Shell final : public PlatformView::Delegate,
   fml::WeakPtr<PlatformView>
       weak_platform_view_;  // to be shared across threads
 
+  // Channels whose platform messages are batched. Read on the platform and UI
+  // task runners.
+  mutable std::mutex batched_channels_mutex_;
+  std::set<std::string> batched_channels_;
+  // Deliver the messages on batched channels to the engine and the platform
+  // view respectively.
+  std::shared_ptr<PlatformMessageBatcher> engine_message_batcher_;
+  std::shared_ptr<PlatformMessageBatcher> platform_view_message_batcher_;
+
   std::unordered_map<std::string_view,  // method
                      std::pair<fml::RefPtr<fml::TaskRunner>,
                                ServiceProtocolHandler>  // task-runner/function
@@ -469,6 +493,8 @@ class Shell final : public PlatformView::Delegate,
 
   void ReportTimings();
 
+  bool IsPlatformMessageChannelBatched(const std::string& channel) const;
+
   // |PlatformView::Delegate|
   void OnPlatformViewCreated(std::unique_ptr<Surface> surface) override;
 
@@ -4,12 +4,30 @@
 
 #include "flutter/shell/common/shell.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
 #include "flutter/benchmarking/benchmarking.h"
+#include "flutter/flow/compositor_context.h"
+#include "flutter/flow/layers/container_layer.h"
+#include "flutter/flow/layers/layer_tree.h"
+#include "flutter/flow/layers/opacity_layer.h"
+#include "flutter/flow/layers/picture_layer.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/make_copyable.h"
+#include "flutter/fml/thread.h"
 #include "flutter/runtime/dart_vm.h"
+#include "flutter/shell/common/platform_message_batcher.h"
 #include "flutter/shell/common/thread_host.h"
 #include "flutter/testing/elf_loader.h"
 #include "flutter/testing/testing.h"
+#include "third_party/skia/include/core/SkPath.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+#include "third_party/skia/include/core/SkSurface.h"
+#include "third_party/skia/include/utils/SkNWayCanvas.h"
 
 namespace flutter {
 
@@ -120,4 +138,270 @@ static void BM_ShellInitializationAndShutdown(benchmark::State& state) {
 
 BENCHMARK(BM_ShellInitializationAndShutdown);
 
+// A picture that is expensive to rasterize, similar to a complex vector logo.
+static sk_sp<SkPicture> CreateExpensivePicture(const SkRect& bounds,
+                                               int seed) {
+  SkPictureRecorder recorder;
+  SkCanvas* canvas = recorder.beginRecording(bounds);
+  SkPaint paint;
+  paint.setAntiAlias(true);
+  for (int i = 0; i < 500; i++) {
+    paint.setColor(SkColorSetARGB(0x80, (seed * 37 + i) & 0xFF, i & 0xFF,
+                                  (seed * 11) & 0xFF));
+    SkPath path;
+    path.moveTo(bounds.left(), bounds.top() + (i % 50) * 4);
+    path.cubicTo(bounds.centerX(), bounds.top() - i, bounds.centerX(),
+                 bounds.bottom() + i, bounds.right(), bounds.bottom());
+    canvas->drawPath(path, paint);
+  }
+  return recorder.finishRecordingAsPicture();
+}
+
+// Rasterizes a scene of expensive pictures for a number of frames with the
+// raster cache either preparing pictures synchronously or asynchronously,
+// and reports the worst and mean frame times. Frames are spaced one frame
+// budget apart, like vsync paced frames would be.
+static void RasterCacheWarmUp(benchmark::State& state, bool async) {
+  const SkISize frame_size = SkISize::Make(1000, 1000);
+  const int picture_count = 12;
+  const int frame_count = 30;
+
+  std::vector<sk_sp<SkPicture>> pictures;
+  for (int i = 0; i < picture_count; i++) {
+    pictures.push_back(CreateExpensivePicture(SkRect::MakeWH(240, 240), i));
+  }
+
+  std::shared_ptr<fml::ConcurrentMessageLoop> worker_loop;
+  if (async) {
+    worker_loop = fml::ConcurrentMessageLoop::Create();
+  }
+
+  double worst_frame_ms = 0;
+  double total_frame_ms = 0;
+  int64_t frames = 0;
+  while (state.KeepRunning()) {
+    CompositorContext compositor_context(fml::kDefaultFrameBudget);
+    if (worker_loop) {
+      compositor_context.raster_cache().SetAsyncRasterizationTaskRunner(
+          worker_loop->GetTaskRunner());
+    }
+
+    LayerTree layer_tree(frame_size, 1.0f);
+    auto root = std::make_shared<ContainerLayer>();
+    for (int i = 0; i < picture_count; i++) {
+      SkPoint offset = SkPoint::Make((i % 4) * 250, (i / 4) * 250);
+      root->Add(std::make_shared<PictureLayer>(
+          offset, SkiaGPUObject<SkPicture>(pictures[i], nullptr),
+          /* is_complex= */ true, /* will_change= */ false));
+    }
+    layer_tree.set_root_layer(root);
+
+    sk_sp<SkSurface> surface =
+        SkSurface::MakeRasterN32Premul(frame_size.width(), frame_size.height());
+
+    for (int frame = 0; frame < frame_count; frame++) {
+      fml::TimePoint start = fml::TimePoint::Now();
+      {
+        auto scoped_frame = compositor_context.AcquireFrame(
+            nullptr, surface->getCanvas(), nullptr, SkMatrix::I(), false, true,
+            nullptr);
+        scoped_frame->Raster(layer_tree, false, nullptr);
+      }
+      fml::TimeDelta frame_time = fml::TimePoint::Now() - start;
+      worst_frame_ms = std::max(worst_frame_ms, frame_time.ToMillisecondsF());
+      total_frame_ms += frame_time.ToMillisecondsF();
+      frames++;
+
+      benchmarking::ScopedPauseTiming pause(state);
+      fml::TimeDelta frame_budget = fml::TimeDelta::FromMillisecondsF(
+          fml::kDefaultFrameBudget.count());
+      if (frame_time < frame_budget) {
+        std::this_thread::sleep_for(std::chrono::microseconds(
+            (frame_budget - frame_time).ToMicroseconds()));
+      }
+    }
+  }
+
+  state.counters["WorstFrameMs"] = worst_frame_ms;
+  state.counters["MeanFrameMs"] = frames > 0 ? total_frame_ms / frames : 0;
+}
+
+static void BM_RasterCacheWarmUpSync(benchmark::State& state) {
+  RasterCacheWarmUp(state, false);
+}
+
+BENCHMARK(BM_RasterCacheWarmUpSync)->Unit(benchmark::kMillisecond);
+
+static void BM_RasterCacheWarmUpAsync(benchmark::State& state) {
+  RasterCacheWarmUp(state, true);
+}
+
+BENCHMARK(BM_RasterCacheWarmUpAsync)->Unit(benchmark::kMillisecond);
+
+// Forwards to a canvas and adds up the device pixels of the saveLayers, which
+// is the size of the offscreen layers that have to be allocated.
+class SaveLayerPixelCountingCanvas final : public SkNWayCanvas {
+ public:
+  explicit SaveLayerPixelCountingCanvas(SkCanvas* canvas)
+      : SkNWayCanvas(canvas->imageInfo().width(),
+                     canvas->imageInfo().height()) {
+    addCanvas(canvas);
+  }
+
+  int64_t save_layer_pixels() const { return save_layer_pixels_; }
+
+ private:
+  int64_t save_layer_pixels_ = 0;
+
+  // |SkNWayCanvas|
+  SaveLayerStrategy getSaveLayerStrategy(const SaveLayerRec& rec) override {
+    SkIRect bounds = getDeviceClipBounds();
+    if (rec.fBounds &&
+        !bounds.intersect(getTotalMatrix().mapRect(*rec.fBounds).roundOut())) {
+      bounds.setEmpty();
+    }
+    save_layer_pixels_ += bounds.width() * bounds.height();
+    return SkNWayCanvas::getSaveLayerStrategy(rec);
+  }
+};
+
+// Rasterizes frames of a fading grid of shapes without the raster cache, so
+// that OpacityLayer either applies the opacity to the shapes or draws them
+// into a saveLayer. Overlapping shapes can't take the opacity directly. The
+// size of the saveLayers per frame is reported.
+static void OpacityFade(benchmark::State& state, bool overlapping_shapes) {
+  const SkISize frame_size = SkISize::Make(1000, 1000);
+  const int columns = 8;
+  const int rows = 6;
+  const SkScalar cell_width = SkIntToScalar(frame_size.width()) / columns;
+  const SkScalar cell_height = SkIntToScalar(frame_size.height()) / rows;
+
+  SkPictureRecorder recorder;
+  SkCanvas* recording_canvas =
+      recorder.beginRecording(SkRect::Make(frame_size));
+  SkPaint paint;
+  paint.setAntiAlias(true);
+  for (int i = 0; i < columns * rows; i++) {
+    paint.setColor(SkColorSetRGB((i * 37) & 0xFF, (i * 11) & 0xFF, 0x80));
+    SkRect cell = SkRect::MakeXYWH((i % columns) * cell_width,
+                                   (i / columns) * cell_height, cell_width,
+                                   cell_height);
+    SkScalar inset = overlapping_shapes ? -4 : 4;
+    recording_canvas->drawRRect(
+        SkRRect::MakeRectXY(cell.makeInset(inset, inset), 12, 12), paint);
+  }
+  sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+  CompositorContext compositor_context(fml::kDefaultFrameBudget);
+  sk_sp<SkSurface> surface =
+      SkSurface::MakeRasterN32Premul(frame_size.width(), frame_size.height());
+  SaveLayerPixelCountingCanvas canvas(surface->getCanvas());
+  auto picture_layer = std::make_shared<PictureLayer>(
+      SkPoint::Make(0, 0), SkiaGPUObject<SkPicture>(picture, nullptr),
+      /* is_complex= */ false, /* will_change= */ false);
+
+  int64_t frames = 0;
+  while (state.KeepRunning()) {
+    SkAlpha alpha = static_cast<SkAlpha>(frames % 256);
+    LayerTree layer_tree(frame_size, 1.0f);
+    auto opacity_layer = std::make_shared<OpacityLayer>(alpha, SkPoint());
+    opacity_layer->Add(picture_layer);
+    auto root = std::make_shared<ContainerLayer>();
+    root->Add(opacity_layer);
+    layer_tree.set_root_layer(root);
+
+    auto scoped_frame = compositor_context.AcquireFrame(
+        nullptr, &canvas, nullptr, SkMatrix::I(), false, true, nullptr);
+    scoped_frame->Raster(layer_tree, /* ignore_raster_cache= */ true,
+                         nullptr);
+    frames++;
+  }
+
+  state.counters["SaveLayerPixelsPerFrame"] =
+      frames > 0 ? static_cast<double>(canvas.save_layer_pixels()) / frames
+                 : 0;
+}
+
+static void BM_OpacityFadeOfSeparateShapes(benchmark::State& state) {
+  OpacityFade(state, false);
+}
+
+BENCHMARK(BM_OpacityFadeOfSeparateShapes)->Unit(benchmark::kMicrosecond);
+
+static void BM_OpacityFadeOfOverlappingShapes(benchmark::State& state) {
+  OpacityFade(state, true);
+}
+
+BENCHMARK(BM_OpacityFadeOfOverlappingShapes)->Unit(benchmark::kMicrosecond);
+
+// Sends a stream of small platform messages to another thread, either with a
+// task per message or through a PlatformMessageBatcher, and reports the rate
+// and the delivery latency of the messages. Each message carries the time it
+// was sent at, like sensor events do.
+static void PlatformMessageStream(benchmark::State& state, bool batched) {
+  const int message_count = 10000;
+  const size_t message_size = 64;
+
+  fml::Thread ui_thread("io.flutter.bench.ui");
+  auto task_runner = ui_thread.GetTaskRunner();
+
+  // Only accessed on the UI thread while messages are in flight.
+  int delivered = 0;
+  double total_latency_us = 0;
+  double worst_latency_us = 0;
+  fml::AutoResetWaitableEvent all_delivered;
+  auto handle_message = [&](std::unique_ptr<PlatformMessage> message) {
+    int64_t sent_ns;
+    memcpy(&sent_ns, message->data().GetMapping(), sizeof(sent_ns));
+    fml::TimePoint sent = fml::TimePoint::FromEpochDelta(
+        fml::TimeDelta::FromNanoseconds(sent_ns));
+    fml::TimeDelta latency = fml::TimePoint::Now() - sent;
+    total_latency_us += latency.ToMicrosecondsF();
+    worst_latency_us = std::max(worst_latency_us, latency.ToMicrosecondsF());
+    if (++delivered == message_count) {
+      all_delivered.Signal();
+    }
+  };
+  auto batcher = PlatformMessageBatcher::Create(task_runner, handle_message);
+
+  int64_t messages = 0;
+  while (state.KeepRunning()) {
+    delivered = 0;
+    for (int i = 0; i < message_count; i++) {
+      uint8_t payload[message_size] = {};
+      int64_t sent_ns = fml::TimePoint::Now().ToEpochDelta().ToNanoseconds();
+      memcpy(payload, &sent_ns, sizeof(sent_ns));
+      auto message = std::make_unique<PlatformMessage>(
+          "sensors", fml::MallocMapping::Copy(payload, message_size), nullptr);
+      if (batched) {
+        batcher->AddMessage(std::move(message));
+      } else {
+        task_runner->PostTask(fml::MakeCopyable(
+            [&handle_message, message = std::move(message)]() mutable {
+              handle_message(std::move(message));
+            }));
+      }
+    }
+    all_delivered.Wait();
+    messages += message_count;
+  }
+
+  state.SetItemsProcessed(messages);
+  state.counters["MeanLatencyUs"] =
+      messages > 0 ? total_latency_us / messages : 0;
+  state.counters["WorstLatencyUs"] = worst_latency_us;
+}
+
+static void BM_PlatformMessageStreamUnbatched(benchmark::State& state) {
+  PlatformMessageStream(state, false);
+}
+
+BENCHMARK(BM_PlatformMessageStreamUnbatched)->Unit(benchmark::kMillisecond);
+
+static void BM_PlatformMessageStreamBatched(benchmark::State& state) {
+  PlatformMessageStream(state, true);
+}
+
+BENCHMARK(BM_PlatformMessageStreamBatched)->Unit(benchmark::kMillisecond);
+
 }  // namespace flutter
@@ -0,0 +1,174 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/staged_sksl_warmup.h"
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/time/time_point.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+struct StagedSkSLWarmUp::State {
+  State(fml::RefPtr<fml::TaskRunner> p_raster_task_runner,
+        fml::TimeDelta p_batch_budget)
+      : raster_task_runner(std::move(p_raster_task_runner)),
+        batch_budget(p_batch_budget) {}
+
+  const fml::RefPtr<fml::TaskRunner> raster_task_runner;
+  const fml::TimeDelta batch_budget;
+  // Set before the loader is started and not changed after.
+  size_t skip_count = 0;
+  // Only used on the raster task runner.
+  Compiler compiler;
+  size_t compiled_count = 0;
+  size_t successful_count = 0;
+  bool done = false;
+
+  // Set on the raster task runner, read by the loader on the IO task runner.
+  std::atomic<bool> cancelled = false;
+
+  std::mutex mutex;
+  std::deque<PersistentCache::SkSLCache> pending;
+  size_t loaded_count = 0;
+  bool loaded = false;
+  // Whether a |CompileBatch| task is posted. There is at most one at a time.
+  bool batch_scheduled = false;
+};
+
+StagedSkSLWarmUp::StagedSkSLWarmUp(
+    fml::RefPtr<fml::TaskRunner> raster_task_runner,
+    fml::RefPtr<fml::TaskRunner> io_task_runner,
+    fml::TimeDelta batch_budget)
+    : raster_task_runner_(std::move(raster_task_runner)),
+      io_task_runner_(std::move(io_task_runner)),
+      batch_budget_(batch_budget) {}
+
+StagedSkSLWarmUp::~StagedSkSLWarmUp() {
+  if (!state_) {
+    return;
+  }
+  FML_DCHECK(raster_task_runner_->RunsTasksOnCurrentThread());
+  state_->cancelled = true;
+  if (!state_->done) {
+    TRACE_EVENT_ASYNC_END0("flutter", "StagedSkSLWarmUp",
+                           reinterpret_cast<int64_t>(state_.get()));
+  }
+}
+
+void StagedSkSLWarmUp::Start(Compiler compiler, size_t skip_count) {
+  FML_DCHECK(raster_task_runner_->RunsTasksOnCurrentThread());
+  FML_DCHECK(!state_);
+  state_ = std::make_shared<State>(raster_task_runner_, batch_budget_);
+  state_->compiler = std::move(compiler);
+  state_->skip_count = skip_count;
+  TRACE_EVENT_ASYNC_BEGIN0("flutter", "StagedSkSLWarmUp",
+                           reinterpret_cast<int64_t>(state_.get()));
+  io_task_runner_->PostTask([state = state_] { LoadSkSLs(state); });
+}
+
+bool StagedSkSLWarmUp::IsDone() const {
+  return state_ && state_->done;
+}
+
+size_t StagedSkSLWarmUp::GetCompiledCount() const {
+  FML_DCHECK(raster_task_runner_->RunsTasksOnCurrentThread());
+  return state_ ? state_->skip_count + state_->compiled_count : 0;
+}
+
+void StagedSkSLWarmUp::LoadSkSLs(const std::shared_ptr<State>& state) {
+  TRACE_EVENT0("flutter", "StagedSkSLWarmUp::LoadSkSLs");
+  size_t skipped_count = 0;
+  PersistentCache::GetCacheForProcess()->VisitSkSLs(
+      [&state, &skipped_count](PersistentCache::SkSLCache sksl) {
+        if (state->cancelled) {
+          return false;
+        }
+        if (skipped_count < state->skip_count) {
+          skipped_count++;
+          return true;
+        }
+        std::scoped_lock lock(state->mutex);
+        state->pending.push_back(std::move(sksl));
+        state->loaded_count++;
+        ScheduleBatchLocked(state);
+        return true;
+      });
+  std::scoped_lock lock(state->mutex);
+  state->loaded = true;
+  ScheduleBatchLocked(state);
+}
+
+void StagedSkSLWarmUp::ScheduleBatchLocked(
+    const std::shared_ptr<State>& state) {
+  if (state->batch_scheduled) {
+    return;
+  }
+  state->batch_scheduled = true;
+  state->raster_task_runner->PostTask([state] { CompileBatch(state); });
+}
+
+void StagedSkSLWarmUp::CompileBatch(const std::shared_ptr<State>& state) {
+  if (state->cancelled) {
+    return;
+  }
+  TRACE_EVENT0("flutter", "StagedSkSLWarmUp::CompileBatch");
+  const fml::TimePoint start = fml::TimePoint::Now();
+  const size_t compiled_before = state->compiled_count;
+  size_t loaded_count;
+  while (!state->cancelled) {
+    PersistentCache::SkSLCache sksl;
+    {
+      std::scoped_lock lock(state->mutex);
+      loaded_count = state->loaded_count;
+      if (state->pending.empty()) {
+        // The loader schedules the next batch once it has loaded more SkSLs
+        // or reached the end.
+        state->batch_scheduled = false;
+        if (state->loaded) {
+          Finish(*state);
+        }
+        return;
+      }
+      if (state->compiled_count > compiled_before &&
+          fml::TimePoint::Now() - start >= state->batch_budget) {
+        // Leave the rest for a later task so that frames can be rasterized
+        // in between.
+        state->raster_task_runner->PostTask([state] { CompileBatch(state); });
+        break;
+      }
+      sksl = std::move(state->pending.front());
+      state->pending.pop_front();
+    }
+    TRACE_EVENT0("flutter", "PrecompilingSkSL");
+    if (state->compiler(sksl)) {
+      state->successful_count++;
+    }
+    state->compiled_count++;
+  }
+  FML_TRACE_COUNTER("flutter", "StagedSkSLWarmUp",
+                    reinterpret_cast<int64_t>(state.get()),  // Trace Counter ID
+                    "Loaded", loaded_count,                  //
+                    "Compiled", state->compiled_count,       //
+                    "Successful", state->successful_count);
+}
+
+void StagedSkSLWarmUp::Finish(State& state) {
+  FML_TRACE_COUNTER("flutter", "StagedSkSLWarmUp",
+                    reinterpret_cast<int64_t>(&state),  // Trace Counter ID
+                    "Loaded", state.loaded_count,       //
+                    "Compiled", state.compiled_count,   //
+                    "Successful", state.successful_count);
+  TRACE_EVENT_ASYNC_END0("flutter", "StagedSkSLWarmUp",
+                         reinterpret_cast<int64_t>(&state));
+  state.done = true;
+  FML_DLOG(INFO) << "Precompiled " << state.successful_count << " of "
+                 << state.compiled_count << " SkSLs.";
+}
+
+}  // namespace flutter
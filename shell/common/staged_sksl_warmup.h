@@ -0,0 +1,100 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_STAGED_SKSL_WARMUP_H_
+#define FLUTTER_SHELL_COMMON_STAGED_SKSL_WARMUP_H_
+
+#include <functional>
+#include <memory>
+
+#include "flutter/common/graphics/persistent_cache.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/task_runner.h"
+#include "flutter/fml/time/time_delta.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      Precompiles the SkSLs known to the persistent cache without
+///             stalling the first frames.
+///
+///             `PersistentCache::PrecompileKnownSkSLs` reads every SkSL and
+///             compiles all of them before the surface draws its first frame.
+///             With thousands of bundled shaders this delays startup
+///             noticeably. Instead, the staged warm-up reads the SkSLs on the
+///             IO task runner, in the order of `PersistentCache::VisitSkSLs`,
+///             and compiles them on the raster task runner in batches that
+///             stay within a time budget. Each batch is a separate task, so
+///             frames are rasterized between the batches.
+///
+///             The progress is reported to the timeline with the
+///             "StagedSkSLWarmUp" counter, and the time from the start of the
+///             warm-up to the last compilation as the async
+///             "StagedSkSLWarmUp" event.
+///
+///             This class must be created, started and destroyed on the
+///             raster task runner. Destroying it cancels the remaining work.
+///
+class StagedSkSLWarmUp {
+ public:
+  //----------------------------------------------------------------------------
+  /// @brief      Compiles the given SkSL on the raster task runner, returning
+  ///             whether the compilation succeeded.
+  ///
+  using Compiler = std::function<bool(const PersistentCache::SkSLCache& sksl)>;
+
+  static constexpr fml::TimeDelta kDefaultBatchBudget =
+      fml::TimeDelta::FromMilliseconds(4);
+
+  StagedSkSLWarmUp(fml::RefPtr<fml::TaskRunner> raster_task_runner,
+                   fml::RefPtr<fml::TaskRunner> io_task_runner,
+                   fml::TimeDelta batch_budget = kDefaultBatchBudget);
+
+  ~StagedSkSLWarmUp();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Starts loading the SkSLs of the persistent cache of the
+  ///             process and compiling them with `compiler`. May only be
+  ///             called once.
+  ///
+  /// @param[in]  compiler    Compiles each SkSL.
+  /// @param[in]  skip_count  The number of SkSLs at the start that are not
+  ///                         compiled, because an earlier warm-up for the
+  ///                         same context compiled them already.
+  ///
+  void Start(Compiler compiler, size_t skip_count = 0);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Whether every SkSL has been loaded and compiled.
+  ///
+  bool IsDone() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      The number of SkSLs compiled so far, including the skipped
+  ///             ones. A later warm-up can skip as many.
+  ///
+  size_t GetCompiledCount() const;
+
+ private:
+  struct State;
+
+  const fml::RefPtr<fml::TaskRunner> raster_task_runner_;
+  const fml::RefPtr<fml::TaskRunner> io_task_runner_;
+  const fml::TimeDelta batch_budget_;
+  std::shared_ptr<State> state_;
+
+  static void LoadSkSLs(const std::shared_ptr<State>& state);
+
+  static void CompileBatch(const std::shared_ptr<State>& state);
+
+  static void ScheduleBatchLocked(const std::shared_ptr<State>& state);
+
+  static void Finish(State& state);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(StagedSkSLWarmUp);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_STAGED_SKSL_WARMUP_H_
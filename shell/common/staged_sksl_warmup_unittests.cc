@@ -0,0 +1,195 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/staged_sksl_warmup.h"
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "flutter/assets/asset_manager.h"
+#include "flutter/assets/directory_asset_bundle.h"
+#include "flutter/fml/base32.h"
+#include "flutter/fml/file.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/thread.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+// Bundles SkSLs with the given keys with the application, in this order.
+class BundledSkSLs {
+ public:
+  explicit BundledSkSLs(const std::vector<std::string>& keys) {
+    PersistentCache::SetCacheDirectoryPath(cache_dir_.path());
+    PersistentCache::ResetCacheForProcess();
+
+    // "eA==" is the Base64 encoding of "x".
+    std::string json = "{\"data\": {";
+    for (size_t i = 0; i < keys.size(); ++i) {
+      json += (i == 0 ? "\"" : ", \"") + fml::Base32Encode(keys[i]).second +
+              "\": \"eA==\"";
+    }
+    json += "}}";
+    fml::WriteAtomically(asset_dir_.fd(), PersistentCache::kAssetFileName,
+                         fml::DataMapping(json));
+
+    auto asset_manager = std::make_shared<AssetManager>();
+    asset_manager->PushBack(std::make_unique<DirectoryAssetBundle>(
+        fml::OpenDirectory(asset_dir_.path().c_str(), false,
+                           fml::FilePermission::kRead),
+        false));
+    PersistentCache::SetAssetManager(asset_manager);
+  }
+
+  ~BundledSkSLs() {
+    PersistentCache::SetAssetManager(nullptr);
+    PersistentCache::SetCacheDirectoryPath("");
+    PersistentCache::ResetCacheForProcess();
+  }
+
+ private:
+  fml::ScopedTemporaryDirectory cache_dir_;
+  fml::ScopedTemporaryDirectory asset_dir_;
+};
+
+std::string KeyOf(const PersistentCache::SkSLCache& sksl) {
+  return std::string(reinterpret_cast<const char*>(sksl.first->data()),
+                     sksl.first->size());
+}
+
+void RunOn(const fml::RefPtr<fml::TaskRunner>& task_runner,
+           const std::function<void()>& task) {
+  fml::AutoResetWaitableEvent latch;
+  task_runner->PostTask([&task, &latch] {
+    task();
+    latch.Signal();
+  });
+  latch.Wait();
+}
+
+// Waits until the warm-up is done, returning false if it takes too long.
+bool WaitUntilDone(const fml::RefPtr<fml::TaskRunner>& raster_task_runner,
+                   const StagedSkSLWarmUp& warm_up) {
+  for (int i = 0; i < 500; ++i) {
+    bool done = false;
+    RunOn(raster_task_runner, [&] { done = warm_up.IsDone(); });
+    if (done) {
+      return true;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return false;
+}
+
+}  // namespace
+
+TEST(StagedSkSLWarmUpTest, CompilesBundledSkSLsInOrder) {
+  BundledSkSLs bundled({"c", "a", "b"});
+  fml::Thread raster_thread("raster");
+  fml::Thread io_thread("io");
+  auto raster_task_runner = raster_thread.GetTaskRunner();
+
+  std::unique_ptr<StagedSkSLWarmUp> warm_up;
+  std::vector<std::string> compiled;
+  RunOn(raster_task_runner, [&] {
+    warm_up = std::make_unique<StagedSkSLWarmUp>(raster_task_runner,
+                                                 io_thread.GetTaskRunner());
+    EXPECT_FALSE(warm_up->IsDone());
+    warm_up->Start([&compiled](const PersistentCache::SkSLCache& sksl) {
+      compiled.push_back(KeyOf(sksl));
+      return true;
+    });
+  });
+
+  ASSERT_TRUE(WaitUntilDone(raster_task_runner, *warm_up));
+  EXPECT_EQ(compiled, (std::vector<std::string>{"c", "a", "b"}));
+  RunOn(raster_task_runner, [&] { warm_up.reset(); });
+}
+
+TEST(StagedSkSLWarmUpTest, SkipsSkSLsCompiledByAnEarlierWarmUp) {
+  BundledSkSLs bundled({"a", "b", "c"});
+  fml::Thread raster_thread("raster");
+  fml::Thread io_thread("io");
+  auto raster_task_runner = raster_thread.GetTaskRunner();
+
+  std::unique_ptr<StagedSkSLWarmUp> warm_up;
+  std::vector<std::string> compiled;
+  RunOn(raster_task_runner, [&] {
+    warm_up = std::make_unique<StagedSkSLWarmUp>(raster_task_runner,
+                                                 io_thread.GetTaskRunner());
+    warm_up->Start(
+        [&compiled](const PersistentCache::SkSLCache& sksl) {
+          compiled.push_back(KeyOf(sksl));
+          return true;
+        },
+        2);
+  });
+
+  ASSERT_TRUE(WaitUntilDone(raster_task_runner, *warm_up));
+  EXPECT_EQ(compiled, (std::vector<std::string>{"c"}));
+  RunOn(raster_task_runner, [&] {
+    EXPECT_EQ(warm_up->GetCompiledCount(), 3u);
+    warm_up.reset();
+  });
+}
+
+TEST(StagedSkSLWarmUpTest, InterleavesBatchesWithOtherTasks) {
+  BundledSkSLs bundled({"a", "b", "c"});
+  fml::Thread raster_thread("raster");
+  fml::Thread io_thread("io");
+  auto raster_task_runner = raster_thread.GetTaskRunner();
+
+  // With no time budget, every batch compiles a single SkSL, so a task posted
+  // while compiling runs before the next SkSL is compiled.
+  std::unique_ptr<StagedSkSLWarmUp> warm_up;
+  std::vector<std::string> events;
+  RunOn(raster_task_runner, [&] {
+    warm_up = std::make_unique<StagedSkSLWarmUp>(
+        raster_task_runner, io_thread.GetTaskRunner(), fml::TimeDelta::Zero());
+    warm_up->Start([&](const PersistentCache::SkSLCache& sksl) {
+      events.push_back(KeyOf(sksl));
+      raster_task_runner->PostTask([&] { events.push_back("frame"); });
+      return true;
+    });
+  });
+
+  ASSERT_TRUE(WaitUntilDone(raster_task_runner, *warm_up));
+  EXPECT_EQ(events, (std::vector<std::string>{"a", "frame", "b", "frame", "c",
+                                              "frame"}));
+  RunOn(raster_task_runner, [&] { warm_up.reset(); });
+}
+
+TEST(StagedSkSLWarmUpTest, DestroyingCancelsCompilation) {
+  BundledSkSLs bundled({"a", "b", "c"});
+  fml::Thread raster_thread("raster");
+  fml::Thread io_thread("io");
+  auto raster_task_runner = raster_thread.GetTaskRunner();
+
+  std::unique_ptr<StagedSkSLWarmUp> warm_up;
+  size_t compiled_count = 0;
+  RunOn(raster_task_runner, [&] {
+    warm_up = std::make_unique<StagedSkSLWarmUp>(
+        raster_task_runner, io_thread.GetTaskRunner(), fml::TimeDelta::Zero());
+    warm_up->Start([&](const PersistentCache::SkSLCache& sksl) {
+      compiled_count++;
+      warm_up.reset();
+      return true;
+    });
+  });
+
+  // Let the loader and any scheduled batch run.
+  RunOn(io_thread.GetTaskRunner(), [] {});
+  RunOn(raster_task_runner, [] {});
+  RunOn(raster_task_runner, [] {});
+  EXPECT_EQ(compiled_count, 1u);
+  EXPECT_EQ(warm_up, nullptr);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -320,6 +320,15 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
 
   command_line.GetOptionValue(FlagForSwitch(Switch::FlutterAssetsDir),
                               &settings.assets_path);
+  command_line.GetOptionValue(FlagForSwitch(Switch::AssetPack),
+                              &settings.asset_pack_path);
+  if (command_line.HasOption(FlagForSwitch(Switch::AssetAccessTraceFrames))) {
+    std::string asset_access_trace_frames;
+    command_line.GetOptionValue(FlagForSwitch(Switch::AssetAccessTraceFrames),
+                                &asset_access_trace_frames);
+    settings.asset_access_trace_frame_count =
+        std::stoul(asset_access_trace_frames);
+  }
 
   std::vector<std::string_view> aot_shared_library_name =
       command_line.GetOptionValues(FlagForSwitch(Switch::AotSharedLibraryName));
@@ -389,6 +398,12 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
   settings.enable_skparagraph =
       command_line.HasOption(FlagForSwitch(Switch::EnableSkParagraph));
 
+  settings.enable_canvas_command_buffer = command_line.HasOption(
+      FlagForSwitch(Switch::EnableCanvasCommandBuffer));
+
+  settings.enable_pointer_event_coalescing = command_line.HasOption(
+      FlagForSwitch(Switch::EnablePointerEventCoalescing));
+
   std::string all_dart_flags;
   if (command_line.GetOptionValue(FlagForSwitch(Switch::DartFlags),
                                   &all_dart_flags)) {
@@ -412,6 +427,9 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
   settings.cache_sksl =
       command_line.HasOption(FlagForSwitch(Switch::CacheSkSL));
 
+  settings.staged_sksl_warm_up =
+      command_line.HasOption(FlagForSwitch(Switch::StagedSkSLWarmUp));
+
   settings.purge_persistent_cache =
       command_line.HasOption(FlagForSwitch(Switch::PurgePersistentCache));
 
@@ -421,6 +439,35 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
                                 &old_gen_heap_size);
     settings.old_gen_heap_size = std::stoi(old_gen_heap_size);
   }
+
+  if (command_line.HasOption(
+          FlagForSwitch(Switch::RasterCacheMaxRetainedBytes))) {
+    std::string raster_cache_max_retained_bytes;
+    command_line.GetOptionValue(
+        FlagForSwitch(Switch::RasterCacheMaxRetainedBytes),
+        &raster_cache_max_retained_bytes);
+    settings.raster_cache_max_retained_bytes =
+        std::stoull(raster_cache_max_retained_bytes);
+  }
+
+  settings.raster_cache_async_rasterization = command_line.HasOption(
+      FlagForSwitch(Switch::RasterCacheAsyncRasterization));
+  settings.raster_cache_persistent_images = command_line.HasOption(
+      FlagForSwitch(Switch::RasterCachePersistentImages));
+  settings.raster_cache_subtrees =
+      command_line.HasOption(FlagForSwitch(Switch::RasterCacheSubtrees));
+  settings.concurrent_preroll =
+      command_line.HasOption(FlagForSwitch(Switch::ConcurrentPreroll));
+
+  if (command_line.HasOption(
+          FlagForSwitch(Switch::DecodedImageCacheMaxBytes))) {
+    std::string decoded_image_cache_max_bytes;
+    command_line.GetOptionValue(
+        FlagForSwitch(Switch::DecodedImageCacheMaxBytes),
+        &decoded_image_cache_max_bytes);
+    settings.decoded_image_cache_max_bytes =
+        std::stoull(decoded_image_cache_max_bytes);
+  }
   return settings;
 }
 
@@ -109,6 +109,15 @@ DEF_SWITCH(SkiaDeterministicRendering,
 DEF_SWITCH(FlutterAssetsDir,
            "flutter-assets-dir",
            "Path to the Flutter assets directory.")
+DEF_SWITCH(AssetPack,
+           "asset-pack",
+           "Path to an asset pack built with the asset-pack tool. Assets are "
+           "looked up in the pack before the Flutter assets directory.")
+DEF_SWITCH(AssetAccessTraceFrames,
+           "asset-access-trace-frames",
+           "Record the assets requested during this many frames after launch "
+           "in the persistent cache, and prefetch the assets recorded by the "
+           "previous launch in the background.")
 DEF_SWITCH(Help, "help", "Display this help text.")
 DEF_SWITCH(LogTag, "log-tag", "Tag associated with log messages.")
 DEF_SWITCH(DisableServiceAuthCodes,
@@ -152,6 +161,11 @@ DEF_SWITCH(CacheSkSL,
            "should only be used during development phases. The generated SkSLs "
            "can later be used in the release build for shader precompilation "
            "at launch in order to eliminate the shader-compile jank.")
+DEF_SWITCH(StagedSkSLWarmUp,
+           "staged-sksl-warm-up",
+           "Load the SkSLs to precompile on the IO thread and compile them in "
+           "small batches between frames, instead of compiling all of them "
+           "before the first frame.")
 DEF_SWITCH(PurgePersistentCache,
            "purge-persistent-cache",
            "Remove all existing persistent cache. This is mainly for debugging "
@@ -203,9 +217,52 @@ DEF_SWITCH(
 DEF_SWITCH(OldGenHeapSize,
            "old-gen-heap-size",
            "The size limit in megabytes for the Dart VM old gen heap space.")
+DEF_SWITCH(RasterCacheMaxRetainedBytes,
+           "raster-cache-max-retained-bytes",
+           "The byte budget for raster cache entries that are kept across "
+           "frames while unused. Entries are evicted in least recently used "
+           "order once the budget is exceeded. Defaults to 0, which evicts "
+           "entries as soon as they are not used for a frame.")
+DEF_SWITCH(RasterCacheAsyncRasterization,
+           "raster-cache-async-rasterization",
+           "Rasterize raster cache pictures on worker threads instead of the "
+           "raster thread. Pictures are drawn directly until their cached "
+           "image is ready.")
+DEF_SWITCH(RasterCacheSubtrees,
+           "raster-cache-subtrees",
+           "Rasterize layer subtrees that are retained across frames once and "
+           "draw them from the raster cache while only their translation "
+           "changes. The performance overlay shows how many subtrees were "
+           "drawn from the cache.")
+DEF_SWITCH(ConcurrentPreroll,
+           "concurrent-preroll",
+           "Preroll the children of container layers on worker threads as "
+           "well as on the raster thread. Raster cache updates and platform "
+           "views are still handled on the raster thread, in order.")
+DEF_SWITCH(RasterCachePersistentImages,
+           "raster-cache-persistent-images",
+           "Store pictures cached by the raster cache in the persistent cache, "
+           "so that later runs of the application can draw them without "
+           "rasterizing them first.")
+DEF_SWITCH(DecodedImageCacheMaxBytes,
+           "decoded-image-cache-max-bytes",
+           "The byte budget for decoded images that are kept so that decoding "
+           "the same image at the same size again skips decompression. "
+           "Defaults to 0, which disables the cache.")
 DEF_SWITCH(EnableSkParagraph,
            "enable-skparagraph",
            "Selects the SkParagraph implementation of the text layout engine.")
+DEF_SWITCH(EnableCanvasCommandBuffer,
+           "enable-canvas-command-buffer",
+           "Records the draw operations of dart:ui Canvas objects into a "
+           "command buffer that is replayed with one native call per flush, "
+           "instead of making a native call for each of them.")
+DEF_SWITCH(EnablePointerEventCoalescing,
+           "enable-pointer-event-coalescing",
+           "Merges the pointer move and hover events received within a frame "
+           "into one event per pointer before dispatching them to the "
+           "framework. Useful for input devices that report at a much higher "
+           "rate than the display refreshes.")
 
 DEF_SWITCHES_END
 
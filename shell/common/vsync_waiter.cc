@@ -128,7 +128,7 @@ void VsyncWaiter::FireCallback(fml::TimePoint frame_start_time,
 
     TRACE_FLOW_BEGIN("flutter", kVsyncFlowName, flow_identifier);
 
-    task_runners_.GetUITaskRunner()->PostTaskForTime(
+    fml::closure frame_task =
         [this, callback, flow_identifier, frame_start_time, frame_target_time,
          pause_secondary_tasks]() {
           FML_TRACE_EVENT("flutter", kVsyncTraceName, "StartTime",
@@ -142,8 +142,16 @@ void VsyncWaiter::FireCallback(fml::TimePoint frame_start_time,
           if (pause_secondary_tasks) {
             ResumeDartMicroTasks();
           }
-        },
-        frame_start_time);
+        };
+#ifdef OS_FUCHSIA
+    task_runners_.GetUITaskRunner()->PostTaskForTime(frame_task,
+                                                     frame_start_time);
+#else
+    // Producing the frame runs ahead of the other tasks that are due.
+    fml::MessageLoopTaskQueues::GetInstance()->RegisterTask(
+        task_runners_.GetUITaskRunner()->GetTaskQueueId(), frame_task,
+        frame_start_time, fml::TaskSourceGrade::kUserInteraction);
+#endif
   }
 
   for (auto& secondary_callback : secondary_callbacks) {
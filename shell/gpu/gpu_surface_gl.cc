@@ -34,6 +34,10 @@ static const int kGrCacheMaxCount = 8192;
 // system channel.
 static const size_t kGrCacheMaxByteSize = 24 * (1 << 20);
 
+// The number of presented frames whose damage is remembered. Framebuffers that
+// are older than that are repainted entirely.
+static const size_t kMaxDamageHistorySize = 4;
+
 sk_sp<GrDirectContext> GPUSurfaceGL::MakeGLContext(
     GPUSurfaceGLDelegate* delegate) {
   auto context_switch = delegate->GLContextMakeCurrent();
@@ -184,6 +188,7 @@ bool GPUSurfaceGL::CreateOrUpdateSurfaces(const SkISize& size) {
   // Either way, we need to get rid of previous surface.
   onscreen_surface_ = nullptr;
   fbo_id_ = 0;
+  damage_history_.clear();
 
   if (size.isEmpty()) {
     FML_LOG(ERROR) << "Cannot create surfaces of empty size.";
@@ -252,16 +257,42 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceGL::AcquireFrame(const SkISize& size) {
   SurfaceFrame::SubmitCallback submit_callback =
       [weak = weak_factory_.GetWeakPtr()](const SurfaceFrame& surface_frame,
                                           SkCanvas* canvas) {
-        return weak ? weak->PresentSurface(canvas) : false;
+        return weak ? weak->PresentSurface(surface_frame, canvas) : false;
       };
 
-  return std::make_unique<SurfaceFrame>(
+  auto frame = std::make_unique<SurfaceFrame>(
       surface, delegate_->SurfaceSupportsReadback(), submit_callback,
       std::move(context_switch));
+
+  if (delegate_->SurfaceSupportsPartialRepaint()) {
+    SurfaceFrame::FramebufferInfo framebuffer_info;
+    framebuffer_info.supports_partial_repaint = true;
+    framebuffer_info.existing_damage =
+        ExistingDamage(delegate_->GLContextFBOBufferAge());
+    frame->set_framebuffer_info(framebuffer_info);
+  }
+
+  return frame;
+}
+
+std::optional<SkIRect> GPUSurfaceGL::ExistingDamage(int buffer_age) const {
+  if (buffer_age <= 0 ||
+      static_cast<size_t>(buffer_age - 1) > damage_history_.size()) {
+    return std::nullopt;
+  }
+  SkIRect existing_damage = SkIRect::MakeEmpty();
+  for (auto i = damage_history_.end() - (buffer_age - 1);
+       i != damage_history_.end(); ++i) {
+    existing_damage.join(*i);
+  }
+  return existing_damage;
 }
 
-bool GPUSurfaceGL::PresentSurface(SkCanvas* canvas) {
+bool GPUSurfaceGL::PresentSurface(const SurfaceFrame& frame, SkCanvas* canvas) {
   if (delegate_ == nullptr || canvas == nullptr || context_ == nullptr) {
+    // The frame may have been partially rendered before it was dropped, so the
+    // contents of the framebuffer are no longer known.
+    damage_history_.clear();
     return false;
   }
 
@@ -270,7 +301,40 @@ bool GPUSurfaceGL::PresentSurface(SkCanvas* canvas) {
     onscreen_surface_->getCanvas()->flush();
   }
 
-  if (!delegate_->GLContextPresent(fbo_id_)) {
+  const auto& submit_info = frame.submit_info();
+  const SkIRect surface_rect = SkIRect::MakeWH(onscreen_surface_->width(),
+                                               onscreen_surface_->height());
+
+  // The damage history is kept in the coordinates of the layer tree, which
+  // is what the rasterizer expects the existing damage in.
+  if (submit_info.frame_damage) {
+    damage_history_.push_back(*submit_info.frame_damage);
+    if (damage_history_.size() > kMaxDamageHistorySize) {
+      damage_history_.pop_front();
+    }
+  } else {
+    // The whole frame changed, so older framebuffers differ from it entirely.
+    damage_history_.clear();
+  }
+
+  auto to_framebuffer_rect =
+      [&](const std::optional<SkIRect>& rect) -> std::optional<SkIRect> {
+    if (!rect) {
+      return std::nullopt;
+    }
+    SkIRect framebuffer_rect =
+        GetRootTransformation().mapRect(SkRect::Make(*rect)).roundOut();
+    if (!framebuffer_rect.intersect(surface_rect)) {
+      return SkIRect::MakeEmpty();
+    }
+    return framebuffer_rect;
+  };
+
+  GLPresentInfo present_info;
+  present_info.fbo_id = fbo_id_;
+  present_info.frame_damage = to_framebuffer_rect(submit_info.frame_damage);
+  present_info.buffer_damage = to_framebuffer_rect(submit_info.buffer_damage);
+  if (!delegate_->GLContextPresent(present_info)) {
     return false;
   }
 
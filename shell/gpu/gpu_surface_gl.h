@@ -5,8 +5,10 @@
 #ifndef SHELL_GPU_GPU_SURFACE_GL_H_
 #define SHELL_GPU_GPU_SURFACE_GL_H_
 
+#include <deque>
 #include <functional>
 #include <memory>
+#include <optional>
 
 #include "flutter/common/graphics/gl_context_switch.h"
 #include "flutter/flow/embedded_views.h"
@@ -56,6 +58,9 @@ class GPUSurfaceGL : public Surface {
   sk_sp<SkSurface> onscreen_surface_;
   /// FBO backing the current `onscreen_surface_`.
   uint32_t fbo_id_ = 0;
+  // The frame damage of the most recently presented frames, newest last. Used
+  // to compute the existing damage of a framebuffer from its buffer age.
+  std::deque<SkIRect> damage_history_;
   bool context_owner_ = false;
   // TODO(38466): Refactor GPU surface APIs take into account the fact that an
   // external view embedder may want to render to the root surface. This is a
@@ -71,7 +76,12 @@ class GPUSurfaceGL : public Surface {
       const SkISize& untransformed_size,
       const SkMatrix& root_surface_transformation);
 
-  bool PresentSurface(SkCanvas* canvas);
+  // Returns the area in which a framebuffer that was last presented
+  // |buffer_age| frames ago differs from the previous frame, or nullopt if
+  // that is unknown.
+  std::optional<SkIRect> ExistingDamage(int buffer_age) const;
+
+  bool PresentSurface(const SurfaceFrame& frame, SkCanvas* canvas);
 
   FML_DISALLOW_COPY_AND_ASSIGN(GPUSurfaceGL);
 };
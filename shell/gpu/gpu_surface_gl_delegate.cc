@@ -20,6 +20,14 @@ bool GPUSurfaceGLDelegate::SurfaceSupportsReadback() const {
   return true;
 }
 
+bool GPUSurfaceGLDelegate::SurfaceSupportsPartialRepaint() const {
+  return false;
+}
+
+int GPUSurfaceGLDelegate::GLContextFBOBufferAge() const {
+  return 0;
+}
+
 SkMatrix GPUSurfaceGLDelegate::GLContextSurfaceTransformation() const {
   SkMatrix matrix;
   matrix.setIdentity();
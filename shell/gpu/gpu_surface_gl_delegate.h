@@ -5,6 +5,8 @@
 #ifndef FLUTTER_SHELL_GPU_GPU_SURFACE_GL_DELEGATE_H_
 #define FLUTTER_SHELL_GPU_GPU_SURFACE_GL_DELEGATE_H_
 
+#include <optional>
+
 #include "flutter/common/graphics/gl_context_switch.h"
 #include "flutter/flow/embedded_views.h"
 #include "flutter/fml/macros.h"
@@ -20,6 +22,21 @@ struct GLFrameInfo {
   uint32_t height;
 };
 
+// Information passed to the delegate when presenting a frame. All rects are in
+// the coordinates of the framebuffer, with the origin at the top left.
+struct GLPresentInfo {
+  uint32_t fbo_id;
+
+  // The area of the frame that changed since the previously presented frame.
+  // Only this area needs to be updated on screen. If not set, the whole frame
+  // changed.
+  std::optional<SkIRect> frame_damage;
+
+  // The area of the framebuffer that was repainted for this frame. If not set,
+  // the whole framebuffer was repainted.
+  std::optional<SkIRect> buffer_damage;
+};
+
 class GPUSurfaceGLDelegate {
  public:
   ~GPUSurfaceGLDelegate();
@@ -33,7 +50,7 @@ class GPUSurfaceGLDelegate {
 
   // Called to present the main GL surface. This is only called for the main GL
   // context and not any of the contexts dedicated for IO.
-  virtual bool GLContextPresent(uint32_t fbo_id) = 0;
+  virtual bool GLContextPresent(const GLPresentInfo& present_info) = 0;
 
   // The ID of the main window bound framebuffer. Typically FBO0.
   virtual intptr_t GLContextFBO(GLFrameInfo frame_info) const = 0;
@@ -49,6 +66,19 @@ class GPUSurfaceGLDelegate {
   // circumstances such as a BackdropFilter.
   virtual bool SurfaceSupportsReadback() const;
 
+  // Indicates whether or not painting may be restricted to the area of the
+  // frame that changed since the last frame. If true, the damage of each frame
+  // is passed to GLContextPresent and GLContextFBOBufferAge is called before
+  // rendering each frame.
+  virtual bool SurfaceSupportsPartialRepaint() const;
+
+  // The number of frames since the contents of the main window bound
+  // framebuffer were last presented, as reported by EGL_EXT_buffer_age. That
+  // is 1 if the framebuffer contains the previous frame, 2 if it contains the
+  // frame before that and so on. 0 means that the contents are undefined and
+  // the whole frame is repainted.
+  virtual int GLContextFBOBufferAge() const;
+
   // A transformation applied to the onscreen surface before the canvas is
   // flushed.
   virtual SkMatrix GLContextSurfaceTransformation() const;
@@ -60,16 +60,37 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceSoftware::AcquireFrame(
       [self = weak_factory_.GetWeakPtr()](const SurfaceFrame& surface_frame,
                                           SkCanvas* canvas) -> bool {
     // If the surface itself went away, there is nothing more to do.
-    if (!self || !self->IsValid() || canvas == nullptr) {
+    if (!self || !self->IsValid()) {
+      return false;
+    }
+
+    if (canvas == nullptr) {
+      // The frame may have been partially rendered before it was dropped, so
+      // the contents of the backing store are no longer known.
+      self->last_backing_store_ = nullptr;
       return false;
     }
 
     canvas->flush();
+    self->last_backing_store_ = surface_frame.SkiaSurface();
 
+    const auto& frame_damage = surface_frame.submit_info().frame_damage;
+    if (frame_damage) {
+      return self->delegate_->PresentBackingStoreDamage(
+          surface_frame.SkiaSurface(), *frame_damage);
+    }
     return self->delegate_->PresentBackingStore(surface_frame.SkiaSurface());
   };
 
-  return std::make_unique<SurfaceFrame>(backing_store, true, on_submit);
+  SurfaceFrame::FramebufferInfo framebuffer_info;
+  framebuffer_info.supports_partial_repaint = true;
+  if (backing_store == last_backing_store_) {
+    framebuffer_info.existing_damage = SkIRect::MakeEmpty();
+  }
+
+  auto frame = std::make_unique<SurfaceFrame>(backing_store, true, on_submit);
+  frame->set_framebuffer_info(framebuffer_info);
+  return frame;
 }
 
 // |Surface|
@@ -38,6 +38,10 @@ class GPUSurfaceSoftware : public Surface {
   // hack to make avoid allocating resources for the root surface when an
   // external view embedder is present.
   const bool render_to_surface_;
+  // The backing store that the last frame was rendered into. If the delegate
+  // hands out the same backing store again, it still holds that frame and only
+  // the damage of the next frame needs to be repainted.
+  sk_sp<SkSurface> last_backing_store_;
   fml::TaskRunnerAffineWeakPtrFactory<GPUSurfaceSoftware> weak_factory_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(GPUSurfaceSoftware);
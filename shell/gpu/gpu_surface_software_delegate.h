@@ -48,6 +48,24 @@ class GPUSurfaceSoftwareDelegate {
   ///             the screen.
   ///
   virtual bool PresentBackingStore(sk_sp<SkSurface> backing_store) = 0;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Called by the platform instead of |PresentBackingStore| when
+  ///             only part of the backing store changed since the previously
+  ///             presented frame. The platform only needs to update that area
+  ///             on-screen. The default implementation presents the entire
+  ///             backing store.
+  ///
+  /// @param[in]  backing_store  The software backing store to present.
+  /// @param[in]  damage         The area of the backing store that changed,
+  ///                            with the origin at the top left. May be
+  ///                            empty if nothing changed.
+  ///
+  /// @return     Returns if the platform could present the backing store onto
+  ///             the screen.
+  ///
+  virtual bool PresentBackingStoreDamage(sk_sp<SkSurface> backing_store,
+                                         const SkIRect& damage);
 };
 
 }  // namespace flutter
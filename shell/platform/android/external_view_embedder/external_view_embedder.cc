@@ -114,7 +114,7 @@ void AndroidExternalViewEmbedder::SubmitFrame(
       int64_t current_view_id = composition_order_[j];
       SkRect current_view_rect = GetViewRect(current_view_id);
       // Each rect corresponds to a native view that renders Flutter UI.
-      std::list<SkRect> intersection_rects =
+      std::vector<SkRect> intersection_rects =
           rtree->searchNonOverlappingDrawnRects(current_view_rect);
 
       // Limit the number of native views, so it doesn't grow forever.
@@ -36,6 +36,9 @@ class BinaryMessengerImpl : public BinaryMessenger {
   void SetMessageHandler(const std::string& channel,
                          BinaryMessageHandler handler) override;
 
+  // |flutter::BinaryMessenger|
+  void SetChannelBatched(const std::string& channel, bool batched) override;
+
  private:
   // Handle for interacting with the C API.
   FlutterDesktopMessengerRef messenger_;
@@ -111,6 +111,11 @@ void BinaryMessengerImpl::SetMessageHandler(const std::string& channel,
                                      ForwardToHandler, message_handler);
 }
 
+void BinaryMessengerImpl::SetChannelBatched(const std::string& channel,
+                                            bool batched) {
+  FlutterDesktopMessengerSetBatched(messenger_, channel.c_str(), batched);
+}
+
 // ========== engine_method_result.h ==========
 
 namespace internal {
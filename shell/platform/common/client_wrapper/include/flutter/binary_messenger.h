@@ -45,6 +45,14 @@ class BinaryMessenger {
   // existing handler.
   virtual void SetMessageHandler(const std::string& channel,
                                  BinaryMessageHandler handler) = 0;
+
+  // Sets whether messages on the specified channel are delivered in batches
+  // rather than with a task per message, in both directions. Batching is meant
+  // for channels that send many messages per frame. Messages on a batched
+  // channel stay in order, but may overtake messages on other channels.
+  //
+  // Messengers that do not support batching ignore this.
+  virtual void SetChannelBatched(const std::string& channel, bool batched) {}
 };
 
 }  // namespace flutter
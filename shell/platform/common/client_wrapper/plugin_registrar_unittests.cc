@@ -5,6 +5,7 @@
 #include "flutter/shell/platform/common/client_wrapper/include/flutter/plugin_registrar.h"
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "flutter/shell/platform/common/client_wrapper/testing/stub_flutter_api.h"
@@ -40,6 +41,12 @@ class TestApi : public testing::StubFlutterApi {
     last_message_callback_set_ = callback;
   }
 
+  bool MessengerSetBatched(const char* channel, bool batched) override {
+    last_batched_channel_ = channel;
+    last_batched_ = batched;
+    return true;
+  }
+
   void PluginRegistrarSetDestructionHandler(
       FlutterDesktopOnPluginRegistrarDestroyed callback) override {
     last_destruction_callback_set_ = callback;
@@ -52,12 +59,16 @@ class TestApi : public testing::StubFlutterApi {
   FlutterDesktopOnPluginRegistrarDestroyed last_destruction_callback_set() {
     return last_destruction_callback_set_;
   }
+  const std::string& last_batched_channel() { return last_batched_channel_; }
+  bool last_batched() { return last_batched_; }
 
  private:
   const uint8_t* last_data_sent_ = nullptr;
   FlutterDesktopMessageCallback last_message_callback_set_ = nullptr;
   FlutterDesktopOnPluginRegistrarDestroyed last_destruction_callback_set_ =
       nullptr;
+  std::string last_batched_channel_;
+  bool last_batched_ = false;
 };
 
 // A PluginRegistrar whose destruction can be watched for by tests.
@@ -155,6 +166,25 @@ TEST(PluginRegistrarTest, MessengerSetMessageHandler) {
   EXPECT_EQ(test_api->last_message_callback_set(), nullptr);
 }
 
+// Tests that the registrar returns a messenger that passes channel batching
+// through to the C API.
+TEST(PluginRegistrarTest, MessengerSetChannelBatched) {
+  testing::ScopedStubFlutterApi scoped_api_stub(std::make_unique<TestApi>());
+  auto test_api = static_cast<TestApi*>(scoped_api_stub.stub());
+
+  auto dummy_registrar_handle =
+      reinterpret_cast<FlutterDesktopPluginRegistrarRef>(1);
+  PluginRegistrar registrar(dummy_registrar_handle);
+  BinaryMessenger* messenger = registrar.messenger();
+
+  messenger->SetChannelBatched("sensors", true);
+  EXPECT_EQ(test_api->last_batched_channel(), "sensors");
+  EXPECT_TRUE(test_api->last_batched());
+
+  messenger->SetChannelBatched("sensors", false);
+  EXPECT_FALSE(test_api->last_batched());
+}
+
 // Tests that the registrar manager returns the same instance when getting
 // the wrapper for the same reference.
 TEST(PluginRegistrarTest, ManagerSameInstance) {
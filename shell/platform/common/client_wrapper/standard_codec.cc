@@ -75,6 +75,95 @@ EncodedType EncodedTypeForValue(const EncodableValue& value) {
   return EncodedType::kNull;
 }
 
+// Returns |offset| rounded up to the next multiple of |alignment|.
+size_t AlignOffset(size_t offset, size_t alignment) {
+  size_t mod = offset % alignment;
+  return mod ? offset + alignment - mod : offset;
+}
+
+// Returns the number of bytes used by the variable-length encoding of |size|.
+size_t EncodedSizeLength(size_t size) {
+  if (size < 254) {
+    return 1;
+  }
+  return size <= 0xffff ? 3 : 5;
+}
+
+// The number of container levels EncodedEndOffset looks into. Walking deep
+// trees of small maps costs more than the buffer growth it would save, while
+// the large payloads worth pre-sizing for are typed lists near the top.
+constexpr int kEncodedSizeMaxDepth = 2;
+
+// Returns the offset at which the encoding of |value| ends when it is written
+// starting at |offset|, including any alignment padding.
+//
+// Custom values are counted as their type byte alone, since their encoding is
+// up to the serializer extension, and lists and maps nested more than
+// |depth| levels down are counted as their header alone. The result is
+// therefore a lower bound, only meant to size buffers ahead of encoding.
+size_t EncodedEndOffset(const EncodableValue& value,
+                        size_t offset,
+                        int depth = kEncodedSizeMaxDepth) {
+  // Type byte.
+  offset += 1;
+  switch (value.index()) {
+    case 0:
+    case 1:
+      return offset;
+    case 2:
+      return offset + 4;
+    case 3:
+      return offset + 8;
+    case 4:
+      return AlignOffset(offset, 8) + 8;
+    case 5: {
+      size_t size = std::get<std::string>(value).size();
+      return offset + EncodedSizeLength(size) + size;
+    }
+    case 6: {
+      size_t count = std::get<std::vector<uint8_t>>(value).size();
+      return offset + EncodedSizeLength(count) + count;
+    }
+    case 7: {
+      size_t count = std::get<std::vector<int32_t>>(value).size();
+      offset += EncodedSizeLength(count);
+      return count ? AlignOffset(offset, 4) + count * 4 : offset;
+    }
+    case 8: {
+      size_t count = std::get<std::vector<int64_t>>(value).size();
+      offset += EncodedSizeLength(count);
+      return count ? AlignOffset(offset, 8) + count * 8 : offset;
+    }
+    case 9: {
+      size_t count = std::get<std::vector<double>>(value).size();
+      offset += EncodedSizeLength(count);
+      return count ? AlignOffset(offset, 8) + count * 8 : offset;
+    }
+    case 10: {
+      const auto& list = std::get<EncodableList>(value);
+      offset += EncodedSizeLength(list.size());
+      if (depth > 0) {
+        for (const auto& item : list) {
+          offset = EncodedEndOffset(item, offset, depth - 1);
+        }
+      }
+      return offset;
+    }
+    case 11: {
+      const auto& map = std::get<EncodableMap>(value);
+      offset += EncodedSizeLength(map.size());
+      if (depth > 0) {
+        for (const auto& pair : map) {
+          offset = EncodedEndOffset(pair.first, offset, depth - 1);
+          offset = EncodedEndOffset(pair.second, offset, depth - 1);
+        }
+      }
+      return offset;
+    }
+  }
+  return offset;
+}
+
 }  // namespace
 
 StandardCodecSerializer::StandardCodecSerializer() = default;
@@ -181,7 +270,7 @@ EncodableValue StandardCodecSerializer::ReadValueOfType(
       std::string string_value;
       string_value.resize(size);
       stream->ReadBytes(reinterpret_cast<uint8_t*>(&string_value[0]), size);
-      return EncodableValue(string_value);
+      return EncodableValue(std::move(string_value));
     }
     case EncodedType::kUInt8List:
       return ReadVector<uint8_t>(stream);
@@ -198,7 +287,7 @@ EncodableValue StandardCodecSerializer::ReadValueOfType(
       for (size_t i = 0; i < length; ++i) {
         list_value.push_back(ReadValue(stream));
       }
-      return EncodableValue(list_value);
+      return EncodableValue(std::move(list_value));
     }
     case EncodedType::kMap: {
       size_t length = ReadSize(stream);
@@ -208,7 +297,7 @@ EncodableValue StandardCodecSerializer::ReadValueOfType(
         EncodableValue value = ReadValue(stream);
         map_value.emplace(std::move(key), std::move(value));
       }
-      return EncodableValue(map_value);
+      return EncodableValue(std::move(map_value));
     }
   }
   std::cerr << "Unknown type in StandardCodecSerializer::ReadValueOfType: "
@@ -258,11 +347,11 @@ EncodableValue StandardCodecSerializer::ReadVector(
   }
   stream->ReadBytes(reinterpret_cast<uint8_t*>(vector.data()),
                     count * type_size);
-  return EncodableValue(vector);
+  return EncodableValue(std::move(vector));
 }
 
 template <typename T>
-void StandardCodecSerializer::WriteVector(const std::vector<T> vector,
+void StandardCodecSerializer::WriteVector(const std::vector<T>& vector,
                                           ByteStreamWriter* stream) const {
   size_t count = vector.size();
   WriteSize(count, stream);
@@ -285,8 +374,8 @@ const StandardMessageCodec& StandardMessageCodec::GetInstance(
   if (!serializer) {
     serializer = &StandardCodecSerializer::GetInstance();
   }
-  auto* sInstances = new std::map<const StandardCodecSerializer*,
-                                  std::unique_ptr<StandardMessageCodec>>;
+  static auto* sInstances = new std::map<const StandardCodecSerializer*,
+                                         std::unique_ptr<StandardMessageCodec>>;
   auto it = sInstances->find(serializer);
   if (it == sInstances->end()) {
     // Uses new due to private constructor (to prevent API clients from
@@ -316,6 +405,7 @@ std::unique_ptr<std::vector<uint8_t>>
 StandardMessageCodec::EncodeMessageInternal(
     const EncodableValue& message) const {
   auto encoded = std::make_unique<std::vector<uint8_t>>();
+  encoded->reserve(EncodedEndOffset(message, 0));
   ByteBufferStreamWriter stream(encoded.get());
   serializer_->WriteValue(message, &stream);
   return encoded;
@@ -329,8 +419,8 @@ const StandardMethodCodec& StandardMethodCodec::GetInstance(
   if (!serializer) {
     serializer = &StandardCodecSerializer::GetInstance();
   }
-  auto* sInstances = new std::map<const StandardCodecSerializer*,
-                                  std::unique_ptr<StandardMethodCodec>>;
+  static auto* sInstances = new std::map<const StandardCodecSerializer*,
+                                         std::unique_ptr<StandardMethodCodec>>;
   auto it = sInstances->find(serializer);
   if (it == sInstances->end()) {
     // Uses new due to private constructor (to prevent API clients from
@@ -369,9 +459,15 @@ StandardMethodCodec::DecodeMethodCallInternal(const uint8_t* message,
 std::unique_ptr<std::vector<uint8_t>>
 StandardMethodCodec::EncodeMethodCallInternal(
     const MethodCall<EncodableValue>& method_call) const {
+  EncodableValue method_name(method_call.method_name());
+  size_t encoded_size = EncodedEndOffset(method_name, 0);
+  if (method_call.arguments()) {
+    encoded_size = EncodedEndOffset(*method_call.arguments(), encoded_size);
+  }
   auto encoded = std::make_unique<std::vector<uint8_t>>();
+  encoded->reserve(encoded_size + 1);
   ByteBufferStreamWriter stream(encoded.get());
-  serializer_->WriteValue(EncodableValue(method_call.method_name()), &stream);
+  serializer_->WriteValue(method_name, &stream);
   if (method_call.arguments()) {
     serializer_->WriteValue(*method_call.arguments(), &stream);
   } else {
@@ -384,6 +480,7 @@ std::unique_ptr<std::vector<uint8_t>>
 StandardMethodCodec::EncodeSuccessEnvelopeInternal(
     const EncodableValue* result) const {
   auto encoded = std::make_unique<std::vector<uint8_t>>();
+  encoded->reserve(result ? EncodedEndOffset(*result, 1) : 2);
   ByteBufferStreamWriter stream(encoded.get());
   stream.WriteByte(0);
   if (result) {
@@ -0,0 +1,124 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/shell/platform/common/client_wrapper/include/flutter/standard_message_codec.h"
+#include "flutter/shell/platform/common/client_wrapper/include/flutter/standard_method_codec.h"
+
+namespace flutter {
+
+namespace {
+
+// A list of |count| doubles, as sent for sampled sensor or chart data.
+EncodableValue CreateFloat64List(size_t count) {
+  std::vector<double> values(count);
+  for (size_t i = 0; i < count; ++i) {
+    values[i] = std::sin(static_cast<double>(i));
+  }
+  return EncodableValue(std::move(values));
+}
+
+// A list of |count| 32-bit ints, as sent for index or pixel data.
+EncodableValue CreateInt32List(size_t count) {
+  std::vector<int32_t> values(count);
+  for (size_t i = 0; i < count; ++i) {
+    values[i] = static_cast<int32_t>(i * 7919);
+  }
+  return EncodableValue(std::move(values));
+}
+
+// A tree of maps |depth| levels deep with |fanout| children per level, whose
+// leaves mix the scalar types a typical plugin reply contains.
+EncodableValue CreateNestedMap(int depth, int fanout) {
+  EncodableMap map;
+  map[EncodableValue("id")] = EncodableValue(depth * 1000 + fanout);
+  map[EncodableValue("name")] = EncodableValue("node_" + std::to_string(depth));
+  map[EncodableValue("enabled")] = EncodableValue(depth % 2 == 0);
+  map[EncodableValue("scale")] = EncodableValue(1.0 / (depth + 1));
+  map[EncodableValue("timestamp")] =
+      EncodableValue(static_cast<int64_t>(1600000000000ll + depth));
+  if (depth > 0) {
+    EncodableList children;
+    for (int i = 0; i < fanout; ++i) {
+      children.push_back(CreateNestedMap(depth - 1, fanout));
+    }
+    map[EncodableValue("children")] = EncodableValue(std::move(children));
+  }
+  return EncodableValue(std::move(map));
+}
+
+void EncodeMessage(benchmark::State& state, const EncodableValue& value) {
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  size_t bytes = 0;
+  while (state.KeepRunning()) {
+    auto encoded = codec.EncodeMessage(value);
+    bytes += encoded->size();
+    benchmark::DoNotOptimize(encoded->data());
+  }
+  state.SetBytesProcessed(bytes);
+}
+
+void DecodeMessage(benchmark::State& state, const EncodableValue& value) {
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  auto encoded = codec.EncodeMessage(value);
+  size_t bytes = 0;
+  while (state.KeepRunning()) {
+    auto decoded = codec.DecodeMessage(*encoded);
+    bytes += encoded->size();
+    benchmark::DoNotOptimize(decoded.get());
+  }
+  state.SetBytesProcessed(bytes);
+}
+
+}  // namespace
+
+static void BM_EncodeFloat64List(benchmark::State& state) {
+  EncodeMessage(state, CreateFloat64List(state.range(0)));
+}
+BENCHMARK(BM_EncodeFloat64List)->Arg(100)->Arg(10000);
+
+static void BM_DecodeFloat64List(benchmark::State& state) {
+  DecodeMessage(state, CreateFloat64List(state.range(0)));
+}
+BENCHMARK(BM_DecodeFloat64List)->Arg(100)->Arg(10000);
+
+static void BM_EncodeInt32List(benchmark::State& state) {
+  EncodeMessage(state, CreateInt32List(state.range(0)));
+}
+BENCHMARK(BM_EncodeInt32List)->Arg(100)->Arg(10000);
+
+static void BM_DecodeInt32List(benchmark::State& state) {
+  DecodeMessage(state, CreateInt32List(state.range(0)));
+}
+BENCHMARK(BM_DecodeInt32List)->Arg(100)->Arg(10000);
+
+static void BM_EncodeNestedMap(benchmark::State& state) {
+  EncodeMessage(state, CreateNestedMap(state.range(0), 4));
+}
+BENCHMARK(BM_EncodeNestedMap)->Arg(2)->Arg(5);
+
+static void BM_DecodeNestedMap(benchmark::State& state) {
+  DecodeMessage(state, CreateNestedMap(state.range(0), 4));
+}
+BENCHMARK(BM_DecodeNestedMap)->Arg(2)->Arg(5);
+
+static void BM_EncodeMethodCall(benchmark::State& state) {
+  const StandardMethodCodec& codec = StandardMethodCodec::GetInstance();
+  MethodCall<EncodableValue> call(
+      "updateSamples", std::make_unique<EncodableValue>(EncodableMap{
+                           {EncodableValue("samples"), CreateFloat64List(256)},
+                           {EncodableValue("state"), CreateNestedMap(1, 4)},
+                       }));
+  while (state.KeepRunning()) {
+    auto encoded = codec.EncodeMethodCall(call);
+    benchmark::DoNotOptimize(encoded->data());
+  }
+}
+BENCHMARK(BM_EncodeMethodCall);
+
+}  // namespace flutter
@@ -93,6 +93,16 @@ void FlutterDesktopMessengerSetCallback(FlutterDesktopMessengerRef messenger,
   }
 }
 
+bool FlutterDesktopMessengerSetBatched(FlutterDesktopMessengerRef messenger,
+                                       const char* channel,
+                                       bool batched) {
+  bool result = false;
+  if (s_stub_implementation) {
+    result = s_stub_implementation->MessengerSetBatched(channel, batched);
+  }
+  return result;
+}
+
 FlutterDesktopTextureRegistrarRef FlutterDesktopRegistrarGetTextureRegistrar(
     FlutterDesktopPluginRegistrarRef registrar) {
   return reinterpret_cast<FlutterDesktopTextureRegistrarRef>(1);
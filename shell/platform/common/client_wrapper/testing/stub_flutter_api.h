@@ -65,6 +65,11 @@ class StubFlutterApi {
                                     FlutterDesktopMessageCallback callback,
                                     void* user_data) {}
 
+  // Called for FlutterDesktopMessengerSetBatched.
+  virtual bool MessengerSetBatched(const char* channel, bool batched) {
+    return true;
+  }
+
   // Called for FlutterDesktopRegisterExternalTexture.
   virtual int64_t TextureRegistrarRegisterExternalTexture(
       const FlutterDesktopTextureInfo* info) {
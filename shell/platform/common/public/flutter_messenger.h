@@ -87,6 +87,17 @@ FLUTTER_EXPORT void FlutterDesktopMessengerSetCallback(
     FlutterDesktopMessageCallback callback,
     void* user_data);
 
+// Sets whether the messages on the specified channel are delivered in batches,
+// in both directions. Batching saves the engine a task per message on channels
+// that send many messages per frame, like sensor streams, but lets messages on
+// the channel overtake earlier messages on other channels.
+//
+// Returns false if the engine could not change the setting.
+FLUTTER_EXPORT bool FlutterDesktopMessengerSetBatched(
+    FlutterDesktopMessengerRef messenger,
+    const char* channel,
+    bool batched);
+
 #if defined(__cplusplus)
 }  // extern "C"
 #endif
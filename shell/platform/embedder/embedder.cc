@@ -8,6 +8,7 @@
 #include <cstring>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <set>
 #include <string>
 #include <vector>
@@ -118,8 +119,8 @@ static bool IsSoftwareRendererConfigValid(const FlutterRendererConfig* config) {
 
   const FlutterSoftwareRendererConfig* software_config = &config->software;
 
-  if (SAFE_ACCESS(software_config, surface_present_callback, nullptr) ==
-      nullptr) {
+  if (!SAFE_EXISTS_ONE_OF(software_config, surface_present_callback,
+                          surface_present_with_info_callback)) {
     return false;
   }
 
@@ -176,6 +177,23 @@ static void* DefaultGLProcResolver(const char* name) {
 }
 #endif  // OS_LINUX || OS_WIN
 
+// Describes |rect| to the embedder, using |storage| to hold the rect. A missing
+// rect means that the damage is not known and is described by an empty list.
+static FlutterDamage MakeFlutterDamage(const std::optional<SkIRect>& rect,
+                                       FlutterRect& storage) {
+  FlutterDamage damage = {};
+  damage.struct_size = sizeof(FlutterDamage);
+  if (rect.has_value()) {
+    storage.left = rect->left();
+    storage.top = rect->top();
+    storage.right = rect->right();
+    storage.bottom = rect->bottom();
+    damage.num_rects = 1;
+    damage.damage = &storage;
+  }
+  return damage;
+}
+
 static flutter::Shell::CreateCallback<flutter::PlatformView>
 InferOpenGLPlatformViewCreationCallback(
     const FlutterRendererConfig* config,
@@ -197,13 +215,20 @@ InferOpenGLPlatformViewCreationCallback(
 
   auto gl_present = [present = config->open_gl.present,
                      present_with_info = config->open_gl.present_with_info,
-                     user_data](uint32_t fbo_id) -> bool {
+                     user_data](
+                        flutter::GLPresentInfo gl_present_info) -> bool {
     if (present) {
       return present(user_data);
     } else {
+      FlutterRect frame_damage_rect = {};
+      FlutterRect buffer_damage_rect = {};
       FlutterPresentInfo present_info = {};
       present_info.struct_size = sizeof(FlutterPresentInfo);
-      present_info.fbo_id = fbo_id;
+      present_info.fbo_id = gl_present_info.fbo_id;
+      present_info.frame_damage = MakeFlutterDamage(
+          gl_present_info.frame_damage, frame_damage_rect);
+      present_info.buffer_damage = MakeFlutterDamage(
+          gl_present_info.buffer_damage, buffer_damage_rect);
       return present_with_info(user_data, &present_info);
     }
   };
@@ -269,6 +294,15 @@ InferOpenGLPlatformViewCreationCallback(
 #endif
   }
 
+  std::function<uint32_t(void)> gl_fbo_buffer_age_callback = nullptr;
+  if (SAFE_ACCESS(open_gl_config, fbo_buffer_age_callback, nullptr) !=
+      nullptr) {
+    gl_fbo_buffer_age_callback =
+        [ptr = config->open_gl.fbo_buffer_age_callback, user_data]() {
+          return ptr(user_data);
+        };
+  }
+
   bool fbo_reset_after_present =
       SAFE_ACCESS(open_gl_config, fbo_reset_after_present, false);
 
@@ -280,6 +314,7 @@ InferOpenGLPlatformViewCreationCallback(
       gl_make_resource_current_callback,   // gl_make_resource_current_callback
       gl_surface_transformation_callback,  // gl_surface_transformation_callback
       gl_proc_resolver,                    // gl_proc_resolver
+      gl_fbo_buffer_age_callback,          // gl_fbo_buffer_age_callback
   };
 
   return fml::MakeCopyable(
@@ -380,10 +415,25 @@ InferSoftwarePlatformViewCreationCallback(
     return nullptr;
   }
 
+  const FlutterSoftwareRendererConfig* software_config = &config->software;
   auto software_present_backing_store =
-      [ptr = config->software.surface_present_callback, user_data](
-          const void* allocation, size_t row_bytes, size_t height) -> bool {
-    return ptr(user_data, allocation, row_bytes, height);
+      [ptr = SAFE_ACCESS(software_config, surface_present_callback, nullptr),
+       ptr_with_info = SAFE_ACCESS(software_config,
+                                   surface_present_with_info_callback, nullptr),
+       user_data](const void* allocation, size_t row_bytes, size_t height,
+                  const std::optional<SkIRect>& damage) -> bool {
+    if (ptr) {
+      return ptr(user_data, allocation, row_bytes, height);
+    } else {
+      FlutterRect frame_damage_rect = {};
+      FlutterSoftwarePresentInfo present_info = {};
+      present_info.struct_size = sizeof(FlutterSoftwarePresentInfo);
+      present_info.allocation = allocation;
+      present_info.row_bytes = row_bytes;
+      present_info.height = height;
+      present_info.frame_damage = MakeFlutterDamage(damage, frame_damage_rect);
+      return ptr_with_info(user_data, &present_info);
+    }
   };
 
   flutter::EmbedderSurfaceSoftware::SoftwareDispatchTable
@@ -1648,6 +1698,26 @@ FlutterEngineResult FlutterEngineSendPlatformMessage(
                                   "Flutter application.");
 }
 
+FlutterEngineResult FlutterEngineSetPlatformMessageChannelBatched(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    const char* channel,
+    bool batched) {
+  if (engine == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Invalid engine handle.");
+  }
+
+  if (channel == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Invalid channel argument.");
+  }
+
+  return reinterpret_cast<flutter::EmbedderEngine*>(engine)
+                 ->SetPlatformMessageChannelBatched(channel, batched)
+             ? kSuccess
+             : LOG_EMBEDDER_ERROR(kInternalInconsistency,
+                                  "Could not update the batching of the "
+                                  "platform message channel.");
+}
+
 FlutterEngineResult FlutterPlatformMessageCreateResponseHandle(
     FLUTTER_API_SYMBOL(FlutterEngine) engine,
     FlutterDataCallback data_callback,
@@ -2302,6 +2372,8 @@ FlutterEngineResult FlutterEngineGetProcAddresses(
   SET_PROC(PostCallbackOnAllNativeThreads,
            FlutterEnginePostCallbackOnAllNativeThreads);
   SET_PROC(NotifyDisplayUpdate, FlutterEngineNotifyDisplayUpdate);
+  SET_PROC(SetPlatformMessageChannelBatched,
+           FlutterEngineSetPlatformMessageChannelBatched);
 #undef SET_PROC
 
   return kSuccess;
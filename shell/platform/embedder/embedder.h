@@ -367,6 +367,22 @@ typedef uint32_t (*UIntFrameInfoCallback)(
     void* /* user data */,
     const FlutterFrameInfo* /* frame info */);
 
+/// The area of a surface that changed, as a list of rectangles in the
+/// coordinates of the surface with the origin at the top left.
+///
+/// If `num_rects` is zero, the area that changed is not known and the entire
+/// surface must be assumed to have changed. If nothing changed, a single empty
+/// rectangle is reported.
+typedef struct {
+  /// The size of this struct. Must be sizeof(FlutterDamage).
+  size_t struct_size;
+  /// The number of rectangles in `damage`.
+  size_t num_rects;
+  /// The rectangles that make up the damaged area. Only valid for the duration
+  /// of the callback this is passed to.
+  FlutterRect* damage;
+} FlutterDamage;
+
 /// This information is passed to the embedder when a surface is presented.
 ///
 /// See: \ref FlutterOpenGLRendererConfig.present_with_info.
@@ -375,6 +391,16 @@ typedef struct {
   size_t struct_size;
   /// Id of the fbo backing the surface that was presented.
   uint32_t fbo_id;
+  /// The area of the frame that changed since the previously presented frame.
+  /// Only this area needs to be updated on screen, for example by passing it
+  /// to `eglSwapBuffersWithDamageKHR` (after flipping it to a bottom left
+  /// origin).
+  FlutterDamage frame_damage;
+  /// The area of the fbo that the engine painted to for this frame. This is
+  /// the frame damage extended by the existing damage of the fbo, as derived
+  /// from the age reported by
+  /// \ref FlutterOpenGLRendererConfig.fbo_buffer_age_callback.
+  FlutterDamage buffer_damage;
 } FlutterPresentInfo;
 
 /// Callback for when a surface is presented.
@@ -440,6 +466,15 @@ typedef struct {
   /// `FlutterPresentInfo` struct that the embedder can use to release any
   /// resources. The return value indicates success of the present call.
   BoolPresentInfoCallback present_with_info;
+  /// This is an optional callback that returns the age of the contents of the
+  /// fbo that was last returned by the fbo callback, with the same meaning as
+  /// `EGL_BUFFER_AGE_EXT`. That is 1 if the fbo contains the previously
+  /// presented frame, 2 if it contains the frame before that and so on. 0 means
+  /// that the contents are undefined. It is invoked on the raster thread before
+  /// every frame. When specified, the engine only repaints the area of the fbo
+  /// that differs from the new frame, and the damage reported to
+  /// `present_with_info` can be used to only update that area on screen.
+  UIntCallback fbo_buffer_age_callback;
 } FlutterOpenGLRendererConfig;
 
 /// Alias for id<MTLDevice>.
@@ -540,14 +575,51 @@ typedef struct {
   FlutterMetalTextureFrameCallback external_texture_frame_callback;
 } FlutterMetalRendererConfig;
 
+/// This information is passed to the embedder when a software surface is
+/// presented.
+///
+/// See: \ref FlutterSoftwareRendererConfig.surface_present_with_info_callback.
+typedef struct {
+  /// The size of this struct. Must be sizeof(FlutterSoftwarePresentInfo).
+  size_t struct_size;
+  /// The fully populated buffer. The pixel format of the buffer is the native
+  /// 32-bit RGBA format.
+  const void* allocation;
+  /// The number of bytes in each row of the buffer.
+  size_t row_bytes;
+  /// The number of rows in the buffer.
+  size_t height;
+  /// The area of the buffer that changed since the previously presented
+  /// buffer. Only this area needs to be copied to the screen.
+  FlutterDamage frame_damage;
+} FlutterSoftwarePresentInfo;
+
+/// Callback for when a software surface is presented.
+typedef bool (*SoftwareSurfacePresentInfoCallback)(
+    void* /* user data */,
+    const FlutterSoftwarePresentInfo* /* present info */);
+
 typedef struct {
   /// The size of this struct. Must be sizeof(FlutterSoftwareRendererConfig).
   size_t struct_size;
+  /// Specifying one (and only one) of `surface_present_callback` or
+  /// `surface_present_with_info_callback` is required. Specifying both is an
+  /// error and engine initialization will be terminated.
+  ///
   /// The callback presented to the embedder to present a fully populated buffer
   /// to the user. The pixel format of the buffer is the native 32-bit RGBA
   /// format. The buffer is owned by the Flutter engine and must be copied in
   /// this callback if needed.
   SoftwareSurfacePresentCallback surface_present_callback;
+  /// Specifying one (and only one) of `surface_present_callback` or
+  /// `surface_present_with_info_callback` is required. Specifying both is an
+  /// error and engine initialization will be terminated. When using this
+  /// variant, the embedder is passed a `FlutterSoftwarePresentInfo` struct
+  /// that also contains the area of the buffer that changed since the last
+  /// present, so that only that area needs to be copied. The engine renders
+  /// every frame into the same buffer for as long as the surface size does not
+  /// change. The buffer is owned by the Flutter engine.
+  SoftwareSurfacePresentInfoCallback surface_present_with_info_callback;
 } FlutterSoftwareRendererConfig;
 
 typedef struct {
@@ -1742,6 +1814,31 @@ FlutterEngineResult FlutterEngineSendPlatformMessage(
     FLUTTER_API_SYMBOL(FlutterEngine) engine,
     const FlutterPlatformMessage* message);
 
+//------------------------------------------------------------------------------
+/// @brief      Sets whether the platform messages on a channel are delivered
+///             in batches. Instead of posting a task for every message, the
+///             engine delivers all messages sent on batched channels in the
+///             meantime with a single task, both to the Flutter application
+///             and to the platform message callback of the embedder. This is
+///             meant for channels that send many messages per frame, like
+///             sensor streams.
+///
+///             Messages on a batched channel are still delivered in order, but
+///             may be delivered before events of other kinds that were sent
+///             earlier, like pointer events or messages on other channels.
+///
+/// @param[in]  engine   A running engine instance.
+/// @param[in]  channel  The name of the channel.
+/// @param[in]  batched  Whether messages on the channel are batched.
+///
+/// @return     The result of the call.
+///
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineSetPlatformMessageChannelBatched(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    const char* channel,
+    bool batched);
+
 //------------------------------------------------------------------------------
 /// @brief     Creates a platform message response handle that allows the
 ///            embedder to set a native callback for a response to a message.
@@ -2258,6 +2355,11 @@ typedef FlutterEngineResult (*FlutterEngineSendKeyEventFnPtr)(
 typedef FlutterEngineResult (*FlutterEngineSendPlatformMessageFnPtr)(
     FLUTTER_API_SYMBOL(FlutterEngine) engine,
     const FlutterPlatformMessage* message);
+typedef FlutterEngineResult (
+    *FlutterEngineSetPlatformMessageChannelBatchedFnPtr)(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    const char* channel,
+    bool batched);
 typedef FlutterEngineResult (
     *FlutterEnginePlatformMessageCreateResponseHandleFnPtr)(
     FLUTTER_API_SYMBOL(FlutterEngine) engine,
@@ -2377,6 +2479,8 @@ typedef struct {
   FlutterEnginePostCallbackOnAllNativeThreadsFnPtr
       PostCallbackOnAllNativeThreads;
   FlutterEngineNotifyDisplayUpdateFnPtr NotifyDisplayUpdate;
+  FlutterEngineSetPlatformMessageChannelBatchedFnPtr
+      SetPlatformMessageChannelBatched;
 } FlutterEngineProcTable;
 
 //------------------------------------------------------------------------------
@@ -158,6 +158,17 @@ bool EmbedderEngine::SendPlatformMessage(
   return true;
 }
 
+bool EmbedderEngine::SetPlatformMessageChannelBatched(
+    const std::string& channel,
+    bool batched) {
+  if (!IsValid()) {
+    return false;
+  }
+
+  shell_->SetPlatformMessageChannelBatched(channel, batched);
+  return true;
+}
+
 bool EmbedderEngine::RegisterTexture(int64_t texture) {
   if (!IsValid()) {
     return false;
@@ -70,6 +70,9 @@ class EmbedderEngine {
 
   bool SendPlatformMessage(std::unique_ptr<PlatformMessage> message);
 
+  bool SetPlatformMessageChannelBatched(const std::string& channel,
+                                        bool batched);
+
   bool RegisterTexture(int64_t texture);
 
   bool UnregisterTexture(int64_t texture);
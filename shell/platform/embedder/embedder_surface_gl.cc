@@ -45,8 +45,8 @@ bool EmbedderSurfaceGL::GLContextClearCurrent() {
 }
 
 // |GPUSurfaceGLDelegate|
-bool EmbedderSurfaceGL::GLContextPresent(uint32_t fbo_id) {
-  return gl_dispatch_table_.gl_present_callback(fbo_id);
+bool EmbedderSurfaceGL::GLContextPresent(const GLPresentInfo& present_info) {
+  return gl_dispatch_table_.gl_present_callback(present_info);
 }
 
 // |GPUSurfaceGLDelegate|
@@ -75,6 +75,20 @@ EmbedderSurfaceGL::GLProcResolver EmbedderSurfaceGL::GetGLProcResolver() const {
   return gl_dispatch_table_.gl_proc_resolver;
 }
 
+// |GPUSurfaceGLDelegate|
+bool EmbedderSurfaceGL::SurfaceSupportsPartialRepaint() const {
+  return static_cast<bool>(gl_dispatch_table_.gl_fbo_buffer_age_callback);
+}
+
+// |GPUSurfaceGLDelegate|
+int EmbedderSurfaceGL::GLContextFBOBufferAge() const {
+  auto callback = gl_dispatch_table_.gl_fbo_buffer_age_callback;
+  if (!callback) {
+    return 0;
+  }
+  return static_cast<int>(callback());
+}
+
 // |EmbedderSurface|
 std::unique_ptr<Surface> EmbedderSurfaceGL::CreateGPUSurface() {
   const bool render_to_surface = !external_view_embedder_;
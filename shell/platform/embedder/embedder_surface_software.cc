@@ -78,6 +78,18 @@ sk_sp<SkSurface> EmbedderSurfaceSoftware::AcquireBackingStore(
 // |GPUSurfaceSoftwareDelegate|
 bool EmbedderSurfaceSoftware::PresentBackingStore(
     sk_sp<SkSurface> backing_store) {
+  return Present(std::move(backing_store), std::nullopt);
+}
+
+// |GPUSurfaceSoftwareDelegate|
+bool EmbedderSurfaceSoftware::PresentBackingStoreDamage(
+    sk_sp<SkSurface> backing_store,
+    const SkIRect& damage) {
+  return Present(std::move(backing_store), damage);
+}
+
+bool EmbedderSurfaceSoftware::Present(sk_sp<SkSurface> backing_store,
+                                      const std::optional<SkIRect>& damage) {
   if (!IsValid()) {
     FML_LOG(ERROR) << "Tried to present an invalid software surface.";
     return false;
@@ -102,7 +114,8 @@ bool EmbedderSurfaceSoftware::PresentBackingStore(
   return software_dispatch_table_.software_present_backing_store(
       pixmap.addr(),      //
       pixmap.rowBytes(),  //
-      pixmap.height()     //
+      pixmap.height(),    //
+      damage              //
   );
 }
 
@@ -5,6 +5,8 @@
 #ifndef FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_SURFACE_SOFTWARE_H_
 #define FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_SURFACE_SOFTWARE_H_
 
+#include <optional>
+
 #include "flutter/fml/macros.h"
 #include "flutter/shell/gpu/gpu_surface_software.h"
 #include "flutter/shell/platform/embedder/embedder_external_view_embedder.h"
@@ -16,7 +18,10 @@ class EmbedderSurfaceSoftware final : public EmbedderSurface,
                                       public GPUSurfaceSoftwareDelegate {
  public:
   struct SoftwareDispatchTable {
-    std::function<bool(const void* allocation, size_t row_bytes, size_t height)>
+    std::function<bool(const void* allocation,
+                       size_t row_bytes,
+                       size_t height,
+                       const std::optional<SkIRect>& damage)>
         software_present_backing_store;  // required
   };
 
@@ -47,6 +52,13 @@ class EmbedderSurfaceSoftware final : public EmbedderSurface,
   // |GPUSurfaceSoftwareDelegate|
   bool PresentBackingStore(sk_sp<SkSurface> backing_store) override;
 
+  // |GPUSurfaceSoftwareDelegate|
+  bool PresentBackingStoreDamage(sk_sp<SkSurface> backing_store,
+                                 const SkIRect& damage) override;
+
+  bool Present(sk_sp<SkSurface> backing_store,
+               const std::optional<SkIRect>& damage);
+
   FML_DISALLOW_COPY_AND_ASSIGN(EmbedderSurfaceSoftware);
 };
 
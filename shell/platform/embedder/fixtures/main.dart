@@ -704,6 +704,33 @@ void push_frames_over_and_over() {
 }
 
 
+Picture CreateColoredBoxWithCullRect(Color color, Size size) {
+  Paint paint = Paint();
+  paint.color = color;
+  PictureRecorder recorder = PictureRecorder();
+  Rect rect = Rect.fromLTRB(0.0, 0.0, size.width, size.height);
+  Canvas canvas = Canvas(recorder, rect);
+  canvas.drawRect(rect, paint);
+  return recorder.endRecording();
+}
+
+/// Renders frames that only differ in the color of a 50x50 box at (100, 100).
+@pragma('vm:entry-point')
+void render_box_with_changing_color() {
+  int frame = 0;
+  PlatformDispatcher.instance.onBeginFrame = (Duration duration) {
+    SceneBuilder builder = SceneBuilder();
+    builder.addPicture(Offset(0.0, 0.0), CreateColoredBoxWithCullRect(Color.fromARGB(255, 128, 128, 128), Size(800.0, 600.0)));
+    Color color = frame.isEven ? Color.fromARGB(255, 255, 0, 0) : Color.fromARGB(255, 0, 0, 255);
+    builder.addPicture(Offset(100.0, 100.0), CreateColoredBoxWithCullRect(color, Size(50.0, 50.0)));
+    PlatformDispatcher.instance.views.first.render(builder.build());
+    frame++;
+    signalNativeTest();
+    PlatformDispatcher.instance.scheduleFrame();
+  };
+  PlatformDispatcher.instance.scheduleFrame();
+}
+
 @pragma('vm:entry-point')
 void platform_view_mutators() {
   PlatformDispatcher.instance.onBeginFrame = (Duration duration) {
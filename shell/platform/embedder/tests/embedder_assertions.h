@@ -6,6 +6,7 @@
 #define FLUTTER_SHELL_PLATFORM_EMBEDDER_TESTS_EMBEDDER_ASSERTIONS_H_
 
 #include <sstream>
+#include <vector>
 
 #include "flutter/fml/logging.h"
 #include "flutter/shell/platform/embedder/embedder.h"
@@ -465,6 +466,12 @@ inline SkRect SkRectMake(const FlutterRect& rect) {
   return SkRect::MakeLTRB(rect.left, rect.top, rect.right, rect.bottom);
 }
 
+inline std::vector<FlutterRect> FlutterDamageRects(
+    const FlutterDamage& damage) {
+  return std::vector<FlutterRect>(damage.damage,
+                                  damage.damage + damage.num_rects);
+}
+
 inline FlutterRoundedRect FlutterRoundedRectMake(const SkRRect& rect) {
   FlutterRoundedRect r = {};
   r.rect = FlutterRectMake(rect.rect());
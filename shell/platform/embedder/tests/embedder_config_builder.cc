@@ -20,6 +20,22 @@
 namespace flutter {
 namespace testing {
 
+static sk_sp<SkImage> MakeImageFromAllocation(const void* allocation,
+                                              size_t row_bytes,
+                                              size_t height) {
+  auto image_info =
+      SkImageInfo::MakeN32Premul(SkISize::Make(row_bytes / 4, height));
+  SkBitmap bitmap;
+  if (!bitmap.installPixels(image_info, const_cast<void*>(allocation),
+                            row_bytes)) {
+    FML_LOG(ERROR) << "Could not copy pixels for the software "
+                      "composition from the engine.";
+    return nullptr;
+  }
+  bitmap.setImmutable();
+  return SkImage::MakeFromBitmap(bitmap);
+}
+
 EmbedderConfigBuilder::EmbedderConfigBuilder(
     EmbedderTestContext& context,
     InitializationPreference preference)
@@ -45,7 +61,7 @@ EmbedderConfigBuilder::EmbedderConfigBuilder(
   opengl_renderer_config_.present_with_info =
       [](void* context, const FlutterPresentInfo* present_info) -> bool {
     return reinterpret_cast<EmbedderTestContextGL*>(context)->GLPresent(
-        present_info->fbo_id);
+        *present_info);
   };
   opengl_renderer_config_.fbo_with_frame_info_callback =
       [](void* context, const FlutterFrameInfo* frame_info) -> uint32_t {
@@ -77,18 +93,12 @@ EmbedderConfigBuilder::EmbedderConfigBuilder(
   software_renderer_config_.surface_present_callback =
       [](void* context, const void* allocation, size_t row_bytes,
          size_t height) {
-        auto image_info =
-            SkImageInfo::MakeN32Premul(SkISize::Make(row_bytes / 4, height));
-        SkBitmap bitmap;
-        if (!bitmap.installPixels(image_info, const_cast<void*>(allocation),
-                                  row_bytes)) {
-          FML_LOG(ERROR) << "Could not copy pixels for the software "
-                            "composition from the engine.";
+        auto image = MakeImageFromAllocation(allocation, row_bytes, height);
+        if (!image) {
           return false;
         }
-        bitmap.setImmutable();
         return reinterpret_cast<EmbedderTestContextSoftware*>(context)->Present(
-            SkImage::MakeFromBitmap(bitmap));
+            std::move(image));
       };
 
   // The first argument is treated as the executable name. Don't make tests have
@@ -149,11 +159,44 @@ void EmbedderConfigBuilder::SetOpenGLPresentCallBack() {
   FML_CHECK(renderer_config_.type == FlutterRendererType::kOpenGL);
   renderer_config_.open_gl.present = [](void* context) -> bool {
     // passing a placeholder fbo_id.
-    return reinterpret_cast<EmbedderTestContextGL*>(context)->GLPresent(0);
+    FlutterPresentInfo present_info = {};
+    present_info.struct_size = sizeof(FlutterPresentInfo);
+    present_info.fbo_id = 0;
+    return reinterpret_cast<EmbedderTestContextGL*>(context)->GLPresent(
+        present_info);
+  };
+#endif
+}
+
+void EmbedderConfigBuilder::SetOpenGLFBOBufferAgeCallBack() {
+#ifdef SHELL_ENABLE_GL
+  // SetOpenGLRendererConfig must be called before this.
+  FML_CHECK(renderer_config_.type == FlutterRendererType::kOpenGL);
+  renderer_config_.open_gl.fbo_buffer_age_callback =
+      [](void* context) -> uint32_t {
+    return reinterpret_cast<EmbedderTestContextGL*>(context)
+        ->GLGetFBOBufferAge();
   };
 #endif
 }
 
+void EmbedderConfigBuilder::SetSoftwarePresentWithInfoCallBack() {
+  // SetSoftwareRendererConfig must be called before this.
+  FML_CHECK(renderer_config_.type == FlutterRendererType::kSoftware);
+  renderer_config_.software.surface_present_callback = nullptr;
+  renderer_config_.software.surface_present_with_info_callback =
+      [](void* context, const FlutterSoftwarePresentInfo* present_info) {
+        auto image = MakeImageFromAllocation(present_info->allocation,
+                                             present_info->row_bytes,
+                                             present_info->height);
+        if (!image) {
+          return false;
+        }
+        return reinterpret_cast<EmbedderTestContextSoftware*>(context)->Present(
+            std::move(image), *present_info);
+      };
+}
+
 void EmbedderConfigBuilder::SetOpenGLRendererConfig(SkISize surface_size) {
 #ifdef SHELL_ENABLE_GL
   renderer_config_.type = FlutterRendererType::kOpenGL;
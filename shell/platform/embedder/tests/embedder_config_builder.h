@@ -62,6 +62,14 @@ class EmbedderConfigBuilder {
   // test this behavior.
   void SetOpenGLPresentCallBack();
 
+  // Used to set an `open_gl.fbo_buffer_age_callback` that reports the buffer
+  // age set on the context, which enables partial repaint.
+  void SetOpenGLFBOBufferAgeCallBack();
+
+  // Used to replace the `software.surface_present_callback` with a
+  // `software.surface_present_with_info_callback`.
+  void SetSoftwarePresentWithInfoCallBack();
+
   void SetAssetsPath();
 
   void SetSnapshots();
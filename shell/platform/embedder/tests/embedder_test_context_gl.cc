@@ -39,7 +39,7 @@ bool EmbedderTestContextGL::GLClearCurrent() {
   return gl_surface_->ClearCurrent();
 }
 
-bool EmbedderTestContextGL::GLPresent(uint32_t fbo_id) {
+bool EmbedderTestContextGL::GLPresent(const FlutterPresentInfo& present_info) {
   FML_CHECK(gl_surface_) << "GL surface must be initialized.";
   gl_surface_present_count_++;
 
@@ -50,7 +50,7 @@ bool EmbedderTestContextGL::GLPresent(uint32_t fbo_id) {
   }
 
   if (callback) {
-    callback(fbo_id);
+    callback(present_info);
   }
 
   FireRootSurfacePresentCallbackIfPresent(
@@ -69,6 +69,10 @@ void EmbedderTestContextGL::SetGLPresentCallback(GLPresentCallback callback) {
   gl_present_callback_ = callback;
 }
 
+void EmbedderTestContextGL::SetGLFBOBufferAge(uint32_t age) {
+  gl_fbo_buffer_age_ = age;
+}
+
 uint32_t EmbedderTestContextGL::GLGetFramebuffer(FlutterFrameInfo frame_info) {
   FML_CHECK(gl_surface_) << "GL surface must be initialized.";
 
@@ -91,6 +95,10 @@ bool EmbedderTestContextGL::GLMakeResourceCurrent() {
   return gl_surface_->MakeResourceCurrent();
 }
 
+uint32_t EmbedderTestContextGL::GLGetFBOBufferAge() {
+  return gl_fbo_buffer_age_;
+}
+
 void* EmbedderTestContextGL::GLGetProcAddress(const char* name) {
   FML_CHECK(gl_surface_) << "GL surface must be initialized.";
   return gl_surface_->GetProcAddress(name);
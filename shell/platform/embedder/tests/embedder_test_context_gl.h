@@ -5,6 +5,8 @@
 #ifndef FLUTTER_SHELL_PLATFORM_EMBEDDER_TESTS_EMBEDDER_CONTEXT_GL_H_
 #define FLUTTER_SHELL_PLATFORM_EMBEDDER_TESTS_EMBEDDER_CONTEXT_GL_H_
 
+#include <atomic>
+
 #include "flutter/shell/platform/embedder/tests/embedder_test_context.h"
 #include "flutter/testing/test_gl_surface.h"
 
@@ -14,7 +16,8 @@ namespace testing {
 class EmbedderTestContextGL : public EmbedderTestContext {
  public:
   using GLGetFBOCallback = std::function<void(FlutterFrameInfo frame_info)>;
-  using GLPresentCallback = std::function<void(uint32_t fbo_id)>;
+  using GLPresentCallback =
+      std::function<void(const FlutterPresentInfo& present_info)>;
 
   EmbedderTestContextGL(std::string assets_path = "");
 
@@ -53,6 +56,15 @@ class EmbedderTestContextGL : public EmbedderTestContext {
   ///
   void SetGLPresentCallback(GLPresentCallback callback);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Sets the buffer age that is reported to the engine when it
+  ///             asks for the age of the contents of the FBO. Only used if the
+  ///             `fbo_buffer_age_callback` is set via the config builder.
+  ///
+  /// @param[in]  age   The buffer age to report.
+  ///
+  void SetGLFBOBufferAge(uint32_t age);
+
  protected:
   virtual void SetupCompositor() override;
 
@@ -65,6 +77,7 @@ class EmbedderTestContextGL : public EmbedderTestContext {
   std::mutex gl_callback_mutex_;
   GLGetFBOCallback gl_get_fbo_callback_;
   GLPresentCallback gl_present_callback_;
+  std::atomic<uint32_t> gl_fbo_buffer_age_ = 0;
 
   void SetupSurface(SkISize surface_size) override;
 
@@ -72,12 +85,14 @@ class EmbedderTestContextGL : public EmbedderTestContext {
 
   bool GLClearCurrent();
 
-  bool GLPresent(uint32_t fbo_id);
+  bool GLPresent(const FlutterPresentInfo& present_info);
 
   uint32_t GLGetFramebuffer(FlutterFrameInfo frame_info);
 
   bool GLMakeResourceCurrent();
 
+  uint32_t GLGetFBOBufferAge();
+
   void* GLGetProcAddress(const char* name);
 
   FML_DISALLOW_COPY_AND_ASSIGN(EmbedderTestContextGL);
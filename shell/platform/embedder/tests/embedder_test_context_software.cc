@@ -30,6 +30,28 @@ bool EmbedderTestContextSoftware::Present(sk_sp<SkImage> image) {
   return true;
 }
 
+bool EmbedderTestContextSoftware::Present(
+    sk_sp<SkImage> image,
+    const FlutterSoftwarePresentInfo& present_info) {
+  PresentInfoCallback callback;
+  {
+    std::scoped_lock lock(present_callback_mutex_);
+    callback = present_info_callback_;
+  }
+
+  if (callback) {
+    callback(present_info);
+  }
+
+  return Present(std::move(image));
+}
+
+void EmbedderTestContextSoftware::SetPresentInfoCallback(
+    PresentInfoCallback callback) {
+  std::scoped_lock lock(present_callback_mutex_);
+  present_info_callback_ = callback;
+}
+
 size_t EmbedderTestContextSoftware::GetSurfacePresentCount() const {
   return software_surface_present_count_;
 }
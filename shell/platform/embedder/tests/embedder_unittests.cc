@@ -387,6 +387,62 @@ TEST_F(EmbedderTest, PlatformMessagesCanBeSentWithoutResponseHandles) {
   message.Wait();
 }
 
+//------------------------------------------------------------------------------
+/// Tests that platform messages on a batched channel are all delivered, in
+/// order, including payloads large enough to be handed to Dart without a copy.
+///
+TEST_F(EmbedderTest, BatchedPlatformMessagesAreDeliveredInOrder) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig();
+  builder.SetDartEntrypoint("platform_messages_no_response");
+
+  std::vector<std::string> messages;
+  for (int i = 0; i < 10; i++) {
+    messages.push_back(std::to_string(i));
+  }
+  messages.push_back(std::string(4096, 'a'));
+
+  fml::AutoResetWaitableEvent ready, received_all;
+  std::vector<std::string> received_messages;
+  context.AddNativeCallback(
+      "SignalNativeTest",
+      CREATE_NATIVE_ENTRY(
+          [&ready](Dart_NativeArguments args) { ready.Signal(); }));
+  context.AddNativeCallback(
+      "SignalNativeMessage",
+      CREATE_NATIVE_ENTRY(([&](Dart_NativeArguments args) {
+        received_messages.push_back(
+            tonic::DartConverter<std::string>::FromDart(
+                Dart_GetNativeArgument(args, 0)));
+        if (received_messages.size() == messages.size()) {
+          received_all.Signal();
+        }
+      })));
+
+  auto engine = builder.LaunchEngine();
+
+  ASSERT_TRUE(engine.is_valid());
+  ready.Wait();
+
+  ASSERT_EQ(FlutterEngineSetPlatformMessageChannelBatched(
+                engine.get(), "test_channel", true),
+            kSuccess);
+
+  for (const auto& message_data : messages) {
+    FlutterPlatformMessage platform_message = {};
+    platform_message.struct_size = sizeof(FlutterPlatformMessage);
+    platform_message.channel = "test_channel";
+    platform_message.message =
+        reinterpret_cast<const uint8_t*>(message_data.data());
+    platform_message.message_size = message_data.size();
+    ASSERT_EQ(FlutterEngineSendPlatformMessage(engine.get(), &platform_message),
+              kSuccess);
+  }
+  received_all.Wait();
+  ASSERT_EQ(received_messages, messages);
+}
+
 //------------------------------------------------------------------------------
 /// Tests that a null platform message can be sent.
 ///
@@ -1001,6 +1057,64 @@ TEST_F(EmbedderTest, VerifyB143464703WithSoftwareBackend) {
       ImageMatchesFixture("verifyb143464703_soft_noxform.png", rendered_scene));
 }
 
+TEST_F(EmbedderTest, SoftwarePresentInfoContainsFrameDamage) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig(SkISize::Make(800, 600));
+  builder.SetSoftwarePresentWithInfoCallBack();
+  builder.SetDartEntrypoint("render_box_with_changing_color");
+
+  context.AddNativeCallback("SignalNativeTest",
+                            CREATE_NATIVE_ENTRY([&](Dart_NativeArguments args) {
+                              /* Nothing to do. */
+                            }));
+
+  constexpr size_t kFrameCount = 3;
+  fml::CountDownLatch frame_latch(kFrameCount);
+  std::mutex damage_mutex;
+  std::vector<std::vector<FlutterRect>> frame_damage;
+  auto& software_context = static_cast<EmbedderTestContextSoftware&>(context);
+  software_context.SetPresentInfoCallback(
+      [&](const FlutterSoftwarePresentInfo& present_info) {
+        std::scoped_lock lock(damage_mutex);
+        if (frame_damage.size() == kFrameCount) {
+          return;
+        }
+        ASSERT_EQ(present_info.struct_size,
+                  sizeof(FlutterSoftwarePresentInfo));
+        ASSERT_EQ(present_info.row_bytes, 800u * 4);
+        ASSERT_EQ(present_info.height, 600u);
+        frame_damage.push_back(FlutterDamageRects(present_info.frame_damage));
+        frame_latch.CountDown();
+      });
+
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+
+  FlutterWindowMetricsEvent event = {};
+  event.struct_size = sizeof(event);
+  event.width = 800;
+  event.height = 600;
+  event.pixel_ratio = 1.0;
+  ASSERT_EQ(FlutterEngineSendWindowMetricsEvent(engine.get(), &event),
+            kSuccess);
+
+  frame_latch.Wait();
+  software_context.SetPresentInfoCallback(nullptr);
+  engine.reset();
+
+  ASSERT_EQ(frame_damage.size(), kFrameCount);
+  // Nothing was presented before the first frame. After that, the engine
+  // renders into the same buffer, so only the box needs to be copied.
+  ASSERT_EQ(frame_damage[0],
+            std::vector<FlutterRect>{FlutterRectMakeLTRB(0, 0, 800, 600)});
+  for (size_t i = 1; i < frame_damage.size(); i++) {
+    ASSERT_EQ(frame_damage[i], std::vector<FlutterRect>{
+                                   FlutterRectMakeLTRB(100, 100, 150, 150)});
+  }
+}
+
 TEST_F(EmbedderTest, CanSendLowMemoryNotification) {
   auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
 
@@ -3121,8 +3121,9 @@ TEST_F(EmbedderTest, PresentInfoContainsValidFBOId) {
   const uint32_t window_fbo_id =
       static_cast<EmbedderTestContextGL&>(context).GetWindowFBOId();
   static_cast<EmbedderTestContextGL&>(context).SetGLPresentCallback(
-      [window_fbo_id = window_fbo_id, &frame_latch](uint32_t fbo_id) {
-        ASSERT_EQ(fbo_id, window_fbo_id);
+      [window_fbo_id = window_fbo_id,
+       &frame_latch](const FlutterPresentInfo& present_info) {
+        ASSERT_EQ(present_info.fbo_id, window_fbo_id);
 
         frame_latch.CountDown();
       });
@@ -3130,6 +3131,122 @@ TEST_F(EmbedderTest, PresentInfoContainsValidFBOId) {
   frame_latch.Wait();
 }
 
+//------------------------------------------------------------------------------
+/// Launches the `render_box_with_changing_color` fixture on an 800x600 OpenGL
+/// surface and returns the present info damage of the first three frames.
+///
+static void CollectPresentedDamage(
+    EmbedderTest& test,
+    bool set_buffer_age_callback,
+    uint32_t buffer_age,
+    std::vector<std::vector<FlutterRect>>& frame_damage,
+    std::vector<std::vector<FlutterRect>>& buffer_damage) {
+  auto& context =
+      test.GetEmbedderContext(EmbedderTestContextType::kOpenGLContext);
+
+  EmbedderConfigBuilder builder(context);
+  builder.SetOpenGLRendererConfig(SkISize::Make(800, 600));
+  if (set_buffer_age_callback) {
+    builder.SetOpenGLFBOBufferAgeCallBack();
+  }
+  builder.SetDartEntrypoint("render_box_with_changing_color");
+
+  context.AddNativeCallback("SignalNativeTest",
+                            CREATE_NATIVE_ENTRY([&](Dart_NativeArguments args) {
+                              /* Nothing to do. */
+                            }));
+
+  constexpr size_t kFrameCount = 3;
+  fml::CountDownLatch frame_latch(kFrameCount);
+  std::mutex damage_mutex;
+  auto& gl_context = static_cast<EmbedderTestContextGL&>(context);
+  gl_context.SetGLFBOBufferAge(buffer_age);
+  gl_context.SetGLPresentCallback(
+      [&](const FlutterPresentInfo& present_info) {
+        std::scoped_lock lock(damage_mutex);
+        if (frame_damage.size() == kFrameCount) {
+          return;
+        }
+        ASSERT_EQ(present_info.frame_damage.struct_size,
+                  sizeof(FlutterDamage));
+        ASSERT_EQ(present_info.buffer_damage.struct_size,
+                  sizeof(FlutterDamage));
+        frame_damage.push_back(FlutterDamageRects(present_info.frame_damage));
+        buffer_damage.push_back(
+            FlutterDamageRects(present_info.buffer_damage));
+        frame_latch.CountDown();
+      });
+
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+
+  FlutterWindowMetricsEvent event = {};
+  event.struct_size = sizeof(event);
+  event.width = 800;
+  event.height = 600;
+  event.pixel_ratio = 1.0;
+  ASSERT_EQ(FlutterEngineSendWindowMetricsEvent(engine.get(), &event),
+            kSuccess);
+
+  frame_latch.Wait();
+
+  // Stop recording before the vectors go away.
+  gl_context.SetGLPresentCallback(nullptr);
+  engine.reset();
+}
+
+TEST_F(EmbedderTest, PresentInfoContainsFrameDamage) {
+  std::vector<std::vector<FlutterRect>> frame_damage;
+  std::vector<std::vector<FlutterRect>> buffer_damage;
+  CollectPresentedDamage(*this, true, 1, frame_damage, buffer_damage);
+  ASSERT_EQ(frame_damage.size(), 3u);
+
+  const auto full_frame = FlutterRectMakeLTRB(0, 0, 800, 600);
+  const auto box = FlutterRectMakeLTRB(100, 100, 150, 150);
+
+  // Nothing was presented before the first frame.
+  ASSERT_EQ(frame_damage[0], std::vector<FlutterRect>{full_frame});
+  ASSERT_EQ(buffer_damage[0], std::vector<FlutterRect>{full_frame});
+
+  // The FBO contains the previous frame, so only the box is repainted.
+  for (size_t i = 1; i < frame_damage.size(); i++) {
+    ASSERT_EQ(frame_damage[i], std::vector<FlutterRect>{box});
+    ASSERT_EQ(buffer_damage[i], std::vector<FlutterRect>{box});
+  }
+}
+
+TEST_F(EmbedderTest, PresentInfoBufferDamageIncludesExistingDamage) {
+  std::vector<std::vector<FlutterRect>> frame_damage;
+  std::vector<std::vector<FlutterRect>> buffer_damage;
+  // The contents of the FBO are undefined, so all of it must be repainted
+  // even though only the box changed on screen.
+  CollectPresentedDamage(*this, true, 0, frame_damage, buffer_damage);
+  ASSERT_EQ(frame_damage.size(), 3u);
+
+  const auto full_frame = FlutterRectMakeLTRB(0, 0, 800, 600);
+  const auto box = FlutterRectMakeLTRB(100, 100, 150, 150);
+
+  ASSERT_EQ(frame_damage[0], std::vector<FlutterRect>{full_frame});
+  for (size_t i = 1; i < frame_damage.size(); i++) {
+    ASSERT_EQ(frame_damage[i], std::vector<FlutterRect>{box});
+  }
+  for (size_t i = 0; i < buffer_damage.size(); i++) {
+    ASSERT_EQ(buffer_damage[i], std::vector<FlutterRect>{full_frame});
+  }
+}
+
+TEST_F(EmbedderTest, PresentInfoDamageIsUnknownWithoutBufferAgeCallback) {
+  std::vector<std::vector<FlutterRect>> frame_damage;
+  std::vector<std::vector<FlutterRect>> buffer_damage;
+  CollectPresentedDamage(*this, false, 1, frame_damage, buffer_damage);
+  ASSERT_EQ(frame_damage.size(), 3u);
+
+  for (size_t i = 0; i < frame_damage.size(); i++) {
+    ASSERT_TRUE(frame_damage[i].empty());
+    ASSERT_TRUE(buffer_damage[i].empty());
+  }
+}
+
 TEST_F(EmbedderTest, SetSingleDisplayConfigurationWithDisplayId) {
   auto& context = GetEmbedderContext(EmbedderTestContextType::kOpenGLContext);
 
@@ -1101,6 +1101,13 @@ void FlutterDesktopMessengerSetCallback(FlutterDesktopMessengerRef messenger,
                                                             user_data);
 }
 
+bool FlutterDesktopMessengerSetBatched(FlutterDesktopMessengerRef messenger,
+                                       const char* channel,
+                                       bool batched) {
+  return FlutterEngineSetPlatformMessageChannelBatched(
+             messenger->engine->flutter_engine, channel, batched) == kSuccess;
+}
+
 FlutterDesktopTextureRegistrarRef FlutterDesktopRegistrarGetTextureRegistrar(
     FlutterDesktopPluginRegistrarRef registrar) {
   std::cerr << "GLFW Texture support is not implemented yet." << std::endl;
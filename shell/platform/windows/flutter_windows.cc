@@ -206,6 +206,12 @@ void FlutterDesktopMessengerSetCallback(FlutterDesktopMessengerRef messenger,
                                                               user_data);
 }
 
+bool FlutterDesktopMessengerSetBatched(FlutterDesktopMessengerRef messenger,
+                                       const char* channel,
+                                       bool batched) {
+  return messenger->engine->SetPlatformMessageChannelBatched(channel, batched);
+}
+
 FlutterDesktopTextureRegistrarRef FlutterDesktopRegistrarGetTextureRegistrar(
     FlutterDesktopPluginRegistrarRef registrar) {
   return HandleForTextureRegistrar(registrar->engine->texture_registrar());
@@ -369,6 +369,12 @@ void FlutterWindowsEngine::SendPlatformMessageResponse(
   embedder_api_.SendPlatformMessageResponse(engine_, handle, data, data_length);
 }
 
+bool FlutterWindowsEngine::SetPlatformMessageChannelBatched(const char* channel,
+                                                            bool batched) {
+  return embedder_api_.SetPlatformMessageChannelBatched(engine_, channel,
+                                                        batched) == kSuccess;
+}
+
 void FlutterWindowsEngine::HandlePlatformMessage(
     const FlutterPlatformMessage* engine_message) {
   if (engine_message->struct_size != sizeof(FlutterPlatformMessage)) {
@@ -124,6 +124,9 @@ class FlutterWindowsEngine {
       const uint8_t* data,
       size_t data_length);
 
+  // Sets whether messages on the given channel are delivered in batches.
+  bool SetPlatformMessageChannelBatched(const char* channel, bool batched);
+
   // Callback passed to Flutter engine for notifying window of platform
   // messages.
   void HandlePlatformMessage(const FlutterPlatformMessage*);
@@ -151,6 +151,8 @@ def RunCCTests(build_dir, filter):
     ]
   RunEngineExecutable(build_dir, 'flow_unittests', filter, flow_flags + shuffle_flags)
 
+  RunEngineExecutable(build_dir, 'assets_unittests', filter, shuffle_flags)
+
   # TODO(44614): Re-enable after https://github.com/flutter/flutter/issues/44614 has been addressed.
   # RunEngineExecutable(build_dir, 'fml_unittests', filter, [ fml_unittests_filter ] + shuffle_flags)
 
@@ -198,6 +200,12 @@ def RunEngineBenchmarks(build_dir, filter):
 
   RunEngineExecutable(build_dir, 'ui_benchmarks', filter)
 
+  RunEngineExecutable(build_dir, 'client_wrapper_benchmarks', filter)
+
+  RunEngineExecutable(build_dir, 'assets_benchmarks', filter)
+
+  RunEngineExecutable(build_dir, 'flow_benchmarks', filter)
+
   if IsLinux():
     RunEngineExecutable(build_dir, 'txt_benchmarks', filter)
 
@@ -119,6 +119,74 @@ BENCHMARK_F(ParagraphFixture, LongLayout)(benchmark::State& state) {
   }
 }
 
+BENCHMARK_F(ParagraphFixture, ResizeLongLayout)(benchmark::State& state) {
+  const char* text =
+      "This is a very long sentence to test if the text will properly wrap "
+      "around and go to the next line. Sometimes, short sentence. Longer "
+      "sentences are okay too because they are necessary. Very short. "
+      "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod "
+      "tempor incididunt ut labore et dolore magna aliqua. Ut enim ad minim "
+      "veniam, quis nostrud exercitation ullamco laboris nisi ut aliquip ex ea "
+      "commodo consequat. Duis aute irure dolor in reprehenderit in voluptate "
+      "velit esse cillum dolore eu fugiat nulla pariatur. Excepteur sint "
+      "occaecat cupidatat non proident, sunt in culpa qui officia deserunt "
+      "mollit anim id est laborum.";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  txt::ParagraphStyle paragraph_style;
+
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+
+  txt::ParagraphBuilderTxt builder(paragraph_style, font_collection_);
+
+  builder.PushStyle(text_style);
+  builder.AddText(u16_text);
+  builder.Pop();
+  auto paragraph = BuildParagraph(builder);
+  int width = 300;
+  while (state.KeepRunning()) {
+    paragraph->Layout(width);
+    width = width == 300 ? 400 : 300;
+  }
+}
+
+BENCHMARK_F(ParagraphFixture, AppendTextLayout)(benchmark::State& state) {
+  const char* text =
+      "This is a very long sentence to test if the text will properly wrap "
+      "around and go to the next line. Sometimes, short sentence. Longer "
+      "sentences are okay too because they are necessary. Very short. ";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+  std::u16string u16_appended_text(u"Lorem ipsum dolor sit amet. ");
+
+  txt::ParagraphStyle paragraph_style;
+
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+
+  while (state.KeepRunning()) {
+    state.PauseTiming();
+    txt::ParagraphBuilderTxt builder(paragraph_style, font_collection_);
+    builder.PushStyle(text_style);
+    for (int i = 0; i < 16; ++i) {
+      builder.AddText(u16_text);
+    }
+    builder.Pop();
+    auto paragraph = BuildParagraph(builder);
+    paragraph->Layout(300);
+    state.ResumeTiming();
+
+    paragraph->AppendText(u16_appended_text, text_style);
+    paragraph->Layout(300);
+  }
+}
+
 BENCHMARK_F(ParagraphFixture, JustifyLayout)(benchmark::State& state) {
   const char* text =
       "This is a very long sentence to test if the text will properly wrap "
@@ -443,4 +511,85 @@ BENCHMARK_REGISTER_F(ParagraphFixture, SkTextBlobAlloc)
     ->Range(1 << 7, 1 << 14)
     ->Complexity(benchmark::oN);
 
+// -----------------------------------------------------------------------------
+//
+// The following benchmarks lay out text on several threads at once, like
+// engines spawned from the same engine do. All threads share one font
+// collection, as those engines do, along with the minikin caches.
+//
+// -----------------------------------------------------------------------------
+
+static void BM_ParagraphLayoutMultiThreaded(benchmark::State& state) {
+  const char* text =
+      "This is a very long sentence to test if the text will properly wrap "
+      "around and go to the next line. Sometimes, short sentence. Longer "
+      "sentences are okay too because they are necessary. Very short. "
+      "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod "
+      "tempor incididunt ut labore et dolore magna aliqua. Ut enim ad minim "
+      "veniam, quis nostrud exercitation ullamco laboris nisi ut aliquip ex ea "
+      "commodo consequat. Duis aute irure dolor in reprehenderit in voluptate "
+      "velit esse cillum dolore eu fugiat nulla pariatur. Excepteur sint "
+      "occaecat cupidatat non proident, sunt in culpa qui officia deserunt "
+      "mollit anim id est laborum. "
+      // Characters that Roboto doesn't have, so that the layouts look for
+      // fallback fonts.
+      "\u3053\u3093\u306b\u3061\u306f \u0645\u0631\u062d\u0628\u0627";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  static std::shared_ptr<FontCollection> font_collection =
+      GetTestFontCollection();
+
+  txt::ParagraphStyle paragraph_style;
+
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+
+  txt::ParagraphBuilderTxt builder(paragraph_style, font_collection);
+
+  builder.PushStyle(text_style);
+  builder.AddText(u16_text);
+  builder.Pop();
+  auto paragraph = BuildParagraph(builder);
+  while (state.KeepRunning()) {
+    paragraph->SetDirty();
+    paragraph->Layout(300);
+  }
+}
+BENCHMARK(BM_ParagraphLayoutMultiThreaded)->ThreadRange(1, 8)->UseRealTime();
+
+// Changes the text size on every iteration, so that most words miss the
+// layout cache and have to be shaped.
+static void BM_MinikinDoLayoutMultiThreaded(benchmark::State& state) {
+  std::vector<uint16_t> text;
+  for (uint16_t i = 0; i < state.range(0); ++i) {
+    text.push_back(i % 5 == 0 ? ' ' : 'a' + i % 26);
+  }
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  minikin::FontStyle font(4, false);
+  minikin::MinikinPaint paint;
+  paint.letterSpacing = text_style.letter_spacing;
+  paint.wordSpacing = text_style.word_spacing;
+
+  static std::shared_ptr<FontCollection> font_collection =
+      GetTestFontCollection();
+  auto collection = font_collection->GetMinikinFontCollectionForFamilies(
+      text_style.font_families, "en-US");
+
+  size_t iteration = 0;
+  while (state.KeepRunning()) {
+    paint.size = 8 + (state.thread_index * 1024 + iteration++ % 1024) / 16.0;
+    minikin::Layout layout;
+    layout.doLayout(text.data(), 0, text.size(), text.size(), 0, font, paint,
+                    collection);
+  }
+}
+BENCHMARK(BM_MinikinDoLayoutMultiThreaded)
+    ->Arg(1 << 10)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+
 }  // namespace txt
@@ -375,22 +375,36 @@ const std::shared_ptr<FontFamily>& FontCollection::findFallbackFont(
     uint32_t langListId) const {
   std::string locale = GetFontLocale(langListId);
 
-  const auto it = mCachedFallbackFamilies.find(locale);
-  if (it != mCachedFallbackFamilies.end()) {
-    for (const auto& fallbackFamily : it->second) {
-      if (calcCoverageScore(ch, vs, fallbackFamily)) {
-        return fallbackFamily;
+  {
+    std::scoped_lock lock(mFallbackMutex);
+    const auto it = mCachedFallbackFamilies.find(locale);
+    if (it != mCachedFallbackFamilies.end()) {
+      for (const auto& fallbackFamily : it->second) {
+        if (calcCoverageScore(ch, vs, fallbackFamily)) {
+          return fallbackFamily;
+        }
       }
     }
   }
 
+  // The provider takes locks of its own, so mFallbackMutex is not held while
+  // it matches the character.
   const std::shared_ptr<FontFamily>& fallback =
-      mFallbackFontProvider->matchFallbackFont(ch, GetFontLocale(langListId));
+      mFallbackFontProvider->matchFallbackFont(ch, locale);
+  if (!fallback) {
+    return fallback;
+  }
 
-  if (fallback) {
-    mCachedFallbackFamilies[locale].push_back(fallback);
+  // Another layout may have added the same family in the meantime.
+  std::scoped_lock lock(mFallbackMutex);
+  auto& fallbackFamilies = mCachedFallbackFamilies[locale];
+  for (const auto& fallbackFamily : fallbackFamilies) {
+    if (fallbackFamily == fallback) {
+      return fallbackFamily;
+    }
   }
-  return fallback;
+  fallbackFamilies.push_back(fallback);
+  return fallbackFamilies.back();
 }
 
 const uint32_t NBSP = 0x00A0;
@@ -434,8 +448,6 @@ bool FontCollection::hasVariationSelector(uint32_t baseCodepoint,
     return false;
   }
 
-  std::scoped_lock _l(gMinikinLock);
-
   // Currently mRanges can not be used here since it isn't aware of the
   // variation sequence.
   for (size_t i = 0; i < mVSFamilyVec.size(); i++) {
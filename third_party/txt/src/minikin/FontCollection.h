@@ -17,8 +17,10 @@
 #ifndef MINIKIN_FONT_COLLECTION_H
 #define MINIKIN_FONT_COLLECTION_H
 
+#include <deque>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <unordered_set>
 #include <vector>
 
@@ -155,9 +157,15 @@ class FontCollection {
   // libtxt extension: Fallback font provider.
   std::unique_ptr<FallbackFontProvider> mFallbackFontProvider;
 
+  // libtxt extension: Guards mCachedFallbackFamilies, which layouts on
+  // different threads may update at the same time. Never held while calling
+  // into mFallbackFontProvider.
+  mutable std::mutex mFallbackMutex;
+
   // libtxt extension: Fallback fonts discovered after this font collection
-  // was constructed.
-  mutable std::map<std::string, std::vector<std::shared_ptr<FontFamily>>>
+  // was constructed. A deque, so that the families returned by
+  // findFallbackFont stay where they are when more families are added.
+  mutable std::map<std::string, std::deque<std::shared_ptr<FontFamily>>>
       mCachedFallbackFamilies;
 };
 
@@ -56,7 +56,6 @@ android::hash_t FontStyle::hash() const {
 
 // static
 uint32_t FontStyle::registerLanguageList(const std::string& languages) {
-  std::scoped_lock _l(gMinikinLock);
   return FontLanguageListCache::getId(languages);
 }
 
@@ -197,7 +196,6 @@ void FontFamily::computeCoverage() {
 
 bool FontFamily::hasGlyph(uint32_t codepoint,
                           uint32_t variationSelector) const {
-  assertMinikinLocked();
   if (variationSelector != 0 && !mHasVSTable) {
     // Early exit if the variation selector is specified but the font doesn't
     // have a cmap format 14 subtable.
@@ -205,7 +203,11 @@ bool FontFamily::hasGlyph(uint32_t codepoint,
   }
 
   const FontStyle defaultStyle;
-  hb_font_t* font = getHbFontLocked(getClosestMatch(defaultStyle).font);
+  hb_font_t* font;
+  {
+    std::scoped_lock _l(gMinikinLock);
+    font = getHbFontLocked(getClosestMatch(defaultStyle).font);
+  }
   uint32_t unusedGlyph;
   bool result =
       hb_font_get_glyph(font, codepoint, variationSelector, &unusedGlyph);
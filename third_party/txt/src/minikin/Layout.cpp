@@ -22,6 +22,8 @@
 #include <algorithm>
 #include <fstream>
 #include <iostream>  // for debugging
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -52,11 +54,14 @@ struct LayoutContext {
 
   void clearHbFonts() {
     for (size_t i = 0; i < hbFonts.size(); i++) {
-      hb_font_set_funcs(hbFonts[i], nullptr, nullptr, nullptr);
       hb_font_destroy(hbFonts[i]);
     }
     hbFonts.clear();
   }
+
+  // Layouts shape into a buffer owned by their thread, so that layouts on
+  // different threads don't share any HarfBuzz state.
+  static hb_buffer_t* getHbBuffer();
 };
 
 // Layout cache datatypes
@@ -108,6 +113,9 @@ class LayoutCacheKey {
                         collection);
   }
 
+  // The number of bytes used by the copied text of the key.
+  size_t getMemoryUsage() const { return sizeof(*this) + mNchars * 2; }
+
  private:
   const uint16_t* mChars;
   size_t mNchars;
@@ -129,53 +137,108 @@ class LayoutCacheKey {
   android::hash_t computeHash() const;
 };
 
-class LayoutCache : private android::OnEntryRemoved<LayoutCacheKey, Layout*> {
+// A part of the layout cache. The cache is split into shards selected by the
+// hash of the key, each with its own lock, so that layouts on different
+// threads rarely wait for each other. The least recently used layouts of a
+// shard are evicted once the layouts in it use more than kMaxBytes.
+class LayoutCacheShard
+    : private android::OnEntryRemoved<LayoutCacheKey, Layout*> {
  public:
-  LayoutCache() : mCache(kMaxEntries) {
+  LayoutCacheShard()
+      : mCache(android::LruCache<LayoutCacheKey, Layout*>::kUnlimitedCapacity) {
     mCache.setOnEntryRemovedListener(this);
   }
 
-  void clear() { mCache.clear(); }
-
-  Layout* get(LayoutCacheKey& key,
-              LayoutContext* ctx,
-              const std::shared_ptr<FontCollection>& collection) {
-    Layout* layout = mCache.get(key);
-    if (layout == NULL) {
-      key.copyText();
-      layout = new Layout();
-      key.doLayout(layout, ctx, collection);
-      mCache.put(key, layout);
+  void clear() {
+    std::scoped_lock lock(mMutex);
+    mCache.clear();
+  }
+
+  // Calls |callback| with the layout for |key|. The layout is only valid for
+  // the duration of the callback.
+  template <typename Callback>
+  void get(LayoutCacheKey& key,
+           LayoutContext* ctx,
+           const std::shared_ptr<FontCollection>& collection,
+           Callback callback) {
+    {
+      std::scoped_lock lock(mMutex);
+      Layout* layout = mCache.get(key);
+      if (layout != NULL) {
+        callback(layout);
+        return;
+      }
+    }
+
+    // Shaping is the expensive part, so it happens without holding the lock.
+    // If another thread lays out the same word in the meantime, the first
+    // layout to be added to the cache is kept.
+    std::unique_ptr<Layout> layout(new Layout());
+    key.doLayout(layout.get(), ctx, collection);
+    callback(layout.get());
+
+    std::scoped_lock lock(mMutex);
+    if (mCache.get(key) != NULL) {
+      return;
+    }
+    key.copyText();
+    mBytes += getMemoryUsage(key, *layout);
+    mCache.put(key, layout.release());
+    while (mBytes > kMaxBytes && mCache.size() > 1) {
+      mCache.removeOldest();
     }
-    return layout;
   }
 
  private:
   // callback for OnEntryRemoved
   void operator()(LayoutCacheKey& key, Layout*& value) {
+    mBytes -= getMemoryUsage(key, *value);
     key.freeText();
     delete value;
   }
 
+  static size_t getMemoryUsage(const LayoutCacheKey& key,
+                               const Layout& layout) {
+    return key.getMemoryUsage() + layout.getMemoryUsage();
+  }
+
+  // At the typical size of a cached word this keeps around 5000 layouts in
+  // the whole cache, as many as the cache used to be limited to.
+  static const size_t kMaxBytes = 128 * 1024;
+
+  std::mutex mMutex;
   android::LruCache<LayoutCacheKey, Layout*> mCache;
+  size_t mBytes = 0;
+};
+
+class LayoutCache {
+ public:
+  void clear() {
+    for (LayoutCacheShard& shard : mShards) {
+      shard.clear();
+    }
+  }
+
+  template <typename Callback>
+  void get(LayoutCacheKey& key,
+           LayoutContext* ctx,
+           const std::shared_ptr<FontCollection>& collection,
+           Callback callback) {
+    mShards[key.hash() % kShardCount].get(key, ctx, collection, callback);
+  }
 
-  // static const size_t kMaxEntries = LruCache<LayoutCacheKey,
-  // Layout*>::kUnlimitedCapacity;
+ private:
+  static const size_t kShardCount = 16;
 
-  // TODO: eviction based on memory footprint; for now, we just use a constant
-  // number of strings
-  static const size_t kMaxEntries = 5000;
+  LayoutCacheShard mShards[kShardCount];
 };
 
 class LayoutEngine {
  public:
   LayoutEngine() {
     unicodeFunctions = hb_unicode_funcs_create(hb_icu_get_unicode_funcs());
-    hbBuffer = hb_buffer_create();
-    hb_buffer_set_unicode_funcs(hbBuffer, unicodeFunctions);
   }
 
-  hb_buffer_t* hbBuffer;
   hb_unicode_funcs_t* unicodeFunctions;
   LayoutCache layoutCache;
 
@@ -185,6 +248,19 @@ class LayoutEngine {
   }
 };
 
+hb_buffer_t* LayoutContext::getHbBuffer() {
+  struct HbBufferDeleter {
+    void operator()(hb_buffer_t* buffer) { hb_buffer_destroy(buffer); }
+  };
+  thread_local std::unique_ptr<hb_buffer_t, HbBufferDeleter> hbBuffer;
+  if (hbBuffer == nullptr) {
+    hbBuffer.reset(hb_buffer_create());
+    hb_buffer_set_unicode_funcs(hbBuffer.get(),
+                                LayoutEngine::getInstance().unicodeFunctions);
+  }
+  return hbBuffer.get();
+}
+
 bool LayoutCacheKey::operator==(const LayoutCacheKey& other) const {
   return mId == other.mId && mStart == other.mStart && mCount == other.mCount &&
          mStyle == other.mStyle && mSize == other.mSize &&
@@ -254,34 +330,31 @@ static hb_bool_t harfbuzzGetGlyphHorizontalOrigin(hb_font_t* /* hbFont */,
   return true;
 }
 
-hb_font_funcs_t* getHbFontFuncs(bool forColorBitmapFont) {
-  assertMinikinLocked();
-
-  static hb_font_funcs_t* hbFuncs = nullptr;
-  static hb_font_funcs_t* hbFuncsForColorBitmap = nullptr;
-
-  hb_font_funcs_t** funcs =
-      forColorBitmapFont ? &hbFuncs : &hbFuncsForColorBitmap;
-  if (*funcs == nullptr) {
-    *funcs = hb_font_funcs_create();
-    if (forColorBitmapFont) {
-      // Don't override the h_advance function since we use HarfBuzz's
-      // implementation for emoji for performance reasons. Note that it is
-      // technically possible for a TrueType font to have outline and embedded
-      // bitmap at the same time. We ignore modified advances of hinted outline
-      // glyphs in that case.
-    } else {
-      // Override the h_advance function since we can't use HarfBuzz's
-      // implemenation. It may return the wrong value if the font uses hinting
-      // aggressively.
-      hb_font_funcs_set_glyph_h_advance_func(
-          *funcs, harfbuzzGetGlyphHorizontalAdvance, 0, 0);
-    }
-    hb_font_funcs_set_glyph_h_origin_func(
-        *funcs, harfbuzzGetGlyphHorizontalOrigin, 0, 0);
-    hb_font_funcs_make_immutable(*funcs);
+static hb_font_funcs_t* createHbFontFuncs(bool forColorBitmapFont) {
+  hb_font_funcs_t* funcs = hb_font_funcs_create();
+  if (forColorBitmapFont) {
+    // Don't override the h_advance function since we use HarfBuzz's
+    // implementation for emoji for performance reasons. Note that it is
+    // technically possible for a TrueType font to have outline and embedded
+    // bitmap at the same time. We ignore modified advances of hinted outline
+    // glyphs in that case.
+  } else {
+    // Override the h_advance function since we can't use HarfBuzz's
+    // implemenation. It may return the wrong value if the font uses hinting
+    // aggressively.
+    hb_font_funcs_set_glyph_h_advance_func(
+        funcs, harfbuzzGetGlyphHorizontalAdvance, 0, 0);
   }
-  return *funcs;
+  hb_font_funcs_set_glyph_h_origin_func(funcs, harfbuzzGetGlyphHorizontalOrigin,
+                                        0, 0);
+  hb_font_funcs_make_immutable(funcs);
+  return funcs;
+}
+
+hb_font_funcs_t* getHbFontFuncs(bool forColorBitmapFont) {
+  static hb_font_funcs_t* hbFuncs = createHbFontFuncs(false);
+  static hb_font_funcs_t* hbFuncsForColorBitmap = createHbFontFuncs(true);
+  return forColorBitmapFont ? hbFuncsForColorBitmap : hbFuncs;
 }
 
 static bool isColorBitmapFont(hb_font_t* font) {
@@ -316,7 +389,16 @@ int Layout::findFace(const FakedFont& face, LayoutContext* ctx) {
   // Note: ctx == NULL means we're copying from the cache, no need to create
   // corresponding hb_font object.
   if (ctx != NULL) {
-    hb_font_t* font = getHbFontLocked(face.font);
+    hb_font_t* parent;
+    {
+      std::scoped_lock _l(gMinikinLock);
+      parent = getHbFontLocked(face.font);
+    }
+    // The cached font is shared with other threads, so the paint dependent
+    // funcs, size and scale are set on a font of our own that is derived
+    // from it.
+    hb_font_t* font = hb_font_create_sub_font(parent);
+    hb_font_destroy(parent);
     hb_font_set_funcs(font, getHbFontFuncs(isColorBitmapFont(font)),
                       &ctx->paint, 0);
     ctx->hbFonts.push_back(font);
@@ -325,10 +407,7 @@ int Layout::findFace(const FakedFont& face, LayoutContext* ctx) {
 }
 
 static hb_script_t codePointToScript(hb_codepoint_t codepoint) {
-  static hb_unicode_funcs_t* u = 0;
-  if (!u) {
-    u = LayoutEngine::getInstance().unicodeFunctions;
-  }
+  static hb_unicode_funcs_t* u = LayoutEngine::getInstance().unicodeFunctions;
   return hb_unicode_script(u, codepoint);
 }
 
@@ -588,8 +667,6 @@ void Layout::doLayout(const uint16_t* buf,
                       const FontStyle& style,
                       const MinikinPaint& paint,
                       const std::shared_ptr<FontCollection>& collection) {
-  std::scoped_lock _l(gMinikinLock);
-
   LayoutContext ctx;
   ctx.style = style;
   ctx.paint = paint;
@@ -612,8 +689,6 @@ float Layout::measureText(const uint16_t* buf,
                           const MinikinPaint& paint,
                           const std::shared_ptr<FontCollection>& collection,
                           float* advances) {
-  std::scoped_lock _l(gMinikinLock);
-
   LayoutContext ctx;
   ctx.style = style;
   ctx.paint = paint;
@@ -720,14 +795,15 @@ float Layout::doLayoutWord(const uint16_t* buf,
     }
     advance = layoutForWord.getAdvance();
   } else {
-    Layout* layoutForWord = cache.get(key, ctx, collection);
-    if (layout) {
-      layout->appendLayout(layoutForWord, bufStart, wordSpacing);
-    }
-    if (advances) {
-      layoutForWord->getAdvances(advances);
-    }
-    advance = layoutForWord->getAdvance();
+    cache.get(key, ctx, collection, [&](Layout* layoutForWord) {
+      if (layout) {
+        layout->appendLayout(layoutForWord, bufStart, wordSpacing);
+      }
+      if (advances) {
+        layoutForWord->getAdvances(advances);
+      }
+      advance = layoutForWord->getAdvance();
+    });
   }
 
   if (wordSpacing != 0) {
@@ -919,7 +995,7 @@ void Layout::doLayoutRun(const uint16_t* buf,
                          bool isRtl,
                          LayoutContext* ctx,
                          const std::shared_ptr<FontCollection>& collection) {
-  hb_buffer_t* buffer = LayoutEngine::getInstance().hbBuffer;
+  hb_buffer_t* buffer = ctx->getHbBuffer();
   std::vector<FontCollection::Run> items;
   collection->itemize(buf + start, count, ctx->style, &items);
 
@@ -1192,10 +1268,16 @@ void Layout::getBounds(MinikinRect* bounds) const {
   bounds->set(mBounds);
 }
 
+size_t Layout::getMemoryUsage() const {
+  return sizeof(Layout) + mGlyphs.capacity() * sizeof(LayoutGlyph) +
+         mAdvances.capacity() * sizeof(float) +
+         mFaces.capacity() * sizeof(FakedFont);
+}
+
 void Layout::purgeCaches() {
-  std::scoped_lock _l(gMinikinLock);
   LayoutCache& layoutCache = LayoutEngine::getInstance().layoutCache;
   layoutCache.clear();
+  std::scoped_lock _l(gMinikinLock);
   purgeHbFontCacheLocked();
 }
 
@@ -114,6 +114,10 @@ class Layout {
 
   void getBounds(MinikinRect* rect) const;
 
+  // The approximate number of bytes used by this layout. Used to bound the
+  // memory used by the layout cache.
+  size_t getMemoryUsage() const;
+
   // Purge all caches, useful in low memory conditions
   static void purgeCaches();
 
@@ -127,13 +127,27 @@ float LineBreaker::addStyleRun(MinikinPaint* paint,
                                size_t start,
                                size_t end,
                                bool isRtl) {
+  return addMeasuredStyleRun(paint, typeface, style, start, start, end, isRtl);
+}
+
+float LineBreaker::addMeasuredStyleRun(
+    MinikinPaint* paint,
+    const std::shared_ptr<FontCollection>& typeface,
+    FontStyle style,
+    size_t start,
+    size_t measuredEnd,
+    size_t end,
+    bool isRtl) {
   float width = 0.0f;
 
   float hyphenPenalty = 0.0;
   if (paint != nullptr) {
-    width = Layout::measureText(mTextBuf.data(), start, end - start,
-                                mTextBuf.size(), isRtl, style, *paint, typeface,
-                                mCharWidths.data() + start);
+    if (measuredEnd < end) {
+      width = Layout::measureText(mTextBuf.data(), measuredEnd,
+                                  end - measuredEnd, mTextBuf.size(), isRtl,
+                                  style, *paint, typeface,
+                                  mCharWidths.data() + measuredEnd);
+    }
 
     // a heuristic that seems to perform well
     hyphenPenalty =
@@ -148,6 +148,19 @@ class LineBreaker {
                     size_t end,
                     bool isRtl);
 
+  // libtxt: Same as addStyleRun, but the widths of the code units in
+  // [start, measuredEnd) have already been stored in charWidths(), for example
+  // by an earlier layout of the same text, and are not measured again.
+  // measuredEnd must be a word break for the purposes of layout caching (see
+  // getPrevWordBreakForCache). Returns the width of the measured part only.
+  float addMeasuredStyleRun(MinikinPaint* paint,
+                            const std::shared_ptr<FontCollection>& typeface,
+                            FontStyle style,
+                            size_t start,
+                            size_t measuredEnd,
+                            size_t end,
+                            bool isRtl);
+
   void addReplacement(size_t start, size_t end, float width);
 
   size_t computeBreaks();
@@ -28,8 +28,10 @@
 namespace minikin {
 
 // All external Minikin interfaces are designed to be thread-safe.
-// Presently, that's implemented by through a global lock, and having
-// all external interfaces take that lock.
+// The shared HarfBuzz font cache and font table lookups are guarded by a
+// global lock. Text layout only takes it briefly to look up fonts, and the
+// layout cache and language list cache have locks of their own, so that
+// layouts on different threads can run concurrently.
 
 extern std::recursive_mutex gMinikinLock;
 
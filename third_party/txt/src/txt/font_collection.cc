@@ -99,10 +99,12 @@ size_t FontCollection::GetFontManagersCount() const {
 
 void FontCollection::SetupDefaultFontManager() {
   default_font_manager_ = GetDefaultFontManager();
+  fonts_generation_++;
 }
 
 void FontCollection::SetDefaultFontManager(sk_sp<SkFontMgr> font_manager) {
   default_font_manager_ = font_manager;
+  fonts_generation_++;
 
 #if FLUTTER_ENABLE_SKSHAPER
   skt_collection_.reset();
@@ -111,6 +113,7 @@ void FontCollection::SetDefaultFontManager(sk_sp<SkFontMgr> font_manager) {
 
 void FontCollection::SetAssetFontManager(sk_sp<SkFontMgr> font_manager) {
   asset_font_manager_ = font_manager;
+  fonts_generation_++;
 
 #if FLUTTER_ENABLE_SKSHAPER
   skt_collection_.reset();
@@ -119,6 +122,7 @@ void FontCollection::SetAssetFontManager(sk_sp<SkFontMgr> font_manager) {
 
 void FontCollection::SetDynamicFontManager(sk_sp<SkFontMgr> font_manager) {
   dynamic_font_manager_ = font_manager;
+  fonts_generation_++;
 
 #if FLUTTER_ENABLE_SKSHAPER
   skt_collection_.reset();
@@ -127,6 +131,7 @@ void FontCollection::SetDynamicFontManager(sk_sp<SkFontMgr> font_manager) {
 
 void FontCollection::SetTestFontManager(sk_sp<SkFontMgr> font_manager) {
   test_font_manager_ = font_manager;
+  fonts_generation_++;
 
 #if FLUTTER_ENABLE_SKSHAPER
   skt_collection_.reset();
@@ -149,6 +154,7 @@ std::vector<sk_sp<SkFontMgr>> FontCollection::GetFontManagerOrder() const {
 
 void FontCollection::DisableFontFallback() {
   enable_font_fallback_ = false;
+  fonts_generation_++;
 
 #if FLUTTER_ENABLE_SKSHAPER
   if (skt_collection_) {
@@ -161,6 +167,8 @@ std::shared_ptr<minikin::FontCollection>
 FontCollection::GetMinikinFontCollectionForFamilies(
     const std::vector<std::string>& font_families,
     const std::string& locale) {
+  std::scoped_lock lock(cache_mutex_);
+
   // Look inside the font collections cache first.
   FamilyKey family_key(font_families, locale);
   auto cached = font_collections_cache_.find(family_key);
@@ -320,6 +328,7 @@ const std::shared_ptr<minikin::FontFamily>& FontCollection::MatchFallbackFont(
   // Check if the ch's matched font has been cached. We cache the results of
   // this method as repeated matchFamilyStyleCharacter calls can become
   // extremely laggy when typing a large number of complex emojis.
+  std::scoped_lock lock(cache_mutex_);
   auto lookup = fallback_match_cache_.find(ch);
   if (lookup != fallback_match_cache_.end()) {
     return *lookup->second;
@@ -381,7 +390,11 @@ FontCollection::GetFallbackFontFamily(const sk_sp<SkFontMgr>& manager,
 }
 
 void FontCollection::ClearFontFamilyCache() {
-  font_collections_cache_.clear();
+  fonts_generation_++;
+  {
+    std::scoped_lock lock(cache_mutex_);
+    font_collections_cache_.clear();
+  }
 
 #if FLUTTER_ENABLE_SKSHAPER
   if (skt_collection_) {
@@ -17,7 +17,9 @@
 #ifndef LIB_TXT_SRC_FONT_COLLECTION_H_
 #define LIB_TXT_SRC_FONT_COLLECTION_H_
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <unordered_map>
@@ -68,6 +70,11 @@ class FontCollection : public std::enable_shared_from_this<FontCollection> {
   // Remove all entries in the font family cache.
   void ClearFontFamilyCache();
 
+  // Returns a counter that is incremented whenever the fonts that a family
+  // name resolves to may have changed, so that paragraphs know to measure
+  // their text again.
+  size_t GetFontsGeneration() const { return fonts_generation_; }
+
 #if FLUTTER_ENABLE_SKSHAPER
 
   // Construct a Skia text layout FontCollection based on this collection.
@@ -94,6 +101,11 @@ class FontCollection : public std::enable_shared_from_this<FontCollection> {
   sk_sp<SkFontMgr> asset_font_manager_;
   sk_sp<SkFontMgr> dynamic_font_manager_;
   sk_sp<SkFontMgr> test_font_manager_;
+  std::atomic<size_t> fonts_generation_ = 0;
+  // Guards the caches below. Paragraphs may be laid out on several threads
+  // at once, for example by engines spawned from the same engine, and the
+  // minikin collections ask for fallback fonts during layout.
+  std::mutex cache_mutex_;
   std::unordered_map<FamilyKey,
                      std::shared_ptr<minikin::FontCollection>,
                      FamilyKey::Hasher>
@@ -114,7 +126,7 @@ class FontCollection : public std::enable_shared_from_this<FontCollection> {
 #endif
 
   // Performs the actual work of MatchFallbackFont. The result is cached in
-  // fallback_match_cache_.
+  // fallback_match_cache_. Must be called with cache_mutex_ held.
   const std::shared_ptr<minikin::FontFamily>& DoMatchFallbackFont(
       uint32_t ch,
       std::string locale);
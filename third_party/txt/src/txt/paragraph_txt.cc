@@ -236,6 +236,7 @@ ParagraphTxt::~ParagraphTxt() = default;
 
 void ParagraphTxt::SetText(std::vector<uint16_t> text, StyledRuns runs) {
   SetDirty(true);
+  measured_text_end_ = 0;
   if (text.size() == 0)
     return;
   text_ = std::move(text);
@@ -246,6 +247,7 @@ void ParagraphTxt::SetInlinePlaceholders(
     std::vector<PlaceholderRun> inline_placeholders,
     std::unordered_set<size_t> obj_replacement_char_indexes) {
   needs_layout_ = true;
+  measured_text_end_ = 0;
   inline_placeholders_ = std::move(inline_placeholders);
   obj_replacement_char_indexes_ = std::move(obj_replacement_char_indexes);
 }
@@ -255,6 +257,18 @@ bool ParagraphTxt::ComputeLineBreaks() {
   line_widths_.clear();
   max_intrinsic_width_ = 0;
 
+  // Fonts that were loaded or replaced since the last layout may change the
+  // widths of the text.
+  const size_t fonts_generation = font_collection_->GetFontsGeneration();
+  if (fonts_generation != measured_fonts_generation_) {
+    measured_text_end_ = 0;
+    measured_fonts_generation_ = fonts_generation;
+  }
+
+  std::vector<MeasuredRun> measured_runs;
+  size_t measured_run_index = 0;
+  measured_char_widths_.resize(text_.size());
+
   std::vector<size_t> newline_positions;
   // Discover and add all hard breaks.
   for (size_t i = 0; i < text_.size(); ++i) {
@@ -343,10 +357,38 @@ bool ParagraphTxt::ComputeLineBreaks() {
                              isRtl);
         inline_placeholder_index++;
       } else {
-        // Is a regular text run.
-        double run_width = breaker_.addStyleRun(&paint, collection, font,
-                                                run_start, run_end, isRtl);
+        // Is a regular text run. Reuse the widths that are still valid from
+        // the previous layout and only measure the rest of the run.
+        size_t start = block_start + run_start;
+        size_t end = block_start + run_end;
+        size_t measured_end =
+            std::min(std::max(measured_text_end_, start), end);
+        std::copy(measured_char_widths_.begin() + start,
+                  measured_char_widths_.begin() + measured_end,
+                  breaker_.charWidths() + run_start);
+        double run_width = breaker_.addMeasuredStyleRun(
+            &paint, collection, font, run_start, measured_end - block_start,
+            run_end, isRtl);
+
+        while (measured_run_index < measured_runs_.size() &&
+               measured_runs_[measured_run_index].start < start) {
+          measured_run_index++;
+        }
+        if (measured_end == end && measured_run_index < measured_runs_.size() &&
+            measured_runs_[measured_run_index].start == start &&
+            measured_runs_[measured_run_index].end == end) {
+          run_width = measured_runs_[measured_run_index].width;
+        } else {
+          run_width = std::accumulate(
+              measured_char_widths_.begin() + start,
+              measured_char_widths_.begin() + measured_end, run_width);
+        }
         block_total_width += run_width;
+
+        std::copy(breaker_.charWidths() + run_start,
+                  breaker_.charWidths() + run_end,
+                  measured_char_widths_.begin() + start);
+        measured_runs.push_back({start, end, run_width});
       }
 
       if (run.end > block_end)
@@ -379,6 +421,8 @@ bool ParagraphTxt::ComputeLineBreaks() {
     breaker_.finish();
   }
 
+  measured_runs_ = std::move(measured_runs);
+  measured_text_end_ = text_.size();
   return true;
 }
 
@@ -1369,12 +1413,14 @@ double ParagraphTxt::GetLongestLine() {
 
 void ParagraphTxt::SetParagraphStyle(const ParagraphStyle& style) {
   needs_layout_ = true;
+  measured_text_end_ = 0;
   paragraph_style_ = style;
 }
 
 void ParagraphTxt::SetFontCollection(
     std::shared_ptr<FontCollection> font_collection) {
   font_collection_ = std::move(font_collection);
+  measured_text_end_ = 0;
 }
 
 std::shared_ptr<minikin::FontCollection>
@@ -2017,6 +2063,22 @@ void ParagraphTxt::SetDirty(bool dirty) {
   needs_layout_ = dirty;
 }
 
+void ParagraphTxt::AppendText(const std::u16string& text,
+                              const TextStyle& style) {
+  if (text.empty())
+    return;
+  SetDirty(true);
+  // The width of a word depends on all of its code units, so the last word of
+  // the current text has to be measured again along with the appended text.
+  measured_text_end_ =
+      std::min(measured_text_end_,
+               minikin::getPrevWordBreakForCache(text_.data(), text_.size(),
+                                                 text_.size()));
+  runs_.StartRun(runs_.AddStyle(style), text_.size());
+  text_.insert(text_.end(), text.begin(), text.end());
+  runs_.EndRunIfNeeded(text_.size());
+}
+
 std::vector<LineMetrics>& ParagraphTxt::GetLineMetrics() {
   FML_DCHECK(!needs_layout_) << "only valid after layout";
   return line_metrics_;
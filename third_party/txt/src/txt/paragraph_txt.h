@@ -126,6 +126,12 @@ class ParagraphTxt : public Paragraph {
   // Layout from being calculated by setting to false.
   void SetDirty(bool dirty = true);
 
+  // Appends text in the given style to the end of the paragraph. The next
+  // Layout() only measures the appended text and the word it continues, and
+  // reuses the measurements of the rest of the paragraph. Placeholders can not
+  // be appended.
+  void AppendText(const std::u16string& text, const TextStyle& style);
+
  private:
   friend class ParagraphBuilderTxt;
   FRIEND_TEST(ParagraphTest, SimpleParagraph);
@@ -153,6 +159,7 @@ class ParagraphTxt : public Paragraph {
   FRIEND_TEST_LINUX_ONLY(ParagraphTest, EmojiMultiLineRectsParagraph);
   FRIEND_TEST(ParagraphTest, HyphenBreakParagraph);
   FRIEND_TEST(ParagraphTest, RepeatLayoutParagraph);
+  FRIEND_TEST(ParagraphTest, AppendTextParagraph);
   FRIEND_TEST(ParagraphTest, Ellipsize);
   FRIEND_TEST(ParagraphTest, UnderlineShiftParagraph);
   FRIEND_TEST(ParagraphTest, WavyDecorationParagraph);
@@ -190,6 +197,21 @@ class ParagraphTxt : public Paragraph {
   size_t final_line_count_;
   std::vector<double> line_widths_;
 
+  // The widths measured by the line breaker in the last ComputeLineBreaks().
+  // They only depend on the text and its styles, so a layout at a new width or
+  // after text was appended reuses them instead of measuring the text again.
+  struct MeasuredRun {
+    size_t start;
+    size_t end;
+    double width;
+  };
+  std::vector<MeasuredRun> measured_runs_;
+  std::vector<float> measured_char_widths_;
+  // The measurements of the code units before this index are valid.
+  size_t measured_text_end_ = 0;
+  // The FontCollection::GetFontsGeneration() of the measurements.
+  size_t measured_fonts_generation_ = 0;
+
   // Stores the result of Layout().
   std::vector<PaintRecord> records_;
 
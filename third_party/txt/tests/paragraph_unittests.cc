@@ -5919,6 +5919,69 @@ TEST_F(ParagraphTest, RepeatLayoutParagraph) {
   ASSERT_TRUE(Snapshot());
 }
 
+TEST_F(ParagraphTest, AppendTextParagraph) {
+  const char* text = "Sentence to layout at diff widths to get diff line ";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+  const char* appended_text =
+      "counts. short words short words short words short words end";
+  auto icu_appended_text = icu::UnicodeString::fromUTF8(appended_text);
+  std::u16string u16_appended_text(
+      icu_appended_text.getBuffer(),
+      icu_appended_text.getBuffer() + icu_appended_text.length());
+
+  txt::ParagraphStyle paragraph_style;
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.font_size = 31;
+  text_style.color = SK_ColorBLACK;
+
+  txt::ParagraphBuilderTxt builder(paragraph_style, GetTestFontCollection());
+  builder.PushStyle(text_style);
+  builder.AddText(u16_text);
+  builder.Pop();
+  auto paragraph = BuildParagraph(builder);
+  paragraph->Layout(300);
+  paragraph->AppendText(u16_appended_text, text_style);
+  paragraph->Layout(300);
+
+  txt::ParagraphBuilderTxt expected_builder(paragraph_style,
+                                            GetTestFontCollection());
+  expected_builder.PushStyle(text_style);
+  expected_builder.AddText(u16_text);
+  expected_builder.Pop();
+  expected_builder.PushStyle(text_style);
+  expected_builder.AddText(u16_appended_text);
+  expected_builder.Pop();
+  auto expected_paragraph = BuildParagraph(expected_builder);
+  expected_paragraph->Layout(300);
+
+  ASSERT_EQ(paragraph->text_, expected_paragraph->text_);
+  ASSERT_EQ(paragraph->GetLineCount(), expected_paragraph->GetLineCount());
+  for (size_t i = 0; i < paragraph->GetLineCount(); ++i) {
+    ASSERT_EQ(paragraph->line_metrics_[i].start_index,
+              expected_paragraph->line_metrics_[i].start_index);
+    ASSERT_EQ(paragraph->line_metrics_[i].end_index,
+              expected_paragraph->line_metrics_[i].end_index);
+    ASSERT_NEAR(paragraph->line_metrics_[i].width,
+                expected_paragraph->line_metrics_[i].width, 0.001);
+  }
+  ASSERT_NEAR(paragraph->GetMaxIntrinsicWidth(),
+              expected_paragraph->GetMaxIntrinsicWidth(), 0.001);
+
+  // Laying out at a new width reuses the measurements of the whole text.
+  paragraph->Layout(600);
+  expected_paragraph->Layout(600);
+  ASSERT_EQ(paragraph->GetLineCount(), expected_paragraph->GetLineCount());
+  for (size_t i = 0; i < paragraph->GetLineCount(); ++i) {
+    ASSERT_EQ(paragraph->line_metrics_[i].end_index,
+              expected_paragraph->line_metrics_[i].end_index);
+  }
+  ASSERT_NEAR(paragraph->GetMaxIntrinsicWidth(),
+              expected_paragraph->GetMaxIntrinsicWidth(), 0.001);
+}
+
 TEST_F(ParagraphTest, Ellipsize) {
   const char* text =
       "This is a very long sentence to test if the text will properly wrap "
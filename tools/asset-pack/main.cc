@@ -0,0 +1,64 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "flutter/assets/asset_pack.h"
+#include "flutter/fml/file.h"
+
+void Usage() {
+  std::cout << "Usage:" << std::endl;
+  std::cout << "asset-pack <output.pack> <flutter_assets>" << std::endl;
+  std::cout << std::endl;
+  std::cout << "Packs all files in the flutter_assets directory into a single "
+               "asset pack, which the engine can load with the --asset-pack "
+               "switch instead of reading the directory."
+            << std::endl;
+  std::cout << "The output.pack file will be overwritten if it exists already "
+               "and packing succeeds."
+            << std::endl;
+}
+
+int main(int argc, char** argv) {
+  if (argc != 3) {
+    Usage();
+    return -1;
+  }
+  std::string output_file_path(argv[1]);
+  std::string assets_directory_path(argv[2]);
+
+  fml::UniqueFD assets_directory = fml::OpenDirectory(
+      assets_directory_path.c_str(), false, fml::FilePermission::kRead);
+  if (!fml::IsDirectory(assets_directory)) {
+    std::cerr << "Failed to open the assets directory "
+              << assets_directory_path << "; aborting." << std::endl;
+    return -1;
+  }
+
+  flutter::AssetPackBuilder builder;
+  if (!builder.AddDirectory(assets_directory)) {
+    std::cerr << "Failed to read the assets in " << assets_directory_path
+              << "; aborting." << std::endl;
+    return -1;
+  }
+  auto pack = builder.Build();
+  if (!pack) {
+    std::cerr << "Failed to build the asset pack; aborting." << std::endl;
+    return -1;
+  }
+
+  std::ofstream output_file(output_file_path, std::ios::out | std::ios::binary);
+  output_file.write(reinterpret_cast<const char*>(pack->GetMapping()),
+                    pack->GetSize());
+  if (!output_file.good()) {
+    std::cerr << "Failed to write the asset pack to " << output_file_path
+              << "; aborting." << std::endl;
+    return -1;
+  }
+  std::cout << "Wrote " << pack->GetSize() << " bytes to " << output_file_path
+            << std::endl;
+  return 0;
+}